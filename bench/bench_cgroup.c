@@ -0,0 +1,139 @@
+/**
+ * @file bench_cgroup.c
+ * @brief Benchmark of the cgroup view: one walk of a hierarchy of 3000 cgroups,
+ *        the per-cgroup process counts, and the per-process cgroup lookup.
+ * @version 2.0.1
+ */
+
+#include "../include/system/cgroup.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Returns a monotonic timestamp in milliseconds.
+ */
+static double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/**
+ * @brief Writes @p text to @p dir/@p name.
+ */
+static void write_file(const char* dir, const char* name, const char* text) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE* file = fopen(path, "w");
+    if (!file) return;
+    fputs(text, file);
+    fclose(file);
+}
+
+/**
+ * @brief Creates a cgroup directory with the files a memory/pids/cpu-enabled
+ *        cgroup has, sized like a real memory.stat, and its pressure files.
+ */
+static void make_cgroup(const char* dir, int seed) {
+    char text[2048];
+    mkdir(dir, 0755);
+    snprintf(text, sizeof(text),
+             "usage_usec %d\nuser_usec 0\nsystem_usec 0\nnr_periods 0\nnr_throttled 0\n"
+             "throttled_usec 0\n",
+             seed * 1000);
+    write_file(dir, "cpu.stat", text);
+    write_file(dir, "memory.current", "104857600\n");
+    write_file(dir, "pids.current", "7\n");
+    const char* pressure = "some avg10=0.12 avg60=0.34 avg300=0.56 total=123456\n"
+                           "full avg10=0.01 avg60=0.02 avg300=0.03 total=4567\n";
+    write_file(dir, "cpu.pressure", pressure);
+    write_file(dir, "memory.pressure", pressure);
+    write_file(dir, "io.pressure", pressure);
+    int len = 0;
+    static const char* keys[] = {
+        "anon",          "file",          "kernel",        "kernel_stack",  "pagetables",
+        "percpu",        "sock",          "vmalloc",       "shmem",         "file_mapped",
+        "file_dirty",    "swapcached",    "anon_thp",      "file_thp",      "shmem_thp",
+        "inactive_anon", "active_anon",   "inactive_file", "active_file",   "unevictable",
+        "slab",          "pgfault",       "pgmajfault",    "pgrefill",      "pgscan",
+        "pgsteal",       "pgactivate",    "pgdeactivate",  "pglazyfree",    "thp_fault_alloc"};
+    for (unsigned i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+        len += snprintf(text + len, sizeof(text) - len, "%s %d\n", keys[i], 4096 * (seed + i));
+    }
+    write_file(dir, "memory.stat", text);
+}
+
+/**
+ * @brief Main entry point of the cgroup benchmark.
+ */
+int main() {
+    const int slices   = 30;
+    const int services = 100;
+    const int walks    = 20;
+    char      root[]   = "/tmp/procx_bench_cgroup_XXXXXX";
+    if (!mkdtemp(root)) return 1;
+    write_file(root, "cpu.stat", "usage_usec 0\n");
+    for (int s = 0; s < slices; s++) {
+        char slice[256];
+        snprintf(slice, sizeof(slice), "%s/slice-%02d.slice", root, s);
+        make_cgroup(slice, s);
+        for (int v = 0; v < services; v++) {
+            char service[320];
+            snprintf(service, sizeof(service), "%s/unit-%03d.service", slice, v);
+            make_cgroup(service, s * services + v);
+        }
+    }
+
+    CgroupSampler sampler;
+    CgroupList    list;
+    if (cgroup_sampler_init(&sampler, root) != 0) return 1;
+    cgroup_list_init(&list);
+    sampler.enabled = 1;
+    cgroup_sampler_collect(&sampler, &list);
+    double start = now_ms();
+    for (int i = 0; i < walks; i++) cgroup_sampler_collect(&sampler, &list);
+    double walk = (now_ms() - start) / walks;
+
+    // Processes spread over the services, as the sampler counts them per sample.
+    const int    count = 20000;
+    ProcessNode* nodes = calloc(count, sizeof(ProcessNode));
+    srand(42);
+    for (int i = 0; i < count; i++) {
+        nodes[i].pid       = 1 + i;
+        nodes[i].cgroup_id = list.items[1 + rand() % (list.count - 1)].id;
+        nodes[i].next      = (i + 1 < count) ? &nodes[i + 1] : NULL;
+    }
+    ProcessSnapshot snapshot;
+    snapshot_init(&snapshot);
+    snapshot_build(&snapshot, nodes, count);
+    start = now_ms();
+    for (int i = 0; i < walks; i++) cgroup_list_count(&list, &snapshot);
+    double counting = (now_ms() - start) / walks;
+
+    printf("ProcX cgroup benchmark\n");
+    printf("%d cgroups (%d slices of %d services)\n", list.count, slices, services);
+    printf("  walk         %8.3f ms   (%.1f us per cgroup)\n", walk, walk * 1000 / list.count);
+    printf("  count        %8.3f ms   (%d processes)\n", counting, count);
+
+    CgroupSampler host;
+    if (cgroup_sampler_init(&host, NULL) == 0) {
+        const int lookups = 2000;
+        start             = now_ms();
+        for (int i = 0; i < lookups; i++) cgroup_sampler_resolve(&host, getpid());
+        double lookup = (now_ms() - start) * 1000 / lookups;
+        printf("  lookup       %8.3f us   per process, once per process lifetime\n", lookup);
+        cgroup_sampler_free(&host);
+    }
+
+    snapshot_free(&snapshot);
+    free(nodes);
+    cgroup_list_free(&list);
+    cgroup_sampler_free(&sampler);
+    char command[64];
+    snprintf(command, sizeof(command), "rm -rf %s", root);
+    return system(command) == 0 ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file bench_record.c
+ * @brief Benchmark of the flight recorder: frame sizes, append cost, and replay
+ *        seek cost at 20k processes.
+ * @version 2.0.1
+ */
+
+#include "../include/system/recorder.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Returns a monotonic timestamp in milliseconds.
+ */
+static double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/**
+ * @brief Fills a list with the same process mix as bench_sort.c.
+ */
+static ProcessNode* make_processes(int count, unsigned int seed) {
+    static const char* names[] = {"kworker/u16:", "bash", "sshd", "postgres", "nginx", "python3",
+                                  "systemd", "java", "node", "containerd-shim"};
+    ProcessNode*       nodes   = calloc(count, sizeof(ProcessNode));
+    srand(seed);
+    for (int i = 0; i < count; i++) {
+        nodes[i].pid         = 1 + i * 3 + rand() % 3;
+        nodes[i].ppid        = 1 + rand() % 1000;
+        nodes[i].num_threads = 1 + rand() % 32;
+        nodes[i].cpu_usage   = (rand() % 10 == 0) ? (float)(rand() % 4000) / 100.0f : 0.0f;
+        nodes[i].memory_kb   = (rand() % 4 == 0) ? 0 : 1024L + rand() % 4000000;
+        nodes[i].state       = (rand() % 20 == 0) ? 'R' : 'S';
+        nodes[i].priority    = 20;
+        nodes[i].starttime   = 1000 + rand() % 100000;
+        snprintf(nodes[i].name, sizeof(nodes[i].name), "%s%d", names[rand() % 10], rand() % 40);
+        strcpy(nodes[i].username, "root");
+        nodes[i].next = (i + 1 < count) ? &nodes[i + 1] : NULL;
+    }
+    return nodes;
+}
+
+/**
+ * @brief Moves a busy host forward by one sample: 10% of the processes used
+ *        CPU, a few changed memory, and one in a thousand exited or started.
+ */
+static void advance(ProcessNode* nodes, int count) {
+    for (int i = 0; i < count; i++) {
+        if (rand() % 10 == 0) {
+            nodes[i].cpu_usage = (float)(rand() % 4000) / 100.0f;
+            nodes[i].utime += 1 + rand() % 40;
+        } else {
+            nodes[i].cpu_usage = 0.0f;
+        }
+        if (rand() % 50 == 0) nodes[i].memory_kb += rand() % 512;
+        if (rand() % 1000 == 0) nodes[i].pid += 3 * count;
+    }
+}
+
+/**
+ * @brief Main entry point of the recorder benchmark.
+ */
+int main() {
+    const int    count   = 20000;
+    const int    samples = 120;
+    ProcessNode* nodes   = make_processes(count, 42);
+    char         path[]  = "/tmp/procx_bench_record_XXXXXX";
+    int          fd      = mkstemp(path);
+    if (fd < 0) return 1;
+    close(fd);
+
+    Recorder recorder;
+    if (recorder_open(&recorder, path, RECORDER_DEFAULT_SIZE) != 0) return 1;
+    Sample sample;
+    memset(&sample, 0, sizeof(sample));
+    snapshot_init(&sample.snapshot);
+
+    double   append_ms = 0, key_ms = 0;
+    uint64_t key_bytes = 0, delta_bytes = 0;
+    int      keys      = 0;
+    for (int s = 0; s < samples; s++) {
+        advance(nodes, count);
+        snapshot_build(&sample.snapshot, nodes, count);
+        sample.time_ms = 1729212345000LL + s * 1000LL;
+
+        uint64_t before = recorder.header->head;
+        double   start  = now_ms();
+        recorder_append(&recorder, &sample);
+        double   took   = now_ms() - start;
+        uint64_t bytes  = recorder.header->head - before;
+        const RecorderFrame* frame =
+            (const RecorderFrame*)(recorder.map + recorder.header->last);
+        if (frame->flags & RECORDER_FRAME_KEY) {
+            key_ms += took;
+            key_bytes += bytes;
+            keys++;
+        } else {
+            append_ms += took;
+            delta_bytes += bytes;
+        }
+    }
+    recorder_close(&recorder);
+
+    int deltas = samples - keys;
+    printf("ProcX flight recorder benchmark\n");
+    printf("%d processes, %d samples, 10%% busy per sample\n", count, samples);
+    printf("  keyframe   %8.1f KB   append %7.3f ms\n", key_bytes / 1024.0 / keys, key_ms / keys);
+    printf("  delta      %8.1f KB   append %7.3f ms\n", delta_bytes / 1024.0 / deltas,
+           append_ms / deltas);
+    double per_hour = (key_bytes + delta_bytes) / (double)samples * 3600 / (1024.0 * 1024.0);
+    printf("  at 1 s intervals: %.0f MB per hour, %.1f hours in the default %ld MB ring\n",
+           per_hour, (RECORDER_DEFAULT_SIZE / (1024.0 * 1024.0)) / per_hour,
+           RECORDER_DEFAULT_SIZE / (1024 * 1024));
+
+    Replay replay;
+    char   error[256];
+    if (replay_open(&replay, path, error, sizeof(error)) != 0) {
+        fprintf(stderr, "%s\n", error);
+        return 1;
+    }
+    double start = now_ms();
+    for (int i = 0; i < 30; i++) replay_step(&replay, -1);
+    double back = (now_ms() - start) / 30;
+    start       = now_ms();
+    for (int i = 0; i < 30; i++) replay_step(&replay, 1);
+    double forward = (now_ms() - start) / 30;
+    printf("  replay step back %7.3f ms   step forward %7.3f ms\n", back, forward);
+    replay_close(&replay);
+
+    snapshot_free(&sample.snapshot);
+    free(nodes);
+    unlink(path);
+    return 0;
+}
@@ -0,0 +1,201 @@
+/**
+ * @file bench_scan.c
+ * @brief Benchmark of a whole sample against generated /proc trees: the table
+ *        update per backend and file set, get_process_info(), the system
+ *        header, filtering, and sorting, at 1k to 200k processes.
+ * @version 2.0.1
+ */
+
+#include "../include/system/process_list.h"
+#include "../include/system/scan_pool.h"
+#include "../include/system/snapshot.h"
+#include "proc_fixture.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** @brief Share of processes that run between two samples. */
+#define BENCH_BUSY_PERCENT 10
+
+/**
+ * @brief Returns a monotonic timestamp in milliseconds.
+ */
+static double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/**
+ * @brief Compares two doubles for qsort().
+ */
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Prints the median and minimum of @p runs timings, with the cost per
+ *        process and the throughput.
+ */
+static void report(const char* label, double* samples, int runs, int count) {
+    qsort(samples, runs, sizeof(double), cmp_double);
+    double median = samples[runs / 2];
+    printf("  %-28s median %9.3f ms   min %9.3f ms   %7.2f us/process   %6.2f M/s\n", label,
+           median, samples[0], median * 1e3 / count, count / median / 1e3);
+}
+
+/**
+ * @brief Times process_table_update() with one configuration, advancing the
+ *        fixture outside the timed part before each update.
+ * @return int 0 if every process was found, -1 otherwise.
+ */
+static int bench_update(ProcFixture* fixture, const char* label, ScanBackend backend,
+                        int workers, int files, int runs) {
+    double       samples[32];
+    ProcessTable table;
+    process_table_init(&table);
+    process_table_set_workers(&table, workers);
+    process_table_set_backend(&table, backend);
+    process_table_set_files(&table, files);
+    process_table_update(&table);
+    if (backend == SCAN_BACKEND_URING && table.backend != SCAN_BACKEND_URING) {
+        printf("  %-28s unavailable\n", label);
+        process_table_free(&table);
+        return 0;
+    }
+    for (int r = 0; r < runs; r++) {
+        proc_fixture_advance(fixture, BENCH_BUSY_PERCENT);
+        double start = now_ms();
+        process_table_update(&table);
+        samples[r] = now_ms() - start;
+    }
+    report(label, samples, runs, fixture->count);
+    int found = table.count;
+    process_table_free(&table);
+    if (found != fixture->count) {
+        fprintf(stderr, "  %s found %d of %d processes\n", label, found, fixture->count);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Times the reader's side of a sample over a table of the fixture:
+ *        snapshot_build(), snapshot_filter(), and snapshot_sort().
+ */
+static void bench_reader(ProcFixture* fixture, int runs) {
+    const SortSpec  by_cpu = {{{SORT_FIELD_CPU, 1}, {SORT_FIELD_MEM, 1}, {SORT_FIELD_PID, 0}}, 3};
+    double          builds[32], filters[32], sorts[32];
+    ProcessTable    table;
+    ProcessSnapshot snapshot;
+    Filter          filter;
+    char            error[128];
+    process_table_init(&table);
+    process_table_update(&table);
+    proc_fixture_advance(fixture, BENCH_BUSY_PERCENT);
+    process_table_update(&table);
+    snapshot_init(&snapshot);
+    filter_init(&filter);
+    filter_compile(&filter, "user:root cpu>0.5 name~^(kworker|postgres)", error, sizeof(error));
+
+    for (int r = 0; r < runs; r++) {
+        double start = now_ms();
+        snapshot_build(&snapshot, table.head, table.count);
+        builds[r] = now_ms() - start;
+        start     = now_ms();
+        snapshot_filter(&snapshot, &filter);
+        filters[r] = now_ms() - start;
+        snapshot_filter(&snapshot, NULL);
+        start = now_ms();
+        snapshot_sort(&snapshot, &by_cpu);
+        sorts[r] = now_ms() - start;
+    }
+    report("snapshot_build()", builds, runs, fixture->count);
+    report("snapshot_filter() 3 terms", filters, runs, fixture->count);
+    report("snapshot_sort() CPU", sorts, runs, fixture->count);
+    filter_free(&filter);
+    snapshot_free(&snapshot);
+    process_table_free(&table);
+}
+
+/**
+ * @brief Times get_process_info() on up to 2000 processes, and the system header.
+ */
+static void bench_single(ProcFixture* fixture, int runs) {
+    double      samples[32];
+    ProcessNode info;
+    int         count = fixture->count < 2000 ? fixture->count : 2000;
+    for (int r = 0; r < runs; r++) {
+        double start = now_ms();
+        for (int i = 0; i < count; i++) get_process_info(fixture->pids[i], &info);
+        samples[r] = now_ms() - start;
+    }
+    report("get_process_info()", samples, runs, count);
+
+    SystemSampler system;
+    SystemInfo    sys_info;
+    system_sampler_init(&system);
+    for (int r = 0; r < runs; r++) {
+        double start = now_ms();
+        system_sampler_read_cpu(&system);
+        system_sampler_collect(&system, &sys_info, fixture->count, 0);
+        samples[r] = now_ms() - start;
+    }
+    qsort(samples, runs, sizeof(double), cmp_double);
+    printf("  %-28s median %9.3f ms   min %9.3f ms\n", "system header", samples[runs / 2],
+           samples[0]);
+    system_sampler_free(&system);
+}
+
+/**
+ * @brief Main entry point of the scan benchmark: bench_scan [COUNT...], by
+ *        default 1000 and 10000 processes.
+ */
+int main(int argc, char** argv) {
+    static const int defaults[] = {1000, 10000};
+    const char*      parent     = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+    int              workers    = scan_pool_default_workers();
+    int              sizes      = argc > 1 ? argc - 1 : 2;
+    int              status     = 0;
+
+    printf("ProcX scan benchmark (generated /proc, %d%% busy per sample)\n", BENCH_BUSY_PERCENT);
+    for (int s = 0; s < sizes; s++) {
+        int count = argc > 1 ? atoi(argv[s + 1]) : defaults[s];
+        int runs  = count >= 100000 ? 5 : count >= 10000 ? 9 : 31;
+        if (count < 1) continue;
+
+        ProcFixture fixture;
+        double      start = now_ms();
+        if (proc_fixture_create(&fixture, parent, count, 42) != 0) {
+            fprintf(stderr, "cannot create a fixture in %s: %s\n", parent, strerror(errno));
+            return 1;
+        }
+        printf("%d processes (generated in %.0f ms)\n", count, now_ms() - start);
+        if (proc_set_root(fixture.root) != 0) {
+            proc_fixture_remove(&fixture);
+            return 1;
+        }
+
+        char label[64];
+        status |= bench_update(&fixture, "update sync, 1 worker", SCAN_BACKEND_SYNC, 1,
+                               PROC_FILES_SCAN, runs);
+        if (workers > 1) {
+            snprintf(label, sizeof(label), "update sync, %d workers", workers);
+            status |= bench_update(&fixture, label, SCAN_BACKEND_SYNC, workers, PROC_FILES_SCAN,
+                                   runs);
+        }
+        status |= bench_update(&fixture, "update uring", SCAN_BACKEND_URING, 1, PROC_FILES_SCAN,
+                               runs);
+        status |= bench_update(&fixture, "update stat only", SCAN_BACKEND_SYNC, 1, PROC_FILE_STAT,
+                               runs);
+        status |= bench_update(&fixture, "update with io", SCAN_BACKEND_SYNC, 1,
+                               PROC_FILES_SCAN | PROC_FILE_IO, runs);
+        bench_single(&fixture, runs);
+        bench_reader(&fixture, runs);
+        proc_fixture_remove(&fixture);
+    }
+    return status == 0 ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file bench_sort.c
+ * @brief Benchmark of snapshot_build(), snapshot_sort(), snapshot_sort_top(), and
+ *        the process tree at 1k to 100k processes.
+ * @version 2.0.1
+ */
+
+#include "../include/system/process_tree.h"
+#include "../include/system/snapshot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Returns a monotonic timestamp in milliseconds.
+ */
+static double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/**
+ * @brief Compares two doubles for qsort().
+ */
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Fills a list with a process mix that resembles a busy host: most
+ * processes idle, a few hundred distinct command names, PIDs in table order,
+ * and each parent started before its children.
+ */
+static ProcessNode* make_processes(int count, unsigned int seed) {
+    static const char* names[] = {"kworker/u16:", "bash", "sshd", "postgres", "nginx", "python3",
+                                  "systemd", "java", "node", "containerd-shim"};
+    ProcessNode*       nodes   = calloc(count, sizeof(ProcessNode));
+    srand(seed);
+    for (int i = 0; i < count; i++) {
+        nodes[i].pid       = 1 + i * 3 + rand() % 3;
+        nodes[i].ppid      = i ? nodes[rand() % i].pid : 0;
+        nodes[i].cpu_usage = (rand() % 10 == 0) ? (float)(rand() % 4000) / 100.0f : 0.0f;
+        nodes[i].memory_kb = (rand() % 4 == 0) ? 0 : 1024L + rand() % 4000000;
+        nodes[i].state     = (rand() % 20 == 0) ? 'R' : 'S';
+        snprintf(nodes[i].name, sizeof(nodes[i].name), "%s%d", names[rand() % 10], rand() % 40);
+        nodes[i].next = (i + 1 < count) ? &nodes[i + 1] : NULL;
+    }
+    return nodes;
+}
+
+/**
+ * @brief Times one sort specification and prints median and minimum.
+ * @param limit Leading rows to order with snapshot_sort_top(), or 0 for a full sort.
+ */
+static void bench_spec(ProcessSnapshot* snapshot, const char* label, const SortSpec* spec,
+                       int limit, int runs) {
+    double samples[64];
+    for (int r = 0; r < runs; r++) {
+        double start = now_ms();
+        if (limit > 0) {
+            snapshot_sort_top(snapshot, spec, limit);
+        } else {
+            snapshot_sort(snapshot, spec);
+        }
+        samples[r] = now_ms() - start;
+    }
+    qsort(samples, runs, sizeof(double), cmp_double);
+    printf("  %-24s median %8.3f ms   min %8.3f ms   %6.1f ns/process\n", label,
+           samples[runs / 2], samples[0], samples[runs / 2] * 1e6 / snapshot->count);
+}
+
+/**
+ * @brief Times process_tree_build() over a sorted snapshot, and
+ *        process_tree_apply() with the root collapsed and expanded.
+ */
+static void bench_tree(ProcessSnapshot* snapshot, const SortSpec* spec, int runs) {
+    double       builds[64], applies[64];
+    ProcessTree  tree;
+    TreeCollapse collapse;
+    process_tree_init(&tree);
+    tree_collapse_init(&collapse);
+    for (int r = 0; r < runs; r++) {
+        snapshot_filter(snapshot, NULL);
+        snapshot_sort(snapshot, spec);
+        double start = now_ms();
+        process_tree_build(&tree, snapshot);
+        builds[r] = now_ms() - start;
+
+        start = now_ms();
+        tree_collapse_toggle(&collapse, snapshot->procs[0].pid);
+        process_tree_apply(&tree, snapshot, &collapse);
+        tree_collapse_toggle(&collapse, snapshot->procs[0].pid);
+        process_tree_apply(&tree, snapshot, &collapse);
+        applies[r] = (now_ms() - start) / 2;
+    }
+    qsort(builds, runs, sizeof(double), cmp_double);
+    qsort(applies, runs, sizeof(double), cmp_double);
+    printf("  %-24s median %8.3f ms   min %8.3f ms   %6.1f ns/process\n", "tree build",
+           builds[runs / 2], builds[0], builds[runs / 2] * 1e6 / snapshot->count);
+    printf("  %-24s median %8.3f ms   min %8.3f ms   %6.1f ns/process\n", "tree fold",
+           applies[runs / 2], applies[0], applies[runs / 2] * 1e6 / snapshot->count);
+    process_tree_free(&tree);
+}
+
+/**
+ * @brief Main entry point of the sort benchmark.
+ */
+int main() {
+    static const int sizes[] = {1000, 10000, 40000, 100000};
+    const SortSpec   by_cpu  = {{{SORT_FIELD_CPU, 1}, {SORT_FIELD_MEM, 1}, {SORT_FIELD_PID, 0}}, 3};
+    const SortSpec   by_mem  = {{{SORT_FIELD_MEM, 1}, {SORT_FIELD_CPU, 1}, {SORT_FIELD_PID, 0}}, 3};
+    const SortSpec   by_name = {{{SORT_FIELD_NAME, 0}, {SORT_FIELD_PID, 0}}, 2};
+    const SortSpec   by_pid  = {{{SORT_FIELD_PID, 0}}, 1};
+
+    printf("ProcX snapshot sort benchmark\n");
+    for (int s = 0; s < 4; s++) {
+        int          count = sizes[s];
+        int          runs  = count >= 100000 ? 9 : 31;
+        ProcessNode* nodes = make_processes(count, 42);
+
+        ProcessSnapshot snapshot;
+        snapshot_init(&snapshot);
+        snapshot_build(&snapshot, nodes, count);
+        double start = now_ms();
+        for (int r = 0; r < runs; r++) snapshot_build(&snapshot, nodes, count);
+        double build = (now_ms() - start) / runs;
+
+        printf("%d processes (build %.3f ms)\n", count, build);
+        bench_spec(&snapshot, "CPU desc, RES desc, PID", &by_cpu, 0, runs);
+        bench_spec(&snapshot, "RES desc, CPU desc, PID", &by_mem, 0, runs);
+        bench_spec(&snapshot, "NAME, PID", &by_name, 0, runs);
+        bench_spec(&snapshot, "PID", &by_pid, 0, runs);
+        // A 60-row terminal shows 52 processes; also scrolled a few pages down.
+        bench_spec(&snapshot, "CPU top 52", &by_cpu, 52, runs);
+        bench_spec(&snapshot, "CPU top 500", &by_cpu, 500, runs);
+        bench_spec(&snapshot, "NAME top 52", &by_name, 52, runs);
+        bench_tree(&snapshot, &by_cpu, runs);
+
+        snapshot_free(&snapshot);
+        free(nodes);
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file bench_sysinfo.c
+ * @brief Benchmark of the per-sample cost of the system header: the kept-open
+ *        SystemSampler against the previous fopen()/sscanf() reads.
+ * @version 2.0.1
+ */
+
+#include "../include/system/sys_info.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Returns a monotonic timestamp in microseconds.
+ */
+static double now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/**
+ * @brief The header as it was read before: four fopen()/fgets()/sscanf()
+ *        passes, getloadavg(), and a walk of the process list for the task counts.
+ */
+static void legacy_system_info(SystemInfo* sys_info, const ProcessNode* head) {
+    static unsigned long long prev_busy = 0, prev_total = 0;
+    char                      line[256];
+    FILE*                     file;
+    memset(sys_info, 0, sizeof(*sys_info));
+
+    if (getloadavg(sys_info->load_avg, 3) == -1) sys_info->load_avg[0] = 0;
+
+    file = fopen("/proc/uptime", "r");
+    if (file) {
+        double uptime;
+        if (fscanf(file, "%lf", &uptime) == 1) sys_info->uptime_sec = (long)uptime;
+        fclose(file);
+    }
+
+    file = fopen("/proc/meminfo", "r");
+    if (file) {
+        long buffers = 0, cached = 0, available = 0;
+        while (fgets(line, sizeof(line), file)) {
+            if (strncmp(line, "MemTotal:", 9) == 0) {
+                sscanf(line, "MemTotal: %ld kB", &sys_info->total_mem_kb);
+            } else if (strncmp(line, "MemFree:", 8) == 0) {
+                sscanf(line, "MemFree: %ld kB", &sys_info->free_mem_kb);
+            } else if (strncmp(line, "MemAvailable:", 13) == 0) {
+                sscanf(line, "MemAvailable: %ld kB", &available);
+            } else if (strncmp(line, "Buffers:", 8) == 0) {
+                sscanf(line, "Buffers: %ld kB", &buffers);
+            } else if (strncmp(line, "Cached:", 7) == 0) {
+                sscanf(line, "Cached: %ld kB", &cached);
+            } else if (strncmp(line, "SwapTotal:", 10) == 0) {
+                sscanf(line, "SwapTotal: %ld kB", &sys_info->total_swp_kb);
+            } else if (strncmp(line, "SwapFree:", 9) == 0) {
+                sscanf(line, "SwapFree: %ld kB", &sys_info->free_swp_kb);
+            }
+        }
+        fclose(file);
+        if (sys_info->total_mem_kb > 0) {
+            sys_info->mem_usage =
+                (int)((sys_info->total_mem_kb - available) * 100 / sys_info->total_mem_kb);
+        }
+    }
+
+    // /proc/stat was read twice per sample: here and by the process table.
+    for (int pass = 0; pass < 2; pass++) {
+        file = fopen("/proc/stat", "r");
+        if (!file) continue;
+        unsigned long long v[8];
+        if (fgets(line, sizeof(line), file) &&
+            sscanf(line, "cpu  %llu %llu %llu %llu %llu %llu %llu %llu", &v[0], &v[1], &v[2],
+                   &v[3], &v[4], &v[5], &v[6], &v[7]) == 8 &&
+            pass == 0) {
+            unsigned long long total = v[0] + v[1] + v[2] + v[3] + v[4] + v[5] + v[6] + v[7];
+            unsigned long long busy  = total - v[3] - v[4];
+            if (total > prev_total) {
+                sys_info->cpu_usage = (int)(100 * (busy - prev_busy) / (total - prev_total));
+            }
+            prev_busy  = busy;
+            prev_total = total;
+        }
+        fclose(file);
+    }
+
+    for (const ProcessNode* node = head; node; node = node->next) {
+        sys_info->total_tasks++;
+        if (node->state == 'R') sys_info->running_tasks++;
+    }
+}
+
+/**
+ * @brief Main entry point of the system header benchmark.
+ */
+int main() {
+    const int    runs  = 2000;
+    const int    count = 20000;
+    ProcessNode* nodes = calloc(count, sizeof(ProcessNode));
+    for (int i = 0; i < count; i++) {
+        nodes[i].state = (i % 50 == 0) ? 'R' : 'S';
+        nodes[i].next  = (i + 1 < count) ? &nodes[i + 1] : NULL;
+    }
+
+    SystemInfo info;
+    double     start = now_us();
+    for (int i = 0; i < runs; i++) legacy_system_info(&info, nodes);
+    double legacy = (now_us() - start) / runs;
+
+    SystemSampler sampler;
+    system_sampler_init(&sampler);
+    start = now_us();
+    for (int i = 0; i < runs; i++) {
+        system_sampler_read_cpu(&sampler);
+        system_sampler_collect(&sampler, &info, count, count / 50);
+    }
+    double kept = (now_us() - start) / runs;
+    system_sampler_free(&sampler);
+
+    printf("ProcX system header benchmark\n");
+    printf("%d samples, %d processes, %d CPU(s)\n", runs, count, info.core_count);
+    printf("  fopen/sscanf + list walk %8.1f us per sample   %.3f%% of a CPU at 100 ms\n", legacy,
+           legacy / 1000.0);
+    printf("  kept-open SystemSampler  %8.1f us per sample   %.3f%% of a CPU at 100 ms\n", kept,
+           kept / 1000.0);
+
+    free(nodes);
+    return 0;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file gen_fixture.c
+ * @brief Creates a synthetic /proc tree to run ProcX against with --proc-root.
+ * @version 2.0.1
+ */
+
+#include "proc_fixture.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Main entry point: gen_fixture [COUNT [PARENT [SEED]]].
+ */
+int main(int argc, char** argv) {
+    int          count  = argc > 1 ? atoi(argv[1]) : 10000;
+    const char*  parent = argc > 2 ? argv[2] : "/tmp";
+    unsigned int seed   = argc > 3 ? (unsigned int)strtoul(argv[3], NULL, 10) : 42;
+    if (count < 1 || count > 1000000) {
+        fprintf(stderr, "usage: %s [COUNT [PARENT [SEED]]], COUNT from 1 to 1000000\n", argv[0]);
+        return 1;
+    }
+
+    ProcFixture fixture;
+    if (proc_fixture_create(&fixture, parent, count, seed) != 0) {
+        fprintf(stderr, "%s: cannot create a fixture in %s: %s\n", argv[0], parent,
+                strerror(errno));
+        return 1;
+    }
+    printf("%s\n", fixture.root);
+    fprintf(stderr, "%d processes; run ./procx --proc-root %s, and rm -r it when done\n", count,
+            fixture.root);
+
+    // The tree stays; only the bookkeeping is released.
+    free(fixture.pids);
+    free(fixture.threads);
+    free(fixture.utime);
+    return 0;
+}
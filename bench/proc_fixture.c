@@ -0,0 +1,356 @@
+/**
+ * @file proc_fixture.c
+ * @brief Implementation of the synthetic /proc tree generator.
+ * @version 2.0.1
+ */
+
+#include "proc_fixture.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** @brief Ticks per CPU that pass in one advance, one second at USER_HZ 100. */
+#define FIXTURE_TICKS 100
+
+/**
+ * @brief Returns a well-mixed value for process @p index and @p salt, so each
+ *        field can be redrawn without keeping it.
+ */
+static unsigned int fixture_rand(const ProcFixture* fixture, int index, unsigned int salt) {
+    unsigned int x = fixture->seed * 0x9e3779b9u ^ (unsigned int)index * 0x85ebca6bu ^ salt;
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    return x ^ (x >> 16);
+}
+
+/**
+ * @brief Writes @p len bytes of @p text to @p name below @p dir_fd.
+ */
+static int write_file(int dir_fd, const char* name, const char* text, int len) {
+    int fd = openat(dir_fd, name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return -1;
+    ssize_t written = write(fd, text, (size_t)len);
+    close(fd);
+    return written == len ? 0 : -1;
+}
+
+/**
+ * @brief Returns non-zero if process @p index is a kernel thread.
+ */
+static int fixture_kernel(const ProcFixture* fixture, int index) {
+    return index > 1 && fixture_rand(fixture, index, 1) % 10 == 0;
+}
+
+/**
+ * @brief Returns the resident pages of process @p index: mostly a few MB, one
+ *        in twenty up to 800 MB, none for kernel threads.
+ */
+static unsigned long fixture_rss(const ProcFixture* fixture, int index) {
+    unsigned int r = fixture_rand(fixture, index, 4);
+    if (fixture_kernel(fixture, index) || index == 1) return 0;
+    return r % 20 == 0 ? 5000 + r % 200000 : 200 + r % 5000;
+}
+
+/**
+ * @brief Writes the command name of process @p index.
+ */
+static void fixture_name(const ProcFixture* fixture, int index, char* out, size_t size) {
+    static const char* names[] = {"bash",  "sshd",    "postgres", "nginx",
+                                  "node",  "python3", "java",     "containerd-shim",
+                                  "redis", "php-fpm", "chrome",   "(sd-pam)"};
+    unsigned int       r       = fixture_rand(fixture, index, 2);
+    if (index == 0) {
+        snprintf(out, size, "systemd");
+    } else if (index == 1) {
+        snprintf(out, size, "kthreadd");
+    } else if (fixture_kernel(fixture, index)) {
+        snprintf(out, size, "kworker/%u:%u-events", r % 64, (r >> 8) % 4);
+    } else {
+        snprintf(out, size, "%s%s%u", names[r % 12], (r >> 4) % 3 ? "" : "-", (r >> 8) % 40);
+    }
+}
+
+/**
+ * @brief Formats the stat line of a process or thread, with all 52 fields.
+ */
+static int fixture_stat(const ProcFixture* fixture, int index, pid_t id, unsigned long utime,
+                        char* out, size_t size) {
+    char          name[64];
+    unsigned int  r      = fixture_rand(fixture, index, 3);
+    int           kernel = fixture_kernel(fixture, index) || index == 1;
+    pid_t         ppid   = index <= 1 ? 0 : kernel ? fixture->pids[1] : fixture->pids[r % index];
+    char          state  = r % 33 == 0 ? 'R' : r % 97 == 0 ? 'D' : kernel ? 'I' : 'S';
+    long          nice   = kernel && r % 3 == 0 ? -20 : r % 50 == 0 ? 10 : 0;
+    unsigned long rss    = fixture_rss(fixture, index);
+    fixture_name(fixture, index, name, sizeof(name));
+    return snprintf(out, size,
+                    "%d (%s) %c %d %d %d 0 -1 %u %u 0 %u 0 %lu %lu 0 0 %ld %ld %d 0 %lu %lu %lu "
+                    "18446744073709551615 94371623411712 94371624180013 140727323477488 0 0 0 0 "
+                    "4096 1260 1 0 0 17 %u 0 0 0 0 0 94371624437456 94371624488708 "
+                    "94371640504320 140727323483925 140727323483942 140727323483942 "
+                    "140727323484142 0\n",
+                    id, name, state, ppid, ppid, ppid, kernel ? 0x208040u : 0x400100u, r % 90000,
+                    r % 300, utime, utime / 3, 20 + nice, nice, fixture->threads[index],
+                    100UL + (unsigned long)index * 5, rss * 4 * 4096, rss, r % 8);
+}
+
+/**
+ * @brief Formats the status file of process @p index, as long as a real one.
+ */
+static int fixture_status(const ProcFixture* fixture, int index, char* out, size_t size) {
+    static const unsigned int uids[] = {0, 0, 0, 1000, 1000, 1001, 33, 999, 65534};
+    char                      name[64];
+    unsigned int              r      = fixture_rand(fixture, index, 5);
+    int                       kernel = fixture_kernel(fixture, index) || index == 1;
+    unsigned int              uid    = kernel || index == 0 ? 0 : uids[r % 9];
+    pid_t                     pid    = fixture->pids[index];
+    fixture_name(fixture, index, name, sizeof(name));
+
+    int len = snprintf(out, size,
+                       "Name:\t%s\nUmask:\t0022\nState:\tS (sleeping)\nTgid:\t%d\nNgid:\t0\n"
+                       "Pid:\t%d\nPPid:\t1\nTracerPid:\t0\nUid:\t%u\t%u\t%u\t%u\n"
+                       "Gid:\t%u\t%u\t%u\t%u\nFDSize:\t64\nGroups:\t%u\nNStgid:\t%d\nNSpid:\t%d\n"
+                       "NSpgid:\t%d\nNSsid:\t%d\nKthread:\t%d\n",
+                       name, pid, pid, uid, uid, uid, uid, uid, uid, uid, uid, uid, pid, pid, pid,
+                       pid, kernel);
+    if (!kernel) {
+        unsigned long rss  = 4 * fixture_rss(fixture, index);
+        unsigned long anon = rss * 3 / 4, file = rss - anon - rss / 32;
+        len += snprintf(out + len, size - len,
+                        "VmPeak:\t%8lu kB\nVmSize:\t%8lu kB\nVmLck:\t       0 kB\n"
+                        "VmPin:\t       0 kB\nVmHWM:\t%8lu kB\nVmRSS:\t%8lu kB\n"
+                        "RssAnon:\t%8lu kB\nRssFile:\t%8lu kB\nRssShmem:\t%8lu kB\n"
+                        "VmData:\t%8lu kB\nVmStk:\t     132 kB\nVmExe:\t     776 kB\n"
+                        "VmLib:\t    3804 kB\nVmPTE:\t     212 kB\nVmSwap:\t%8u kB\n"
+                        "HugetlbPages:\t       0 kB\nCoreDumping:\t0\nTHP_enabled:\t1\n",
+                        rss * 4 + 512, rss * 4, rss, rss, anon, file, rss / 32, anon + 1024,
+                        r % 7 == 0 ? r % 20000 : 0);
+    }
+    len += snprintf(out + len, size - len,
+                    "Threads:\t%d\nSigQ:\t0/63432\nSigPnd:\t0000000000000000\n"
+                    "ShdPnd:\t0000000000000000\nSigBlk:\t0000000000000000\n"
+                    "SigIgn:\t0000000000001000\nSigCgt:\t0000000180004a02\n"
+                    "CapInh:\t0000000000000000\nCapPrm:\t0000000000000000\n"
+                    "CapEff:\t0000000000000000\nCapBnd:\t000001ffffffffff\n"
+                    "CapAmb:\t0000000000000000\nNoNewPrivs:\t0\nSeccomp:\t0\n"
+                    "Seccomp_filters:\t0\nSpeculation_Store_Bypass:\tthread vulnerable\n"
+                    "SpeculationIndirectBranch:\tconditional enabled\nCpus_allowed:\tff\n"
+                    "Cpus_allowed_list:\t0-7\nMems_allowed:\t00000001\n"
+                    "Mems_allowed_list:\t0\nvoluntary_ctxt_switches:\t%u\n"
+                    "nonvoluntary_ctxt_switches:\t%u\n",
+                    fixture->threads[index], r % 100000, r % 1000);
+    return len;
+}
+
+/**
+ * @brief Writes the per-process files of process @p index and its threads.
+ */
+static int fixture_write_process(const ProcFixture* fixture, int root_fd, int index) {
+    char  text[4096], name[32];
+    pid_t pid = fixture->pids[index];
+    snprintf(name, sizeof(name), "%d", pid);
+    if (mkdirat(root_fd, name, 0755) != 0) return -1;
+    int dir_fd = openat(root_fd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd < 0) return -1;
+
+    unsigned int  r      = fixture_rand(fixture, index, 6);
+    int           kernel = fixture_kernel(fixture, index) || index == 1;
+    unsigned long rss    = fixture_rss(fixture, index);
+
+    int len    = fixture_stat(fixture, index, pid, fixture->utime[index], text, sizeof(text));
+    int status = write_file(dir_fd, "stat", text, len);
+    len = snprintf(text, sizeof(text), "%lu %lu %lu 194 0 %lu 0\n", rss * 4, rss, rss / 8,
+                   rss * 3 / 4);
+    status |= write_file(dir_fd, "statm", text, len);
+    len = fixture_status(fixture, index, text, sizeof(text));
+    status |= write_file(dir_fd, "status", text, len);
+    unsigned long long bytes = kernel ? 0 : (unsigned long long)(r % 100000) * 4096;
+    len = snprintf(text, sizeof(text),
+                   "rchar: %llu\nwchar: %llu\nsyscr: %u\nsyscw: %u\nread_bytes: %llu\n"
+                   "write_bytes: %llu\ncancelled_write_bytes: 0\n",
+                   bytes * 3, bytes, r % 5000, r % 3000, bytes, bytes / 2);
+    status |= write_file(dir_fd, "io", text, len);
+
+    // Threads: the first has the process's TID, the others the PIDs skipped after it.
+    status |= mkdirat(dir_fd, "task", 0755);
+    int task_fd = openat(dir_fd, "task", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    for (int t = 0; task_fd >= 0 && t < fixture->threads[index]; t++) {
+        snprintf(name, sizeof(name), "%d", pid + t);
+        int thread_fd = -1;
+        if (mkdirat(task_fd, name, 0755) == 0) {
+            thread_fd = openat(task_fd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        }
+        if (thread_fd < 0) {
+            status = -1;
+            break;
+        }
+        unsigned long ticks = fixture->utime[index] / fixture->threads[index];
+        len = fixture_stat(fixture, index, pid + t, ticks, text, sizeof(text));
+        status |= write_file(thread_fd, "stat", text, len);
+        close(thread_fd);
+    }
+    if (task_fd < 0) status = -1;
+    if (task_fd >= 0) close(task_fd);
+    close(dir_fd);
+    return status;
+}
+
+/**
+ * @brief Writes /proc/stat with @c ticks per CPU, of which @p busy percent ran.
+ */
+static int fixture_write_stat(const ProcFixture* fixture, int root_fd, int busy) {
+    char          text[16384];
+    unsigned long user = (unsigned long)fixture->ticks * busy / 100;
+    unsigned long idle = (unsigned long)fixture->ticks - user;
+    int           len  = snprintf(text, sizeof(text), "cpu  %lu 0 %lu %lu 12 0 3 0 0 0\n",
+                                  user * 9 / 10 * fixture->cpus, user / 10 * fixture->cpus,
+                                  idle * fixture->cpus);
+    for (int c = 0; c < fixture->cpus; c++) {
+        len += snprintf(text + len, sizeof(text) - len, "cpu%d %lu 0 %lu %lu 1 0 0 0 0 0\n", c,
+                        user * 9 / 10, user / 10, idle);
+    }
+    len += snprintf(text + len, sizeof(text) - len,
+                    "intr 123456789 9 0 0 0 0\nctxt %ld\nbtime 1729000000\nprocesses %d\n"
+                    "procs_running %d\nprocs_blocked 0\nsoftirq 4567890 0 1 2 3 4 5 6 7 8 9\n",
+                    fixture->ticks * 1000, fixture->count * 3, 1 + fixture->count / 100);
+    return write_file(root_fd, "stat", text, len);
+}
+
+/**
+ * @brief Writes the system-wide files other than stat.
+ */
+static int fixture_write_system(const ProcFixture* fixture, int root_fd) {
+    char text[4096];
+    int  status = 0;
+    int  len    = snprintf(text, sizeof(text),
+                           "MemTotal:       32768000 kB\nMemFree:         8192000 kB\n"
+                           "MemAvailable:   20480000 kB\nBuffers:          512000 kB\n"
+                           "Cached:         10240000 kB\nSwapCached:         1024 kB\n"
+                           "Active:         12000000 kB\nInactive:        9000000 kB\n"
+                           "Active(anon):    8000000 kB\nInactive(anon):  1000000 kB\n"
+                           "Active(file):    4000000 kB\nInactive(file):  8000000 kB\n"
+                           "Unevictable:           0 kB\nMlocked:               0 kB\n"
+                           "SwapTotal:       8192000 kB\nSwapFree:        8000000 kB\n"
+                           "Dirty:              1200 kB\nWriteback:             0 kB\n"
+                           "AnonPages:       9000000 kB\nMapped:          1500000 kB\n"
+                           "Shmem:            600000 kB\nKReclaimable:     800000 kB\n"
+                           "Slab:            1200000 kB\nSReclaimable:     800000 kB\n"
+                           "SUnreclaim:       400000 kB\nKernelStack:       %6d kB\n"
+                           "PageTables:       120000 kB\nCommitLimit:    24576000 kB\n"
+                           "Committed_AS:   30000000 kB\nVmallocTotal:   34359738367 kB\n"
+                           "VmallocUsed:      100000 kB\nHugePages_Total:       0\n"
+                           "Hugepagesize:       2048 kB\n",
+                           fixture->count * 16);
+    status |= write_file(root_fd, "meminfo", text, len);
+    len = snprintf(text, sizeof(text), "0.52 0.58 0.59 2/%d %d\n", fixture->count * 2,
+                   fixture->pids[fixture->count - 1]);
+    status |= write_file(root_fd, "loadavg", text, len);
+    len = snprintf(text, sizeof(text), "123456.78 %d.00\n", 123456 * fixture->cpus);
+    status |= write_file(root_fd, "uptime", text, len);
+    len = snprintf(text, sizeof(text),
+                   "   8       0 sda 123456 789 9876543 45678 234567 890 8765432 56789 0 "
+                   "67890 102467 0 0 0 0 4567 1234\n"
+                   "   8       1 sda1 123000 789 9870000 45600 234000 890 8760000 56700 0 "
+                   "67800 102300 0 0 0 0 0 0\n"
+                   " 259       0 nvme0n1 654321 0 87654321 98765 432109 0 76543210 87654 0 "
+                   "123456 186419 0 0 0 0 9876 5432\n");
+    status |= write_file(root_fd, "diskstats", text, len);
+
+    status |= mkdirat(root_fd, "pressure", 0755);
+    int pressure_fd = openat(root_fd, "pressure", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (pressure_fd < 0) return -1;
+    len = snprintf(text, sizeof(text),
+                   "some avg10=1.25 avg60=0.87 avg300=0.42 total=123456789\n"
+                   "full avg10=0.00 avg60=0.00 avg300=0.00 total=0\n");
+    status |= write_file(pressure_fd, "cpu", text, len);
+    status |= write_file(pressure_fd, "memory", text, len);
+    status |= write_file(pressure_fd, "io", text, len);
+    close(pressure_fd);
+    return status;
+}
+
+int proc_fixture_create(ProcFixture* fixture, const char* parent, int count, unsigned int seed) {
+    memset(fixture, 0, sizeof(*fixture));
+    snprintf(fixture->root, sizeof(fixture->root), "%s/procx_fixture_XXXXXX", parent);
+    fixture->count   = count;
+    fixture->seed    = seed;
+    fixture->cpus    = 8;
+    fixture->pids    = calloc(count > 0 ? count : 1, sizeof(pid_t));
+    fixture->threads = calloc(count > 0 ? count : 1, sizeof(int));
+    fixture->utime   = calloc(count > 0 ? count : 1, sizeof(unsigned long));
+    if (count < 1 || !fixture->pids || !fixture->threads || !fixture->utime ||
+        !mkdtemp(fixture->root)) {
+        int error = count < 1 ? EINVAL : errno;
+        free(fixture->pids);
+        free(fixture->threads);
+        free(fixture->utime);
+        memset(fixture, 0, sizeof(*fixture));
+        errno = error;
+        return -1;
+    }
+
+    // PIDs ascend with small gaps, and threads take the PIDs right after theirs.
+    pid_t next = 1;
+    for (int i = 0; i < count; i++) {
+        unsigned int r      = fixture_rand(fixture, i, 7);
+        int          many   = !fixture_kernel(fixture, i) && i > 1 && r % 8 == 0;
+        fixture->pids[i]    = next;
+        fixture->threads[i] = many ? 2 + (int)(r >> 8) % 15 : 1;
+        fixture->utime[i]   = r % 7 == 0 ? r % 500000 : r % 100;
+        next += fixture->threads[i] + (int)(r >> 16) % 3;
+    }
+
+    int root_fd = open(fixture->root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    int status  = root_fd < 0 ? -1 : 0;
+    for (int i = 0; status == 0 && i < count; i++) {
+        status = fixture_write_process(fixture, root_fd, i);
+    }
+    if (status == 0) status = fixture_write_stat(fixture, root_fd, 0);
+    if (status == 0) status = fixture_write_system(fixture, root_fd);
+    if (root_fd >= 0) close(root_fd);
+    if (status != 0) {
+        int error = errno;
+        proc_fixture_remove(fixture);
+        errno = error;
+        return -1;
+    }
+    return 0;
+}
+
+int proc_fixture_advance(ProcFixture* fixture, int busy_percent) {
+    char text[1024], name[48];
+    int  root_fd = open(fixture->root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (root_fd < 0) return -1;
+
+    // A different share of the processes runs in every interval.
+    fixture->ticks += FIXTURE_TICKS;
+    int status = fixture_write_stat(fixture, root_fd, busy_percent);
+    for (int i = 0; status == 0 && i < fixture->count; i++) {
+        unsigned int r = fixture_rand(fixture, i, 8 + (unsigned int)fixture->ticks);
+        if ((int)(r % 100) >= busy_percent) continue;
+        fixture->utime[i] += 1 + r % FIXTURE_TICKS;
+        int len = fixture_stat(fixture, i, fixture->pids[i], fixture->utime[i], text, sizeof(text));
+        snprintf(name, sizeof(name), "%d/stat", fixture->pids[i]);
+        status = write_file(root_fd, name, text, len);
+    }
+    close(root_fd);
+    return status;
+}
+
+void proc_fixture_remove(ProcFixture* fixture) {
+    if (fixture->root[0]) {
+        char command[320];
+        snprintf(command, sizeof(command), "rm -rf '%s'", fixture->root);
+        if (system(command) != 0) fprintf(stderr, "cannot remove %s\n", fixture->root);
+    }
+    free(fixture->pids);
+    free(fixture->threads);
+    free(fixture->utime);
+    memset(fixture, 0, sizeof(*fixture));
+}
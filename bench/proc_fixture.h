@@ -0,0 +1,63 @@
+/**
+ * @file proc_fixture.h
+ * @brief Generator of synthetic /proc trees for the benchmarks, so that the
+ *        collectors can be measured at 1k to 200k processes on any host.
+ * @version 2.0.1
+ */
+
+#ifndef PROCX_PROC_FIXTURE_H
+#define PROCX_PROC_FIXTURE_H
+
+#include <sys/types.h>
+
+/**
+ * @struct ProcFixture
+ * @brief A generated tree and what is needed to advance its counters.
+ *
+ * Each process gets stat, statm, status, io, and task/[tid]/stat for each of
+ * its threads; the tree also has stat, meminfo, loadavg, uptime, diskstats,
+ * and pressure/{cpu,memory,io}. Values are drawn from a fixed seed, so the same
+ * count and seed always give the same tree.
+ */
+typedef struct ProcFixture {
+    char           root[256]; /**< Directory laid out like /proc */
+    int            count;     /**< Number of processes */
+    unsigned int   seed;      /**< Seed the values were drawn from */
+    pid_t*         pids;      /**< PID of each process, ascending */
+    int*           threads;   /**< Thread count of each process */
+    unsigned long* utime;     /**< Current user ticks of each process */
+    long           ticks;     /**< Ticks per CPU written to stat so far */
+    int            cpus;      /**< CPU lines in stat */
+} ProcFixture;
+
+/**
+ * @brief Creates a tree of @p count processes in a new directory below @p parent.
+ *
+ * About one process in ten is a kernel thread, with an empty statm and no
+ * memory lines in status; the others get a few hundred distinct command names,
+ * a handful of owners, and one to sixteen threads whose TIDs follow their PID.
+ *
+ * @param fixture Filled with the tree.
+ * @param parent Directory to create it in, such as /tmp.
+ * @param count Number of processes.
+ * @param seed Seed of the values.
+ * @return int 0 on success, -1 with errno set; nothing is left behind on failure.
+ */
+int proc_fixture_create(ProcFixture* fixture, const char* parent, int count, unsigned int seed);
+
+/**
+ * @brief Lets one sampling interval pass: rewrites /proc/stat and the stat of
+ *        @p busy_percent percent of the processes with more CPU time.
+ * @param fixture Tree to advance.
+ * @param busy_percent Share of processes that ran, from 0 to 100.
+ * @return int 0 on success, -1 if a file could not be written.
+ */
+int proc_fixture_advance(ProcFixture* fixture, int busy_percent);
+
+/**
+ * @brief Deletes the tree and frees the fixture.
+ * @param fixture Fixture to remove.
+ */
+void proc_fixture_remove(ProcFixture* fixture);
+
+#endif  // PROCX_PROC_FIXTURE_H
@@ -9,9 +9,23 @@
 
 #include <sys/types.h>
 
+/**
+ * @enum ProcessChange
+ * @brief How a process changed between the previous and the current sample.
+ */
+typedef enum ProcessChange {
+    PROCESS_UNCHANGED = 0, /**< Seen before, no displayed value changed */
+    PROCESS_CHANGED,       /**< Seen before, at least one displayed value changed */
+    PROCESS_ADDED          /**< First seen in the current sample */
+} ProcessChange;
+
 /**
  * @struct ProcessNode
  * @brief Linked list node representing a single system process.
+ *
+ * The same node describes one thread of a process in the thread view: @c pid
+ * is then the thread ID, @c name the thread's name, and @c thread_of the
+ * process it belongs to.
  */
 typedef struct ProcessNode {
     pid_t               pid;          /**< Process ID */
@@ -22,11 +36,27 @@ typedef struct ProcessNode {
     char                name[256];    /**< Name of the process executable */
     char                state;        /**< Process state (e.g., R, S, Z) */
     long                memory_kb;    /**< Resident Set Size (RAM used) in KB */
+    long                vsz_kb;       /**< Virtual memory size in KB, -1 if unknown */
+    long                anon_kb;      /**< Resident anonymous memory in KB, -1 if unknown */
+    long                file_kb;      /**< Resident file-backed memory in KB, -1 if unknown */
+    long                shmem_kb;     /**< Resident shared memory in KB, -1 if unknown */
+    long                swap_kb;      /**< Swapped-out memory in KB, -1 if unknown */
+    long                pss_kb;       /**< Proportional set size in KB, -1 if not measured */
+    long                uss_kb;       /**< Unique (private) set size in KB, -1 if not measured */
     float               cpu_usage;    /**< CPU usage percentage */
     unsigned long       utime;        /**< User time ticks */
     unsigned long       stime;        /**< Kernel time ticks */
     long                priority;     /**< Priority of the process */
     long                nice_value;   /**< Nice value of the process */
+    unsigned long long  starttime;    /**< Start time in clock ticks after boot */
+    unsigned int        generation;   /**< Last sample generation that saw the process */
+    ProcessChange       change;       /**< Change since the previous sample */
+    pid_t               thread_of;    /**< For a thread row, the PID of its process; 0 otherwise */
+    unsigned long long  cgroup_id;    /**< cgroup v2 ID (directory inode), 0 if not resolved */
+    float               io_read;      /**< Bytes read from storage per second, -1 if not read */
+    float               io_write;     /**< Bytes written to storage per second, -1 if not read */
+    float               io_syscalls;  /**< Read and write system calls per second, -1 if not read */
+    struct ProcessNode* threads;      /**< Thread rows of an expanded process, linked by next */
     struct ProcessNode* next;         /**< Pointer to the next process in the list */
 } ProcessNode;
 
@@ -0,0 +1,192 @@
+/**
+ * @file cgroup.h
+ * @brief Per-cgroup CPU, memory, and task accounting read from the cgroup v2 hierarchy.
+ * @version 2.0.1
+ */
+
+#ifndef PROCX_CGROUP_H
+#define PROCX_CGROUP_H
+
+#include "proc_parser.h"
+#include "snapshot.h"
+#include <stddef.h>
+#include <sys/types.h>
+
+/** @brief Stored length of a cgroup directory name, including the terminator. */
+#define CGROUP_NAME_SIZE 64
+
+/** @brief Deepest level of the hierarchy that is walked. */
+#define CGROUP_MAX_DEPTH 32
+
+/**
+ * @struct CgroupInfo
+ * @brief Values of one cgroup in one sample.
+ *
+ * Values that the cgroup does not expose, because its controller is not
+ * enabled or it is the root, are -1; for pressure, some_avg10 is -1.
+ */
+typedef struct CgroupInfo {
+    unsigned long long id;                     /**< Directory inode, the kernel's cgroup ID */
+    int                parent;                 /**< Index of the parent, -1 for the root */
+    int                depth;                  /**< Depth below the root, 0 for the root */
+    int                descendants;            /**< Cgroups below, which directly follow it */
+    char               name[CGROUP_NAME_SIZE]; /**< Directory name, "/" for the root */
+    unsigned long long usage_usec;             /**< cpu.stat usage_usec */
+    float              cpu_usage;              /**< CPU% since the previous sample, 100 per CPU */
+    long               memory_kb;              /**< memory.current */
+    long               anon_kb;                /**< memory.stat anon */
+    long               file_kb;                /**< memory.stat file (page cache) */
+    long               kernel_kb;              /**< memory.stat kernel, or its parts if older */
+    long               tasks;                  /**< pids.current */
+    int                processes;              /**< Processes of the snapshot in the subtree */
+
+    PressureStat pressure[PRESSURE_RESOURCES]; /**< cpu.pressure, memory.pressure, io.pressure */
+} CgroupInfo;
+
+/**
+ * @struct CgroupList
+ * @brief The cgroups of one sample, in depth-first order with siblings by name.
+ */
+typedef struct CgroupList {
+    CgroupInfo* items;      /**< Cgroups; a subtree is a contiguous range */
+    int         count;      /**< Number of cgroups */
+    int         capacity;   /**< Allocated size of items */
+    int*        index;      /**< ID to item map, open addressing, -1 for empty slots */
+    int         index_mask; /**< Number of slots in index minus one, -1 while empty */
+} CgroupList;
+
+/**
+ * @struct CgroupSampler
+ * @brief Cgroup hierarchy state kept by the sampling thread.
+ */
+typedef struct CgroupSampler {
+    int                 root_fd;        /**< Root of the cgroup v2 hierarchy, -1 if none found */
+    int                 enabled;        /**< Non-zero to walk the hierarchy and map processes */
+    CgroupList          previous;       /**< IDs and CPU usage of the previous walk */
+    long long           time_ms;        /**< Monotonic time of the previous walk */
+    struct CgroupEntry* entries;        /**< Child directories stacked while walking */
+    size_t              entry_capacity; /**< Allocated size of entries */
+} CgroupSampler;
+
+/**
+ * @brief Initializes an empty list.
+ * @param list List to initialize.
+ */
+void cgroup_list_init(CgroupList* list);
+
+/**
+ * @brief Returns the index of a cgroup in a list.
+ * @param list List to search.
+ * @param id Cgroup ID.
+ * @return int The index, or -1 if @p id is not in the list.
+ */
+int cgroup_list_find(const CgroupList* list, unsigned long long id);
+
+/**
+ * @brief Counts the processes of a snapshot in every cgroup and its subtree.
+ * @param list List whose processes fields are set.
+ * @param snapshot Snapshot whose processes carry cgroup IDs.
+ */
+void cgroup_list_count(CgroupList* list, const ProcessSnapshot* snapshot);
+
+/**
+ * @brief Restricts the matching rows of a snapshot to one cgroup subtree.
+ *
+ * Must directly follow snapshot_filter(). A row is kept when its process is
+ * in the cgroup @p id or any cgroup below it; thread rows go with their
+ * process. Nothing is kept if @p id is not in @p list.
+ *
+ * @param list Cgroups of the same sample.
+ * @param id Root of the subtree.
+ * @param snapshot Filtered snapshot to restrict.
+ */
+void cgroup_list_restrict(const CgroupList* list, unsigned long long id,
+                          ProcessSnapshot* snapshot);
+
+/**
+ * @brief Writes the path of a cgroup, such as "/system.slice/ssh.service".
+ * @param list List holding the cgroup.
+ * @param index Index of the cgroup.
+ * @param out Destination buffer.
+ * @param size Size of @p out; longer paths are truncated.
+ */
+void cgroup_list_path(const CgroupList* list, int index, char* out, size_t size);
+
+/**
+ * @brief Frees the buffers of a list.
+ * @param list List to free.
+ */
+void cgroup_list_free(CgroupList* list);
+
+/**
+ * @brief Opens the cgroup v2 hierarchy.
+ *
+ * With a NULL @p root, /sys/fs/cgroup is used if it is a cgroup2 mount, and
+ * /sys/fs/cgroup/unified otherwise (hybrid hosts). Another directory, such as
+ * a test fixture, is used as given. The sampler starts disabled.
+ *
+ * @param sampler Sampler to initialize.
+ * @param root Hierarchy root, or NULL to detect it.
+ * @return int 0 on success, -1 if no hierarchy was found (root_fd is then -1).
+ */
+int cgroup_sampler_init(CgroupSampler* sampler, const char* root);
+
+/**
+ * @brief Walks the hierarchy and fills a list with the values of every cgroup.
+ *
+ * Each cgroup costs one directory read and one read each of cpu.stat,
+ * memory.current, memory.stat, pids.current, cpu.pressure, memory.pressure,
+ * and io.pressure. CPU usage is the change in usage_usec since the previous
+ * walk; it is 0 for a cgroup seen for the first time.
+ *
+ * @param sampler Sampler holding the previous walk.
+ * @param list List to fill; empty if the sampler is disabled or has no hierarchy.
+ * @return int 0 on success, -1 on allocation failure.
+ */
+int cgroup_sampler_collect(CgroupSampler* sampler, CgroupList* list);
+
+/**
+ * @brief Looks up the cgroup of a process.
+ *
+ * Reads the "0::" line of /proc/<pid>/cgroup and returns the inode of that
+ * directory below the hierarchy root.
+ *
+ * @param sampler Sampler holding the hierarchy root.
+ * @param pid Process ID.
+ * @return unsigned long long The cgroup ID, or 0 if it cannot be determined.
+ */
+unsigned long long cgroup_sampler_resolve(const CgroupSampler* sampler, pid_t pid);
+
+/**
+ * @brief Closes the hierarchy and frees the sampler's buffers.
+ * @param sampler Sampler to free.
+ */
+void cgroup_sampler_free(CgroupSampler* sampler);
+
+/**
+ * @brief Extracts usage_usec from the contents of a cpu.stat file.
+ * @return int 0 on success, -1 if the key is missing.
+ */
+int cgroup_parse_cpu_stat(const char* buf, size_t len, unsigned long long* usage_usec);
+
+/**
+ * @brief Fills anon_kb, file_kb, and kernel_kb from the contents of a memory.stat file.
+ *
+ * Without a "kernel" line (kernels before 5.18), kernel memory is the sum of
+ * kernel_stack, pagetables, sec_pagetables, percpu, sock, vmalloc, and slab.
+ *
+ * @return int 0 on success, -1 if no known key was found.
+ */
+int cgroup_parse_memory_stat(const char* buf, size_t len, CgroupInfo* info);
+
+/**
+ * @brief Extracts the cgroup v2 path from the contents of /proc/<pid>/cgroup.
+ * @param buf File contents.
+ * @param len Length of @p buf.
+ * @param path Destination, such as "/system.slice/ssh.service".
+ * @param size Size of @p path.
+ * @return int 0 on success, -1 if there is no "0::" line or it does not fit.
+ */
+int cgroup_parse_proc(const char* buf, size_t len, char* path, size_t size);
+
+#endif  // PROCX_CGROUP_H
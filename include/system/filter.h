@@ -0,0 +1,132 @@
+/**
+ * @file filter.h
+ * @brief Compiled multi-field filter expressions for the process list.
+ * @version 2.0.1
+ */
+
+#ifndef PROCX_FILTER_H
+#define PROCX_FILTER_H
+
+#include "../core/process.h"
+#include <regex.h>
+#include <stddef.h>
+
+/** @brief Maximum number of terms in one filter expression. */
+#define FILTER_MAX_TERMS 16
+
+/** @brief Maximum length of a term's text operand, including the terminator. */
+#define FILTER_TEXT_SIZE 64
+
+/**
+ * @enum FilterField
+ * @brief Process attribute a term tests.
+ */
+typedef enum FilterField {
+    FILTER_FIELD_NAME = 0, /**< Command name */
+    FILTER_FIELD_USER,     /**< Owner's user name */
+    FILTER_FIELD_STATE,    /**< State letter */
+    FILTER_FIELD_PID,      /**< Process ID */
+    FILTER_FIELD_PPID,     /**< Parent process ID */
+    FILTER_FIELD_UID,      /**< Owner's user ID */
+    FILTER_FIELD_CPU,      /**< CPU usage in percent */
+    FILTER_FIELD_MEM,      /**< Resident memory in KB */
+    FILTER_FIELD_THREADS,  /**< Thread count */
+    FILTER_FIELD_NICE,     /**< Nice value */
+    FILTER_FIELD_PRI       /**< Kernel priority */
+} FilterField;
+
+/**
+ * @enum FilterOp
+ * @brief Comparison a term applies to its field.
+ */
+typedef enum FilterOp {
+    FILTER_OP_CONTAINS = 0, /**< Case-insensitive substring */
+    FILTER_OP_EQUALS_TEXT,  /**< Case-insensitive equality */
+    FILTER_OP_STATE_IN,     /**< State letter is one of the operand's letters */
+    FILTER_OP_REGEX,        /**< POSIX extended regular expression, case-insensitive */
+    FILTER_OP_EQ,           /**< Numeric == */
+    FILTER_OP_LT,           /**< Numeric < */
+    FILTER_OP_LE,           /**< Numeric <= */
+    FILTER_OP_GT,           /**< Numeric > */
+    FILTER_OP_GE            /**< Numeric >= */
+} FilterOp;
+
+/**
+ * @struct FilterTerm
+ * @brief One compiled predicate.
+ */
+typedef struct FilterTerm {
+    FilterField field;                  /**< Attribute to test */
+    FilterOp    op;                     /**< Comparison */
+    int         negate;                 /**< Non-zero if the term was prefixed with '!' */
+    double      number;                 /**< Operand of numeric comparisons */
+    char        text[FILTER_TEXT_SIZE]; /**< Operand of text comparisons */
+    regex_t     regex;                  /**< Compiled operand of FILTER_OP_REGEX */
+} FilterTerm;
+
+/**
+ * @struct Filter
+ * @brief Conjunction of compiled terms; an empty filter matches everything.
+ */
+typedef struct Filter {
+    FilterTerm terms[FILTER_MAX_TERMS]; /**< Terms, all of which must match */
+    int        count;                   /**< Number of terms */
+} Filter;
+
+/**
+ * @brief Initializes an empty filter that matches every process.
+ * @param filter Filter to initialize.
+ */
+void filter_init(Filter* filter);
+
+/**
+ * @brief Parses and compiles a filter expression.
+ *
+ * The expression is a blank-separated list of terms that must all match:
+ *
+ * - @c word: the command name contains @c word (case-insensitive).
+ * - @c name:text / @c user:text: name contains / user name equals @c text.
+ * - @c state:RD: the state letter is one of the given letters.
+ * - @c name~regex / @c user~regex: POSIX extended regex, case-insensitive.
+ * - @c field>N, @c >=, @c <, @c <=, @c = or @c : for the numeric fields pid,
+ *   ppid, uid, cpu (percent), mem (KB, or with a K/M/G suffix), threads, nice,
+ *   and pri.
+ * - A leading @c ! negates a term.
+ *
+ * Words that do not start with a known field name and operator, such as
+ * @c kworker/0:1, are plain name substrings.
+ *
+ * @param filter Filter to fill; left empty on failure.
+ * @param query Expression to compile.
+ * @param error Buffer for a message describing the first error.
+ * @param error_size Size of @p error.
+ * @return int 0 on success, -1 on a syntax error.
+ */
+int filter_compile(Filter* filter, const char* query, char* error, size_t error_size);
+
+/**
+ * @brief Tests a process against a compiled filter.
+ * @param filter Compiled filter.
+ * @param proc Process to test.
+ * @return int Non-zero if every term matches.
+ */
+int filter_match(const Filter* filter, const ProcessNode* proc);
+
+/**
+ * @brief Returns the per-process files the fields of a filter come from.
+ *
+ * user, uid, and threads need status, and mem needs statm; everything else,
+ * including plain name words, is in stat.
+ *
+ * @param filter Compiled filter.
+ * @return int ProcFile bits, always including PROC_FILE_STAT.
+ */
+int filter_files(const Filter* filter);
+
+/**
+ * @brief Releases the compiled regular expressions and empties the filter.
+ * @param filter Filter to free.
+ */
+void filter_free(Filter* filter);
+
+#endif  // PROCX_FILTER_H
@@ -0,0 +1,123 @@
+/**
+ * @file pid_table.h
+ * @brief Open-addressing hash table of per-process sample state keyed by PID.
+ * @version 2.0.1
+ */
+
+#ifndef PROCX_PID_TABLE_H
+#define PROCX_PID_TABLE_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+struct ProcessNode;
+
+/**
+ * @struct PidTableEntry
+ * @brief State remembered for one process between two samples.
+ *
+ * An entry is identified by its PID together with the process start time, so a
+ * recycled PID never inherits the ticks of the process that used it before.
+ */
+typedef struct PidTableEntry {
+    pid_t               pid;        /**< Process ID (0 = empty slot, -1 = deleted slot) */
+    unsigned int        generation; /**< Last sample generation that touched this entry */
+    unsigned long long  starttime;  /**< Process start time in clock ticks after boot */
+    unsigned long       utime;      /**< User time ticks at the previous sample */
+    unsigned long       stime;      /**< Kernel time ticks at the previous sample */
+    unsigned long long  io_read;    /**< read_bytes at the previous I/O read */
+    unsigned long long  io_write;   /**< write_bytes at the previous I/O read */
+    unsigned long long  io_calls;   /**< syscr plus syscw at the previous I/O read */
+    long long           io_time_ms; /**< Monotonic time of the previous I/O read, 0 if none */
+    long                pss_kb;     /**< PSS of the previous smaps_rollup read, -1 if unreadable */
+    long                uss_kb;     /**< USS of the previous smaps_rollup read, -1 if unreadable */
+    long long           pss_ms;     /**< Monotonic time of the previous rollup read, 0 if none */
+    struct ProcessNode* node;       /**< Owner's node for this process, NULL until assigned */
+} PidTableEntry;
+
+/**
+ * @struct PidTable
+ * @brief Linear-probing hash table whose size follows the live process count.
+ */
+typedef struct PidTable {
+    PidTableEntry* slots;      /**< Slot array, capacity is a power of two */
+    size_t         capacity;   /**< Number of slots */
+    size_t         count;      /**< Number of live entries */
+    size_t         used;       /**< Live plus deleted slots (probe chain occupancy) */
+    unsigned int   generation; /**< Current sample generation */
+} PidTable;
+
+/**
+ * @brief Initializes an empty table. No memory is allocated until the first insert.
+ * @param table Table to initialize.
+ */
+void pid_table_init(PidTable* table);
+
+/**
+ * @brief Releases all memory owned by the table.
+ * @param table Table to free.
+ */
+void pid_table_free(PidTable* table);
+
+/**
+ * @brief Starts a new sample generation. Call once before touching the live processes.
+ * @param table Table to advance.
+ */
+void pid_table_begin(PidTable* table);
+
+/**
+ * @brief Finds or creates the entry for a process and marks it as seen in this generation.
+ *
+ * If an entry for @p pid exists but belongs to an older process (different start
+ * time), it is reset and reported as new. New entries start with zero ticks and
+ * a NULL node.
+ *
+ * @param table Table to update.
+ * @param pid Process ID.
+ * @param starttime Process start time from field 22 of /proc/[pid]/stat.
+ * @param is_new Set to 1 when the entry did not exist (or was recycled), 0 otherwise.
+ * @return Pointer to the entry, valid until the next call that modifies the table,
+ *         or NULL if memory could not be allocated.
+ */
+PidTableEntry* pid_table_touch(PidTable* table, pid_t pid, unsigned long long starttime,
+                               int* is_new);
+
+/**
+ * @brief Looks up a process without modifying the table.
+ * @param table Table to search.
+ * @param pid Process ID.
+ * @param starttime Process start time; entries with another start time do not match.
+ * @return Pointer to the entry, or NULL if not found.
+ */
+PidTableEntry* pid_table_find(const PidTable* table, pid_t pid, unsigned long long starttime);
+
+/**
+ * @brief Looks up the entry of a PID whatever the start time it was recorded with.
+ * @param table Table to search.
+ * @param pid Process ID.
+ * @return Pointer to the entry, or NULL if the PID is not in the table.
+ */
+PidTableEntry* pid_table_get(const PidTable* table, pid_t pid);
+
+/**
+ * @brief Removes the entry of a PID, if any.
+ * @param table Table to update.
+ * @param pid Process ID.
+ * @return int 1 if an entry was removed, 0 otherwise.
+ */
+int pid_table_remove(PidTable* table, pid_t pid);
+
+/**
+ * @brief Removes every entry but keeps the slot array for reuse.
+ * @param table Table to clear.
+ */
+void pid_table_clear(PidTable* table);
+
+/**
+ * @brief Evicts every entry not touched in the current generation and shrinks the
+ *        table when it has become sparse.
+ * @param table Table to sweep.
+ */
+void pid_table_sweep(PidTable* table);
+
+#endif  // PROCX_PID_TABLE_H
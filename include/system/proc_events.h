@@ -0,0 +1,72 @@
+/**
+ * @file proc_events.h
+ * @brief Process lifecycle events (fork, exec, exit, uid) from the netlink proc connector.
+ * @version 2.0.1
+ */
+
+#ifndef PROCX_PROC_EVENTS_H
+#define PROCX_PROC_EVENTS_H
+
+#include "pid_table.h"
+#include <stdio.h>
+
+/**
+ * @struct ProcEvents
+ * @brief Subscription to the kernel's proc connector plus the state derived from it.
+ *
+ * Processes forked since the last drain are kept in @c born, keyed by PID with
+ * the fork timestamp (nanoseconds since boot) stored as the start time. Only
+ * whole processes are tracked; thread creation and exit are ignored.
+ */
+typedef struct ProcEvents {
+    int           sock;        /**< Netlink connector socket, -1 when not subscribed */
+    PidTable      born;        /**< Processes forked since the owner last consumed them */
+    int           overrun;     /**< Set when the kernel dropped events; the PID set is stale */
+    unsigned long forks;       /**< Process forks seen since subscribing */
+    unsigned long execs;       /**< exec() calls seen since subscribing */
+    unsigned long exits;       /**< Process exits seen since subscribing */
+    unsigned long uid_changes; /**< setuid()-style credential changes seen since subscribing */
+    unsigned long short_lived; /**< Processes that exited without ever being sampled */
+    FILE*         exit_log;    /**< Where short-lived exits are logged, or NULL */
+} ProcEvents;
+
+/**
+ * @brief Initializes the state without subscribing.
+ * @param events Events to initialize.
+ */
+void proc_events_init(ProcEvents* events);
+
+/**
+ * @brief Opens a non-blocking netlink connector socket and subscribes to proc events.
+ *
+ * Kernels before 6.6 require CAP_NET_ADMIN, and the connector only exists in
+ * the initial network namespace. On failure nothing is left open, errno
+ * describes the error (typically EPERM or ECONNREFUSED), and the caller should
+ * keep scanning /proc with readdir.
+ *
+ * @param events Initialized events.
+ * @return int 0 on success, -1 on failure.
+ */
+int proc_events_open(ProcEvents* events);
+
+/**
+ * @brief Reads every pending event without blocking.
+ *
+ * Forks add the child to @c born; exits remove it again. An exiting process
+ * that is neither in @c born nor in @p sampled was never seen by a sample, so
+ * it is counted in @c short_lived and, if @c exit_log is set, logged with its
+ * exit status, lifetime, and parent.
+ *
+ * @param events Subscribed events.
+ * @param sampled PIDs present in the last sample, keyed as in ProcessTable::index.
+ * @return int Number of events read, or -1 if the socket failed and was closed.
+ */
+int proc_events_drain(ProcEvents* events, const PidTable* sampled);
+
+/**
+ * @brief Unsubscribes, closes the socket, and frees the born set.
+ * @param events Events to close.
+ */
+void proc_events_close(ProcEvents* events);
+
+#endif  // PROCX_PROC_EVENTS_H
@@ -0,0 +1,426 @@
+/**
+ * @file proc_parser.h
+ * @brief Allocation-free readers and scanners for /proc/[pid] files and the
+ *        system-wide files in /proc.
+ * @version 2.0.1
+ */
+
+#ifndef PROCX_PROC_PARSER_H
+#define PROCX_PROC_PARSER_H
+
+#include "../core/process.h"
+#include <stddef.h>
+#include <sys/types.h>
+
+/** @brief Buffer size for /proc/[pid]/stat (comm is at most 64 bytes, 52 numeric fields). */
+#define PROC_STAT_BUF_SIZE 1024
+/** @brief Buffer size for /proc/[pid]/statm (seven numbers). */
+#define PROC_STATM_BUF_SIZE 256
+/** @brief Buffer size for /proc/[pid]/status (large enough for long Groups lines). */
+#define PROC_STATUS_BUF_SIZE 8192
+
+/** @brief Buffer size for /proc/meminfo (the fields ProcX uses are in the first lines). */
+#define PROC_MEMINFO_BUF_SIZE 4096
+/** @brief Buffer size for /proc/loadavg and /proc/uptime. */
+#define PROC_SMALL_BUF_SIZE 128
+/** @brief Buffer size for /proc/[pid]/io (seven labelled counters, at most about 230 bytes). */
+#define PROC_IO_BUF_SIZE 512
+/** @brief Buffer size for /proc/[pid]/smaps_rollup (about 700 bytes). */
+#define PROC_ROLLUP_BUF_SIZE 2048
+/** @brief Buffer size for /proc/diskstats (about 120 bytes per device). */
+#define PROC_DISKSTATS_BUF_SIZE 16384
+
+/** @brief Largest number of CPUs tracked individually; later CPUs only count in the total. */
+#define PROC_MAX_CPUS 256
+
+/**
+ * @enum ProcFile
+ * @brief Per-process files, as bits of a mask of the files a sample needs.
+ *
+ * Columns, sort orders, filters, and batch fields each declare the files
+ * their values come from; the union of what is in use decides what is read.
+ */
+typedef enum ProcFile {
+    PROC_FILE_STAT   = 1 << 0, /**< stat: name, state, PPID, CPU times, priority; always read */
+    PROC_FILE_STATM  = 1 << 1, /**< statm: resident and virtual size */
+    PROC_FILE_STATUS = 1 << 2, /**< status: UID, thread count, and the RSS breakdown */
+    PROC_FILE_IO     = 1 << 3, /**< io: I/O rates */
+    PROC_FILE_ROLLUP = 1 << 4  /**< smaps_rollup: PSS and USS, measured for a memory view */
+} ProcFile;
+
+/** @brief The files every collection backend can read per process, and what recordings hold. */
+#define PROC_FILES_SCAN (PROC_FILE_STAT | PROC_FILE_STATM | PROC_FILE_STATUS)
+
+/**
+ * @struct CpuTimes
+ * @brief One "cpu" line of /proc/stat, in clock ticks since boot.
+ */
+typedef struct CpuTimes {
+    unsigned long long user;    /**< Time in user mode */
+    unsigned long long nice;    /**< Time in user mode at a positive nice value */
+    unsigned long long system;  /**< Time in kernel mode */
+    unsigned long long idle;    /**< Idle time */
+    unsigned long long iowait;  /**< Idle time with I/O outstanding */
+    unsigned long long irq;     /**< Time servicing interrupts */
+    unsigned long long softirq; /**< Time servicing softirqs */
+    unsigned long long steal;   /**< Time taken by other guests of the hypervisor */
+} CpuTimes;
+
+/**
+ * @struct CpuStat
+ * @brief Everything ProcX uses from one read of /proc/stat.
+ *
+ * The file is read once per sample; the difference between two of these gives
+ * the total CPU time that both the meters and per-process CPU% are measured
+ * against.
+ */
+typedef struct CpuStat {
+    CpuTimes           total;                /**< Aggregate "cpu" line */
+    CpuTimes           cores[PROC_MAX_CPUS]; /**< "cpuN" lines, indexed by N */
+    int                core_count;           /**< Highest N seen plus one; offline CPUs stay 0 */
+    unsigned long long ctxt;                 /**< Context switches since boot */
+    int                procs_running;        /**< Runnable tasks, threads included */
+    int                procs_blocked;        /**< Tasks blocked on I/O */
+    long long          time_ms;              /**< Monotonic time of the read, 0 if it failed */
+} CpuStat;
+
+/**
+ * @struct MemInfo
+ * @brief The /proc/meminfo fields behind the memory and swap meters, in KB.
+ */
+typedef struct MemInfo {
+    long total_kb;      /**< MemTotal */
+    long free_kb;       /**< MemFree */
+    long available_kb;  /**< MemAvailable, 0 on kernels before 3.14 */
+    long buffers_kb;    /**< Buffers */
+    long cached_kb;     /**< Cached */
+    long swap_total_kb; /**< SwapTotal */
+    long swap_free_kb;  /**< SwapFree */
+} MemInfo;
+
+/**
+ * @enum PressureResource
+ * @brief Resources with pressure stall information, in the order of their files.
+ */
+typedef enum PressureResource {
+    PRESSURE_CPU = 0,  /**< /proc/pressure/cpu, cpu.pressure */
+    PRESSURE_MEMORY,   /**< /proc/pressure/memory, memory.pressure */
+    PRESSURE_IO,       /**< /proc/pressure/io, io.pressure */
+    PRESSURE_RESOURCES /**< Number of resources */
+} PressureResource;
+
+/**
+ * @struct PressureStat
+ * @brief Stall averages of one pressure file, in percent of wall time.
+ *
+ * "some" is the share of time in which at least one task was stalled on the
+ * resource, "full" the share in which all non-idle tasks were.
+ */
+typedef struct PressureStat {
+    float some_avg10; /**< "some" over the last 10 seconds */
+    float some_avg60; /**< "some" over the last 60 seconds */
+    float full_avg10; /**< "full" over the last 10 seconds, 0 if the kernel has no full line */
+    float full_avg60; /**< "full" over the last 60 seconds */
+} PressureStat;
+
+/**
+ * @struct ProcIo
+ * @brief The counters of /proc/[pid]/io that the I/O columns use.
+ */
+typedef struct ProcIo {
+    unsigned long long read_bytes;  /**< Bytes fetched from storage */
+    unsigned long long write_bytes; /**< Bytes sent to storage, including writeback */
+    unsigned long long syscr;       /**< read() and similar system calls */
+    unsigned long long syscw;       /**< write() and similar system calls */
+} ProcIo;
+
+/**
+ * @struct ProcRollup
+ * @brief The sums of /proc/[pid]/smaps_rollup that the memory columns use.
+ */
+typedef struct ProcRollup {
+    long pss_kb; /**< Proportional set size: each page divided by the processes mapping it */
+    long uss_kb; /**< Unique set size: Private_Clean plus Private_Dirty */
+} ProcRollup;
+
+/** @brief Most block devices that /proc/diskstats is parsed for. */
+#define PROC_MAX_DISKS 64
+
+/**
+ * @struct DiskCounters
+ * @brief The /proc/diskstats counters of one block device.
+ */
+typedef struct DiskCounters {
+    char               name[32];        /**< Device name, such as "sda" or "nvme0n1" */
+    unsigned long long sectors_read;    /**< 512-byte sectors read */
+    unsigned long long sectors_written; /**< 512-byte sectors written */
+    unsigned long long io_ticks;        /**< Milliseconds in which I/O was in flight */
+} DiskCounters;
+
+/**
+ * @brief Returns a directory descriptor for /proc, opened once and cached.
+ * @return int The descriptor, or -1 if /proc cannot be opened.
+ */
+int proc_root_fd();
+
+/**
+ * @brief Reads every /proc file from @p path instead, such as a generated fixture.
+ *
+ * Must be called before any process table, system sampler, or scan is set up,
+ * since they keep descriptors opened relative to the root.
+ *
+ * @param path Directory laid out like /proc.
+ * @return int 0 on success, -1 with errno set if @p path is not a directory.
+ */
+int proc_set_root(const char* path);
+
+/**
+ * @brief Reads a whole file relative to a directory descriptor with a single read.
+ *
+ * The buffer is NUL-terminated; at most @p size - 1 bytes are read.
+ *
+ * @param dir_fd Directory descriptor the path is relative to.
+ * @param name File name relative to @p dir_fd.
+ * @param buf Destination buffer.
+ * @param size Size of @p buf in bytes.
+ * @return Number of bytes read, or -1 on failure.
+ */
+ssize_t proc_read_file(int dir_fd, const char* name, char* buf, size_t size);
+
+/**
+ * @brief Re-reads an open /proc file from the start with a single pread().
+ *
+ * procfs regenerates the contents on every read at offset 0, so a descriptor
+ * opened once serves every sample. The buffer is NUL-terminated.
+ *
+ * @param fd Open descriptor, or -1.
+ * @param buf Destination buffer.
+ * @param size Size of @p buf in bytes.
+ * @return Number of bytes read, or -1 on failure.
+ */
+ssize_t proc_reread(int fd, char* buf, size_t size);
+
+/**
+ * @brief Parses the contents of /proc/[pid]/stat.
+ *
+ * The command name is taken between the first '(' and the last ')', so names
+ * containing spaces or parentheses are preserved. Fills name, state, ppid,
+ * utime, stime, priority, nice_value, and starttime.
+ *
+ * @param buf File contents.
+ * @param len Number of valid bytes in @p buf.
+ * @param info Node to populate.
+ * @return int 0 on success, -1 if the contents are malformed.
+ */
+int proc_parse_stat(const char* buf, size_t len, ProcessNode* info);
+
+/**
+ * @brief Parses the contents of /proc/[pid]/statm and sets vsz_kb and memory_kb from the
+ *        size and RSS fields.
+ * @param buf File contents.
+ * @param len Number of valid bytes in @p buf.
+ * @param info Node to populate.
+ * @return int 0 on success, -1 if the contents are malformed.
+ */
+int proc_parse_statm(const char* buf, size_t len, ProcessNode* info);
+
+/**
+ * @brief Parses the contents of /proc/[pid]/status for the real UID, the thread
+ *        count, and the RSS breakdown.
+ *
+ * anon_kb, file_kb, shmem_kb, and swap_kb come from RssAnon, RssFile,
+ * RssShmem, and VmSwap; they are -1 if the line is missing, as it is for
+ * kernel threads.
+ *
+ * @param buf File contents.
+ * @param len Number of valid bytes in @p buf.
+ * @param info Node to populate (uid, num_threads, and the memory breakdown).
+ */
+void proc_parse_status(const char* buf, size_t len, ProcessNode* info);
+
+/**
+ * @brief Parses the stat, statm, and status contents of one process, however
+ *        they were read.
+ *
+ * This is the single place that turns raw file contents into a ProcessNode, so
+ * every collection backend produces identical results. A file that was not
+ * wanted is passed as NULL: without statm, memory_kb is 0 and vsz_kb -1;
+ * without status, uid is (uid_t)-1, num_threads 0, and the breakdown -1.
+ *
+ * @param pid Process ID the files belong to.
+ * @param stat Contents of stat; @p stat_len < 0 means it could not be read.
+ * @param stat_len Number of valid bytes in @p stat.
+ * @param statm Contents of statm, or NULL; @p statm_len < 0 means it could not be read.
+ * @param statm_len Number of valid bytes in @p statm.
+ * @param status Contents of status, or NULL; @p status_len < 0 means it could not be read.
+ * @param status_len Number of valid bytes in @p status.
+ * @param info Node to populate.
+ * @return int Same as proc_read_process().
+ */
+int proc_parse_files(pid_t pid, const char* stat, ssize_t stat_len, const char* statm,
+                     ssize_t statm_len, const char* status, ssize_t status_len, ProcessNode* info);
+
+/**
+ * @brief Sums all fields of a CPU line.
+ * @param times Times to sum.
+ * @return Total clock ticks.
+ */
+unsigned long long proc_cpu_total(const CpuTimes* times);
+
+/**
+ * @brief Parses the contents of /proc/stat in one pass.
+ *
+ * Reads the aggregate and per-CPU lines, ctxt, procs_running, and
+ * procs_blocked; everything else is skipped. time_ms is left unchanged.
+ *
+ * @param buf File contents.
+ * @param len Number of valid bytes in @p buf.
+ * @param stat Destination, cleared first.
+ * @return int 0 on success, -1 if the aggregate line is missing or malformed.
+ */
+int proc_parse_cpu_stat(const char* buf, size_t len, CpuStat* stat);
+
+/**
+ * @brief Reads and parses /proc/stat, however long its interrupt lines are.
+ *
+ * The file is read from the start in fixed chunks and only the lines of
+ * interest are kept, so the interrupt counters of a large machine need no
+ * large buffer.
+ *
+ * @param fd Open descriptor of /proc/stat; it is read with pread() and can be reused.
+ * @param stat Destination; on failure it is cleared and time_ms is 0.
+ * @return int 0 on success, -1 on failure.
+ */
+int proc_read_cpu_stat(int fd, CpuStat* stat);
+
+/**
+ * @brief Parses the contents of /proc/meminfo.
+ *
+ * Keys are looked up in a table of the fields ProcX uses, and the scan stops
+ * as soon as all of them were found.
+ *
+ * @param buf File contents.
+ * @param len Number of valid bytes in @p buf.
+ * @param info Destination; fields that are missing stay 0.
+ * @return int 0 on success, -1 if MemTotal is missing.
+ */
+int proc_parse_meminfo(const char* buf, size_t len, MemInfo* info);
+
+/**
+ * @brief Parses the three load averages at the start of /proc/loadavg.
+ * @param buf File contents.
+ * @param len Number of valid bytes in @p buf.
+ * @param load Destination for the 1, 5, and 15 minute averages.
+ * @return int 0 on success, -1 if the contents are malformed.
+ */
+int proc_parse_loadavg(const char* buf, size_t len, double load[3]);
+
+/**
+ * @brief Parses the whole seconds of uptime from /proc/uptime.
+ * @param buf File contents.
+ * @param len Number of valid bytes in @p buf.
+ * @param seconds Destination.
+ * @return int 0 on success, -1 if the contents are malformed.
+ */
+int proc_parse_uptime(const char* buf, size_t len, long* seconds);
+
+/**
+ * @brief Parses the avg10 and avg60 values of a pressure file.
+ *
+ * The same format is used by the files in /proc/pressure and by the cgroup v2
+ * files cpu.pressure, memory.pressure, and io.pressure. CPU pressure only has
+ * a "full" line from Linux 5.13 on.
+ *
+ * @param buf File contents.
+ * @param len Number of valid bytes in @p buf.
+ * @param stat Destination; values of a missing line are 0.
+ * @return int 0 on success, -1 if there is no "some" line.
+ */
+int proc_parse_pressure(const char* buf, size_t len, PressureStat* stat);
+
+/**
+ * @brief Parses the contents of /proc/[pid]/io.
+ * @param buf File contents.
+ * @param len Number of valid bytes in @p buf.
+ * @param io Destination; counters of missing lines are 0.
+ * @return int 0 on success, -1 if neither read_bytes nor write_bytes is present.
+ */
+int proc_parse_io(const char* buf, size_t len, ProcIo* io);
+
+/**
+ * @brief Parses the contents of /proc/[pid]/smaps_rollup.
+ * @param buf File contents.
+ * @param len Number of valid bytes in @p buf.
+ * @param rollup Destination.
+ * @return int 0 on success, -1 if there is no Pss line.
+ */
+int proc_parse_smaps_rollup(const char* buf, size_t len, ProcRollup* rollup);
+
+/**
+ * @brief Reads and parses /proc/[pid]/smaps_rollup (Linux 4.14 and later).
+ *
+ * The kernel walks every mapping of the process under its mmap lock to
+ * produce this file, which takes from tens of microseconds to milliseconds
+ * for large processes, so callers read it sparingly. It needs the same
+ * access as /proc/[pid]/io.
+ *
+ * @param root_fd Descriptor of the /proc directory.
+ * @param pid Process ID.
+ * @param rollup Destination.
+ * @return int 0 on success, -1 if the file cannot be read.
+ */
+int proc_read_smaps_rollup(int root_fd, pid_t pid, ProcRollup* rollup);
+
+/**
+ * @brief Reads and parses /proc/[pid]/io.
+ *
+ * The file needs the same access as ptrace(PTRACE_MODE_READ), so it fails
+ * for other users' processes unless ProcX runs with privilege.
+ *
+ * @param root_fd Descriptor of the /proc directory.
+ * @param pid Process ID.
+ * @param io Destination.
+ * @return int 0 on success, -1 if the file cannot be read.
+ */
+int proc_read_io(int root_fd, pid_t pid, ProcIo* io);
+
+/**
+ * @brief Parses /proc/diskstats.
+ * @param buf File contents.
+ * @param len Number of valid bytes in @p buf.
+ * @param disks Destination, one entry per device in file order.
+ * @param max Capacity of @p disks; further devices are ignored.
+ * @return int Number of devices parsed.
+ */
+int proc_parse_diskstats(const char* buf, size_t len, DiskCounters* disks, int max);
+
+/**
+ * @brief Names of the pressure files, indexed by PressureResource.
+ */
+extern const char* const proc_pressure_names[PRESSURE_RESOURCES];
+
+/**
+ * @brief Formats a PID as a decimal string without stdio.
+ * @param pid PID to format.
+ * @param out Destination, at least 12 bytes.
+ * @return int Length of the formatted string.
+ */
+int proc_format_pid(pid_t pid, char* out);
+
+/**
+ * @brief Reads and parses stat, and statm and status if wanted, of one process.
+ *
+ * Files are opened relative to a per-PID directory descriptor, so all three
+ * come from the same process instance even if the PID is recycled meanwhile.
+ * The username is not resolved.
+ *
+ * @param root_fd Descriptor of the /proc directory.
+ * @param pid Process ID to read.
+ * @param files ProcFile bits; stat is always read, statm and status only if set.
+ * @param info Node to populate.
+ * @return int 0 on success, 1 if only status was unreadable (uid and num_threads
+ *         keep their defaults), -1 if the process vanished or stat is unreadable.
+ */
+int proc_read_process(int root_fd, pid_t pid, int files, ProcessNode* info);
+
+#endif  // PROCX_PROC_PARSER_H
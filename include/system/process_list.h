@@ -1,6 +1,6 @@
 /**
  * @file process_list.h
- * @brief Functions to scan, build, and sort the list of all running processes.
+ * @brief Functions to scan and maintain the table of all running processes.
  * @version 2.0.1
  */
 
@@ -8,44 +8,289 @@
 #define PROCX_PROCESS_LIST_H
 
 #include "../core/process.h"
+#include "cgroup.h"
+#include "pid_table.h"
+#include "profile.h"
+#include "sys_info.h"
+#include "proc_events.h"
+#include "scan_pool.h"
+#include "uring_scan.h"
+#include <dirent.h>
+
+/** @brief Event-driven updates between two full readdir() reconciliations. */
+#define PROCESS_EVENTS_RESCAN_INTERVAL 30
+
+/** @brief Maximum number of processes that can be expanded one by one. */
+#define THREAD_VIEW_MAX_PIDS 64
+
+/**
+ * @struct ThreadView
+ * @brief Processes whose threads are listed as rows of their own.
+ *
+ * Expanding a process multiplies its scan cost by its thread count, so only
+ * the processes listed here, or every process when @c all is set, have their
+ * threads read.
+ */
+typedef struct ThreadView {
+    int   all;                        /**< Non-zero to expand every process */
+    int   count;                      /**< Number of entries in pids */
+    pid_t pids[THREAD_VIEW_MAX_PIDS]; /**< Processes expanded one by one */
+} ThreadView;
+
+/** @brief Maximum number of processes whose memory is measured one by one. */
+#define MEMORY_VIEW_MAX_PIDS 256
+
+/** @brief Default age after which the PSS and USS of a process are measured again. */
+#define MEMORY_VIEW_DEFAULT_AGE_MS 5000
+
+/**
+ * @struct MemoryView
+ * @brief Processes whose PSS and USS are read from /proc/[pid]/smaps_rollup.
+ *
+ * The kernel walks every mapping of a process to produce smaps_rollup, so
+ * only the processes listed here, normally the rows on screen, or every
+ * process when @c all is set, are measured, each at most once per
+ * @c max_age_ms. Other processes keep their last measurement.
+ */
+typedef struct MemoryView {
+    int   all;                        /**< Non-zero to measure every process */
+    int   max_age_ms;                 /**< Age at which a measurement is repeated */
+    int   count;                      /**< Number of entries in pids */
+    pid_t pids[MEMORY_VIEW_MAX_PIDS]; /**< Processes measured one by one, in ascending order */
+} MemoryView;
+
+/**
+ * @enum ScanBackend
+ * @brief How the per-process /proc files are opened and read.
+ */
+typedef enum ScanBackend {
+    SCAN_BACKEND_SYNC = 0, /**< openat/pread/close per file, optionally on a worker pool */
+    SCAN_BACKEND_URING     /**< Batched through io_uring, falls back to SYNC if unavailable */
+} ScanBackend;
+
+/**
+ * @struct ProcessTable
+ * @brief Long-lived set of running processes, updated in place on every sample.
+ *
+ * Nodes of processes that are still alive are reused across samples, so at
+ * steady state an update performs no allocation. After each update the table
+ * describes what changed: new nodes are flagged PROCESS_ADDED, updated ones
+ * PROCESS_CHANGED, and the PIDs of processes that disappeared are listed in
+ * @c exited.
+ */
+typedef struct ProcessTable {
+    ProcessNode*       head;             /**< Live processes, linked through next */
+    int                count;            /**< Number of live processes */
+    int                added;            /**< Processes that appeared in the last update */
+    int                changed;          /**< Processes whose values changed in the last update */
+    pid_t*             exited;           /**< PIDs that disappeared in the last update */
+    int                exited_count;     /**< Number of entries in exited */
+    int                exited_capacity;  /**< Allocated size of exited */
+    ProcessNode*       free_nodes;       /**< Nodes of exited processes kept for reuse */
+    int                free_count;       /**< Number of nodes in free_nodes */
+    PidTable           index;            /**< PID to node map, also holds the previous ticks */
+    DIR*               proc_dir;         /**< /proc directory stream, rewound on every update */
+    pid_t*             pids;             /**< PIDs collected by the current scan */
+    ProcessNode*       scratch;          /**< Parse buffer, one entry per collected PID */
+    int                scan_capacity;    /**< Allocated size of pids and scratch */
+    int                workers;          /**< Configured number of scan workers */
+    ScanPool*          pool;             /**< Worker pool, created on first parallel scan */
+    ScanBackend        backend;          /**< Active collection backend */
+    UringScanner*      uring;            /**< io_uring scanner, created on first use */
+    SystemSampler      system;           /**< System-wide /proc files, read with each update */
+    ProcEvents         events;           /**< Proc connector subscription (sock < 0 when off) */
+    int                rescan_countdown; /**< Event-driven updates left before a full rescan */
+    ThreadView         thread_view;      /**< Processes whose threads are read */
+    PidTable           thread_ticks;     /**< TID to the ticks of the previous update */
+    int                thread_count;     /**< Thread rows attached to the live processes */
+    ProcessNode*       thread_scratch;   /**< Parse buffer for the threads of one process */
+    int                thread_capacity;  /**< Allocated size of thread_scratch */
+    CgroupSampler      cgroups;          /**< cgroup v2 hierarchy, walked while enabled */
+    int                files;            /**< ProcFile bits of the per-process files read */
+    MemoryView         memory_view;      /**< Processes whose smaps_rollup is read */
+    unsigned int       user_generation;  /**< user_cache_generation() at the last merge */
+    ProfilePass        profile;          /**< Phase durations of the last update */
+} ProcessTable;
+
+/**
+ * @brief Initializes an empty process table.
+ * @param table Table to initialize.
+ */
+void process_table_init(ProcessTable* table);
+
+/**
+ * @brief Sets the number of workers used to parse /proc in parallel.
+ *
+ * With more than one worker, scans of large process counts are split into one
+ * contiguous PID slice per worker; results are always merged on the caller.
+ *
+ * @param table Table to configure.
+ * @param workers Number of workers (1 disables parallel scanning).
+ */
+void process_table_set_workers(ProcessTable* table, int workers);
+
+/**
+ * @brief Selects the collection backend.
+ *
+ * Selecting SCAN_BACKEND_URING on a system without a usable io_uring silently
+ * falls back to SCAN_BACKEND_SYNC; @c backend then reports the active one.
+ * Both backends produce identical nodes. The worker count only applies to SYNC.
+ *
+ * @param table Table to configure.
+ * @param backend Backend to use from the next update on.
+ */
+void process_table_set_backend(ProcessTable* table, ScanBackend backend);
+
+/**
+ * @brief Switches PID discovery from readdir() to netlink proc connector events.
+ *
+ * Once enabled, an update only re-reads the processes already in the table
+ * plus those forked since the previous update; a full readdir() of /proc runs
+ * every PROCESS_EVENTS_RESCAN_INTERVAL updates, or immediately if events were
+ * lost. Processes that exit before any update sees them are counted in
+ * @c events.short_lived and optionally logged to @p exit_log.
+ *
+ * @param table Table to configure.
+ * @param exit_log Stream for short-lived exit records, or NULL. Not closed by the table.
+ * @return int 0 on success, -1 if the connector is unavailable (errno is set);
+ *         the table then keeps using readdir().
+ */
+int process_table_enable_events(ProcessTable* table, FILE* exit_log);
+
+/**
+ * @brief Selects the processes whose threads are read from the next update on.
+ *
+ * After each update, every expanded process that is still alive has one node
+ * per thread in its @c threads list, read from /proc/[pid]/task/[tid]/stat.
+ * A thread's cpu_usage uses the same tick delta as a process, so it is 0 in
+ * the first update that sees the thread. Collapsed processes lose their lists.
+ *
+ * @param table Table to configure.
+ * @param view Processes to expand.
+ */
+void process_table_set_threads(ProcessTable* table, const ThreadView* view);
+
+/**
+ * @brief Enables or disables the cgroup walk and the process-to-cgroup mapping.
+ *
+ * While enabled, every process gets a @c cgroup_id. It is looked up once when
+ * the process first appears, and again only if its name changes (an exec),
+ * so steady-state updates read no /proc/[pid]/cgroup file.
+ *
+ * @param table Table to configure.
+ * @param enabled Non-zero to enable.
+ */
+void process_table_set_cgroups(ProcessTable* table, int enabled);
+
+/**
+ * @brief Selects the per-process files that later updates read.
+ *
+ * stat is always read. Without PROC_FILE_STATM, memory_kb is 0 and vsz_kb -1;
+ * without PROC_FILE_STATUS, uid is (uid_t)-1, num_threads 0, the RSS
+ * breakdown -1, and the username "-", so getpwuid() is not called either.
+ * The default, PROC_FILES_SCAN, reads all three.
+ *
+ * With PROC_FILE_IO, every update reads /proc/[pid]/io for each process, one
+ * more open per process, and sets io_read, io_write, and io_syscalls from the
+ * change of its counters since the previous update, per second. The rates
+ * are 0 in the first update that reads a process, and -1 without the bit or
+ * when the file cannot be read (another user's process without privilege).
+ * Thread rows always have -1.
+ *
+ * PROC_FILE_ROLLUP is ignored; smaps_rollup is read for the memory view, see
+ * process_table_set_memory().
+ *
+ * @param table Table to configure.
+ * @param files ProcFile bits.
+ */
+void process_table_set_files(ProcessTable* table, int files);
+
+/**
+ * @brief Selects the processes whose PSS and USS are measured from the next update on.
+ *
+ * A process in the view whose last measurement is older than the view's
+ * max_age_ms, or that was never measured, has its smaps_rollup read during
+ * the update. Every process carries its last measurement in pss_kb and
+ * uss_kb, whether or not it is still in the view; both are -1 until it is
+ * first measured or when the file cannot be read. Thread rows always have -1.
+ *
+ * @param table Table to configure.
+ * @param view Processes to measure.
+ */
+void process_table_set_memory(ProcessTable* table, const MemoryView* view);
+
+/**
+ * @brief Initializes a view with no expanded process.
+ * @param view View to initialize.
+ */
+void thread_view_init(ThreadView* view);
+
+/**
+ * @brief Checks whether a process is expanded.
+ * @param view View to query.
+ * @param pid Process ID.
+ * @return int Non-zero if the threads of @p pid are read.
+ */
+int thread_view_expanded(const ThreadView* view, pid_t pid);
 
 /**
- * @brief Scans the /proc directory and builds a linked list of processes.
- * @return Pointer to the head of the ProcessNode linked list.
+ * @brief Expands a collapsed process or collapses an expanded one.
+ * @param view View to update.
+ * @param pid Process ID.
+ * @return int 1 if the process is now expanded, 0 if it is now collapsed, -1 if
+ *         THREAD_VIEW_MAX_PIDS processes are already expanded.
  */
-ProcessNode* build_process_list();
+int thread_view_toggle(ThreadView* view, pid_t pid);
 
 /**
- * @brief Frees the memory allocated for the process linked list.
- * @param head Pointer to the head of the list.
+ * @brief Initializes a view that measures no process.
+ * @param view View to initialize.
+ * @param max_age_ms Age at which a measurement is repeated; 0 measures on every update.
  */
-void free_process_list(ProcessNode* head);
+void memory_view_init(MemoryView* view, int max_age_ms);
 
 /**
- * @brief Sorts the process list using a custom comparison function.
- * @param head_ref Pointer to the pointer of the head node.
- * @param cmp Comparison function to use for sorting.
+ * @brief Adds a process to a view, keeping the PIDs in ascending order.
+ * @param view View to update.
+ * @param pid Process ID; a PID already in the view is not added twice.
+ * @return int 0 on success, -1 if MEMORY_VIEW_MAX_PIDS processes are already listed.
  */
-void sort_process_list(ProcessNode** head_ref, int (*cmp)(ProcessNode*, ProcessNode*));
+int memory_view_add(MemoryView* view, pid_t pid);
 
 /**
- * @brief Comparison function for PIDs.
+ * @brief Checks whether a process is measured.
+ * @param view View to query.
+ * @param pid Process ID.
+ * @return int Non-zero if the smaps_rollup of @p pid is read.
  */
-int cmp_pid(ProcessNode* a, ProcessNode* b);
+int memory_view_wants(const MemoryView* view, pid_t pid);
 
 /**
- * @brief Comparison function for CPU usage.
+ * @brief Rescans /proc and updates the table in place.
+ *
+ * The relative order of surviving processes is preserved, new processes are
+ * appended to the end of the list, and exited ones are unlinked. While
+ * profiling is enabled, @c profile holds the durations of the update's
+ * phases; the /proc/stat read counts towards PROFILE_SYSINFO.
+ *
+ * @param table Table to update.
+ * @return int 0 on success, -1 if /proc cannot be opened.
  */
-int cmp_cpu(ProcessNode* a, ProcessNode* b);
+int process_table_update(ProcessTable* table);
 
 /**
- * @brief Comparison function for Memory usage.
+ * @brief Checks whether the last update changed anything at all.
+ * @param table Table to query.
+ * @return int Non-zero if a process was added, changed, or exited.
  */
-int cmp_mem(ProcessNode* a, ProcessNode* b);
+static inline int process_table_dirty(const ProcessTable* table) {
+    return table->added || table->changed || table->exited_count;
+}
 
 /**
- * @brief Comparison function for Process names.
+ * @brief Frees every node and resource owned by the table.
+ * @param table Table to free.
  */
-int cmp_name(ProcessNode* a, ProcessNode* b);
+void process_table_free(ProcessTable* table);
 
 #endif  // PROCX_PROCESS_LIST_H
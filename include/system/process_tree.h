@@ -0,0 +1,127 @@
+/**
+ * @file process_tree.h
+ * @brief Parent/child hierarchy of a snapshot, built in linear time from a PPID index.
+ * @version 2.0.1
+ */
+
+#ifndef PROCX_PROCESS_TREE_H
+#define PROCX_PROCESS_TREE_H
+
+#include "snapshot.h"
+#include <stdint.h>
+#include <sys/types.h>
+
+/** @brief Maximum number of processes that can be collapsed one by one. */
+#define TREE_MAX_COLLAPSED 64
+
+/** @brief Node flag: the node is the last of its siblings. */
+#define TREE_NODE_LAST 0x01
+/** @brief Node flag: the node has at least one child. */
+#define TREE_NODE_PARENT 0x02
+/** @brief Node flag: the children of the node are hidden. */
+#define TREE_NODE_COLLAPSED 0x04
+
+/**
+ * @struct TreeCollapse
+ * @brief Processes whose subtrees are hidden in the tree view.
+ *
+ * Kept by PID, so a collapsed subtree stays collapsed across samples.
+ */
+typedef struct TreeCollapse {
+    int   count;                    /**< Number of entries in pids */
+    pid_t pids[TREE_MAX_COLLAPSED]; /**< Collapsed processes */
+} TreeCollapse;
+
+/**
+ * @struct ProcessTree
+ * @brief Depth-first layout of the matching rows of a snapshot.
+ *
+ * Per-row arrays are indexed like ProcessSnapshot::procs. Children are stored
+ * in compressed form: the children of row @c r are
+ * <tt>children[child_start[r]]</tt> to <tt>children[child_start[r + 1] - 1]</tt>,
+ * and the roots are the children of the virtual row @c snapshot->count.
+ */
+typedef struct ProcessTree {
+    int*           index;       /**< PID to row map, open addressing, -1 for empty slots */
+    int            index_mask;  /**< Number of slots in index minus one */
+    int*           parent;      /**< Parent row, or -1 for a root */
+    int*           child_start; /**< Offsets into children, count + 2 entries */
+    int*           children;    /**< Rows grouped by parent, each group in display order */
+    int*           preorder;    /**< Rows in depth-first order */
+    int*           descendants; /**< Number of rows in the subtree below each row */
+    int*           depth;       /**< Depth of each row, 0 for a root */
+    uint64_t*      guides;      /**< Bit d set if the ancestor at depth d has later siblings */
+    unsigned char* flags;       /**< TREE_NODE_* flags of each row */
+    float*         subtree_cpu; /**< CPU usage of each process and its descendants */
+    long*          subtree_mem; /**< Resident memory of each process and its descendants */
+    int            count;       /**< Number of rows in preorder */
+    int            capacity;    /**< Allocated size of the per-row arrays */
+} ProcessTree;
+
+/**
+ * @brief Initializes an empty tree.
+ * @param tree Tree to initialize.
+ */
+void process_tree_init(ProcessTree* tree);
+
+/**
+ * @brief Builds the hierarchy of the matching rows of a snapshot.
+ *
+ * A process whose parent is not among the matching rows becomes a root, and a
+ * thread row is a child of its process. Siblings keep the order they have in
+ * @c snapshot->order, so sorting the snapshot first sorts every sibling group.
+ * The build is O(n): one pass fills the PID index, one counts and places the
+ * children, and an iterative depth-first walk lays out the rows. Parent links
+ * that form a cycle, which PID reuse between two reads can produce, are cut.
+ *
+ * @param tree Tree to fill.
+ * @param snapshot Filtered snapshot, in the sibling order wanted.
+ * @return int 0 on success, -1 on allocation failure (the tree is then empty).
+ */
+int process_tree_build(ProcessTree* tree, const ProcessSnapshot* snapshot);
+
+/**
+ * @brief Writes the visible rows of the tree into the display order.
+ *
+ * Replaces @c order with the rows of the tree in depth-first order, skipping
+ * the subtrees of collapsed processes, and sets @c matched and @c sorted to
+ * the number of visible rows. Only the walk is repeated, so a collapse or an
+ * expansion does not rebuild anything.
+ *
+ * @param tree Tree built from @p snapshot.
+ * @param snapshot Snapshot whose display order is replaced.
+ * @param collapse Processes whose subtrees are hidden.
+ */
+void process_tree_apply(ProcessTree* tree, ProcessSnapshot* snapshot,
+                        const TreeCollapse* collapse);
+
+/**
+ * @brief Frees every buffer owned by the tree.
+ * @param tree Tree to free.
+ */
+void process_tree_free(ProcessTree* tree);
+
+/**
+ * @brief Initializes a set with no collapsed process.
+ * @param collapse Set to initialize.
+ */
+void tree_collapse_init(TreeCollapse* collapse);
+
+/**
+ * @brief Checks whether a process is collapsed.
+ * @param collapse Set to query.
+ * @param pid Process ID.
+ * @return int Non-zero if the subtree of @p pid is hidden.
+ */
+int tree_collapse_contains(const TreeCollapse* collapse, pid_t pid);
+
+/**
+ * @brief Collapses an expanded process or expands a collapsed one.
+ * @param collapse Set to update.
+ * @param pid Process ID.
+ * @return int 1 if the process is now collapsed, 0 if it is now expanded, -1 if
+ *         TREE_MAX_COLLAPSED processes are already collapsed.
+ */
+int tree_collapse_toggle(TreeCollapse* collapse, pid_t pid);
+
+#endif  // PROCX_PROCESS_TREE_H
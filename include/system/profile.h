@@ -0,0 +1,213 @@
+/**
+ * @file profile.h
+ * @brief Self-profiling: phase timers and counters of ProcX's own cost.
+ * @version 2.0.1
+ */
+
+#ifndef PROCX_PROFILE_H
+#define PROCX_PROFILE_H
+
+#include <time.h>
+
+/** @brief Durations kept per phase for the percentiles. */
+#define PROFILE_HISTORY 256
+
+/**
+ * @enum ProfilePhase
+ * @brief Timed part of a sample or a frame.
+ *
+ * The first four run on the sampling thread once per sample; the others on
+ * the reader once per frame or batch sample, and only when there is work.
+ */
+typedef enum ProfilePhase {
+    PROFILE_READDIR = 0, /**< Collecting the PIDs: readdir() of /proc or proc events */
+    PROFILE_PARSE,       /**< Reading and parsing the per-process files */
+    PROFILE_DELTA,       /**< Merging into the table: CPU and I/O deltas, owners, threads */
+    PROFILE_SYSINFO,     /**< System header: /proc/stat, meminfo, loadavg, PSI, diskstats */
+    PROFILE_FILTER,      /**< snapshot_filter() and the cgroup restriction */
+    PROFILE_SORT,        /**< snapshot_sort() or snapshot_sort_top() */
+    PROFILE_RENDER,      /**< render_dashboard(), or formatting and writing a batch sample */
+    PROFILE_PHASES       /**< Number of phases */
+} ProfilePhase;
+
+/**
+ * @enum ProfileCounter
+ * @brief Event counted while profiling is enabled.
+ */
+typedef enum ProfileCounter {
+    PROFILE_SYSCALLS = 0, /**< System calls issued by the /proc readers and io_uring_enter() */
+    PROFILE_ALLOCS,       /**< malloc(), calloc(), and realloc() calls of the sampling path */
+    PROFILE_PROCESSES,    /**< Processes whose files were read */
+    PROFILE_COUNTERS      /**< Number of counters */
+} ProfileCounter;
+
+/** @brief Phase names as printed in the overlay and in batch profile records. */
+extern const char* const profile_phase_names[PROFILE_PHASES];
+
+/** @brief Counter names as printed in the overlay and in batch profile records. */
+extern const char* const profile_counter_names[PROFILE_COUNTERS];
+
+/** @brief Non-zero while the timers and counters run; see profile_set_enabled(). */
+extern int profile_enabled;
+
+/** @brief Totals of the counters since the start, updated atomically by every thread. */
+extern unsigned long long profile_counters[PROFILE_COUNTERS];
+
+/**
+ * @struct ProfilePass
+ * @brief Phase durations of one sampling pass and the counters at its end.
+ */
+typedef struct ProfilePass {
+    long long          ns[PROFILE_PHASES];         /**< Nanoseconds per phase, 0 if not timed */
+    unsigned long long counters[PROFILE_COUNTERS]; /**< Counter totals when the pass ended */
+} ProfilePass;
+
+/**
+ * @struct ProfileStats
+ * @brief Summary of the recent durations of one phase.
+ */
+typedef struct ProfileStats {
+    long long last_ns; /**< Latest duration */
+    long long p50_ns;  /**< Median of the kept durations */
+    long long p99_ns;  /**< 99th percentile of the kept durations */
+    int       count;   /**< Number of durations kept, at most PROFILE_HISTORY */
+} ProfileStats;
+
+/**
+ * @struct Profiler
+ * @brief Reader-side history of the phases, the counters, and ProcX's own usage.
+ *
+ * Owned by one thread: the sampling thread's phases reach it through the
+ * ProfilePass of each sample, so no timing is ever shared between threads.
+ */
+typedef struct Profiler {
+    long long          history[PROFILE_PHASES][PROFILE_HISTORY]; /**< Rings of durations */
+    long               recorded[PROFILE_PHASES];                 /**< Durations added per phase */
+    unsigned long long totals[PROFILE_COUNTERS];                 /**< Counters at the last pass */
+    unsigned long long per_sample[PROFILE_COUNTERS];             /**< Increase in the last pass */
+    long long          cpu_ns;                                   /**< Own CPU time, last pass */
+    long long          time_ns;                                  /**< Monotonic time, last pass */
+    float              cpu_usage;                                /**< Own CPU%, last pass */
+    long               rss_kb;                                   /**< Own RSS, -1 if unknown */
+    int                statm_fd;                                 /**< /proc/self/statm, kept open */
+} Profiler;
+
+/** @brief Non-zero unless the build defines PROCX_NO_PROFILE (make PROFILE=0). */
+#ifdef PROCX_NO_PROFILE
+#define PROFILE_AVAILABLE 0
+#else
+#define PROFILE_AVAILABLE 1
+#endif
+
+/**
+ * @brief Returns the monotonic clock in nanoseconds.
+ */
+static inline long long profile_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*
+ * Instrumentation points. While profiling is disabled each one costs a
+ * relaxed load and a branch; with PROCX_NO_PROFILE they compile to nothing.
+ *
+ *   PROFILE_COUNT(counter, n)        adds n to a counter
+ *   PROFILE_BEGIN(start);            declares start, the time if enabled or 0
+ *   PROFILE_END(start, total)        adds the time since start to total
+ *   PROFILE_ADD(profiler, ph, start) adds the time since start to a Profiler
+ */
+#ifndef PROCX_NO_PROFILE
+#define PROFILE_ON() __atomic_load_n(&profile_enabled, __ATOMIC_RELAXED)
+#define PROFILE_COUNT(counter, n)                                                   \
+    do {                                                                            \
+        if (PROFILE_ON()) {                                                         \
+            __atomic_fetch_add(&profile_counters[counter], (unsigned long long)(n), \
+                               __ATOMIC_RELAXED);                                   \
+        }                                                                           \
+    } while (0)
+#define PROFILE_BEGIN(start) long long start = PROFILE_ON() ? profile_now_ns() : 0
+#define PROFILE_END(start, total)                         \
+    do {                                                  \
+        if (start) (total) += profile_now_ns() - (start); \
+    } while (0)
+#define PROFILE_ADD(profiler, phase, start)                                       \
+    do {                                                                          \
+        if (start) profiler_add((profiler), (phase), profile_now_ns() - (start)); \
+    } while (0)
+#else
+#define PROFILE_COUNT(counter, n) ((void)0)
+#define PROFILE_BEGIN(start)
+#define PROFILE_END(start, total) ((void)0)
+#define PROFILE_ADD(profiler, phase, start) ((void)0)
+#endif
+
+/**
+ * @brief Starts or stops the timers and counters of every thread.
+ *
+ * Phases that are running when profiling starts are not timed.
+ *
+ * @param enabled Non-zero to enable.
+ */
+void profile_set_enabled(int enabled);
+
+/**
+ * @brief Returns the total of a counter since the start.
+ * @param counter Counter to read.
+ */
+unsigned long long profile_counter(ProfileCounter counter);
+
+/**
+ * @brief Clears the durations of a pass before its phases run.
+ * @param pass Pass to reset.
+ */
+void profile_pass_begin(ProfilePass* pass);
+
+/**
+ * @brief Records the counter totals at the end of a pass.
+ * @param pass Pass whose phases ran.
+ */
+void profile_pass_end(ProfilePass* pass);
+
+/**
+ * @brief Initializes an empty history.
+ * @param profiler Profiler to initialize.
+ */
+void profiler_init(Profiler* profiler);
+
+/**
+ * @brief Adds one duration of a phase, dropping the oldest beyond PROFILE_HISTORY.
+ * @param profiler Profiler to update.
+ * @param phase Phase that ran.
+ * @param ns Its duration; values of 0 or less are ignored.
+ */
+void profiler_add(Profiler* profiler, ProfilePhase phase, long long ns);
+
+/**
+ * @brief Adds the phases of a sampling pass and updates the counters and own usage.
+ *
+ * The per-sample counters are the increase since the previous pass; the CPU
+ * usage is ProcX's CPU time over the same time, from getrusage(), and the
+ * resident memory is read from /proc/self/statm.
+ *
+ * @param profiler Profiler to update.
+ * @param pass Pass taken from a sample.
+ */
+void profiler_add_pass(Profiler* profiler, const ProfilePass* pass);
+
+/**
+ * @brief Summarizes the kept durations of a phase.
+ * @param profiler Profiler to query.
+ * @param phase Phase to summarize.
+ * @param stats Filled with the latest duration and the percentiles.
+ * @return int 0 on success, -1 if the phase has no duration yet.
+ */
+int profiler_stats(const Profiler* profiler, ProfilePhase phase, ProfileStats* stats);
+
+/**
+ * @brief Releases the resources of a profiler.
+ * @param profiler Profiler to free.
+ */
+void profiler_free(Profiler* profiler);
+
+#endif  // PROCX_PROFILE_H
@@ -0,0 +1,172 @@
+/**
+ * @file recorder.h
+ * @brief Flight recorder: delta-encoded samples in a fixed-size ring file, and replay.
+ * @version 2.0.1
+ */
+
+#ifndef PROCX_RECORDER_H
+#define PROCX_RECORDER_H
+
+#include "sampler.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief File magic, "PXR1" in little-endian byte order. */
+#define RECORDER_MAGIC 0x31525850u
+/** @brief Format version written into the file header. */
+#define RECORDER_VERSION 1
+/** @brief Magic at the start of every frame. */
+#define RECORDER_FRAME_MAGIC 0x4d415246u
+/** @brief Magic that marks the unused end of the ring before a wrap to the start. */
+#define RECORDER_WRAP_MAGIC 0x50415257u
+/** @brief Frame flag: the frame is encoded against an empty sample. */
+#define RECORDER_FRAME_KEY 0x1u
+/** @brief Offset of the first frame; the header page comes before it. */
+#define RECORDER_DATA_OFFSET 4096
+/** @brief A keyframe is written every this many frames. */
+#define RECORDER_KEYFRAME_INTERVAL 30
+/** @brief Default ring file size. */
+#define RECORDER_DEFAULT_SIZE (64L * 1024 * 1024)
+/** @brief Smallest accepted ring file size. */
+#define RECORDER_MIN_SIZE (256L * 1024)
+
+/**
+ * @struct RecorderHeader
+ * @brief Header at offset 0 of a ring file.
+ *
+ * Frames are stored back to back from RECORDER_DATA_OFFSET; a frame that does
+ * not fit before the end of the file is written at the start of the data area
+ * instead, after a RECORDER_WRAP_MAGIC marker. The oldest frames are evicted as
+ * they are overwritten, and the oldest remaining frame is always a keyframe.
+ */
+typedef struct RecorderHeader {
+    uint32_t magic;    /**< RECORDER_MAGIC */
+    uint32_t version;  /**< RECORDER_VERSION */
+    uint64_t size;     /**< Total file size in bytes */
+    uint64_t head;     /**< Offset where the next frame will be written */
+    uint64_t tail;     /**< Offset of the oldest frame */
+    uint64_t last;     /**< Offset of the newest frame */
+    uint64_t frames;   /**< Number of frames between tail and last */
+    uint64_t sequence; /**< Sequence number of the newest frame */
+} RecorderHeader;
+
+/**
+ * @struct RecorderFrame
+ * @brief Header of one frame; the encoded sample follows it.
+ */
+typedef struct RecorderFrame {
+    uint32_t magic;    /**< RECORDER_FRAME_MAGIC */
+    uint32_t flags;    /**< RECORDER_FRAME_KEY or 0 */
+    uint64_t length;   /**< Frame size including this header, a multiple of 8 */
+    uint64_t prev;     /**< Offset of the previous frame */
+    uint64_t sequence; /**< Recording sequence number, one more than the previous frame's */
+    int64_t  time_ms;  /**< Wall-clock time of the sample, in ms since the epoch */
+    uint32_t count;    /**< Processes in the sample */
+    uint32_t payload;  /**< Bytes of encoded sample after this header */
+} RecorderFrame;
+
+/**
+ * @struct Recorder
+ * @brief Writer side of a ring file.
+ */
+typedef struct Recorder {
+    int             fd;           /**< Ring file */
+    unsigned char*  map;          /**< Shared mapping of the whole file */
+    RecorderHeader* header;       /**< Header at the start of map */
+    ProcessNode*    prev;         /**< Previous sample, sorted by PID */
+    int             prev_count;   /**< Number of entries in prev */
+    ProcessNode*    next;         /**< Current sample being sorted, swapped with prev */
+    int             capacity;     /**< Allocated size of prev and next */
+    unsigned char*  buffer;       /**< Encoding buffer */
+    size_t          buffer_size;  /**< Allocated size of buffer */
+    int             since_key;    /**< Frames written since the last keyframe */
+    int             error;        /**< errno of the last failed append, 0 if none */
+} Recorder;
+
+/**
+ * @struct Replay
+ * @brief Reader side of a ring file.
+ *
+ * The file is mapped, not read. Moving between frames only follows the frame
+ * headers; samples are decoded on demand from the nearest preceding keyframe,
+ * or from the current frame when stepping forward by one.
+ */
+typedef struct Replay {
+    int            fd;         /**< Ring file */
+    unsigned char* map;        /**< Read-only mapping of the whole file */
+    size_t         size;       /**< Size of map */
+    RecorderHeader header;     /**< Copy of the header taken at open */
+    uint64_t       offset;     /**< Offset of the current frame */
+    long           index;      /**< Position of the current frame, 0 is the oldest */
+    ProcessNode*   procs;      /**< Decoded processes of the current frame, sorted by PID */
+    ProcessNode*   scratch;    /**< Decoding buffer, swapped with procs */
+    int            count;      /**< Number of entries in procs */
+    int            capacity;   /**< Allocated size of procs and scratch */
+    uint64_t       decoded;    /**< Offset of the frame held in procs, 0 if none */
+    Sample         sample;     /**< Current frame as a sample for the dashboard */
+} Replay;
+
+/**
+ * @brief Opens or creates a ring file of @p size bytes.
+ *
+ * An existing recording of the same size is continued; any other file at
+ * @p path is replaced by an empty ring.
+ *
+ * @param recorder Recorder to initialize.
+ * @param path Ring file.
+ * @param size File size in bytes, at least RECORDER_MIN_SIZE.
+ * @return int 0 on success, -1 on failure (errno is set).
+ */
+int recorder_open(Recorder* recorder, const char* path, size_t size);
+
+/**
+ * @brief Appends one sample, evicting the oldest frames as needed.
+ *
+ * Only the processes whose recorded values changed since the previous sample
+ * are stored, except in keyframes.
+ *
+ * @param recorder Open recorder.
+ * @param sample Sample to record; only its process array in table order is read.
+ * @return int 0 on success, -1 if the sample was not recorded (see Recorder::error).
+ */
+int recorder_append(Recorder* recorder, const Sample* sample);
+
+/**
+ * @brief Unmaps and closes the ring file.
+ */
+void recorder_close(Recorder* recorder);
+
+/**
+ * @brief Maps a ring file for replay and decodes its newest frame.
+ * @param replay Replay to initialize.
+ * @param path Ring file.
+ * @param error Buffer for a description of the failure.
+ * @param error_size Size of @p error.
+ * @return int 0 on success, -1 on failure.
+ */
+int replay_open(Replay* replay, const char* path, char* error, size_t error_size);
+
+/**
+ * @brief Number of frames in the recording.
+ */
+static inline long replay_frames(const Replay* replay) { return (long)replay->header.frames; }
+
+/**
+ * @brief Moves @p delta frames forward (positive) or back (negative) and
+ *        decodes the frame reached.
+ *
+ * Movement stops at the oldest and newest frames.
+ *
+ * @param replay Open replay.
+ * @param delta Number of frames to move.
+ * @return int 0 on success, -1 if a frame on the way is damaged; the previous
+ *         frame then stays current.
+ */
+int replay_step(Replay* replay, long delta);
+
+/**
+ * @brief Unmaps the file and frees the decoded sample.
+ */
+void replay_close(Replay* replay);
+
+#endif  // PROCX_RECORDER_H
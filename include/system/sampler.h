@@ -0,0 +1,221 @@
+/**
+ * @file sampler.h
+ * @brief Background sampling thread that publishes process snapshots to the UI.
+ * @version 2.0.1
+ */
+
+#ifndef PROCX_SAMPLER_H
+#define PROCX_SAMPLER_H
+
+#include "cgroup.h"
+#include "process_list.h"
+#include "profile.h"
+#include "snapshot.h"
+#include "sys_info.h"
+#include <pthread.h>
+#include <time.h>
+
+struct Recorder;
+
+/** @brief Most PSI triggers one sampler watches. */
+#define SAMPLER_MAX_PSI_TRIGGERS 4
+
+/**
+ * @struct Sample
+ * @brief Everything taken in one sampling pass.
+ *
+ * Once published, the process copies and the statistics are never written
+ * again by the sampler. The reader may filter and sort the snapshot, which
+ * only touches its index arrays.
+ */
+typedef struct Sample {
+    ProcessSnapshot snapshot;    /**< Processes, in table order until the reader sorts them */
+    SystemInfo      info;        /**< Meters and system statistics taken with the snapshot */
+    CgroupList      cgroups;     /**< cgroup v2 hierarchy, empty unless sampler_set_cgroups() */
+    long            short_lived; /**< Short-lived exits counted so far, or -1 when not tracked */
+    long long       time_ms;     /**< Wall-clock time of the sample, in ms since the epoch */
+    unsigned long   sequence;    /**< Publication number, 0 for the empty initial sample */
+    ProfilePass     profile;     /**< Cost of taking the sample, while profiling is enabled */
+} Sample;
+
+/**
+ * @struct SamplerTrigger
+ * @brief Switches to a faster sampling interval while the system is busy.
+ *
+ * Whenever a sample shows total CPU usage at or above @c cpu_percent, samples
+ * are taken every @c interval_ms until @c window_ms have passed without
+ * another such sample.
+ */
+typedef struct SamplerTrigger {
+    int cpu_percent; /**< Total CPU% that starts a burst, 0 to disable */
+    int interval_ms; /**< Sampling interval during a burst */
+    int window_ms;   /**< Burst length after the last sample over the threshold */
+} SamplerTrigger;
+
+/**
+ * @struct Sampler
+ * @brief Sampling thread and its triple buffer.
+ *
+ * The thread fills @c back, then swaps it with @c ready under the lock; the
+ * reader swaps @c ready with @c front in sampler_take(). Neither side ever
+ * copies a sample or waits for the other to finish with one, so a slow frame
+ * never delays sampling and a slow scan never blocks input.
+ */
+typedef struct Sampler {
+    ProcessTable*    table;       /**< Table updated only by the sampling thread */
+    int              interval_ms; /**< Time between the starts of two samples */
+    SamplerTrigger   trigger;     /**< Burst sampling, off unless cpu_percent is set */
+    struct timespec  burst_until; /**< Monotonic end of the current burst */
+    struct Recorder* recorder;    /**< Flight recorder fed by the sampling thread, or NULL */
+    ThreadView       threads;     /**< Processes whose threads the reader wants to see */
+    int              cgroups;     /**< Non-zero if the reader wants the cgroup hierarchy */
+    int              files;       /**< ProcFile bits of the per-process files the reader wants */
+    MemoryView       memory;      /**< Processes whose PSS and USS the reader wants */
+    Sample           samples[3];  /**< Storage of the three buffers */
+    Sample*          back;        /**< Being filled by the sampling thread */
+    Sample*          ready;       /**< Latest complete sample */
+    Sample*          front;       /**< Sample owned by the reader */
+    int              fresh;       /**< Non-zero if ready is newer than front */
+    int              running;     /**< Cleared to stop the thread */
+    int              wake_fds[2]; /**< Pipe that becomes readable when a sample is published */
+    pthread_t        thread;      /**< Sampling thread */
+    pthread_mutex_t  lock;        /**< Protects the buffer swap, fresh, and running */
+    pthread_cond_t   stop_cond;   /**< Signalled to end the wait between samples early */
+
+    int           psi_fds[SAMPLER_MAX_PSI_TRIGGERS]; /**< PSI triggers that wake the thread */
+    int           psi_count;                         /**< Number of entries in psi_fds */
+    int           psi_stop_fds[2];                   /**< Pipe that ends the PSI watcher */
+    pthread_t     psi_thread;                        /**< Thread polling psi_fds */
+    int           poked;                             /**< Set by the watcher to sample now */
+    unsigned long wakeups;                           /**< Samples taken early on a PSI trigger */
+} Sampler;
+
+/**
+ * @brief Prepares a sampler for @p table without starting it.
+ * @param sampler Sampler to initialize.
+ * @param table Initialized process table.
+ * @param interval_ms Sampling interval in milliseconds.
+ */
+void sampler_init(Sampler* sampler, ProcessTable* table, int interval_ms);
+
+/**
+ * @brief Makes the sampling thread append every sample to @p recorder.
+ *
+ * Must be called before sampler_start(); the recorder belongs to the sampling
+ * thread until sampler_stop().
+ *
+ * @param sampler Sampler that is not running.
+ * @param recorder Open recorder, or NULL to record nothing.
+ */
+void sampler_set_recorder(Sampler* sampler, struct Recorder* recorder);
+
+/**
+ * @brief Configures burst sampling; must be called before sampler_start().
+ * @param sampler Sampler that is not running.
+ * @param trigger Threshold, fast interval, and window.
+ */
+void sampler_set_trigger(Sampler* sampler, const SamplerTrigger* trigger);
+
+/**
+ * @brief Makes a PSI trigger wake the sampling thread for an immediate sample.
+ *
+ * Must be called before sampler_start(). The sampler owns @p fd from here on,
+ * also on failure. When the kernel signals the trigger, the wait for the next
+ * deadline ends at once and the schedule restarts from that sample. A
+ * trigger fires at most once per window, which bounds the extra samples.
+ *
+ * @param sampler Sampler that is not running.
+ * @param fd Trigger descriptor from psi_trigger_open().
+ * @return int 0 on success, -1 if @p fd is invalid or SAMPLER_MAX_PSI_TRIGGERS are set.
+ */
+int sampler_add_psi_trigger(Sampler* sampler, int fd);
+
+/**
+ * @brief Starts sampling on a new thread.
+ *
+ * From here until sampler_stop() the table belongs to the sampling thread.
+ * Samples start every interval on a monotonic schedule, so CPU usage is always
+ * computed over the configured interval; a pass that takes longer than the
+ * interval is followed immediately by the next one.
+ *
+ * @param sampler Sampler prepared with sampler_init().
+ * @return int 0 on success, -1 on failure (errno is set).
+ */
+int sampler_start(Sampler* sampler);
+
+/**
+ * @brief Selects the processes whose threads are included in later samples.
+ *
+ * The sampling thread applies @p view to the table before its next update, so
+ * the thread rows appear in the sample after that; see process_table_set_threads().
+ *
+ * @param sampler Running sampler.
+ * @param view Processes to expand.
+ */
+void sampler_set_threads(Sampler* sampler, const ThreadView* view);
+
+/**
+ * @brief Enables or disables the cgroup hierarchy in later samples.
+ *
+ * Like sampler_set_threads(), this takes effect with the next update. While
+ * enabled, each sample's @c cgroups lists every cgroup with its process count,
+ * and every process carries its cgroup ID; see process_table_set_cgroups().
+ *
+ * @param sampler Running sampler.
+ * @param enabled Non-zero to enable.
+ */
+void sampler_set_cgroups(Sampler* sampler, int enabled);
+
+/**
+ * @brief Selects the per-process files that later samples read.
+ *
+ * Like sampler_set_cgroups(), this takes effect with the next update; see
+ * process_table_set_files(). The default is PROC_FILES_SCAN. While a recorder
+ * is attached, stat, statm, and status are read regardless, since a recording
+ * can be browsed with any columns. It may also be called before
+ * sampler_start(), so that the first sample already reads the I/O counters.
+ *
+ * @param sampler Initialized sampler.
+ * @param files ProcFile bits.
+ */
+void sampler_set_files(Sampler* sampler, int files);
+
+/**
+ * @brief Selects the processes whose PSS and USS later samples measure.
+ *
+ * Takes effect with the next update; see process_table_set_memory(). The
+ * view starts empty with MEMORY_VIEW_DEFAULT_AGE_MS. It may also be called
+ * before sampler_start().
+ *
+ * @param sampler Initialized sampler.
+ * @param view Processes to measure.
+ */
+void sampler_set_memory(Sampler* sampler, const MemoryView* view);
+
+/**
+ * @brief Returns a descriptor that polls readable when a new sample is ready.
+ * @param sampler Running sampler.
+ * @return int File descriptor for poll().
+ */
+static inline int sampler_fd(const Sampler* sampler) { return sampler->wake_fds[0]; }
+
+/**
+ * @brief Makes the latest published sample the reader's @c front sample.
+ *
+ * The previous front sample must no longer be used afterwards.
+ *
+ * @param sampler Running sampler.
+ * @return int 1 if @c front changed, 0 if no newer sample was published.
+ */
+int sampler_take(Sampler* sampler);
+
+/**
+ * @brief Stops and joins the sampling thread and frees the samples.
+ *
+ * The table is handed back to the caller, which still has to free it.
+ *
+ * @param sampler Sampler to stop.
+ */
+void sampler_stop(Sampler* sampler);
+
+#endif  // PROCX_SAMPLER_H
@@ -0,0 +1,80 @@
+/**
+ * @file scan_pool.h
+ * @brief Worker pool that parses /proc/[pid] files for many processes in parallel.
+ * @version 2.0.1
+ */
+
+#ifndef PROCX_SCAN_POOL_H
+#define PROCX_SCAN_POOL_H
+
+#include "../core/process.h"
+
+/** @brief Upper bound on the number of scan workers. */
+#define SCAN_POOL_MAX_WORKERS 64
+
+/**
+ * @struct ScanPool
+ * @brief Opaque pool of long-lived worker threads.
+ */
+typedef struct ScanPool ScanPool;
+
+/**
+ * @brief Default worker count: the number of online CPUs, capped at 16.
+ * @return int Number of workers to use when none is configured.
+ */
+int scan_pool_default_workers();
+
+/**
+ * @brief Creates a pool. The calling thread acts as one of the workers, so
+ *        @p workers - 1 threads are started.
+ * @param workers Total number of workers (1 to SCAN_POOL_MAX_WORKERS).
+ * @return Pointer to the pool, or NULL if it could not be created.
+ */
+ScanPool* scan_pool_create(int workers);
+
+/**
+ * @brief Returns the number of workers of a pool.
+ * @param pool Pool to query.
+ * @return int Total number of workers, including the calling thread.
+ */
+int scan_pool_workers(const ScanPool* pool);
+
+/**
+ * @brief Parses a batch of processes, splitting the PID array into one
+ *        contiguous slice per worker, and waits for all slices to finish.
+ *
+ * Each entry of @p out is filled by proc_read_process(). The username is left
+ * empty for the caller to resolve, or set to "unknown" if status was
+ * unreadable. Entries of processes that could not be read get pid 0.
+ *
+ * @param pool Pool to run on.
+ * @param root_fd Descriptor of the /proc directory.
+ * @param files ProcFile bits of the files to read besides stat.
+ * @param pids PIDs to parse.
+ * @param out Output array with one entry per PID.
+ * @param count Number of PIDs.
+ */
+void scan_pool_parse(ScanPool* pool, int root_fd, int files, const pid_t* pids, ProcessNode* out,
+                     int count);
+
+/**
+ * @brief Parses a slice of processes on the calling thread, with the same
+ *        output contract as scan_pool_parse().
+ */
+void scan_parse_range(int root_fd, int files, const pid_t* pids, ProcessNode* out, int count);
+
+/**
+ * @brief Stores the outcome of proc_read_process() or proc_parse_files() in a
+ *        scan output entry, as described for scan_pool_parse().
+ * @param out Entry that was parsed.
+ * @param result Return value of the parser.
+ */
+void scan_finish_entry(ProcessNode* out, int result);
+
+/**
+ * @brief Stops all worker threads and frees the pool.
+ * @param pool Pool to destroy (may be NULL).
+ */
+void scan_pool_destroy(ScanPool* pool);
+
+#endif  // PROCX_SCAN_POOL_H
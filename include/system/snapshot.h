@@ -0,0 +1,184 @@
+/**
+ * @file snapshot.h
+ * @brief Contiguous per-frame copy of the process table and its multi-key sort.
+ * @version 2.0.1
+ */
+
+#ifndef PROCX_SNAPSHOT_H
+#define PROCX_SNAPSHOT_H
+
+#include "../core/process.h"
+#include "filter.h"
+#include <stdint.h>
+
+/** @brief Maximum number of keys in a sort specification. */
+#define SORT_MAX_KEYS 4
+
+/**
+ * @brief snapshot_sort_top() runs a full sort once the limit exceeds
+ *        count / SORT_TOP_FULL_RATIO.
+ */
+#define SORT_TOP_FULL_RATIO 4
+
+/**
+ * @enum SortField
+ * @brief Process attribute a snapshot can be ordered by.
+ */
+typedef enum SortField {
+    SORT_FIELD_PID = 0, /**< Process ID */
+    SORT_FIELD_CPU,     /**< CPU usage */
+    SORT_FIELD_MEM,     /**< Resident memory */
+    SORT_FIELD_NAME,    /**< Command name, case-insensitive */
+    SORT_FIELD_IO,      /**< Bytes read and written per second; unknown counts as 0 */
+    SORT_FIELD_PSS      /**< Proportional set size; unmeasured counts as 0 */
+} SortField;
+
+/**
+ * @struct SortKey
+ * @brief One level of a sort specification.
+ */
+typedef struct SortKey {
+    SortField field;      /**< Attribute to compare */
+    int       descending; /**< Non-zero to put larger values first */
+} SortKey;
+
+/**
+ * @struct SortSpec
+ * @brief Ordered list of keys; later keys break ties of earlier ones.
+ */
+typedef struct SortSpec {
+    SortKey keys[SORT_MAX_KEYS]; /**< Keys, most significant first */
+    int     count;               /**< Number of keys in use */
+} SortSpec;
+
+/**
+ * @struct SortItem
+ * @brief Sort record: the keys of one process, precomputed as unsigned integers
+ *        whose natural order is the requested order.
+ */
+typedef struct SortItem {
+    uint64_t key[SORT_MAX_KEYS]; /**< Encoded keys, compared most significant first */
+    int      index;              /**< Index of the process in ProcessSnapshot::procs */
+    int      position;           /**< Position of the process in ProcessSnapshot::matches */
+} SortItem;
+
+/**
+ * @struct ProcessSnapshot
+ * @brief Contiguous copy of the process table, taken once per sample.
+ *
+ * The processes are stored in table order in @c procs. The filter is evaluated
+ * once per snapshot into @c matches, the indices of the @c matched processes
+ * that pass it, in table order; @c order lists the same indices in display
+ * order. Sorting only permutes @c order, so the copies are never moved. After a
+ * partial sort only the first @c sorted positions are meaningful as a ranking.
+ *
+ * The thread rows of an expanded process directly follow it in @c procs. They
+ * pass the filter together with their process, and sorting keeps them right
+ * below it, ordered among themselves by the same keys.
+ */
+typedef struct ProcessSnapshot {
+    ProcessNode* procs;    /**< Process copies, in table order (next is NULL) */
+    int*         matches;  /**< Indices into procs that pass the filter, in table order */
+    int*         order;    /**< The indices of matches, in display order */
+    int*         groups;   /**< Index of the process each row belongs to (its own for a process) */
+    int          count;    /**< Number of processes and thread rows */
+    int          threads;  /**< Number of thread rows among them */
+    int          running;  /**< Number of processes (not thread rows) in state R */
+    int          matched;  /**< Number of processes that pass the filter */
+    int          capacity; /**< Allocated size of procs, matches, order, groups, sort buffers */
+    int          sorted;   /**< Leading positions of order that are in sort order */
+    SortItem*    items;    /**< Sort records */
+    SortItem*    scratch;  /**< Merge buffer */
+} ProcessSnapshot;
+
+/**
+ * @brief Initializes an empty snapshot.
+ * @param snapshot Snapshot to initialize.
+ */
+void snapshot_init(ProcessSnapshot* snapshot);
+
+/**
+ * @brief Copies a process list into the snapshot, replacing its contents.
+ *
+ * Each process is followed by the rows of its @c threads list, if any.
+ * Afterwards every row matches, @c order is the identity, i.e. the list
+ * order, and @c sorted is 0.
+ *
+ * @param snapshot Snapshot to fill.
+ * @param head First process of the list.
+ * @param count Number of processes plus thread rows (used to size the buffers).
+ * @return int 0 on success, -1 on allocation failure (the snapshot is then empty).
+ */
+int snapshot_build(ProcessSnapshot* snapshot, const ProcessNode* head, int count);
+
+/**
+ * @brief Evaluates a filter once over the whole snapshot.
+ *
+ * Fills @c matches and @c order with the processes that pass @p filter, and
+ * the thread rows of those processes, in table order, and resets @c sorted.
+ * Rendering, navigation, and actions then index this vector instead of
+ * re-testing every process.
+ *
+ * @param snapshot Snapshot to filter.
+ * @param filter Compiled filter; NULL or an empty filter selects everything.
+ */
+void snapshot_filter(ProcessSnapshot* snapshot, const Filter* filter);
+
+/**
+ * @brief Orders the matching processes by a multi-key specification.
+ *
+ * Keys are encoded once per process, then sorted with an iterative, stable
+ * bottom-up merge sort, so the stack depth is constant and processes that
+ * compare equal on every key keep their relative order from snapshot_build().
+ * Thread rows are ranked by the keys of their process, then follow it ordered
+ * by their own keys. The order is not applied if memory runs short.
+ *
+ * @param snapshot Snapshot to sort.
+ * @param spec Keys to sort by.
+ */
+void snapshot_sort(ProcessSnapshot* snapshot, const SortSpec* spec);
+
+/**
+ * @brief Orders only the first @p limit display positions.
+ *
+ * The @p limit processes that come first under @p spec are selected with a
+ * bounded max-heap in O(n log limit) and placed at the front of @c order, in
+ * exactly the order snapshot_sort() would give them (ties are broken by table
+ * order, like the stable full sort). The remaining positions hold the other
+ * processes in table order. When @p limit is a large fraction of the snapshot,
+ * this simply runs snapshot_sort().
+ *
+ * @param snapshot Snapshot to sort.
+ * @param spec Keys to sort by.
+ * @param limit Number of leading positions that must be in order.
+ */
+void snapshot_sort_top(ProcessSnapshot* snapshot, const SortSpec* spec, int limit);
+
+/**
+ * @brief Returns the per-process files a sort order needs.
+ *
+ * Every key counts, tie-breaks included: a value that was not read would be 0
+ * for every process and silently drop its key from the order.
+ *
+ * @param spec Sort order, or NULL for none.
+ * @return int ProcFile bits, always including PROC_FILE_STAT.
+ */
+int snapshot_sort_files(const SortSpec* spec);
+
+/**
+ * @brief Returns the process at a display position.
+ * @param snapshot Snapshot to read.
+ * @param position Position in display order, 0 to matched - 1.
+ * @return Pointer to the process copy.
+ */
+static inline ProcessNode* snapshot_at(const ProcessSnapshot* snapshot, int position) {
+    return &snapshot->procs[snapshot->order[position]];
+}
+
+/**
+ * @brief Frees every buffer owned by the snapshot.
+ * @param snapshot Snapshot to free.
+ */
+void snapshot_free(ProcessSnapshot* snapshot);
+
+#endif  // PROCX_SNAPSHOT_H
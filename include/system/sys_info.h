@@ -8,23 +8,53 @@
 #define PROCX_SYS_INFO_H
 
 #include "../core/process.h"
+#include "proc_parser.h"
+
+/** @brief Most disks shown in the header. */
+#define SYSTEM_MAX_DISKS 8
+
+/**
+ * @struct DiskInfo
+ * @brief Throughput of one whole disk since the previous sample.
+ */
+typedef struct DiskInfo {
+    char  name[32];  /**< Device name, such as "sda" or "nvme0n1" */
+    float read_bps;  /**< Bytes read per second */
+    float write_bps; /**< Bytes written per second */
+    int   util;      /**< Percentage of the time with I/O in flight */
+} DiskInfo;
 
 /**
  * @struct SystemInfo
  * @brief Global system resource usage statistics.
  */
 typedef struct SystemInfo {
-    int    cpu_usage;     /**< Total CPU Usage in percentage (0-100) */
-    int    mem_usage;     /**< Total RAM Usage in percentage (0-100) */
-    int    swp_usage;     /**< Total Swap Usage in percentage (0-100) */
-    long   total_mem_kb;  /**< Total RAM in KB */
-    long   free_mem_kb;   /**< Free RAM in KB */
-    long   total_swp_kb;  /**< Total Swap in KB */
-    long   free_swp_kb;   /**< Free Swap in KB */
-    int    running_tasks; /**< Number of running processes */
-    int    total_tasks;   /**< Number of total processes */
-    double load_avg[3];   /**< Load average for 1, 5, and 15 minutes */
-    long   uptime_sec;    /**< System uptime in seconds */
+    int           cpu_usage;                /**< Total CPU Usage in percentage (0-100) */
+    int           mem_usage;                /**< Total RAM Usage in percentage (0-100) */
+    int           swp_usage;                /**< Total Swap Usage in percentage (0-100) */
+    long          total_mem_kb;             /**< Total RAM in KB */
+    long          free_mem_kb;              /**< Free RAM in KB */
+    long          total_swp_kb;             /**< Total Swap in KB */
+    long          free_swp_kb;              /**< Free Swap in KB */
+    int           running_tasks;            /**< Number of running processes */
+    int           total_tasks;              /**< Number of total processes */
+    double        load_avg[3];              /**< Load average for 1, 5, and 15 minutes */
+    long          uptime_sec;               /**< System uptime in seconds */
+    int           cpu_user;                 /**< User and nice time in percent of all CPU time */
+    int           cpu_system;               /**< Kernel, irq, and softirq time in percent */
+    int           cpu_iowait;               /**< I/O wait in percent */
+    int           cpu_steal;                /**< Steal time in percent */
+    long          ctxt_rate;                /**< Context switches per second */
+    int           procs_running;            /**< Runnable tasks reported by the kernel */
+    int           procs_blocked;            /**< Tasks blocked on I/O */
+    int           core_count;               /**< Entries in core_usage, 0 if not measured */
+    unsigned char core_usage[PROC_MAX_CPUS]; /**< Busy percentage of each CPU */
+
+    int          psi;                          /**< Non-zero if pressure was read */
+    PressureStat pressure[PRESSURE_RESOURCES]; /**< System-wide stall averages, by resource */
+
+    int      disk_count;              /**< Entries in disks, 0 until two reads of diskstats */
+    DiskInfo disks[SYSTEM_MAX_DISKS]; /**< Whole disks, in /proc/diskstats order */
 } SystemInfo;
 
 /**
@@ -36,9 +66,85 @@ typedef struct SystemInfo {
 int get_process_info(pid_t pid, ProcessNode* info);
 
 /**
- * @brief Fetches global system resource statistics (CPU, Mem, Swap, Tasks).
- * @param sys_info Pointer to SystemInfo struct to populate.
+ * @struct SystemSampler
+ * @brief Open descriptors of the system-wide /proc files, and the last two
+ *        reads of /proc/stat.
+ *
+ * The files are opened once and re-read with pread() at offset 0 on every
+ * sample, so the system header costs eight reads and no open or close. The
+ * process table owns one, since per-process CPU% is measured against the same
+ * /proc/stat reads as the CPU meters.
+ */
+typedef struct SystemSampler {
+    int      stat_fd;                          /**< /proc/stat, or -1 */
+    int      meminfo_fd;                       /**< /proc/meminfo, or -1 */
+    int      loadavg_fd;                       /**< /proc/loadavg, or -1 */
+    int      uptime_fd;                        /**< /proc/uptime, or -1 */
+    int      pressure_fds[PRESSURE_RESOURCES]; /**< /proc/pressure/<resource>, or -1 without PSI */
+    CpuStat  cpu_stats[2];                     /**< Storage of the two /proc/stat reads */
+    CpuStat* cpu;                              /**< Latest /proc/stat read */
+    CpuStat* cpu_prev;                         /**< The read before, zeroed until there is one */
+
+    int           diskstats_fd;                /**< /proc/diskstats, or -1 */
+    DiskCounters  disks[PROC_MAX_DISKS];       /**< Previous read of every device */
+    unsigned char disk_whole[PROC_MAX_DISKS];  /**< Non-zero for the devices that are shown */
+    int           disk_count;                  /**< Entries in disks */
+    long long     disk_time_ms;                /**< Monotonic time of that read, 0 before it */
+} SystemSampler;
+
+/**
+ * @brief Opens the system-wide /proc files.
+ *
+ * A file that cannot be opened leaves its values at 0 in every sample.
+ *
+ * @param sampler Sampler to initialize; must not be moved afterwards.
+ */
+void system_sampler_init(SystemSampler* sampler);
+
+/**
+ * @brief Reads /proc/stat, keeping the previous read.
+ * @param sampler Initialized sampler.
+ * @return Clock ticks of all CPUs since the previous read, 0 if either read failed.
+ */
+unsigned long long system_sampler_read_cpu(SystemSampler* sampler);
+
+/**
+ * @brief Fills the system statistics of a sample.
+ *
+ * Memory, swap, load, uptime, pressure, and disk counters are read now; the
+ * CPU figures come from the last two system_sampler_read_cpu() calls. Disk
+ * throughput is the change since the previous call, for whole disks other
+ * than loop, RAM, and zram devices. Task counts are passed in because
+ * snapshot_build() already counts them while copying the processes.
+ *
+ * @param sampler Initialized sampler.
+ * @param sys_info Destination; fields without data are 0.
+ * @param total_tasks Number of processes in the sample.
+ * @param running_tasks Number of those in state R.
+ */
+void system_sampler_collect(SystemSampler* sampler, SystemInfo* sys_info, int total_tasks,
+                            int running_tasks);
+
+/**
+ * @brief Closes the files.
+ * @param sampler Sampler to release.
+ */
+void system_sampler_free(SystemSampler* sampler);
+
+/**
+ * @brief Opens a PSI trigger on a system-wide pressure file.
+ *
+ * The kernel signals POLLPRI on the returned descriptor when the tasks were
+ * stalled on @p resource for more than @p stall_us within any @p window_us.
+ * Windows must be between 500 ms and 10 s; unprivileged triggers need a
+ * window that is a multiple of 2 s.
+ *
+ * @param resource Resource to watch.
+ * @param full Non-zero to trigger on "full" stalls instead of "some".
+ * @param stall_us Stall time that fires the trigger.
+ * @param window_us Tracking window.
+ * @return int The descriptor, or -1 if PSI or the trigger is not available.
  */
-void get_system_info(SystemInfo* sys_info, ProcessNode* head);
+int psi_trigger_open(PressureResource resource, int full, long stall_us, long window_us);
 
 #endif  // PROCX_SYS_INFO_H
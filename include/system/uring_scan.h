@@ -0,0 +1,54 @@
+/**
+ * @file uring_scan.h
+ * @brief io_uring-backed collection backend that batches /proc/[pid] reads.
+ * @version 2.0.1
+ */
+
+#ifndef PROCX_URING_SCAN_H
+#define PROCX_URING_SCAN_H
+
+#include "../core/process.h"
+
+/** @brief Number of processes whose files are opened and read per batch. */
+#define URING_SCAN_BATCH 128
+
+/**
+ * @struct UringScanner
+ * @brief Opaque io_uring instance plus the read buffers of one batch.
+ */
+typedef struct UringScanner UringScanner;
+
+/**
+ * @brief Creates an io_uring scanner.
+ * @return Pointer to the scanner, or NULL if io_uring is unavailable (old kernel,
+ *         disabled by sysctl, blocked by seccomp) or memory is short.
+ */
+UringScanner* uring_scan_create();
+
+/**
+ * @brief Parses a batch of processes through io_uring.
+ *
+ * For every group of URING_SCAN_BATCH PIDs, the per-PID directories are
+ * opened, then stat and the wanted ones of statm and status are opened, read,
+ * and closed, each stage submitted with a single io_uring_enter(). Contents
+ * are parsed with proc_parse_files(), so the output is identical to
+ * scan_parse_range().
+ *
+ * @param scanner Scanner to use.
+ * @param root_fd Descriptor of the /proc directory.
+ * @param files ProcFile bits of the files to read besides stat.
+ * @param pids PIDs to parse.
+ * @param out Output array with one entry per PID (same contract as scan_pool_parse()).
+ * @param count Number of PIDs.
+ * @return int 0 on success, -1 if the ring failed and the caller should fall back.
+ */
+int uring_scan_parse(UringScanner* scanner, int root_fd, int files, const pid_t* pids,
+                     ProcessNode* out, int count);
+
+/**
+ * @brief Destroys the scanner and releases its ring and buffers.
+ * @param scanner Scanner to destroy (may be NULL).
+ */
+void uring_scan_destroy(UringScanner* scanner);
+
+#endif  // PROCX_URING_SCAN_H
@@ -0,0 +1,88 @@
+/**
+ * @file user_cache.h
+ * @brief Process-wide UID to username cache, resolved off the sampling path.
+ * @version 2.0.1
+ */
+
+#ifndef PROCX_USER_CACHE_H
+#define PROCX_USER_CACHE_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+/** @brief Longest username kept, including the terminator; longer names are cut. */
+#define USER_CACHE_NAME_LEN 32
+
+/** @brief Default interval between two checks of the passwd file. */
+#define USER_CACHE_CHECK_MS 5000
+
+/** @brief Default age after which every cached name is resolved again. */
+#define USER_CACHE_REFRESH_MS 600000
+
+/**
+ * @struct UserCacheStats
+ * @brief Counters of the cache, for tests and benchmarks.
+ */
+typedef struct UserCacheStats {
+    int           users;     /**< UIDs in the cache */
+    int           pending;   /**< UIDs waiting for the resolver */
+    unsigned long lookups;   /**< getpwuid_r() calls made so far */
+    unsigned long refreshes; /**< Times every name was queued again */
+} UserCacheStats;
+
+/**
+ * @brief Copies the name of @p uid into @p out without ever blocking on NSS.
+ *
+ * The first sight of a UID stores its number as a placeholder name and wakes
+ * the resolver thread, which runs getpwuid_r() and replaces the placeholder;
+ * the thread is started by the first lookup. Each UID is resolved once, then
+ * again when the passwd file changes or its name is USER_CACHE_REFRESH_MS old,
+ * and the old name is kept until the new one is known.
+ *
+ * @param uid User ID to look up.
+ * @param out Destination buffer.
+ * @param size Size of @p out in bytes.
+ * @return int 1 if the name was resolved, 0 if @p out holds the placeholder.
+ */
+int user_cache_lookup(uid_t uid, char* out, size_t size);
+
+/**
+ * @brief Returns a counter incremented whenever a cached name changes.
+ *
+ * While it stays the same, a name copied from the cache earlier is still
+ * current, so callers only look up again for UIDs they have not seen.
+ */
+unsigned int user_cache_generation();
+
+/**
+ * @brief Queues every cached UID to be resolved again, keeping the names until then.
+ */
+void user_cache_invalidate();
+
+/**
+ * @brief Waits until the resolver has no pending UID.
+ * @param timeout_ms Longest wait in milliseconds.
+ * @return int 0 once nothing is pending, -1 on timeout.
+ */
+int user_cache_wait(int timeout_ms);
+
+/**
+ * @brief Changes the watched passwd file and the timers; meant for tests.
+ * @param passwd_path File whose changes invalidate the cache, NULL for /etc/passwd.
+ * @param check_ms Interval between two checks of that file.
+ * @param refresh_ms Age after which every name is resolved again.
+ */
+void user_cache_configure(const char* passwd_path, int check_ms, int refresh_ms);
+
+/**
+ * @brief Fills @p stats with the current counters.
+ */
+void user_cache_stats(UserCacheStats* stats);
+
+/**
+ * @brief Stops the resolver thread and empties the cache; the next lookup
+ *        starts over with the default settings.
+ */
+void user_cache_shutdown();
+
+#endif  // PROCX_USER_CACHE_H
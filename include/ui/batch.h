@@ -0,0 +1,178 @@
+/**
+ * @file batch.h
+ * @brief Headless batch mode: streams samples to a file descriptor as JSON Lines or CSV.
+ * @version 2.0.1
+ */
+
+#ifndef PROCX_BATCH_H
+#define PROCX_BATCH_H
+
+#include "../system/profile.h"
+#include "../system/sampler.h"
+#include "../system/snapshot.h"
+#include <stddef.h>
+
+/** @brief Size of the output buffer; records are written in chunks of this size. */
+#define BATCH_BUFFER_SIZE (256 * 1024)
+
+/** @brief Maximum number of fields in one record. */
+#define BATCH_MAX_FIELDS 16
+
+/**
+ * @enum BatchFormat
+ * @brief Record format.
+ */
+typedef enum BatchFormat {
+    BATCH_FORMAT_JSON = 0, /**< One JSON object per process and line */
+    BATCH_FORMAT_CSV,      /**< RFC 4180 CSV with a header line */
+    BATCH_FORMAT_NONE      /**< No output; samples are only counted, e.g. while recording */
+} BatchFormat;
+
+/**
+ * @enum BatchField
+ * @brief Column of a record.
+ */
+typedef enum BatchField {
+    BATCH_FIELD_TIME = 0, /**< Sample time, seconds since the epoch with milliseconds */
+    BATCH_FIELD_PID,      /**< Process ID */
+    BATCH_FIELD_PPID,     /**< Parent process ID */
+    BATCH_FIELD_UID,      /**< Owner's user ID */
+    BATCH_FIELD_USER,     /**< Owner's user name */
+    BATCH_FIELD_STATE,    /**< State letter */
+    BATCH_FIELD_PRI,      /**< Kernel priority */
+    BATCH_FIELD_NICE,     /**< Nice value */
+    BATCH_FIELD_THREADS,  /**< Thread count */
+    BATCH_FIELD_CPU,      /**< CPU usage in percent */
+    BATCH_FIELD_MEM,      /**< Resident memory in KB */
+    BATCH_FIELD_NAME,     /**< Command name */
+    BATCH_FIELD_READ,     /**< Bytes read from storage per second, -1 if unknown */
+    BATCH_FIELD_WRITE,    /**< Bytes written to storage per second, -1 if unknown */
+    BATCH_FIELD_SYSCALLS, /**< Read and write system calls per second, -1 if unknown */
+    BATCH_FIELD_VSZ,      /**< Virtual memory size in KB, -1 if unknown */
+    BATCH_FIELD_ANON,     /**< Resident anonymous memory in KB, -1 if unknown */
+    BATCH_FIELD_FILE,     /**< Resident file-backed memory in KB, -1 if unknown */
+    BATCH_FIELD_SHMEM,    /**< Resident shared memory in KB, -1 if unknown */
+    BATCH_FIELD_SWAP,     /**< Swapped-out memory in KB, -1 if unknown */
+    BATCH_FIELD_PSS,      /**< Proportional set size in KB, -1 if unknown */
+    BATCH_FIELD_USS,      /**< Unique set size in KB, -1 if unknown */
+    BATCH_FIELD_COUNT     /**< Number of fields */
+} BatchField;
+
+/**
+ * @struct BatchOptions
+ * @brief What to emit and how often.
+ */
+typedef struct BatchOptions {
+    BatchFormat     format;                   /**< Record format */
+    BatchField      fields[BATCH_MAX_FIELDS]; /**< Columns, in output order */
+    int             field_count;              /**< Number of columns */
+    long            count;                    /**< Samples to emit, 0 for no limit */
+    int             top;                      /**< Processes per sample, 0 for all */
+    const SortSpec* sort;                     /**< Order of the processes in a sample */
+    int             profile_fd;               /**< Receives a profile record per sample, or -1 */
+} BatchOptions;
+
+/**
+ * @struct BatchWriter
+ * @brief Buffered writer that formats records without stdio.
+ */
+typedef struct BatchWriter {
+    int    fd;     /**< Destination descriptor */
+    char*  buffer; /**< BATCH_BUFFER_SIZE bytes of pending output */
+    size_t length; /**< Bytes pending in buffer */
+    int    error;  /**< errno of the first failed write, 0 if none */
+} BatchWriter;
+
+/**
+ * @brief Sets the default fields (time, pid, user, state, cpu, mem, threads,
+ *        name), JSON, no count or top limit, no sort order, and no profile records.
+ * @param options Options to initialize.
+ */
+void batch_options_init(BatchOptions* options);
+
+/**
+ * @brief Parses a comma-separated field list such as "pid,cpu,name".
+ * @param options Options whose field list is replaced on success.
+ * @param list Field names: time, pid, ppid, uid, user, state, pri, nice,
+ *             threads, cpu, mem, name, read, write, syscalls, vsz, anon,
+ *             file, shmem, swap, pss, uss.
+ * @param error Buffer for a message naming the first bad field.
+ * @param error_size Size of @p error.
+ * @return int 0 on success, -1 on an unknown or excess field.
+ */
+int batch_parse_fields(BatchOptions* options, const char* list, char* error, size_t error_size);
+
+/**
+ * @brief Returns the per-process files the fields and the sort order are read from.
+ *
+ * The result is a set of ProcFile bits for sampler_set_files(). With
+ * PROC_FILE_ROLLUP set, every process has to be measured; see
+ * sampler_set_memory().
+ */
+int batch_files(const BatchOptions* options);
+
+/**
+ * @brief Prepares a writer for @p fd.
+ * @return int 0 on success, -1 if the buffer cannot be allocated.
+ */
+int batch_writer_init(BatchWriter* writer, int fd);
+
+/**
+ * @brief Writes the CSV header line; does nothing for JSON.
+ */
+void batch_emit_header(BatchWriter* writer, const BatchOptions* options);
+
+/**
+ * @brief Appends one record per process for the first @p limit display
+ *        positions of a snapshot. Output is only written once the buffer fills.
+ * @param writer Destination.
+ * @param options Format and fields.
+ * @param snapshot Sorted snapshot.
+ * @param limit Number of leading positions to emit.
+ * @param time_ms Sample time in milliseconds since the epoch.
+ */
+void batch_emit_sample(BatchWriter* writer, const BatchOptions* options,
+                       const ProcessSnapshot* snapshot, int limit, long long time_ms);
+
+/**
+ * @brief Appends one JSON line of ProcX's own cost.
+ *
+ * The line holds the sample time; the last, median, and 99th percentile
+ * duration of every phase in nanoseconds, -1 for a phase that never ran; the
+ * counters' increase over the last sample; and ProcX's CPU% and RSS in KB.
+ *
+ * @param writer Destination.
+ * @param profiler History fed with the samples so far.
+ * @param time_ms Sample time in milliseconds since the epoch.
+ */
+void batch_emit_profile(BatchWriter* writer, const Profiler* profiler, long long time_ms);
+
+/**
+ * @brief Writes everything pending.
+ * @return int 0 on success, -1 if a write failed (see BatchWriter::error).
+ */
+int batch_writer_flush(BatchWriter* writer);
+
+/**
+ * @brief Frees the writer's buffer without flushing.
+ */
+void batch_writer_free(BatchWriter* writer);
+
+/**
+ * @brief Runs batch mode on a started sampler until the sample count is
+ *        reached or standard output fails.
+ *
+ * The first sample only establishes the CPU baseline and is not emitted. Each
+ * later sample is sorted, cut to the top-N, written to standard output, and
+ * flushed. If the consumer is slower than the interval, intermediate samples
+ * are skipped rather than queued. With a @c profile_fd, profiling is enabled
+ * for the run and each emitted sample is followed by batch_emit_profile() on
+ * that descriptor, also with BATCH_FORMAT_NONE.
+ *
+ * @param sampler Running sampler.
+ * @param options What to emit.
+ * @return int 0 on success, 1 on an output error.
+ */
+int batch_run(Sampler* sampler, const BatchOptions* options);
+
+#endif  // PROCX_BATCH_H
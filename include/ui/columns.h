@@ -0,0 +1,172 @@
+/**
+ * @file columns.h
+ * @brief Registry of the dashboard's process columns: what each shows, how it is
+ *        formatted, which /proc files it is read from, and how it sorts.
+ * @version 2.0.1
+ */
+
+#ifndef PROCX_COLUMNS_H
+#define PROCX_COLUMNS_H
+
+#include "../core/process.h"
+#include "../system/snapshot.h"
+#include <stddef.h>
+
+/** @brief Size of a formatted cell, enough for a full command name. */
+#define COLUMN_CELL_SIZE 256
+
+/**
+ * @enum ColumnId
+ * @brief Process column, indexing the registry.
+ */
+typedef enum ColumnId {
+    COLUMN_PID = 0,  /**< Process ID */
+    COLUMN_USER,     /**< Owner's user name */
+    COLUMN_PRI,      /**< Kernel priority */
+    COLUMN_NICE,     /**< Nice value */
+    COLUMN_VSZ,      /**< Virtual memory size in MB */
+    COLUMN_MEM,      /**< Resident memory in MB */
+    COLUMN_THREADS,  /**< Thread count */
+    COLUMN_READ,     /**< Bytes read from storage per second */
+    COLUMN_WRITE,    /**< Bytes written to storage per second */
+    COLUMN_SYSCALLS, /**< Read and write system calls per second */
+    COLUMN_PSS,      /**< Proportional set size in MB */
+    COLUMN_USS,      /**< Unique set size in MB */
+    COLUMN_SWAP,     /**< Swapped-out memory in MB */
+    COLUMN_STATE,    /**< State as a word */
+    COLUMN_CPU,      /**< CPU usage in percent */
+    COLUMN_NAME,     /**< Command name; takes the rest of the line */
+    COLUMN_COUNT     /**< Number of columns */
+} ColumnId;
+
+/**
+ * @enum ColumnColor
+ * @brief Color a formatter asks for; the dashboard maps it to a color pair.
+ */
+typedef enum ColumnColor {
+    COLUMN_COLOR_DEFAULT = 0, /**< Terminal default */
+    COLUMN_COLOR_CYAN,        /**< Identifiers, sleeping processes */
+    COLUMN_COLOR_YELLOW,      /**< CPU usage, waiting processes */
+    COLUMN_COLOR_GREEN,       /**< Running processes */
+    COLUMN_COLOR_RED,         /**< Zombies */
+    COLUMN_COLOR_MAGENTA,     /**< Stopped processes */
+    COLUMN_COLOR_DIM          /**< Idle kernel threads */
+} ColumnColor;
+
+/**
+ * @enum ColumnMode
+ * @brief Which detail columns the dashboard shows; switched with I and M.
+ */
+typedef enum ColumnMode {
+    COLUMN_MODE_DEFAULT = 0, /**< The columns as configured */
+    COLUMN_MODE_IO,          /**< READ/s, WRITE/s, and SYSC/s as the detail columns */
+    COLUMN_MODE_MEMORY       /**< PSS, USS, and SWAP as the detail columns */
+} ColumnMode;
+
+/**
+ * @struct Column
+ * @brief Declaration of one column.
+ *
+ * Neighbouring detail columns are separated by a space and form one group,
+ * which the I and M modes swap as a whole; other columns are separated by a
+ * rule. @c files lists the ProcFile bits of the files the value is parsed
+ * from, so a column that is not shown costs nothing to sample.
+ */
+typedef struct Column {
+    const char*     name;         /**< Name in --columns, as in batch --fields */
+    const char*     header;       /**< Header label */
+    int             width;        /**< Width in cells, 0 for the rest of the line */
+    int             right;        /**< Non-zero to right-align the header and values */
+    int             detail;       /**< Non-zero for a column of the swappable detail group */
+    int             files;        /**< ProcFile bits the value is read from */
+    const SortSpec* sort;         /**< Order selected from this column, or NULL */
+    const char*     sort_name;    /**< Name of @c sort for --sort, or NULL */
+    int             function_key; /**< Function key number that selects @c sort, or 0 */
+
+    /**
+     * @brief Formats the value of a process into @p out, unpadded.
+     * @return int The ColumnColor to draw it in.
+     */
+    int (*format)(char* out, size_t size, const ProcessNode* proc);
+} Column;
+
+/** @brief The registry, indexed by ColumnId. */
+extern const Column columns[COLUMN_COUNT];
+
+/**
+ * @struct ColumnSet
+ * @brief Columns of the process list, left to right.
+ */
+typedef struct ColumnSet {
+    int      count;             /**< Number of columns */
+    ColumnId ids[COLUMN_COUNT]; /**< Columns, each at most once */
+} ColumnSet;
+
+/**
+ * @brief Sets the default columns: pid, user, pri, nice, vsz, mem, state, cpu, name.
+ * @param set Set to fill.
+ */
+void column_set_default(ColumnSet* set);
+
+/**
+ * @brief Parses a comma-separated column list such as "pid,cpu,name".
+ * @param set Set that is replaced on success.
+ * @param list Column names from the registry; name, if given, must be last.
+ * @param error Buffer for a message naming the first bad column.
+ * @param error_size Size of @p error.
+ * @return int 0 on success, -1 on an unknown, repeated, or misplaced column.
+ */
+int column_set_parse(ColumnSet* set, const char* list, char* error, size_t error_size);
+
+/**
+ * @brief Returns the per-process files the columns of a set are read from.
+ * @param set Columns shown.
+ * @return int ProcFile bits for sampler_set_files(); always includes PROC_FILE_STAT.
+ */
+int column_set_files(const ColumnSet* set);
+
+/**
+ * @brief Applies a detail mode to a set of columns.
+ *
+ * The I/O and memory modes remove every detail column of @p base and put
+ * their own where the first one was. Without detail columns, they go before
+ * the first of state, cpu, and name, or at the end.
+ *
+ * @param base Columns as configured.
+ * @param mode Mode to apply.
+ * @param out Columns to show.
+ */
+void column_set_mode(const ColumnSet* base, ColumnMode mode, ColumnSet* out);
+
+/**
+ * @brief Returns the column whose order a function key selects.
+ * @param function_key Function key number, such as 3 for F3.
+ * @return const Column* The column, or NULL if the key selects no order.
+ */
+const Column* column_by_key(int function_key);
+
+/**
+ * @brief Returns the order named in --sort.
+ * @param name cpu, mem, name, pid, io, or pss.
+ * @return const SortSpec* The order, or NULL for an unknown name.
+ */
+const SortSpec* column_sort_named(const char* name);
+
+/**
+ * @brief Formats a rate, scaling bytes to K, M, G, and T, or "-" if it is unknown.
+ * @param out Destination buffer, left unpadded.
+ * @param size Size of @p out.
+ * @param per_second Rate, negative if unknown.
+ * @param bytes Non-zero to scale bytes to K, M, G, and T.
+ */
+void column_format_rate(char* out, size_t size, float per_second, int bytes);
+
+/**
+ * @brief Formats a size in KB as MB with one decimal, or "-" if it is unknown.
+ * @param out Destination buffer, left unpadded.
+ * @param size Size of @p out.
+ * @param kb Size in KB, negative if unknown.
+ */
+void column_format_size(char* out, size_t size, long kb);
+
+#endif  // PROCX_COLUMNS_H
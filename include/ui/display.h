@@ -8,6 +8,12 @@
 #define PROCX_DISPLAY_H
 
 #include "../core/process.h"
+#include "../system/cgroup.h"
+#include "../system/process_tree.h"
+#include "../system/profile.h"
+#include "../system/snapshot.h"
+#include "../system/sys_info.h"
+#include "columns.h"
 
 /**
  * @brief Initializes the ncurses user interface.
@@ -16,14 +22,71 @@ void init_ui();
 
 /**
  * @brief Renders the main aesthetic dashboard.
- * @param head Pointer to the process list.
+ *
+ * Each region (meter lines, filter line, table header, and every process row)
+ * is redrawn only when a value it shows has changed since the last frame, and
+ * the terminal is not refreshed at all when nothing did. A terminal resize
+ * redraws everything.
+ *
+ * @param snapshot Processes to show, in display order.
+ * @param tree Hierarchy applied to @p snapshot, to draw the tree view, or NULL
+ *             for the flat list.
+ * @param cgroups Cgroups to list instead of the processes, or NULL. Rows,
+ *                scrolling, and the selection then refer to cgroups.
+ * @param sys_info System statistics sampled with @p snapshot.
  * @param scroll_offset Number of rows to skip.
  * @param selection_idx Index of the currently selected process.
- * @param search_query Current search string.
- * @param sort_col Current sorting column name.
+ * @param search_query Current filter expression, shown above the table.
+ * @param sort Order of @p snapshot; the header highlights the columns it is
+ *             selected from.
+ * @param short_lived Processes that exited between samples, or -1 when not tracked.
  */
-void render_dashboard(ProcessNode* head, int scroll_offset, int selection_idx,
-                      const char* search_query, const char* sort_col);
+void render_dashboard(const ProcessSnapshot* snapshot, const ProcessTree* tree,
+                      const CgroupList* cgroups, const SystemInfo* sys_info, int scroll_offset,
+                      int selection_idx, const char* search_query, const SortSpec* sort,
+                      long short_lived);
+
+/**
+ * @brief Forces the next render_dashboard() to redraw the whole screen.
+ *
+ * Needed after drawing on stdscr outside of render_dashboard(), such as the
+ * filter prompt. Overlay dialogs of this module restore the screen by themselves.
+ */
+void dashboard_invalidate();
+
+/**
+ * @brief Sets a status line shown between the meters and the filter line.
+ *
+ * Replay uses it for the position in the recording. Like every other region,
+ * the line is only redrawn when its text changes.
+ *
+ * @param status Text to show, or an empty string for none.
+ */
+void dashboard_set_status(const char* status);
+
+/**
+ * @brief Sets the columns of the process list, left to right.
+ *
+ * Each row is formatted by the registry in columns.h. The values come from
+ * the files listed in the columns' declarations, so the sampler must read
+ * them; see column_set_files() and sampler_set_files(). init_ui() sets the
+ * default columns.
+ *
+ * @param set Columns to show.
+ */
+void dashboard_set_columns(const ColumnSet* set);
+
+/**
+ * @brief Number of process rows render_dashboard() can show in the current terminal.
+ * @return int Row count (0 if the terminal is too small).
+ */
+int dashboard_rows();
+
+/**
+ * @brief Screen line of the filter line, which moves down with the per-core meters.
+ * @return int Line number.
+ */
+int dashboard_filter_line();
 
 /**
  * @brief Renders the help overlay.
@@ -37,6 +100,25 @@ void render_help();
  */
 int render_confirmation(int pid);
 
+/**
+ * @brief Renders a dialog explaining why a filter expression was rejected.
+ * @param error Message from filter_compile().
+ */
+void render_filter_error(const char* error);
+
+/**
+ * @brief Draws the self-profiling overlay over the bottom right of the process list.
+ *
+ * Unlike the other overlays it does not wait for a key: it is drawn after
+ * every render_dashboard() while shown, and the caller invalidates the
+ * dashboard once it is hidden. Each phase shows its last, median, and 99th
+ * percentile duration, followed by the counters of the last sample and
+ * ProcX's own CPU% and RSS.
+ *
+ * @param profiler History to summarize.
+ */
+void render_profile(const Profiler* profiler);
+
 /**
  * @brief Renders a detailed process view.
  * @param proc Pointer to the process to display.
@@ -9,59 +9,314 @@
 #endif
 
 #include "../include/ui/display.h"
+#include "../include/system/cgroup.h"
 #include "../include/system/process_list.h"
+#include "../include/system/process_tree.h"
+#include "../include/system/snapshot.h"
+#include "../include/system/sampler.h"
+#include "../include/system/recorder.h"
+#include "../include/system/profile.h"
+#include "../include/system/user_cache.h"
+#include "../include/ui/batch.h"
+#include "../include/ui/columns.h"
 #include <ncurses.h>
 #include <stdlib.h>
 #include <string.h>
 #include <signal.h>
+#include <stdio.h>
+#include <getopt.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <time.h>
 #include <sys/resource.h>
 
 /**
- * @brief Main function of the ProcX application.
+ * @brief Prints command-line usage.
  */
-int main() {
-    init_ui();
-    nodelay(stdscr, TRUE);
+static void print_usage(const char* prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  -w, --workers N   Parse /proc with N threads (default: online CPUs, max 16)\n");
+    printf("  -b, --backend B   Collection backend: sync (default) or uring\n");
+    printf("  -e, --events      Track process births and deaths with proc connector events\n");
+    printf("  -x, --exit-log F  Append short-lived process exits to F (implies --events)\n");
+    printf("  -d, --interval MS Sampling interval in milliseconds (default: 1000)\n");
+    printf("      --batch       Write samples to standard output instead of the dashboard\n");
+    printf("  -f, --format F    Batch record format: json (JSON Lines, default), csv, or none\n");
+    printf("  -n, --count N     Stop after N batch samples (default: run until killed)\n");
+    printf("      --columns L   Dashboard columns, comma-separated (default:\n");
+    printf("                    pid,user,pri,nice,vsz,mem,state,cpu,name)\n");
+    printf("      --fields L    Batch fields, comma-separated (default:\n");
+    printf("                    time,pid,user,state,cpu,mem,threads,name)\n");
+    printf("  -s, --sort K      Batch order: cpu (default), mem, name, pid, io, or pss\n");
+    printf("  -t, --top N       Emit only the first N processes of each batch sample\n");
+    printf("  -R, --record F    Record every sample into the ring file F\n");
+    printf("      --record-size MB  Size of the ring file (default: 64)\n");
+    printf("  -P, --replay F    Browse a recording instead of the live system\n");
+    printf("      --trigger-cpu PCT  Sample faster while total CPU%% is at least PCT\n");
+    printf("      --burst-interval MS  Interval while triggered (default: 100)\n");
+    printf("      --burst-window S  Stay fast for S seconds after the last trigger\n");
+    printf("                    (default: 60)\n");
+    printf("      --psi-trigger R[:full]:MS  Sample at once when tasks stall on R (cpu, memory,\n");
+    printf("                    or io) for MS ms within 2 s; repeatable\n");
+    printf("      --pss-age MS  Measure a process's PSS and USS at most every MS ms\n");
+    printf("                    (default: 5000)\n");
+    printf("      --profile F   Append ProcX's own cost per batch sample to F as JSON Lines\n");
+    printf("      --proc-root D Read D instead of /proc, such as a generated fixture\n");
+    printf("  -h, --help        Show this help and exit\n");
+}
 
-    int  ch;
-    int  scroll_offset                          = 0;
-    int  selection_idx                          = 0;
-    int  refresh_rate                           = 1000;  // ms
-    char search_query[64]                       = "";
-    char sort_col[10]                           = "CPU%";
-    int (*sort_cmp)(ProcessNode*, ProcessNode*) = cmp_cpu;
+/** @brief Tracking window of --psi-trigger; unprivileged triggers need a multiple of 2 s. */
+#define PSI_TRIGGER_WINDOW_MS 2000
 
-    while (1) {
-        timeout(refresh_rate);
-        ProcessNode* process_list = build_process_list();
+/**
+ * @struct PsiTriggerSpec
+ * @brief One --psi-trigger option.
+ */
+typedef struct PsiTriggerSpec {
+    PressureResource resource; /**< Resource to watch */
+    int              full;     /**< Non-zero for "full" stalls, "some" otherwise */
+    int              stall_ms; /**< Stall time within the window that fires the trigger */
+} PsiTriggerSpec;
 
-        // Apply sorting
-        if (sort_cmp) {
-            sort_process_list(&process_list, sort_cmp);
+/**
+ * @brief Parses "cpu:100" or "memory:full:50" into a trigger.
+ * @return int 0 on success, -1 if the text is not RESOURCE[:full]:MS.
+ */
+static int parse_psi_trigger(const char* text, PsiTriggerSpec* spec) {
+    const char* colon = strchr(text, ':');
+    if (!colon) return -1;
+    size_t len     = (size_t)(colon - text);
+    spec->resource = PRESSURE_RESOURCES;
+    for (int i = 0; i < PRESSURE_RESOURCES; i++) {
+        const char* name = proc_pressure_names[i];
+        if (strlen(name) == len && strncmp(text, name, len) == 0) {
+            spec->resource = (PressureResource)i;
         }
+    }
+    if (spec->resource == PRESSURE_RESOURCES) return -1;
+
+    const char* value = colon + 1;
+    spec->full        = strncmp(value, "full:", 5) == 0;
+    if (spec->full) value += 5;
+    char* end;
+    long  ms = strtol(value, &end, 10);
+    if (end == value || *end != '\0' || ms < 1 || ms >= PSI_TRIGGER_WINDOW_MS) return -1;
+    spec->stall_ms = (int)ms;
+    return 0;
+}
+
+/**
+ * @brief Returns the process at a position of the filtered view, or NULL.
+ */
+static ProcessNode* find_filtered(const ProcessSnapshot* snapshot, int index) {
+    if (index < 0 || index >= snapshot->matched) return NULL;
+    return snapshot_at(snapshot, index);
+}
+
+/**
+ * @brief Lists the processes whose PSS and USS the dashboard needs.
+ *
+ * That is every process while sorted by PSS, and otherwise the selected one
+ * plus, while PSS or USS is shown, those of the rows on screen.
+ * Thread rows stand for their process.
+ */
+static void dashboard_memory_view(MemoryView* view, const ProcessSnapshot* snapshot, int first,
+                                  int rows, int selected, int all) {
+    view->all = all;
+    if (all) return;
+    int last = first + rows < snapshot->matched ? first + rows : snapshot->matched;
+    for (int i = first; i < last; i++) {
+        const ProcessNode* proc = snapshot_at(snapshot, i);
+        memory_view_add(view, proc->thread_of ? proc->thread_of : proc->pid);
+    }
+    const ProcessNode* proc = find_filtered(snapshot, selected);
+    if (proc) memory_view_add(view, proc->thread_of ? proc->thread_of : proc->pid);
+}
+
+/**
+ * @brief Shows the position of a replay in the dashboard's status line.
+ */
+static void replay_status(const Replay* replay) {
+    char      when[32];
+    time_t    seconds = (time_t)(replay->sample.time_ms / 1000);
+    struct tm tm;
+    localtime_r(&seconds, &tm);
+    strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &tm);
+
+    char status[160];
+    snprintf(status, sizeof(status),
+             "REPLAY %s.%03lld  sample %ld/%ld   ←/→ step  PgUp/PgDn 10  Home/End",
+             when, replay->sample.time_ms % 1000, replay->index + 1, replay_frames(replay));
+    dashboard_set_status(status);
+}
+
+/**
+ * @brief Runs the interactive dashboard until the user quits.
+ *
+ * Live mode takes each sample published by @p sampler; replay mode shows the
+ * current frame of @p replay and moves through the recording with the arrow,
+ * page, Home, and End keys. Exactly one of the two is non-NULL.
+ *
+ * @param base Columns as configured; I and M swap their detail columns.
+ * @param pss_age_ms Age at which the sampler measures a shown process's PSS again.
+ */
+static void run_dashboard(Sampler* sampler, Replay* replay, const ColumnSet* base,
+                          int pss_age_ms) {
+    int             ch;
+    int             scroll_offset    = 0;
+    int             selection_idx    = 0;
+    char            search_query[64] = "";
+    const SortSpec* sort_spec        = column_sort_named("cpu");
+    int             sort_dirty       = 1;
+    int             filter_dirty     = 1;
+
+    // The filter is compiled once when entered and evaluated once per snapshot.
+    Filter filter;
+    filter_init(&filter);
+
+    // Processes whose threads are listed below them; the sampler reads them.
+    ThreadView threads;
+    thread_view_init(&threads);
+
+    // Tree view: rebuilt for every new sample, filter, or order; collapsing
+    // a subtree only walks it again.
+    ProcessTree  tree;
+    TreeCollapse collapse;
+    int          tree_view  = 0;
+    int          tree_ready = 0;
+    int          fold_dirty = 0;
+    process_tree_init(&tree);
+    tree_collapse_init(&collapse);
+
+    // Cgroup view: the sampler only walks the hierarchy while it is shown or
+    // while the process list is restricted to one cgroup (drill_id).
+    int                cgroup_view = 0;
+    unsigned long long drill_id    = 0;
 
-        render_dashboard(process_list, scroll_offset, selection_idx, search_query, sort_col);
+    // Columns: the sampler reads only the files that the shown columns, the
+    // order, and the filter need; -1 until the first frame sets them.
+    ColumnMode column_mode = COLUMN_MODE_DEFAULT;
+    ColumnSet  shown       = *base;
+    int        files_read  = -1;
+    dashboard_set_columns(&shown);
 
+    // PSS and USS: smaps_rollup is read for the rows on screen and the
+    // selected process, or for every process while sorted by PSS.
+    MemoryView memory;
+    memory_view_init(&memory, pss_age_ms);
+
+    // Self-profiling: the timers and counters only run while P shows them.
+    Profiler profiler;
+    int      profiling = 0;
+    profiler_init(&profiler);
+
+    // Without a sampler, poll() skips the negative descriptor.
+    struct pollfd wait_fds[2] = {{STDIN_FILENO, POLLIN, 0},
+                                 {sampler ? sampler_fd(sampler) : -1, POLLIN, 0}};
+
+    while (1) {
+        // A new sample replaces the snapshot; the filter then selects the
+        // visible processes, of which only the rows up to the bottom of the
+        // screen are ranked. Keys never trigger a rescan.
+        if (sampler && sampler_take(sampler)) {
+            filter_dirty = 1;
+            if (profiling) profiler_add_pass(&profiler, &sampler->front->profile);
+        }
+        int files = column_set_files(&shown) | snapshot_sort_files(sort_spec) |
+                    filter_files(&filter);
+        if (sampler && files != files_read) {
+            sampler_set_files(sampler, files);
+            files_read = files;
+        }
+        Sample*          sample   = sampler ? sampler->front : &replay->sample;
+        ProcessSnapshot* snapshot = &sample->snapshot;
+        if (replay) replay_status(replay);
+        // The tree view leaves only the visible rows in the order, so a new
+        // sort starts again from the filter.
+        if (tree_view && sort_dirty) filter_dirty = 1;
+        if (filter_dirty) {
+            PROFILE_BEGIN(filter_start);
+            snapshot_filter(snapshot, &filter);
+            if (drill_id) cgroup_list_restrict(&sample->cgroups, drill_id, snapshot);
+            PROFILE_ADD(&profiler, PROFILE_FILTER, filter_start);
+            filter_dirty = 0;
+            tree_ready   = 0;
+        }
+        if (sort_dirty) {
+            snapshot->sorted = 0;
+            sort_dirty       = 0;
+        }
+        if (tree_view && !tree_ready) {
+            // Siblings are ranked by a full sort of the matching processes.
+            PROFILE_BEGIN(sort_start);
+            snapshot_sort(snapshot, sort_spec);
+            PROFILE_ADD(&profiler, PROFILE_SORT, sort_start);
+            tree_ready = process_tree_build(&tree, snapshot) == 0;
+            fold_dirty = 1;
+        }
+        if (tree_view && tree_ready && fold_dirty) {
+            process_tree_apply(&tree, snapshot, &collapse);
+            fold_dirty = 0;
+        }
+        int sort_needed = scroll_offset + dashboard_rows();
+        if (sort_needed > snapshot->matched) sort_needed = snapshot->matched;
+        if (snapshot->sorted < sort_needed) {
+            PROFILE_BEGIN(sort_start);
+            snapshot_sort_top(snapshot, sort_spec, sort_needed);
+            PROFILE_ADD(&profiler, PROFILE_SORT, sort_start);
+        }
+
+        PROFILE_BEGIN(render_start);
+        render_dashboard(snapshot, tree_view && tree_ready ? &tree : NULL,
+                         cgroup_view ? &sample->cgroups : NULL, &sample->info, scroll_offset,
+                         selection_idx, search_query, sort_spec, sample->short_lived);
+        PROFILE_ADD(&profiler, PROFILE_RENDER, render_start);
+        if (profiling) render_profile(&profiler);
+        int listed = cgroup_view ? sample->cgroups.count : snapshot->matched;
+
+        // The rows just drawn are measured with the next sample.
+        if (sampler) {
+            MemoryView wanted;
+            memory_view_init(&wanted, pss_age_ms);
+            if (!cgroup_view) {
+                int rows = column_set_files(&shown) & PROC_FILE_ROLLUP ? dashboard_rows() : 0;
+                dashboard_memory_view(&wanted, snapshot, scroll_offset, rows, selection_idx,
+                                      snapshot_sort_files(sort_spec) & PROC_FILE_ROLLUP);
+            }
+            if (memcmp(&wanted, &memory, sizeof(memory)) != 0) {
+                memory = wanted;
+                sampler_set_memory(sampler, &memory);
+            }
+        }
+
+        // Wait for a key or a new sample; a signal such as SIGWINCH also
+        // ends the wait so that getch() can report KEY_RESIZE.
         ch = getch();
+        if (ch == ERR) {
+            poll(wait_fds, 2, -1);
+            continue;
+        }
         if (ch == 'q' || ch == 'Q' || ch == KEY_F(10) || ch == 27) {
-            free_process_list(process_list);
             break;
+        } else if (replay && (ch == KEY_LEFT || ch == KEY_RIGHT || ch == KEY_PPAGE ||
+                              ch == KEY_NPAGE || ch == KEY_HOME || ch == KEY_END)) {
+            // Scrub through the recording; the view keeps its filter, sort, and selection.
+            long delta = replay_frames(replay);
+            if (ch == KEY_LEFT) delta = -1;
+            if (ch == KEY_RIGHT) delta = 1;
+            if (ch == KEY_PPAGE) delta = -10;
+            if (ch == KEY_NPAGE) delta = 10;
+            if (ch == KEY_HOME) delta = -replay_frames(replay);
+            if (replay_step(replay, delta) != 0) beep();
+            filter_dirty = 1;
         } else if (ch == KEY_DOWN) {
             selection_idx++;
-            // Calculate filtered count
-            int          count = 0;
-            ProcessNode* curr  = process_list;
-            while (curr) {
-                if (search_query[0] == '\0' || strcasestr(curr->name, search_query) != NULL) {
-                    count++;
-                }
-                curr = curr->next;
-            }
-            if (selection_idx >= count) selection_idx = count - 1;
+            if (selection_idx >= listed) selection_idx = listed - 1;
             if (selection_idx < 0) selection_idx = 0;
 
-            int max_y = getmaxy(stdscr);
-            if (selection_idx - scroll_offset >= max_y - 10) {
+            if (selection_idx - scroll_offset >= dashboard_rows()) {
                 scroll_offset++;
             }
         } else if (ch == KEY_UP) {
@@ -72,84 +327,554 @@ int main() {
             }
         } else if (ch == KEY_F(1)) {
             render_help();
-        } else if (ch == KEY_F(3)) {
-            sort_cmp = cmp_cpu;
-            strcpy(sort_col, "CPU%");
-        } else if (ch == KEY_F(4)) {
-            sort_cmp = cmp_mem;
-            strcpy(sort_col, "MEM");
-        } else if (ch == KEY_F(5)) {
-            sort_cmp = cmp_name;
-            strcpy(sort_col, "NAME");
-        } else if (ch == KEY_F(6)) {
-            sort_cmp = cmp_pid;
-            strcpy(sort_col, "PID");
+        } else if (ch > KEY_F0 && ch <= KEY_F(12) && column_by_key(ch - KEY_F0)) {
+            // Sort by the column the key is bound to. Recordings hold neither
+            // the I/O counters nor smaps.
+            const SortSpec* spec = column_by_key(ch - KEY_F0)->sort;
+            if (replay && (snapshot_sort_files(spec) & (PROC_FILE_IO | PROC_FILE_ROLLUP))) {
+                beep();
+                continue;
+            }
+            sort_spec  = spec;
+            sort_dirty = 1;
+        } else if (replay && (ch == KEY_F(7) || ch == KEY_F(8) || ch == KEY_F(9) || ch == 'k' ||
+                              ch == 'K')) {
+            // Recorded PIDs may belong to other processes by now.
+            beep();
+        } else if (replay && (ch == 't' || ch == 'T' || ch == KEY_F(2) || ch == 'c' || ch == 'C' ||
+                              ch == 'i' || ch == 'I' || ch == 'm' || ch == 'M')) {
+            // Recordings hold processes only, without their I/O counters or smaps.
+            beep();
+        } else if (ch == 'i' || ch == 'I' || ch == 'm' || ch == 'M') {
+            // The I/O and memory columns take the place of the detail columns
+            // (PRI, NI, VIRT, and RES by default); the same key switches back.
+            ColumnMode mode = (ch == 'i' || ch == 'I') ? COLUMN_MODE_IO : COLUMN_MODE_MEMORY;
+            column_mode     = column_mode == mode ? COLUMN_MODE_DEFAULT : mode;
+            column_set_mode(base, column_mode, &shown);
+            dashboard_set_columns(&shown);
+        } else if (ch == 'c' || ch == 'C') {
+            // Switch to the cgroup list; from a drilled-down process list, go
+            // back to it with the cgroup selected.
+            int back      = drill_id != 0;
+            selection_idx = 0;
+            scroll_offset = 0;
+            if (back) {
+                int index = cgroup_list_find(&sample->cgroups, drill_id);
+                if (index > 0) selection_idx = index;
+                if (selection_idx >= dashboard_rows()) {
+                    scroll_offset = selection_idx - dashboard_rows() + 1;
+                }
+                drill_id     = 0;
+                filter_dirty = 1;
+                dashboard_set_status("");
+            }
+            cgroup_view = back || !cgroup_view;
+            sampler_set_cgroups(sampler, cgroup_view);
+        } else if (cgroup_view && (ch == '\n' || ch == KEY_ENTER)) {
+            // Drill down: list the processes of the selected cgroup and below.
+            if (selection_idx >= sample->cgroups.count) {
+                beep();
+                continue;
+            }
+            char path[256];
+            char status[sizeof(path) + 32];
+            cgroup_list_path(&sample->cgroups, selection_idx, path, sizeof(path));
+            snprintf(status, sizeof(status), "CGROUP %s   C back", path);
+            dashboard_set_status(status);
+            drill_id      = sample->cgroups.items[selection_idx].id;
+            cgroup_view   = 0;
+            filter_dirty  = 1;
+            selection_idx = 0;
+            scroll_offset = 0;
+        } else if (cgroup_view && (ch == 't' || ch == 'T' || ch == KEY_F(2) || ch == 'v' ||
+                                   ch == 'V' || ch == ' ' || ch == '+' || ch == '-' ||
+                                   ch == KEY_F(7) || ch == KEY_F(8) || ch == KEY_F(9) ||
+                                   ch == 'k' || ch == 'K')) {
+            // Process actions have no meaning on a cgroup row.
+            beep();
+        } else if (ch == 't' || ch == 'T') {
+            // Expand or collapse the threads of the selected process.
+            ProcessNode* curr = find_filtered(snapshot, selection_idx);
+            if (!curr || threads.all) {
+                beep();
+                continue;
+            }
+            pid_t owner = curr->thread_of ? curr->thread_of : curr->pid;
+            if (thread_view_toggle(&threads, owner) < 0) {
+                beep();
+                continue;
+            }
+            sampler_set_threads(sampler, &threads);
+            // Collapsing from a thread row moves the selection up to its process.
+            while (curr->thread_of && selection_idx > 0) {
+                curr = find_filtered(snapshot, --selection_idx);
+                if (selection_idx < scroll_offset) scroll_offset = selection_idx;
+            }
+        } else if (ch == KEY_F(2)) {
+            // Expand or collapse every process.
+            threads.all = !threads.all;
+            sampler_set_threads(sampler, &threads);
+        } else if (ch == 'v' || ch == 'V') {
+            // Switch between the flat list and the tree view.
+            tree_view     = !tree_view;
+            filter_dirty  = 1;
+            selection_idx = 0;
+            scroll_offset = 0;
+        } else if (ch == ' ' || ch == '+' || ch == '-') {
+            // Collapse or expand the subtree of the selected process.
+            ProcessNode* curr = find_filtered(snapshot, selection_idx);
+            if (!tree_view || !tree_ready || !curr ||
+                !(tree.flags[snapshot->order[selection_idx]] & TREE_NODE_PARENT)) {
+                beep();
+                continue;
+            }
+            int collapsed = tree_collapse_contains(&collapse, curr->pid);
+            if ((ch == '+' && !collapsed) || (ch == '-' && collapsed)) continue;
+            if (tree_collapse_toggle(&collapse, curr->pid) < 0) {
+                beep();
+                continue;
+            }
+            fold_dirty = 1;
         } else if (ch == KEY_F(7) || ch == KEY_F(8)) {
             // Decrease or Increase Nice Value
-            ProcessNode* curr  = process_list;
-            int          count = 0;
-            while (curr) {
-                if (search_query[0] == '\0' || strcasestr(curr->name, search_query) != NULL) {
-                    if (count == selection_idx) {
-                        int current_nice = getpriority(PRIO_PROCESS, curr->pid);
-                        int new_nice     = (ch == KEY_F(7)) ? current_nice - 1 : current_nice + 1;
-                        if (new_nice >= -20 && new_nice <= 19) {
-                            setpriority(PRIO_PROCESS, curr->pid, new_nice);
-                        }
-                        break;
-                    }
-                    count++;
-                }
-                curr = curr->next;
+            ProcessNode* curr = find_filtered(snapshot, selection_idx);
+            if (curr) {
+                int current_nice = getpriority(PRIO_PROCESS, curr->pid);
+                int new_nice     = (ch == KEY_F(7)) ? current_nice - 1 : current_nice + 1;
+                if (new_nice >= -20 && new_nice <= 19) {
+                    setpriority(PRIO_PROCESS, curr->pid, new_nice);
+                }
             }
         } else if (ch == '\n' || ch == KEY_ENTER) {
             // New Feature: Show Process Details
-            ProcessNode* curr  = process_list;
-            int          count = 0;
-            while (curr) {
-                if (search_query[0] == '\0' || strcasestr(curr->name, search_query) != NULL) {
-                    if (count == selection_idx) {
-                        render_process_details(curr);
-                        break;
-                    }
-                    count++;
-                }
-                curr = curr->next;
+            ProcessNode* curr = find_filtered(snapshot, selection_idx);
+            if (!curr) continue;
+            ProcessNode details = *curr;
+            if (sampler && (files_read & PROC_FILES_SCAN) != PROC_FILES_SCAN) {
+                // The inspector shows every field; read the ones the sampler
+                // skipped, unless the PID was reused since the sample.
+                ProcessNode fresh;
+                if (get_process_info(curr->pid, &fresh) == 0 &&
+                    fresh.starttime == curr->starttime) {
+                    details.uid         = fresh.uid;
+                    details.num_threads = fresh.num_threads;
+                    details.memory_kb   = fresh.memory_kb;
+                    details.vsz_kb      = fresh.vsz_kb;
+                    details.anon_kb     = fresh.anon_kb;
+                    details.file_kb     = fresh.file_kb;
+                    details.shmem_kb    = fresh.shmem_kb;
+                    details.swap_kb     = fresh.swap_kb;
+                    memcpy(details.username, fresh.username, sizeof(details.username));
+                }
             }
+            render_process_details(&details);
         } else if (ch == '/') {
             // Integrated search input
-            mvprintw(5, 2, "FILTER: ");
+            mvprintw(dashboard_filter_line(), 2, "FILTER: ");
             clrtoeol();
             echo();
             curs_set(1);
-            getnstr(search_query, sizeof(search_query) - 1);
+            nodelay(stdscr, FALSE);
+            char query[sizeof(search_query)] = "";
+            getnstr(query, sizeof(query) - 1);
+            nodelay(stdscr, TRUE);
             noecho();
             curs_set(0);
+            dashboard_invalidate();
+
+            // A query that does not compile leaves the current filter active.
+            Filter compiled;
+            char   error[128];
+            if (filter_compile(&compiled, query, error, sizeof(error)) != 0) {
+                render_filter_error(error);
+                continue;
+            }
+            filter_free(&filter);
+            filter = compiled;
+            strcpy(search_query, query);
+            filter_dirty  = 1;
             selection_idx = 0;
             scroll_offset = 0;
+        } else if (ch == 'p' || ch == 'P') {
+            // Show or hide ProcX's own cost; hiding it also stops the timers.
+            if (!PROFILE_AVAILABLE) {
+                beep();
+                continue;
+            }
+            profiling = !profiling;
+            profile_set_enabled(profiling);
+            if (!profiling) dashboard_invalidate();
         } else if (ch == 'h' || ch == 'H') {
             render_help();
         } else if (ch == 'k' || ch == 'K' || ch == KEY_F(9)) {
             // Kill selected process
-            ProcessNode* curr  = process_list;
-            int          count = 0;
-            while (curr) {
-                if (search_query[0] == '\0' || strcasestr(curr->name, search_query) != NULL) {
-                    if (count == selection_idx) {
-                        if (render_confirmation(curr->pid)) {
-                            kill(curr->pid, SIGTERM);
-                        }
-                        break;
-                    }
-                    count++;
-                }
-                curr = curr->next;
+            ProcessNode* curr = find_filtered(snapshot, selection_idx);
+            if (curr && render_confirmation(curr->pid)) {
+                kill(curr->pid, SIGTERM);
             }
         }
+    }
+    profile_set_enabled(0);
+    profiler_free(&profiler);
+    process_tree_free(&tree);
+    filter_free(&filter);
+}
 
-        free_process_list(process_list);
+/**
+ * @brief Browses a recording in the dashboard.
+ * @return int Exit status.
+ */
+static int replay_main(const char* path, const char* prog, const ColumnSet* columns) {
+    Replay replay;
+    char   error[256];
+    if (replay_open(&replay, path, error, sizeof(error)) != 0) {
+        fprintf(stderr, "%s: %s\n", prog, error);
+        return 1;
     }
+    init_ui();
+    nodelay(stdscr, TRUE);
+    run_dashboard(NULL, &replay, columns, 0);
+    replay_close(&replay);
+    close_ui();
+    return 0;
+}
+
+/**
+ * @brief Main function of the ProcX application.
+ */
+int main(int argc, char** argv) {
+    int         workers       = scan_pool_default_workers();
+    ScanBackend backend       = SCAN_BACKEND_SYNC;
+    int         events        = 0;
+    const char* exit_log_path = NULL;
+    int         refresh_rate  = 1000;  // ms
+    int         batch         = 0;
+    const char* record_path   = NULL;
+    long        record_mb     = RECORDER_DEFAULT_SIZE / (1024 * 1024);
+    const char* replay_path   = NULL;
+    const char* profile_path  = NULL;
+    const char* proc_root     = NULL;
+    int         pss_age_ms    = MEMORY_VIEW_DEFAULT_AGE_MS;
+    char        error[128];
+
+    SamplerTrigger trigger = {0, 100, 60 * 1000};
+    PsiTriggerSpec psi_triggers[SAMPLER_MAX_PSI_TRIGGERS];
+    int            psi_count = 0;
+
+    BatchOptions batch_options;
+    batch_options_init(&batch_options);
+    batch_options.sort = column_sort_named("cpu");
+
+    ColumnSet columns;
+    column_set_default(&columns);
+
+    // Long-only options use values outside the range of short option characters.
+    enum {
+        OPT_BATCH = 256,
+        OPT_COLUMNS,
+        OPT_FIELDS,
+        OPT_RECORD_SIZE,
+        OPT_TRIGGER_CPU,
+        OPT_BURST_INTERVAL,
+        OPT_BURST_WINDOW,
+        OPT_PSI_TRIGGER,
+        OPT_PSS_AGE,
+        OPT_PROFILE,
+        OPT_PROC_ROOT
+    };
+    static const struct option long_options[] = {
+        {"workers", required_argument, NULL, 'w'},
+        {"backend", required_argument, NULL, 'b'},
+        {"events", no_argument, NULL, 'e'},
+        {"exit-log", required_argument, NULL, 'x'},
+        {"interval", required_argument, NULL, 'd'},
+        {"batch", no_argument, NULL, OPT_BATCH},
+        {"format", required_argument, NULL, 'f'},
+        {"count", required_argument, NULL, 'n'},
+        {"columns", required_argument, NULL, OPT_COLUMNS},
+        {"fields", required_argument, NULL, OPT_FIELDS},
+        {"sort", required_argument, NULL, 's'},
+        {"top", required_argument, NULL, 't'},
+        {"record", required_argument, NULL, 'R'},
+        {"record-size", required_argument, NULL, OPT_RECORD_SIZE},
+        {"replay", required_argument, NULL, 'P'},
+        {"trigger-cpu", required_argument, NULL, OPT_TRIGGER_CPU},
+        {"burst-interval", required_argument, NULL, OPT_BURST_INTERVAL},
+        {"burst-window", required_argument, NULL, OPT_BURST_WINDOW},
+        {"psi-trigger", required_argument, NULL, OPT_PSI_TRIGGER},
+        {"pss-age", required_argument, NULL, OPT_PSS_AGE},
+        {"profile", required_argument, NULL, OPT_PROFILE},
+        {"proc-root", required_argument, NULL, OPT_PROC_ROOT},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "w:b:ex:d:f:n:s:t:R:P:h", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'w':
+                workers = atoi(optarg);
+                if (workers < 1 || workers > SCAN_POOL_MAX_WORKERS) {
+                    fprintf(stderr, "%s: --workers must be between 1 and %d\n", argv[0],
+                            SCAN_POOL_MAX_WORKERS);
+                    return 1;
+                }
+                break;
+            case 'b':
+                if (strcmp(optarg, "sync") == 0) {
+                    backend = SCAN_BACKEND_SYNC;
+                } else if (strcmp(optarg, "uring") == 0) {
+                    backend = SCAN_BACKEND_URING;
+                } else {
+                    fprintf(stderr, "%s: unknown backend '%s' (use sync or uring)\n", argv[0],
+                            optarg);
+                    return 1;
+                }
+                break;
+            case 'e':
+                events = 1;
+                break;
+            case 'x':
+                events        = 1;
+                exit_log_path = optarg;
+                break;
+            case 'd':
+                refresh_rate = atoi(optarg);
+                if (refresh_rate < 10) {
+                    fprintf(stderr, "%s: --interval must be at least 10 ms\n", argv[0]);
+                    return 1;
+                }
+                break;
+            case OPT_BATCH:
+                batch = 1;
+                break;
+            case 'f':
+                if (strcmp(optarg, "json") == 0) {
+                    batch_options.format = BATCH_FORMAT_JSON;
+                } else if (strcmp(optarg, "csv") == 0) {
+                    batch_options.format = BATCH_FORMAT_CSV;
+                } else if (strcmp(optarg, "none") == 0) {
+                    batch_options.format = BATCH_FORMAT_NONE;
+                } else {
+                    fprintf(stderr, "%s: unknown format '%s' (use json, csv, or none)\n", argv[0],
+                            optarg);
+                    return 1;
+                }
+                break;
+            case 'n':
+                batch_options.count = atol(optarg);
+                if (batch_options.count < 1) {
+                    fprintf(stderr, "%s: --count must be positive\n", argv[0]);
+                    return 1;
+                }
+                break;
+            case OPT_COLUMNS:
+                if (column_set_parse(&columns, optarg, error, sizeof(error)) != 0) {
+                    fprintf(stderr, "%s: --columns: %s\n", argv[0], error);
+                    return 1;
+                }
+                break;
+            case OPT_FIELDS:
+                if (batch_parse_fields(&batch_options, optarg, error, sizeof(error)) != 0) {
+                    fprintf(stderr, "%s: --fields: %s\n", argv[0], error);
+                    return 1;
+                }
+                break;
+            case 's':
+                batch_options.sort = column_sort_named(optarg);
+                if (!batch_options.sort) {
+                    fprintf(stderr,
+                            "%s: unknown sort key '%s' (use cpu, mem, name, pid, io, or pss)\n",
+                            argv[0], optarg);
+                    return 1;
+                }
+                break;
+            case 't':
+                batch_options.top = atoi(optarg);
+                if (batch_options.top < 1) {
+                    fprintf(stderr, "%s: --top must be positive\n", argv[0]);
+                    return 1;
+                }
+                break;
+            case 'R':
+                record_path = optarg;
+                break;
+            case OPT_RECORD_SIZE:
+                record_mb = atol(optarg);
+                if (record_mb < 1) {
+                    fprintf(stderr, "%s: --record-size must be at least 1 MB\n", argv[0]);
+                    return 1;
+                }
+                break;
+            case 'P':
+                replay_path = optarg;
+                break;
+            case OPT_TRIGGER_CPU:
+                trigger.cpu_percent = atoi(optarg);
+                if (trigger.cpu_percent < 1 || trigger.cpu_percent > 100) {
+                    fprintf(stderr, "%s: --trigger-cpu must be between 1 and 100\n", argv[0]);
+                    return 1;
+                }
+                break;
+            case OPT_BURST_INTERVAL:
+                trigger.interval_ms = atoi(optarg);
+                if (trigger.interval_ms < 10) {
+                    fprintf(stderr, "%s: --burst-interval must be at least 10 ms\n", argv[0]);
+                    return 1;
+                }
+                break;
+            case OPT_BURST_WINDOW:
+                trigger.window_ms = atoi(optarg) * 1000;
+                if (trigger.window_ms < 1000) {
+                    fprintf(stderr, "%s: --burst-window must be at least 1 s\n", argv[0]);
+                    return 1;
+                }
+                break;
+            case OPT_PSI_TRIGGER:
+                if (psi_count == SAMPLER_MAX_PSI_TRIGGERS) {
+                    fprintf(stderr, "%s: at most %d --psi-trigger options\n", argv[0],
+                            SAMPLER_MAX_PSI_TRIGGERS);
+                    return 1;
+                }
+                if (parse_psi_trigger(optarg, &psi_triggers[psi_count]) != 0) {
+                    fprintf(stderr, "%s: --psi-trigger '%s' is not RESOURCE[:full]:MS\n", argv[0],
+                            optarg);
+                    return 1;
+                }
+                psi_count++;
+                break;
+            case OPT_PSS_AGE:
+                pss_age_ms = atoi(optarg);
+                if (pss_age_ms < 0) {
+                    fprintf(stderr, "%s: --pss-age must not be negative\n", argv[0]);
+                    return 1;
+                }
+                break;
+            case OPT_PROFILE:
+                if (!PROFILE_AVAILABLE) {
+                    fprintf(stderr, "%s: --profile is not available in this build\n", argv[0]);
+                    return 1;
+                }
+                profile_path = optarg;
+                break;
+            case OPT_PROC_ROOT:
+                proc_root = optarg;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (replay_path) return replay_main(replay_path, argv[0], &columns);
+    if (proc_root && events) {
+        // Events name the host's processes, which a fixture does not have.
+        fprintf(stderr, "%s: --events cannot be combined with --proc-root\n", argv[0]);
+        return 1;
+    }
+    if (proc_root && proc_set_root(proc_root) != 0) {
+        fprintf(stderr, "%s: cannot open %s: %s\n", argv[0], proc_root, strerror(errno));
+        return 1;
+    }
+    if (profile_path && !batch) {
+        fprintf(stderr, "%s: --profile needs --batch; press P in the dashboard\n", argv[0]);
+        return 1;
+    }
+
+    FILE* exit_log = NULL;
+    if (exit_log_path) {
+        exit_log = fopen(exit_log_path, "a");
+        if (!exit_log) {
+            fprintf(stderr, "%s: cannot open %s: %s\n", argv[0], exit_log_path, strerror(errno));
+            return 1;
+        }
+    }
+    if (profile_path) {
+        batch_options.profile_fd =
+            open(profile_path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (batch_options.profile_fd < 0) {
+            fprintf(stderr, "%s: cannot open %s: %s\n", argv[0], profile_path, strerror(errno));
+            if (exit_log) fclose(exit_log);
+            return 1;
+        }
+    }
+
+    ProcessTable table;
+    process_table_init(&table);
+    process_table_set_workers(&table, workers);
+    process_table_set_backend(&table, backend);
+    if (events && process_table_enable_events(&table, exit_log) != 0) {
+        // No privilege or no connector in this namespace; readdir() scanning keeps working.
+        fprintf(stderr, "%s: proc events unavailable (%s), scanning /proc instead\n", argv[0],
+                strerror(errno));
+    }
+
+    // Sampling runs on its own thread from here on; this thread only renders
+    // the latest published sample and handles input.
+    Sampler  sampler;
+    Recorder recorder;
+    sampler_init(&sampler, &table, refresh_rate);
+    if (trigger.cpu_percent > 0) sampler_set_trigger(&sampler, &trigger);
+    if (batch) sampler_set_files(&sampler, batch_files(&batch_options));
+    if (batch && (batch_files(&batch_options) & PROC_FILE_ROLLUP)) {
+        // Batch samples list every process, so every process is measured.
+        MemoryView all;
+        memory_view_init(&all, pss_age_ms);
+        all.all = 1;
+        sampler_set_memory(&sampler, &all);
+    }
+    for (int i = 0; i < psi_count; i++) {
+        // Without PSI the header just leaves pressure out; the triggers only warn.
+        const PsiTriggerSpec* spec = &psi_triggers[i];
+        int fd = psi_trigger_open(spec->resource, spec->full, spec->stall_ms * 1000L,
+                                  PSI_TRIGGER_WINDOW_MS * 1000L);
+        if (fd < 0 || sampler_add_psi_trigger(&sampler, fd) != 0) {
+            fprintf(stderr, "%s: cannot set PSI trigger on %s: %s\n", argv[0],
+                    proc_pressure_names[spec->resource], strerror(errno));
+        }
+    }
+    if (record_path) {
+        if (recorder_open(&recorder, record_path, (size_t)record_mb * 1024 * 1024) != 0) {
+            fprintf(stderr, "%s: cannot record to %s: %s\n", argv[0], record_path,
+                    strerror(errno));
+            process_table_free(&table);
+            if (exit_log) fclose(exit_log);
+            if (profile_path) close(batch_options.profile_fd);
+            return 1;
+        }
+        sampler_set_recorder(&sampler, &recorder);
+    }
+    if (sampler_start(&sampler) != 0) {
+        fprintf(stderr, "%s: cannot start sampler: %s\n", argv[0], strerror(errno));
+        if (record_path) recorder_close(&recorder);
+        process_table_free(&table);
+        if (exit_log) fclose(exit_log);
+        if (profile_path) close(batch_options.profile_fd);
+        return 1;
+    }
+
+    if (batch) {
+        int status = batch_run(&sampler, &batch_options);
+        sampler_stop(&sampler);
+        if (record_path) recorder_close(&recorder);
+        process_table_free(&table);
+        user_cache_shutdown();
+        if (exit_log) fclose(exit_log);
+        if (profile_path) close(batch_options.profile_fd);
+        return status;
+    }
+
+    init_ui();
+    nodelay(stdscr, TRUE);
+    run_dashboard(&sampler, NULL, &columns, pss_age_ms);
 
+    sampler_stop(&sampler);
+    if (record_path) recorder_close(&recorder);
+    process_table_free(&table);
+    user_cache_shutdown();
+    if (exit_log) fclose(exit_log);
     close_ui();
     return 0;
 }
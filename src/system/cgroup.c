@@ -0,0 +1,493 @@
+/**
+ * @file cgroup.c
+ * @brief Implementation of the cgroup v2 walk and the process-to-cgroup mapping.
+ * @version 2.0.1
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "../../include/system/cgroup.h"
+#include "../../include/system/proc_parser.h"
+#include "../../include/system/profile.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <time.h>
+#include <unistd.h>
+
+/** @brief f_type of a cgroup2 mount (CGROUP2_SUPER_MAGIC). */
+#define CGROUP2_MAGIC 0x63677270
+
+/** @brief Buffer for memory.stat, which has about 50 lines on current kernels. */
+#define CGROUP_STAT_BUF_SIZE 8192
+
+/** @brief Buffer for the small single-value files and cpu.stat. */
+#define CGROUP_SMALL_BUF_SIZE 512
+
+/**
+ * @struct CgroupEntry
+ * @brief A child directory found while walking, before siblings are ordered.
+ */
+typedef struct CgroupEntry {
+    unsigned long long id;        /**< Inode of the directory */
+    char               name[256]; /**< Directory name */
+} CgroupEntry;
+
+/**
+ * @brief Scans an unsigned decimal, skipping leading blanks.
+ * @return int 0 on success, -1 if no digit was found.
+ */
+static int cgroup_scan_ull(const char* p, const char* end, unsigned long long* out) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    if (p >= end || *p < '0' || *p > '9') return -1;
+    unsigned long long value = 0;
+    while (p < end && *p >= '0' && *p <= '9') value = value * 10 + (unsigned long long)(*p++ - '0');
+    *out = value;
+    return 0;
+}
+
+/**
+ * @brief Finds a "key value" line and scans its value.
+ * @return int 0 on success, -1 if the key is missing.
+ */
+static int cgroup_find_key(const char* buf, size_t len, const char* key,
+                           unsigned long long* value) {
+    size_t      key_len = strlen(key);
+    const char* p       = buf;
+    const char* end     = buf + len;
+    while (p < end) {
+        const char* eol = memchr(p, '\n', (size_t)(end - p));
+        if (!eol) eol = end;
+        if ((size_t)(eol - p) > key_len && memcmp(p, key, key_len) == 0 && p[key_len] == ' ') {
+            return cgroup_scan_ull(p + key_len, eol, value);
+        }
+        p = eol + 1;
+    }
+    return -1;
+}
+
+int cgroup_parse_cpu_stat(const char* buf, size_t len, unsigned long long* usage_usec) {
+    return cgroup_find_key(buf, len, "usage_usec", usage_usec);
+}
+
+/**
+ * @struct MemoryStatKey
+ * @brief A memory.stat key and where its value goes.
+ */
+typedef struct MemoryStatKey {
+    const char* name;   /**< Key, without the separating space */
+    size_t      length; /**< strlen(name) */
+    int         slot;   /**< 0 anon, 1 file, 2 kernel, 3 part of kernel */
+} MemoryStatKey;
+
+#define MEMORY_STAT_KEY(name, slot) {name, sizeof(name) - 1, slot}
+
+/** @brief The keys ProcX reads; the parts of kernel memory are only used without "kernel". */
+static const MemoryStatKey memory_stat_keys[] = {
+    MEMORY_STAT_KEY("anon", 0),         MEMORY_STAT_KEY("file", 1),
+    MEMORY_STAT_KEY("kernel", 2),       MEMORY_STAT_KEY("kernel_stack", 3),
+    MEMORY_STAT_KEY("pagetables", 3),   MEMORY_STAT_KEY("sec_pagetables", 3),
+    MEMORY_STAT_KEY("percpu", 3),       MEMORY_STAT_KEY("sock", 3),
+    MEMORY_STAT_KEY("vmalloc", 3),      MEMORY_STAT_KEY("slab", 3),
+};
+
+#define MEMORY_STAT_KEY_COUNT (sizeof(memory_stat_keys) / sizeof(memory_stat_keys[0]))
+
+int cgroup_parse_memory_stat(const char* buf, size_t len, CgroupInfo* info) {
+    unsigned long long sums[4]  = {0, 0, 0, 0};
+    int                found[4] = {0, 0, 0, 0};
+    const char*        p        = buf;
+    const char*        end      = buf + len;
+    while (p < end) {
+        const char* eol   = memchr(p, '\n', (size_t)(end - p));
+        const char* space = memchr(p, ' ', (size_t)((eol ? eol : end) - p));
+        if (!eol) eol = end;
+        if (space) {
+            size_t length = (size_t)(space - p);
+            for (unsigned i = 0; i < MEMORY_STAT_KEY_COUNT; i++) {
+                const MemoryStatKey* key = &memory_stat_keys[i];
+                unsigned long long   value;
+                if (key->length != length || memcmp(p, key->name, length) != 0) continue;
+                if (cgroup_scan_ull(space, eol, &value) == 0) {
+                    sums[key->slot] += value;
+                    found[key->slot] = 1;
+                }
+                break;
+            }
+        }
+        p = eol + 1;
+    }
+    if (!found[0] && !found[1] && !found[2] && !found[3]) return -1;
+    info->anon_kb   = (long)(sums[0] / 1024);
+    info->file_kb   = (long)(sums[1] / 1024);
+    info->kernel_kb = (long)((found[2] ? sums[2] : sums[3]) / 1024);
+    return 0;
+}
+
+int cgroup_parse_proc(const char* buf, size_t len, char* path, size_t size) {
+    const char* p   = buf;
+    const char* end = buf + len;
+    while (p < end) {
+        const char* eol = memchr(p, '\n', (size_t)(end - p));
+        if (!eol) eol = end;
+        if (eol - p >= 3 && memcmp(p, "0::", 3) == 0) {
+            size_t length = (size_t)(eol - p - 3);
+            if (length == 0 || length >= size) return -1;
+            memcpy(path, p + 3, length);
+            path[length] = '\0';
+            return 0;
+        }
+        p = eol + 1;
+    }
+    return -1;
+}
+
+void cgroup_list_init(CgroupList* list) {
+    memset(list, 0, sizeof(*list));
+    list->index_mask = -1;
+}
+
+/**
+ * @brief Returns the first index slot to probe for a cgroup ID.
+ */
+static inline int cgroup_slot(unsigned long long id, int mask) {
+    return (int)((id * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+/**
+ * @brief Rebuilds the ID index of a list after its items changed.
+ * @return 0 on success, -1 on allocation failure (the index is then empty).
+ */
+static int cgroup_list_index(CgroupList* list) {
+    int slots = list->index_mask + 1 > 0 ? list->index_mask + 1 : 256;
+    while (slots < 2 * list->count) slots *= 2;
+    if (slots != list->index_mask + 1) {
+        int* index = realloc(list->index, sizeof(int) * slots);
+        PROFILE_COUNT(PROFILE_ALLOCS, 1);
+        if (!index) {
+            list->index_mask = -1;
+            return -1;
+        }
+        list->index      = index;
+        list->index_mask = slots - 1;
+    }
+    memset(list->index, -1, sizeof(int) * slots);
+    for (int i = 0; i < list->count; i++) {
+        int slot = cgroup_slot(list->items[i].id, list->index_mask);
+        while (list->index[slot] >= 0) slot = (slot + 1) & list->index_mask;
+        list->index[slot] = i;
+    }
+    return 0;
+}
+
+int cgroup_list_find(const CgroupList* list, unsigned long long id) {
+    if (list->index_mask < 0) return -1;
+    for (int slot = cgroup_slot(id, list->index_mask);; slot = (slot + 1) & list->index_mask) {
+        int i = list->index[slot];
+        if (i < 0 || list->items[i].id == id) return i;
+    }
+}
+
+void cgroup_list_count(CgroupList* list, const ProcessSnapshot* snapshot) {
+    for (int i = 0; i < list->count; i++) list->items[i].processes = 0;
+    for (int r = 0; r < snapshot->count; r++) {
+        if (snapshot->procs[r].thread_of) continue;
+        int i = cgroup_list_find(list, snapshot->procs[r].cgroup_id);
+        if (i >= 0) list->items[i].processes++;
+    }
+    // Children follow their parent, so a backward pass sums every subtree.
+    for (int i = list->count - 1; i > 0; i--) {
+        int parent = list->items[i].parent;
+        if (parent >= 0) list->items[parent].processes += list->items[i].processes;
+    }
+}
+
+void cgroup_list_restrict(const CgroupList* list, unsigned long long id,
+                          ProcessSnapshot* snapshot) {
+    int root  = cgroup_list_find(list, id);
+    int last  = root >= 0 ? root + list->items[root].descendants : -1;
+    int kept  = 0;
+    for (int i = 0; i < snapshot->matched; i++) {
+        int r = snapshot->matches[i];
+        int c = cgroup_list_find(list, snapshot->procs[snapshot->groups[r]].cgroup_id);
+        if (root < 0 || c < root || c > last) continue;
+        snapshot->matches[kept] = r;
+        snapshot->order[kept]   = r;
+        kept++;
+    }
+    snapshot->matched = kept;
+    snapshot->sorted  = 0;
+}
+
+void cgroup_list_path(const CgroupList* list, int index, char* out, size_t size) {
+    // Collect the ancestors, then write them from the root down.
+    int chain[CGROUP_MAX_DEPTH + 1];
+    int depth = 0;
+    for (int i = index; i > 0 && depth <= CGROUP_MAX_DEPTH; i = list->items[i].parent) {
+        chain[depth++] = i;
+    }
+    size_t len = 0;
+    out[0]     = '\0';
+    if (depth == 0 && size > 1) {
+        out[0] = '/';
+        out[1] = '\0';
+    }
+    while (depth > 0 && len + 1 < size) {
+        const char* name = list->items[chain[--depth]].name;
+        size_t      n    = strlen(name);
+        if (len + 1 + n >= size) n = size - len - 2;
+        out[len++] = '/';
+        memcpy(out + len, name, n);
+        len += n;
+        out[len] = '\0';
+    }
+}
+
+void cgroup_list_free(CgroupList* list) {
+    free(list->items);
+    free(list->index);
+    cgroup_list_init(list);
+}
+
+int cgroup_sampler_init(CgroupSampler* sampler, const char* root) {
+    memset(sampler, 0, sizeof(*sampler));
+    cgroup_list_init(&sampler->previous);
+    sampler->root_fd = -1;
+    if (root) {
+        sampler->root_fd = open(root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        return sampler->root_fd >= 0 ? 0 : -1;
+    }
+
+    static const char* mounts[] = {"/sys/fs/cgroup", "/sys/fs/cgroup/unified"};
+    for (int i = 0; i < 2; i++) {
+        struct statfs fs;
+        if (statfs(mounts[i], &fs) != 0 || fs.f_type != CGROUP2_MAGIC) continue;
+        sampler->root_fd = open(mounts[i], O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (sampler->root_fd >= 0) return 0;
+    }
+    return -1;
+}
+
+/**
+ * @brief Reads a file holding a single byte count, such as memory.current.
+ * @return The value in KB, or -1 if the file is missing.
+ */
+static long cgroup_read_kb(int dir_fd, const char* name) {
+    char               buf[CGROUP_SMALL_BUF_SIZE];
+    unsigned long long value;
+    ssize_t            len = proc_read_file(dir_fd, name, buf, sizeof(buf));
+    if (len <= 0 || cgroup_scan_ull(buf, buf + len, &value) != 0) return -1;
+    return (long)(value / 1024);
+}
+
+/**
+ * @brief Reads the values of one cgroup from its directory.
+ */
+static void cgroup_read(int dir_fd, CgroupInfo* info) {
+    char    buf[CGROUP_STAT_BUF_SIZE];
+    ssize_t len;
+
+    info->usage_usec = 0;
+    len              = proc_read_file(dir_fd, "cpu.stat", buf, CGROUP_SMALL_BUF_SIZE);
+    if (len > 0) cgroup_parse_cpu_stat(buf, (size_t)len, &info->usage_usec);
+
+    info->memory_kb = cgroup_read_kb(dir_fd, "memory.current");
+    info->anon_kb = info->file_kb = info->kernel_kb = -1;
+    len = proc_read_file(dir_fd, "memory.stat", buf, sizeof(buf));
+    if (len > 0) cgroup_parse_memory_stat(buf, (size_t)len, info);
+
+    char               small[CGROUP_SMALL_BUF_SIZE];
+    unsigned long long tasks;
+    len         = proc_read_file(dir_fd, "pids.current", small, sizeof(small));
+    info->tasks = len > 0 && cgroup_scan_ull(small, small + len, &tasks) == 0 ? (long)tasks : -1;
+
+    for (int i = 0; i < PRESSURE_RESOURCES; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "%s.pressure", proc_pressure_names[i]);
+        len = proc_read_file(dir_fd, name, small, sizeof(small));
+        if (len <= 0 || proc_parse_pressure(small, (size_t)len, &info->pressure[i]) != 0) {
+            info->pressure[i].some_avg10 = -1.0f;
+        }
+    }
+}
+
+/**
+ * @brief Orders sibling entries by name.
+ */
+static int cgroup_entry_compare(const void* a, const void* b) {
+    return strcmp(((const CgroupEntry*)a)->name, ((const CgroupEntry*)b)->name);
+}
+
+/**
+ * @brief Appends a cgroup and, depth first, everything below it.
+ *
+ * Takes ownership of @p dir_fd. The child entries of every level are stacked
+ * in the sampler's entries above @p base, so ordering siblings allocates
+ * nothing at steady state.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+static int cgroup_walk(CgroupSampler* sampler, CgroupList* list, int dir_fd,
+                       unsigned long long id, const char* name, int parent, int depth,
+                       size_t base) {
+    if (list->count == list->capacity) {
+        int         capacity = list->capacity ? list->capacity * 2 : 256;
+        CgroupInfo* items    = realloc(list->items, sizeof(CgroupInfo) * capacity);
+        PROFILE_COUNT(PROFILE_ALLOCS, 1);
+        if (!items) {
+            close(dir_fd);
+            return -1;
+        }
+        list->items    = items;
+        list->capacity = capacity;
+    }
+    int         index = list->count++;
+    CgroupInfo* info  = &list->items[index];
+    memset(info, 0, sizeof(*info));
+    info->id     = id;
+    info->parent = parent;
+    info->depth  = depth;
+    snprintf(info->name, sizeof(info->name), "%s", name);
+    cgroup_read(dir_fd, info);
+
+    DIR* dir = depth < CGROUP_MAX_DEPTH ? fdopendir(dir_fd) : NULL;
+    if (!dir) {
+        close(dir_fd);
+        list->items[index].descendants = 0;
+        return 0;
+    }
+
+    // Stack the child directories above the base, then order them.
+    size_t         top = base;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') continue;
+        if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN) continue;
+        if (entry->d_type == DT_UNKNOWN) {
+            struct stat st;
+            if (fstatat(dirfd(dir), entry->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0 ||
+                !S_ISDIR(st.st_mode)) {
+                continue;
+            }
+        }
+        if (top == sampler->entry_capacity) {
+            size_t       capacity = sampler->entry_capacity ? sampler->entry_capacity * 2 : 64;
+            CgroupEntry* entries  = realloc(sampler->entries, sizeof(CgroupEntry) * capacity);
+            PROFILE_COUNT(PROFILE_ALLOCS, 1);
+            if (!entries) {
+                closedir(dir);
+                return -1;
+            }
+            sampler->entries        = entries;
+            sampler->entry_capacity = capacity;
+        }
+        CgroupEntry* child = &sampler->entries[top++];
+        child->id          = entry->d_ino;
+        snprintf(child->name, sizeof(child->name), "%s", entry->d_name);
+    }
+    qsort(sampler->entries + base, top - base, sizeof(CgroupEntry),
+          cgroup_entry_compare);
+
+    int rc = 0;
+    for (size_t i = base; i < top && rc == 0; i++) {
+        // The stack may move while a child is walked, so entries are re-read by index.
+        const CgroupEntry* child = &sampler->entries[i];
+        int fd = openat(dirfd(dir), child->name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) continue;
+        rc = cgroup_walk(sampler, list, fd, child->id, child->name, index, depth + 1, top);
+    }
+    closedir(dir);
+    list->items[index].descendants = list->count - index - 1;
+    return rc;
+}
+
+int cgroup_sampler_collect(CgroupSampler* sampler, CgroupList* list) {
+    list->count = 0;
+    if (!sampler->enabled || sampler->root_fd < 0) {
+        cgroup_list_index(list);
+        return 0;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long long   time_ms = (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+    struct stat st;
+    int         fd = dup(sampler->root_fd);
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        if (fd >= 0) close(fd);
+        cgroup_list_index(list);
+        return 0;
+    }
+    // A directory stream shares the offset of the descriptor it was opened on.
+    lseek(fd, 0, SEEK_SET);
+    int rc = cgroup_walk(sampler, list, fd, st.st_ino, "/", -1, 0, 0);
+    if (cgroup_list_index(list) != 0) rc = -1;
+
+    // CPU usage over the time since the previous walk.
+    long long elapsed_ms = sampler->time_ms ? time_ms - sampler->time_ms : 0;
+    for (int i = 0; i < list->count; i++) {
+        CgroupInfo* info = &list->items[i];
+        int         prev = cgroup_list_find(&sampler->previous, info->id);
+        info->cpu_usage  = 0.0f;
+        if (prev >= 0 && elapsed_ms > 0 &&
+            info->usage_usec >= sampler->previous.items[prev].usage_usec) {
+            info->cpu_usage =
+                (float)(info->usage_usec - sampler->previous.items[prev].usage_usec) /
+                (float)(elapsed_ms * 10);
+        }
+    }
+
+    // Keep the IDs and usage for the next walk.
+    CgroupList* previous = &sampler->previous;
+    if (previous->capacity < list->count) {
+        CgroupInfo* items = realloc(previous->items, sizeof(CgroupInfo) * list->capacity);
+        PROFILE_COUNT(PROFILE_ALLOCS, 1);
+        if (!items) {
+            previous->count = 0;
+            cgroup_list_index(previous);
+            return -1;
+        }
+        previous->items    = items;
+        previous->capacity = list->capacity;
+    }
+    for (int i = 0; i < list->count; i++) {
+        previous->items[i].id         = list->items[i].id;
+        previous->items[i].usage_usec = list->items[i].usage_usec;
+    }
+    previous->count  = list->count;
+    sampler->time_ms = time_ms;
+    if (cgroup_list_index(previous) != 0) rc = -1;
+    return rc;
+}
+
+unsigned long long cgroup_sampler_resolve(const CgroupSampler* sampler, pid_t pid) {
+    if (sampler->root_fd < 0) return 0;
+    char name[32];
+    char buf[CGROUP_STAT_BUF_SIZE];
+    char path[4096];
+    int  n = proc_format_pid(pid, name);
+    memcpy(name + n, "/cgroup", sizeof("/cgroup"));
+    ssize_t len = proc_read_file(proc_root_fd(), name, buf, sizeof(buf));
+    if (len <= 0 || cgroup_parse_proc(buf, (size_t)len, path, sizeof(path)) != 0) return 0;
+
+    // The path starts with '/'; the root cgroup itself is ".".
+    struct stat st;
+    const char* relative = path[1] ? path + 1 : ".";
+    if (fstatat(sampler->root_fd, relative, &st, 0) != 0) return 0;
+    return st.st_ino;
+}
+
+void cgroup_sampler_free(CgroupSampler* sampler) {
+    if (sampler->root_fd >= 0) close(sampler->root_fd);
+    cgroup_list_free(&sampler->previous);
+    free(sampler->entries);
+    memset(sampler, 0, sizeof(*sampler));
+    sampler->root_fd = -1;
+    cgroup_list_init(&sampler->previous);
+}
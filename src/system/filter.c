@@ -0,0 +1,291 @@
+/**
+ * @file filter.c
+ * @brief Implementation of the filter expression compiler and matcher.
+ * @version 2.0.1
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "../../include/system/filter.h"
+#include "../../include/system/proc_parser.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+/**
+ * @struct FilterFieldName
+ * @brief Spelling of a field in expressions.
+ */
+typedef struct FilterFieldName {
+    const char* name;    /**< Name as typed */
+    FilterField field;   /**< Field it selects */
+    int         numeric; /**< Non-zero for fields compared as numbers */
+} FilterFieldName;
+
+static const FilterFieldName filter_fields[] = {
+    {"name", FILTER_FIELD_NAME, 0},       {"comm", FILTER_FIELD_NAME, 0},
+    {"user", FILTER_FIELD_USER, 0},       {"state", FILTER_FIELD_STATE, 0},
+    {"pid", FILTER_FIELD_PID, 1},         {"ppid", FILTER_FIELD_PPID, 1},
+    {"uid", FILTER_FIELD_UID, 1},         {"cpu", FILTER_FIELD_CPU, 1},
+    {"mem", FILTER_FIELD_MEM, 1},         {"res", FILTER_FIELD_MEM, 1},
+    {"threads", FILTER_FIELD_THREADS, 1}, {"nice", FILTER_FIELD_NICE, 1},
+    {"ni", FILTER_FIELD_NICE, 1},         {"pri", FILTER_FIELD_PRI, 1},
+};
+
+void filter_init(Filter* filter) { filter->count = 0; }
+
+void filter_free(Filter* filter) {
+    for (int i = 0; i < filter->count; i++) {
+        if (filter->terms[i].op == FILTER_OP_REGEX) regfree(&filter->terms[i].regex);
+    }
+    filter->count = 0;
+}
+
+/**
+ * @brief Looks up the field name at the start of a term.
+ * @return Matching entry, or NULL if the term does not start with a known field
+ *         directly followed by an operator character.
+ */
+static const FilterFieldName* filter_lookup_field(const char* term, size_t* name_len) {
+    size_t len = 0;
+    while (isalpha((unsigned char)term[len])) len++;
+    if (len == 0 || !strchr(":~<>=", term[len]) || term[len] == '\0') return NULL;
+
+    for (size_t i = 0; i < sizeof(filter_fields) / sizeof(filter_fields[0]); i++) {
+        if (strlen(filter_fields[i].name) == len &&
+            strncasecmp(term, filter_fields[i].name, len) == 0) {
+            *name_len = len;
+            return &filter_fields[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Parses a numeric operand; memory accepts a K, M, or G suffix.
+ * @return 0 on success, -1 if the operand is not a number.
+ */
+static int filter_parse_number(const char* text, FilterField field, double* out) {
+    char*  end;
+    double value = strtod(text, &end);
+    if (end == text) return -1;
+    if (field == FILTER_FIELD_MEM && *end) {
+        switch (tolower((unsigned char)*end)) {
+            case 'k':
+                break;
+            case 'm':
+                value *= 1024.0;
+                break;
+            case 'g':
+                value *= 1024.0 * 1024.0;
+                break;
+            default:
+                return -1;
+        }
+        end++;
+        if (tolower((unsigned char)*end) == 'b') end++;
+    }
+    if (*end) return -1;
+    *out = value;
+    return 0;
+}
+
+/**
+ * @brief Compiles one blank-free term.
+ * @return 0 on success, -1 with a message in @p error.
+ */
+static int filter_compile_term(FilterTerm* term, const char* text, char* error, size_t error_size) {
+    memset(term, 0, sizeof(*term));
+    if (text[0] == '!' && text[1]) {
+        term->negate = 1;
+        text++;
+    }
+
+    size_t                 name_len = 0;
+    const FilterFieldName* field    = filter_lookup_field(text, &name_len);
+    if (!field) {
+        // A bare word (or an unknown prefix such as "kworker/0:1") matches names.
+        if (strlen(text) >= sizeof(term->text)) {
+            snprintf(error, error_size, "term too long: %s", text);
+            return -1;
+        }
+        term->field = FILTER_FIELD_NAME;
+        term->op    = FILTER_OP_CONTAINS;
+        strcpy(term->text, text);
+        return 0;
+    }
+
+    const char* op    = text + name_len;
+    const char* value = op + 1;
+    term->field       = field->field;
+    if ((op[0] == '>' || op[0] == '<') && op[1] == '=') value++;
+    if (*value == '\0') {
+        snprintf(error, error_size, "missing value after '%.*s'", (int)(value - text), text);
+        return -1;
+    }
+    if (strlen(value) >= sizeof(term->text)) {
+        snprintf(error, error_size, "value too long: %s", value);
+        return -1;
+    }
+
+    if (!field->numeric) {
+        strcpy(term->text, value);
+        if (op[0] == ':') {
+            term->op = field->field == FILTER_FIELD_NAME    ? FILTER_OP_CONTAINS
+                       : field->field == FILTER_FIELD_STATE ? FILTER_OP_STATE_IN
+                                                            : FILTER_OP_EQUALS_TEXT;
+            return 0;
+        }
+        if (op[0] == '~' && field->field != FILTER_FIELD_STATE) {
+            int rc = regcomp(&term->regex, value, REG_EXTENDED | REG_ICASE | REG_NOSUB);
+            if (rc != 0) {
+                char reason[64];
+                regerror(rc, &term->regex, reason, sizeof(reason));
+                snprintf(error, error_size, "bad regex '%s': %s", value, reason);
+                return -1;
+            }
+            term->op = FILTER_OP_REGEX;
+            return 0;
+        }
+        snprintf(error, error_size, "'%s' does not support '%c'", field->name, op[0]);
+        return -1;
+    }
+
+    switch (op[0]) {
+        case ':':
+        case '=':
+            term->op = FILTER_OP_EQ;
+            break;
+        case '<':
+            term->op = op[1] == '=' ? FILTER_OP_LE : FILTER_OP_LT;
+            break;
+        case '>':
+            term->op = op[1] == '=' ? FILTER_OP_GE : FILTER_OP_GT;
+            break;
+        default:
+            snprintf(error, error_size, "'%s' does not support '%c'", field->name, op[0]);
+            return -1;
+    }
+    if (filter_parse_number(value, field->field, &term->number) != 0) {
+        snprintf(error, error_size, "'%s' needs a number, got '%s'", field->name, value);
+        return -1;
+    }
+    return 0;
+}
+
+int filter_compile(Filter* filter, const char* query, char* error, size_t error_size) {
+    filter_init(filter);
+    if (error_size > 0) error[0] = '\0';
+
+    const char* p = query;
+    while (*p) {
+        while (*p == ' ' || *p == '\t') p++;
+        if (!*p) break;
+        const char* end = p;
+        while (*end && *end != ' ' && *end != '\t') end++;
+
+        char   text[FILTER_TEXT_SIZE * 2];
+        size_t len = (size_t)(end - p);
+        if (len >= sizeof(text)) len = sizeof(text) - 1;
+        memcpy(text, p, len);
+        text[len] = '\0';
+        p         = end;
+
+        if (filter->count == FILTER_MAX_TERMS) {
+            snprintf(error, error_size, "more than %d terms", FILTER_MAX_TERMS);
+            filter_free(filter);
+            return -1;
+        }
+        if (filter_compile_term(&filter->terms[filter->count], text, error, error_size) != 0) {
+            filter_free(filter);
+            return -1;
+        }
+        filter->count++;
+    }
+    return 0;
+}
+
+/**
+ * @brief Returns the value of a numeric field.
+ */
+static double filter_number(const ProcessNode* proc, FilterField field) {
+    switch (field) {
+        case FILTER_FIELD_PID:
+            return proc->pid;
+        case FILTER_FIELD_PPID:
+            return proc->ppid;
+        case FILTER_FIELD_UID:
+            return proc->uid;
+        case FILTER_FIELD_CPU:
+            return proc->cpu_usage;
+        case FILTER_FIELD_MEM:
+            return (double)proc->memory_kb;
+        case FILTER_FIELD_THREADS:
+            return proc->num_threads;
+        case FILTER_FIELD_NICE:
+            return proc->nice_value;
+        case FILTER_FIELD_PRI:
+            return proc->priority;
+        default:
+            return 0.0;
+    }
+}
+
+/**
+ * @brief Evaluates one term, ignoring its negation.
+ */
+static int filter_term_match(const FilterTerm* term, const ProcessNode* proc) {
+    const char* text = term->field == FILTER_FIELD_USER ? proc->username : proc->name;
+    switch (term->op) {
+        case FILTER_OP_CONTAINS:
+            return strcasestr(text, term->text) != NULL;
+        case FILTER_OP_EQUALS_TEXT:
+            return strcasecmp(text, term->text) == 0;
+        case FILTER_OP_STATE_IN:
+            return proc->state != '\0' && strchr(term->text, proc->state) != NULL;
+        case FILTER_OP_REGEX:
+            return regexec(&term->regex, text, 0, NULL, 0) == 0;
+        case FILTER_OP_EQ:
+            return filter_number(proc, term->field) == term->number;
+        case FILTER_OP_LT:
+            return filter_number(proc, term->field) < term->number;
+        case FILTER_OP_LE:
+            return filter_number(proc, term->field) <= term->number;
+        case FILTER_OP_GT:
+            return filter_number(proc, term->field) > term->number;
+        case FILTER_OP_GE:
+            return filter_number(proc, term->field) >= term->number;
+    }
+    return 0;
+}
+
+int filter_match(const Filter* filter, const ProcessNode* proc) {
+    for (int i = 0; i < filter->count; i++) {
+        const FilterTerm* term = &filter->terms[i];
+        if (filter_term_match(term, proc) == term->negate) return 0;
+    }
+    return 1;
+}
+
+int filter_files(const Filter* filter) {
+    int files = PROC_FILE_STAT;
+    for (int i = 0; i < filter->count; i++) {
+        switch (filter->terms[i].field) {
+            case FILTER_FIELD_USER:
+            case FILTER_FIELD_UID:
+            case FILTER_FIELD_THREADS:
+                files |= PROC_FILE_STATUS;
+                break;
+            case FILTER_FIELD_MEM:
+                files |= PROC_FILE_STATM;
+                break;
+            default:
+                break;
+        }
+    }
+    return files;
+}
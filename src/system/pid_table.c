@@ -0,0 +1,195 @@
+/**
+ * @file pid_table.c
+ * @brief Implementation of the generation-swept PID hash table.
+ * @version 2.0.1
+ */
+
+#include "../../include/system/pid_table.h"
+#include "../../include/system/profile.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PID_SLOT_EMPTY 0
+#define PID_SLOT_DELETED (-1)
+#define PID_TABLE_MIN_CAPACITY 64
+
+/**
+ * @brief Mixes the PID bits so consecutive PIDs spread over the whole table.
+ */
+static size_t pid_hash(pid_t pid) {
+    uint32_t h = (uint32_t)pid;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+/**
+ * @brief Rebuilds the table with a new capacity, dropping deleted slots.
+ * @return 0 on success, -1 if the new slot array could not be allocated.
+ */
+static int pid_table_rehash(PidTable* table, size_t capacity) {
+    PidTableEntry* slots = calloc(capacity, sizeof(PidTableEntry));
+    PROFILE_COUNT(PROFILE_ALLOCS, 1);
+    if (!slots) return -1;
+
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < table->capacity; i++) {
+        PidTableEntry* e = &table->slots[i];
+        if (e->pid == PID_SLOT_EMPTY || e->pid == PID_SLOT_DELETED) continue;
+
+        size_t j = pid_hash(e->pid) & mask;
+        while (slots[j].pid != PID_SLOT_EMPTY) j = (j + 1) & mask;
+        slots[j] = *e;
+    }
+
+    free(table->slots);
+    table->slots    = slots;
+    table->capacity = capacity;
+    table->used     = table->count;
+    return 0;
+}
+
+/**
+ * @brief Smallest power-of-two capacity that keeps @p count entries under half load.
+ */
+static size_t pid_table_capacity_for(size_t count) {
+    size_t capacity = PID_TABLE_MIN_CAPACITY;
+    while (capacity < count * 2) capacity <<= 1;
+    return capacity;
+}
+
+void pid_table_init(PidTable* table) {
+    table->slots      = NULL;
+    table->capacity   = 0;
+    table->count      = 0;
+    table->used       = 0;
+    table->generation = 1;
+}
+
+void pid_table_free(PidTable* table) {
+    free(table->slots);
+    pid_table_init(table);
+}
+
+void pid_table_begin(PidTable* table) {
+    table->generation++;
+    // Generation 0 is reserved so that zeroed slots never look current.
+    if (table->generation == 0) table->generation = 1;
+}
+
+PidTableEntry* pid_table_touch(PidTable* table, pid_t pid, unsigned long long starttime,
+                               int* is_new) {
+    // Keep live + deleted slots under 75% so probe chains stay short.
+    if ((table->used + 1) * 4 > table->capacity * 3) {
+        if (pid_table_rehash(table, pid_table_capacity_for(table->count + 1)) != 0) return NULL;
+    }
+
+    size_t         mask     = table->capacity - 1;
+    size_t         i        = pid_hash(pid) & mask;
+    PidTableEntry* reusable = NULL;
+
+    while (table->slots[i].pid != PID_SLOT_EMPTY) {
+        PidTableEntry* e = &table->slots[i];
+        if (e->pid == pid) {
+            *is_new = (e->starttime != starttime);
+            if (*is_new) {
+                e->starttime  = starttime;
+                e->utime      = 0;
+                e->stime      = 0;
+                e->io_time_ms = 0;
+                e->pss_ms     = 0;
+                e->node       = NULL;
+            }
+            e->generation = table->generation;
+            return e;
+        }
+        if (e->pid == PID_SLOT_DELETED && !reusable) reusable = e;
+        i = (i + 1) & mask;
+    }
+
+    PidTableEntry* e = reusable;
+    if (!e) {
+        e = &table->slots[i];
+        table->used++;
+    }
+    e->pid        = pid;
+    e->starttime  = starttime;
+    e->generation = table->generation;
+    e->utime      = 0;
+    e->stime      = 0;
+    e->io_time_ms = 0;
+    e->pss_ms     = 0;
+    e->node       = NULL;
+    table->count++;
+    *is_new = 1;
+    return e;
+}
+
+PidTableEntry* pid_table_find(const PidTable* table, pid_t pid, unsigned long long starttime) {
+    if (table->capacity == 0) return NULL;
+
+    size_t mask = table->capacity - 1;
+    size_t i    = pid_hash(pid) & mask;
+    while (table->slots[i].pid != PID_SLOT_EMPTY) {
+        PidTableEntry* e = &table->slots[i];
+        if (e->pid == pid) return (e->starttime == starttime) ? e : NULL;
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+PidTableEntry* pid_table_get(const PidTable* table, pid_t pid) {
+    if (table->capacity == 0 || pid <= 0) return NULL;
+
+    size_t mask = table->capacity - 1;
+    size_t i    = pid_hash(pid) & mask;
+    while (table->slots[i].pid != PID_SLOT_EMPTY) {
+        if (table->slots[i].pid == pid) return &table->slots[i];
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+int pid_table_remove(PidTable* table, pid_t pid) {
+    PidTableEntry* e = pid_table_get(table, pid);
+    if (!e) return 0;
+    // Leave a tombstone so probe chains through this slot stay intact.
+    e->pid = PID_SLOT_DELETED;
+    table->count--;
+    return 1;
+}
+
+void pid_table_clear(PidTable* table) {
+    if (table->used == 0) return;
+    memset(table->slots, 0, table->capacity * sizeof(PidTableEntry));
+    table->count = 0;
+    table->used  = 0;
+}
+
+void pid_table_sweep(PidTable* table) {
+    for (size_t i = 0; i < table->capacity; i++) {
+        PidTableEntry* e = &table->slots[i];
+        if (e->pid == PID_SLOT_EMPTY || e->pid == PID_SLOT_DELETED) continue;
+        if (e->generation != table->generation) {
+            e->pid = PID_SLOT_DELETED;
+            table->count--;
+        }
+    }
+
+    // Shrink once the table is mostly empty, and purge tombstones when they crowd it.
+    size_t target = pid_table_capacity_for(table->count);
+    if (table->capacity > target * 4 || table->used * 2 > table->capacity) {
+        if (table->count == 0) {
+            free(table->slots);
+            table->slots    = NULL;
+            table->capacity = 0;
+            table->used     = 0;
+            return;
+        }
+        pid_table_rehash(table, target);
+    }
+}
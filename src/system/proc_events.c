@@ -0,0 +1,201 @@
+/**
+ * @file proc_events.c
+ * @brief Implementation of the netlink proc connector subscription.
+ * @version 2.0.1
+ */
+
+#include "../../include/system/proc_events.h"
+#include "../../include/core/process.h"
+#include <errno.h>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @struct ProcEventsRequest
+ * @brief Netlink message that (un)subscribes from the proc connector.
+ */
+typedef struct __attribute__((packed)) ProcEventsRequest {
+    struct nlmsghdr       header;
+    struct cn_msg         message;
+    enum proc_cn_mcast_op op;
+} ProcEventsRequest;
+
+/**
+ * @brief Sends a PROC_CN_MCAST_LISTEN or PROC_CN_MCAST_IGNORE request.
+ * @return 0 on success, -1 on failure.
+ */
+static int proc_events_request(int sock, enum proc_cn_mcast_op op) {
+    ProcEventsRequest request;
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len  = sizeof(request);
+    request.header.nlmsg_type = NLMSG_DONE;
+    request.header.nlmsg_pid  = (__u32)getpid();
+    request.message.id.idx    = CN_IDX_PROC;
+    request.message.id.val    = CN_VAL_PROC;
+    request.message.len       = sizeof(request.op);
+    request.op                = op;
+    return send(sock, &request, sizeof(request), 0) == (ssize_t)sizeof(request) ? 0 : -1;
+}
+
+void proc_events_init(ProcEvents* events) {
+    memset(events, 0, sizeof(*events));
+    events->sock = -1;
+    pid_table_init(&events->born);
+}
+
+int proc_events_open(ProcEvents* events) {
+    int sock = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (sock < 0) return -1;
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = CN_IDX_PROC;
+    if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+        proc_events_request(sock, PROC_CN_MCAST_LISTEN) != 0) {
+        int saved = errno;
+        close(sock);
+        errno = saved;
+        return -1;
+    }
+
+    events->sock    = sock;
+    events->overrun = 0;
+    return 0;
+}
+
+/**
+ * @brief Appends one line describing a short-lived process to the exit log.
+ * @param lifetime_ns Time from fork to exit, or 0 if the fork was not observed.
+ */
+static void proc_events_log_exit(ProcEvents* events, const struct proc_event* ev,
+                                 unsigned long long lifetime_ns, const PidTable* sampled) {
+    char      stamp[32];
+    time_t    now = time(NULL);
+    struct tm tm;
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", localtime_r(&now, &tm));
+
+    pid_t          ppid   = ev->event_data.exit.parent_tgid;
+    PidTableEntry* parent = pid_table_get(sampled, ppid);
+    const char*    pname  = (parent && parent->node) ? parent->node->name : "?";
+
+    // exit_code holds the wait() status: a terminating signal or an exit status.
+    unsigned int code = ev->event_data.exit.exit_code;
+    fprintf(events->exit_log, "%s pid=%d ppid=%d parent=%s ", stamp,
+            ev->event_data.exit.process_tgid, ppid, pname);
+    if (code & 0x7f) {
+        fprintf(events->exit_log, "signal=%u", code & 0x7f);
+    } else {
+        fprintf(events->exit_log, "status=%u", (code >> 8) & 0xff);
+    }
+    if (lifetime_ns) {
+        fprintf(events->exit_log, " lifetime_ms=%.3f\n", lifetime_ns / 1e6);
+    } else {
+        fprintf(events->exit_log, " lifetime_ms=?\n");
+    }
+}
+
+/**
+ * @brief Applies one proc connector event to the tracked state.
+ */
+static void proc_events_handle(ProcEvents* events, const struct proc_event* ev,
+                               const PidTable* sampled) {
+    switch (ev->what) {
+        case PROC_EVENT_FORK: {
+            // Threads share the parent's TGID; only new thread group leaders are processes.
+            pid_t pid = ev->event_data.fork.child_pid;
+            if (pid != ev->event_data.fork.child_tgid) break;
+            int is_new;
+            events->forks++;
+            pid_table_touch(&events->born, pid, ev->timestamp_ns, &is_new);
+            break;
+        }
+        case PROC_EVENT_EXEC:
+            if (ev->event_data.exec.process_pid == ev->event_data.exec.process_tgid) {
+                events->execs++;
+            }
+            break;
+        case PROC_EVENT_UID:
+            events->uid_changes++;
+            break;
+        case PROC_EVENT_EXIT: {
+            pid_t pid = ev->event_data.exit.process_pid;
+            if (pid != ev->event_data.exit.process_tgid) break;
+            events->exits++;
+
+            unsigned long long lifetime_ns = 0;
+            PidTableEntry*     born        = pid_table_get(&events->born, pid);
+            if (born) {
+                lifetime_ns = ev->timestamp_ns - born->starttime;
+                pid_table_remove(&events->born, pid);
+            } else if (pid_table_get(sampled, pid)) {
+                break;
+            }
+            events->short_lived++;
+            if (events->exit_log) proc_events_log_exit(events, ev, lifetime_ns, sampled);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+int proc_events_drain(ProcEvents* events, const PidTable* sampled) {
+    if (events->sock < 0) return -1;
+
+    // Large enough for a few dozen events per recv(); each one is about 76 bytes.
+    char buf[8192] __attribute__((aligned(NLMSG_ALIGNTO)));
+    int  count = 0;
+    while (1) {
+        struct sockaddr_nl from;
+        socklen_t          from_len = sizeof(from);
+        ssize_t n = recvfrom(events->sock, buf, sizeof(buf), 0, (struct sockaddr*)&from, &from_len);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno == EINTR) continue;
+            if (errno == ENOBUFS) {
+                // The socket buffer overflowed and events were lost.
+                events->overrun = 1;
+                continue;
+            }
+            proc_events_close(events);
+            return -1;
+        }
+        if (from.nl_pid != 0) continue;  // Only trust messages sent by the kernel.
+
+        for (struct nlmsghdr* nlh = (struct nlmsghdr*)buf; NLMSG_OK(nlh, (size_t)n);
+             nlh = NLMSG_NEXT(nlh, n)) {
+            if (nlh->nlmsg_type == NLMSG_NOOP || nlh->nlmsg_type == NLMSG_ERROR) continue;
+            if (nlh->nlmsg_type == NLMSG_OVERRUN) {
+                events->overrun = 1;
+                continue;
+            }
+            struct cn_msg* message = (struct cn_msg*)NLMSG_DATA(nlh);
+            if (message->id.idx != CN_IDX_PROC || message->id.val != CN_VAL_PROC) continue;
+            // The payload follows the 20-byte cn_msg header, so it is not aligned
+            // for the 64-bit timestamp; copy it out before reading any field.
+            struct proc_event event;
+            size_t            length = message->len < sizeof(event) ? message->len : sizeof(event);
+            memset(&event, 0, sizeof(event));
+            memcpy(&event, message->data, length);
+            proc_events_handle(events, &event, sampled);
+            count++;
+        }
+    }
+    if (events->exit_log) fflush(events->exit_log);
+    return count;
+}
+
+void proc_events_close(ProcEvents* events) {
+    if (events->sock >= 0) {
+        proc_events_request(events->sock, PROC_CN_MCAST_IGNORE);
+        close(events->sock);
+        events->sock = -1;
+    }
+    pid_table_free(&events->born);
+}
@@ -0,0 +1,648 @@
+/**
+ * @file proc_parser.c
+ * @brief Implementation of the zero-stdio /proc/[pid] reader and field scanners.
+ * @version 2.0.1
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "../../include/system/proc_parser.h"
+#include "../../include/system/profile.h"
+#include <fcntl.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/** @brief Longest /proc/stat line that is parsed; longer ones (interrupt counters) are skipped. */
+#define PROC_CPU_LINE_SIZE 512
+/** @brief Size of each read from /proc/stat. */
+#define PROC_CPU_CHUNK_SIZE 4096
+
+static int  proc_fd      = -1;
+static long page_size_kb = 0;
+
+/**
+ * @brief Skips blanks (spaces, tabs) at the cursor.
+ */
+static void scan_blanks(const char** cursor, const char* end) {
+    const char* p = *cursor;
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    *cursor = p;
+}
+
+/**
+ * @brief Scans an unsigned decimal number after optional blanks.
+ * @return int 0 on success, -1 if no digit was found.
+ */
+static int scan_ull(const char** cursor, const char* end, unsigned long long* out) {
+    scan_blanks(cursor, end);
+    const char*        p     = *cursor;
+    unsigned long long value = 0;
+    if (p >= end || *p < '0' || *p > '9') return -1;
+    while (p < end && *p >= '0' && *p <= '9') value = value * 10 + (unsigned long long)(*p++ - '0');
+    *cursor = p;
+    *out    = value;
+    return 0;
+}
+
+/**
+ * @brief Scans a signed decimal number after optional blanks.
+ * @return int 0 on success, -1 if no digit was found.
+ */
+static int scan_ll(const char** cursor, const char* end, long long* out) {
+    scan_blanks(cursor, end);
+    int negative = 0;
+    if (*cursor < end && **cursor == '-') {
+        negative = 1;
+        (*cursor)++;
+    }
+    unsigned long long value;
+    if (scan_ull(cursor, end, &value) != 0) return -1;
+    *out = negative ? -(long long)value : (long long)value;
+    return 0;
+}
+
+/**
+ * @brief Skips @p count blank-separated fields.
+ */
+static void scan_skip(const char** cursor, const char* end, int count) {
+    const char* p = *cursor;
+    for (int i = 0; i < count; i++) {
+        while (p < end && *p == ' ') p++;
+        while (p < end && *p != ' ' && *p != '\n') p++;
+    }
+    *cursor = p;
+}
+
+int proc_format_pid(pid_t pid, char* out) {
+    char tmp[16];
+    int  n = 0, len;
+    do {
+        tmp[n++] = (char)('0' + pid % 10);
+        pid /= 10;
+    } while (pid > 0);
+    len = n;
+    while (n > 0) *out++ = tmp[--n];
+    *out = '\0';
+    return len;
+}
+
+int proc_root_fd() {
+    if (proc_fd < 0) {
+        // Also prime the page size so scan workers never race to initialize it.
+        if (page_size_kb == 0) page_size_kb = sysconf(_SC_PAGESIZE) / 1024;
+        proc_fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        PROFILE_COUNT(PROFILE_SYSCALLS, 1);
+    }
+    return proc_fd;
+}
+
+int proc_set_root(const char* path) {
+    int fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    if (page_size_kb == 0) page_size_kb = sysconf(_SC_PAGESIZE) / 1024;
+    if (proc_fd >= 0) close(proc_fd);
+    proc_fd = fd;
+    return 0;
+}
+
+ssize_t proc_reread(int fd, char* buf, size_t size) {
+    if (fd < 0) return -1;
+    PROFILE_COUNT(PROFILE_SYSCALLS, 1);
+    ssize_t n = pread(fd, buf, size - 1, 0);
+    if (n < 0) return -1;
+    buf[n] = '\0';
+    return n;
+}
+
+ssize_t proc_read_file(int dir_fd, const char* name, char* buf, size_t size) {
+    int fd = openat(dir_fd, name, O_RDONLY | O_CLOEXEC);
+    PROFILE_COUNT(PROFILE_SYSCALLS, fd < 0 ? 1 : 3);
+    if (fd < 0) return -1;
+    ssize_t n = pread(fd, buf, size - 1, 0);
+    close(fd);
+    if (n < 0) return -1;
+    buf[n] = '\0';
+    return n;
+}
+
+int proc_parse_stat(const char* buf, size_t len, ProcessNode* info) {
+    const char* end   = buf + len;
+    const char* open  = memchr(buf, '(', len);
+    const char* close = NULL;
+    // The command name may itself contain ')', so the last one ends it.
+    for (const char* p = end; p > buf; p--) {
+        if (p[-1] == ')') {
+            close = p - 1;
+            break;
+        }
+    }
+    if (!open || !close || close < open) return -1;
+
+    size_t name_len = (size_t)(close - open - 1);
+    if (name_len > sizeof(info->name) - 1) name_len = sizeof(info->name) - 1;
+    memcpy(info->name, open + 1, name_len);
+    info->name[name_len] = '\0';
+
+    // Fields after the name, numbered as in proc(5): 3 state, 4 ppid, 14 utime,
+    // 15 stime, 18 priority, 19 nice, 22 starttime.
+    const char* p = close + 1;
+    scan_blanks(&p, end);
+    if (p >= end) return -1;
+    info->state = *p++;
+
+    long long          ppid, priority, nice;
+    unsigned long long utime, stime, starttime;
+    if (scan_ll(&p, end, &ppid) != 0) return -1;
+    scan_skip(&p, end, 9);
+    if (scan_ull(&p, end, &utime) != 0 || scan_ull(&p, end, &stime) != 0) return -1;
+    scan_skip(&p, end, 2);
+    if (scan_ll(&p, end, &priority) != 0 || scan_ll(&p, end, &nice) != 0) return -1;
+    scan_skip(&p, end, 2);
+    if (scan_ull(&p, end, &starttime) != 0) return -1;
+
+    info->ppid       = (pid_t)ppid;
+    info->utime      = (unsigned long)utime;
+    info->stime      = (unsigned long)stime;
+    info->priority   = (long)priority;
+    info->nice_value = (long)nice;
+    info->starttime  = starttime;
+    return 0;
+}
+
+int proc_parse_statm(const char* buf, size_t len, ProcessNode* info) {
+    const char*        p   = buf;
+    const char*        end = buf + len;
+    unsigned long long size, rss;
+    if (scan_ull(&p, end, &size) != 0 || scan_ull(&p, end, &rss) != 0) {
+        info->memory_kb = 0;
+        info->vsz_kb    = -1;
+        return -1;
+    }
+    if (page_size_kb == 0) page_size_kb = sysconf(_SC_PAGESIZE) / 1024;
+    info->memory_kb = (long)rss * page_size_kb;
+    info->vsz_kb    = (long)size * page_size_kb;
+    return 0;
+}
+
+void proc_parse_status(const char* buf, size_t len, ProcessNode* info) {
+    const char* p   = buf;
+    const char* end = buf + len;
+    int         found = 0;
+
+    info->uid         = 0;
+    info->num_threads = 1;
+    info->anon_kb = info->file_kb = info->shmem_kb = info->swap_kb = -1;
+
+    // The memory lines all come before Threads, so the scan still ends there.
+    static const struct {
+        const char* key;
+        size_t      offset;
+    } memory[] = {
+        {"RssAnon:", offsetof(ProcessNode, anon_kb)},
+        {"RssFile:", offsetof(ProcessNode, file_kb)},
+        {"RssShmem:", offsetof(ProcessNode, shmem_kb)},
+        {"VmSwap:", offsetof(ProcessNode, swap_kb)},
+    };
+    while (p < end && found < 2) {
+        const char* eol = memchr(p, '\n', (size_t)(end - p));
+        if (!eol) eol = end;
+
+        unsigned long long value;
+        const char*        v = p;
+        if (eol - p > 4 && memcmp(p, "Uid:", 4) == 0) {
+            v += 4;
+            if (scan_ull(&v, eol, &value) == 0) info->uid = (uid_t)value;
+            found++;
+        } else if (eol - p > 8 && memcmp(p, "Threads:", 8) == 0) {
+            v += 8;
+            if (scan_ull(&v, eol, &value) == 0) info->num_threads = (int)value;
+            found++;
+        } else if (eol - p > 7 && (p[0] == 'R' || p[0] == 'V')) {
+            for (size_t i = 0; i < sizeof(memory) / sizeof(memory[0]); i++) {
+                size_t key_len = strlen(memory[i].key);
+                if ((size_t)(eol - p) <= key_len || memcmp(p, memory[i].key, key_len) != 0) {
+                    continue;
+                }
+                v += key_len;
+                if (scan_ull(&v, eol, &value) == 0) {
+                    *(long*)((char*)info + memory[i].offset) = (long)value;
+                }
+                break;
+            }
+        }
+        p = eol + 1;
+    }
+}
+
+int proc_parse_files(pid_t pid, const char* stat, ssize_t stat_len, const char* statm,
+                     ssize_t statm_len, const char* status, ssize_t status_len,
+                     ProcessNode* info) {
+    info->pid = pid;
+    if (stat_len <= 0 || proc_parse_stat(stat, (size_t)stat_len, info) != 0) return -1;
+
+    if (!statm || statm_len <= 0 || proc_parse_statm(statm, (size_t)statm_len, info) != 0) {
+        info->memory_kb = 0;
+        info->vsz_kb    = -1;
+    }
+    // PSS and USS come from smaps_rollup, which only the process table reads.
+    info->pss_kb = info->uss_kb = -1;
+
+    if (status && status_len > 0) {
+        proc_parse_status(status, (size_t)status_len, info);
+        return 0;
+    }
+    info->anon_kb = info->file_kb = info->shmem_kb = info->swap_kb = -1;
+    if (!status) {
+        // Not wanted: no owner to resolve, and no thread count to show.
+        info->uid         = (uid_t)-1;
+        info->num_threads = 0;
+        return 0;
+    }
+    info->uid         = 0;
+    info->num_threads = 1;
+    return 1;
+}
+
+int proc_read_process(int root_fd, pid_t pid, int files, ProcessNode* info) {
+    char name[16];
+    proc_format_pid(pid, name);
+    int pid_fd = openat(root_fd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    PROFILE_COUNT(PROFILE_SYSCALLS, pid_fd < 0 ? 1 : 2);
+    if (pid_fd < 0) return -1;
+
+    char    stat[PROC_STAT_BUF_SIZE];
+    char    statm[PROC_STATM_BUF_SIZE];
+    char    status[PROC_STATUS_BUF_SIZE];
+    ssize_t stat_len   = proc_read_file(pid_fd, "stat", stat, sizeof(stat));
+    ssize_t statm_len  = -1;
+    ssize_t status_len = -1;
+    // Without stat the process is unusable, so skip the other two files.
+    if (stat_len > 0 && (files & PROC_FILE_STATM)) {
+        statm_len = proc_read_file(pid_fd, "statm", statm, sizeof(statm));
+    }
+    if (stat_len > 0 && (files & PROC_FILE_STATUS)) {
+        status_len = proc_read_file(pid_fd, "status", status, sizeof(status));
+    }
+    close(pid_fd);
+
+    return proc_parse_files(pid, stat, stat_len, (files & PROC_FILE_STATM) ? statm : NULL,
+                            statm_len, (files & PROC_FILE_STATUS) ? status : NULL, status_len,
+                            info);
+}
+
+unsigned long long proc_cpu_total(const CpuTimes* times) {
+    return times->user + times->nice + times->system + times->idle + times->iowait + times->irq +
+           times->softirq + times->steal;
+}
+
+/**
+ * @brief Scans the eight CPU time fields after a "cpu" or "cpuN" label.
+ * @return int 0 on success, -1 if not even user, nice, system, and idle are present.
+ */
+static int scan_cpu_times(const char* p, const char* end, CpuTimes* times) {
+    unsigned long long* fields[] = {&times->user,   &times->nice, &times->system,  &times->idle,
+                                    &times->iowait, &times->irq,  &times->softirq, &times->steal};
+    for (int i = 0; i < 8; i++) {
+        // Kernels older than 2.6.11 stop early; the missing fields stay zero.
+        if (scan_ull(&p, end, fields[i]) != 0) return i >= 4 ? 0 : -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Parses one line of /proc/stat; lines ProcX does not use are ignored.
+ * @return int 1 if the line was a valid aggregate "cpu" line, 0 otherwise.
+ */
+static int cpu_stat_line(const char* p, const char* end, CpuStat* stat) {
+    size_t             len = (size_t)(end - p);
+    unsigned long long value;
+    if (len > 4 && memcmp(p, "cpu", 3) == 0) {
+        if (p[3] == ' ') return scan_cpu_times(p + 3, end, &stat->total) == 0;
+        const char* q = p + 3;
+        if (scan_ull(&q, end, &value) != 0 || value >= PROC_MAX_CPUS) return 0;
+        if (scan_cpu_times(q, end, &stat->cores[value]) == 0 && (int)value >= stat->core_count) {
+            stat->core_count = (int)value + 1;
+        }
+    } else if (len > 5 && memcmp(p, "ctxt ", 5) == 0) {
+        p += 5;
+        if (scan_ull(&p, end, &value) == 0) stat->ctxt = value;
+    } else if (len > 14 && memcmp(p, "procs_running ", 14) == 0) {
+        p += 14;
+        if (scan_ull(&p, end, &value) == 0) stat->procs_running = (int)value;
+    } else if (len > 14 && memcmp(p, "procs_blocked ", 14) == 0) {
+        p += 14;
+        if (scan_ull(&p, end, &value) == 0) stat->procs_blocked = (int)value;
+    }
+    return 0;
+}
+
+int proc_parse_cpu_stat(const char* buf, size_t len, CpuStat* stat) {
+    long long time_ms = stat->time_ms;
+    memset(stat, 0, sizeof(*stat));
+    stat->time_ms   = time_ms;
+    int         found = 0;
+    const char* p     = buf;
+    const char* end   = buf + len;
+    while (p < end) {
+        const char* eol = memchr(p, '\n', (size_t)(end - p));
+        if (!eol) eol = end;
+        found |= cpu_stat_line(p, eol, stat);
+        p = eol + 1;
+    }
+    return found ? 0 : -1;
+}
+
+int proc_read_cpu_stat(int fd, CpuStat* stat) {
+    memset(stat, 0, sizeof(*stat));
+    if (fd < 0) return -1;
+
+    // Lines are assembled across chunk boundaries; one that outgrows the line
+    // buffer is an interrupt counter line and is dropped as it streams past.
+    char    chunk[PROC_CPU_CHUNK_SIZE];
+    char    line[PROC_CPU_LINE_SIZE];
+    size_t  line_len = 0;
+    int     skipping = 0, found = 0;
+    off_t   offset   = 0;
+    ssize_t n;
+    while ((n = pread(fd, chunk, sizeof(chunk), offset)) > 0) {
+        PROFILE_COUNT(PROFILE_SYSCALLS, 1);
+        offset += n;
+        const char* p   = chunk;
+        const char* end = chunk + n;
+        while (p < end) {
+            const char* eol  = memchr(p, '\n', (size_t)(end - p));
+            size_t      part = (size_t)((eol ? eol : end) - p);
+            if (!skipping && line_len + part < sizeof(line)) {
+                memcpy(line + line_len, p, part);
+                line_len += part;
+            } else {
+                skipping = 1;
+            }
+            if (!eol) break;
+            if (!skipping) found |= cpu_stat_line(line, line + line_len, stat);
+            line_len = 0;
+            skipping = 0;
+            p        = eol + 1;
+        }
+    }
+    if (!skipping && line_len > 0) found |= cpu_stat_line(line, line + line_len, stat);
+    PROFILE_COUNT(PROFILE_SYSCALLS, 1);  // The read that ended the loop
+
+    if (n < 0 || !found) {
+        memset(stat, 0, sizeof(*stat));
+        return -1;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    stat->time_ms = (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+    return 0;
+}
+
+/**
+ * @struct MemInfoKey
+ * @brief A /proc/meminfo key and the MemInfo field it fills.
+ */
+typedef struct MemInfoKey {
+    const char* name;   /**< Key including the colon */
+    size_t      length; /**< Length of name */
+    size_t      offset; /**< Offset of the field in MemInfo */
+} MemInfoKey;
+
+#define MEMINFO_KEY(name, field) {name, sizeof(name) - 1, offsetof(MemInfo, field)}
+
+/** @brief The keys ProcX reads, in the order the kernel prints them. */
+static const MemInfoKey meminfo_keys[] = {
+    MEMINFO_KEY("MemTotal:", total_kb),          MEMINFO_KEY("MemFree:", free_kb),
+    MEMINFO_KEY("MemAvailable:", available_kb),  MEMINFO_KEY("Buffers:", buffers_kb),
+    MEMINFO_KEY("Cached:", cached_kb),           MEMINFO_KEY("SwapTotal:", swap_total_kb),
+    MEMINFO_KEY("SwapFree:", swap_free_kb),
+};
+
+#define MEMINFO_KEY_COUNT (sizeof(meminfo_keys) / sizeof(meminfo_keys[0]))
+
+int proc_parse_meminfo(const char* buf, size_t len, MemInfo* info) {
+    memset(info, 0, sizeof(*info));
+    const char* p     = buf;
+    const char* end   = buf + len;
+    unsigned    found = 0, mask = 0;
+    while (p < end && found < MEMINFO_KEY_COUNT) {
+        const char* eol   = memchr(p, '\n', (size_t)(end - p));
+        const char* colon = memchr(p, ':', (size_t)((eol ? eol : end) - p));
+        if (!eol) eol = end;
+        if (colon) {
+            size_t length = (size_t)(colon + 1 - p);
+            for (unsigned i = 0; i < MEMINFO_KEY_COUNT; i++) {
+                const MemInfoKey* key = &meminfo_keys[i];
+                if (key->length != length || (mask & (1u << i))) continue;
+                if (memcmp(p, key->name, length) != 0) continue;
+                const char*        v = colon + 1;
+                unsigned long long value;
+                if (scan_ull(&v, eol, &value) == 0) {
+                    *(long*)((char*)info + key->offset) = (long)value;
+                }
+                mask |= 1u << i;
+                found++;
+                break;
+            }
+        }
+        p = eol + 1;
+    }
+    return (mask & 1u) ? 0 : -1;
+}
+
+/**
+ * @brief Scans a non-negative decimal with an optional fraction, such as "0.25".
+ * @return int 0 on success, -1 if no digit was found.
+ */
+static int scan_decimal(const char** cursor, const char* end, double* out) {
+    unsigned long long whole;
+    if (scan_ull(cursor, end, &whole) != 0) return -1;
+    double value = (double)whole;
+    if (*cursor < end && **cursor == '.') {
+        double scale = 0.1;
+        for ((*cursor)++; *cursor < end && **cursor >= '0' && **cursor <= '9'; (*cursor)++) {
+            value += (**cursor - '0') * scale;
+            scale /= 10;
+        }
+    }
+    *out = value;
+    return 0;
+}
+
+int proc_parse_loadavg(const char* buf, size_t len, double load[3]) {
+    const char* p   = buf;
+    const char* end = buf + len;
+    for (int i = 0; i < 3; i++) {
+        if (scan_decimal(&p, end, &load[i]) != 0) return -1;
+    }
+    return 0;
+}
+
+const char* const proc_pressure_names[PRESSURE_RESOURCES] = {"cpu", "memory", "io"};
+
+/**
+ * @brief Scans "avgN=" followed by a decimal.
+ * @return int 0 on success, -1 if the key or the number is missing.
+ */
+static int scan_pressure_avg(const char** cursor, const char* end, const char* key, float* out) {
+    size_t key_len = strlen(key);
+    scan_blanks(cursor, end);
+    if ((size_t)(end - *cursor) < key_len || memcmp(*cursor, key, key_len) != 0) return -1;
+    *cursor += key_len;
+    double value;
+    if (scan_decimal(cursor, end, &value) != 0) return -1;
+    *out = (float)value;
+    return 0;
+}
+
+int proc_parse_pressure(const char* buf, size_t len, PressureStat* stat) {
+    const char* p    = buf;
+    const char* end  = buf + len;
+    int         some = 0;
+    memset(stat, 0, sizeof(*stat));
+    while (p < end) {
+        const char* eol = memchr(p, '\n', (size_t)(end - p));
+        if (!eol) eol = end;
+        int is_some = eol - p > 5 && memcmp(p, "some ", 5) == 0;
+        int is_full = eol - p > 5 && memcmp(p, "full ", 5) == 0;
+        if (is_some || is_full) {
+            const char* cursor = p + 5;
+            float       avg10, avg60;
+            if (scan_pressure_avg(&cursor, eol, "avg10=", &avg10) == 0 &&
+                scan_pressure_avg(&cursor, eol, "avg60=", &avg60) == 0) {
+                if (is_some) {
+                    stat->some_avg10 = avg10;
+                    stat->some_avg60 = avg60;
+                    some             = 1;
+                } else {
+                    stat->full_avg10 = avg10;
+                    stat->full_avg60 = avg60;
+                }
+            }
+        }
+        p = eol + 1;
+    }
+    return some ? 0 : -1;
+}
+
+int proc_parse_io(const char* buf, size_t len, ProcIo* io) {
+    static const struct {
+        const char* key;
+        size_t      offset;
+    } keys[] = {
+        {"read_bytes:", offsetof(ProcIo, read_bytes)},
+        {"write_bytes:", offsetof(ProcIo, write_bytes)},
+        {"syscr:", offsetof(ProcIo, syscr)},
+        {"syscw:", offsetof(ProcIo, syscw)},
+    };
+    const char* p     = buf;
+    const char* end   = buf + len;
+    int         found = 0;
+    memset(io, 0, sizeof(*io));
+    while (p < end) {
+        const char* eol = memchr(p, '\n', (size_t)(end - p));
+        if (!eol) eol = end;
+        for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+            size_t key_len = strlen(keys[i].key);
+            if ((size_t)(eol - p) <= key_len || memcmp(p, keys[i].key, key_len) != 0) continue;
+            const char*         cursor = p + key_len;
+            unsigned long long* value  = (unsigned long long*)((char*)io + keys[i].offset);
+            if (scan_ull(&cursor, eol, value) == 0 && i < 2) found = 1;
+            break;
+        }
+        p = eol + 1;
+    }
+    return found ? 0 : -1;
+}
+
+int proc_parse_smaps_rollup(const char* buf, size_t len, ProcRollup* rollup) {
+    const char* p   = buf;
+    const char* end = buf + len;
+    int         found = 0;
+    rollup->pss_kb = rollup->uss_kb = 0;
+    while (p < end) {
+        const char* eol = memchr(p, '\n', (size_t)(end - p));
+        if (!eol) eol = end;
+
+        // USS is the memory no other process maps: Private_Clean plus Private_Dirty.
+        unsigned long long value;
+        const char*        v = p;
+        if (eol - p > 4 && memcmp(p, "Pss:", 4) == 0) {
+            v += 4;
+            if (scan_ull(&v, eol, &value) == 0) {
+                rollup->pss_kb = (long)value;
+                found          = 1;
+            }
+        } else if (eol - p > 14 && (memcmp(p, "Private_Clean:", 14) == 0 ||
+                                    memcmp(p, "Private_Dirty:", 14) == 0)) {
+            v += 14;
+            if (scan_ull(&v, eol, &value) == 0) rollup->uss_kb += (long)value;
+        }
+        p = eol + 1;
+    }
+    return found ? 0 : -1;
+}
+
+int proc_read_smaps_rollup(int root_fd, pid_t pid, ProcRollup* rollup) {
+    char name[32];
+    char buf[PROC_ROLLUP_BUF_SIZE];
+    int  len = proc_format_pid(pid, name);
+    memcpy(name + len, "/smaps_rollup", sizeof("/smaps_rollup"));
+    ssize_t n = proc_read_file(root_fd, name, buf, sizeof(buf));
+    if (n <= 0) return -1;
+    return proc_parse_smaps_rollup(buf, (size_t)n, rollup);
+}
+
+int proc_read_io(int root_fd, pid_t pid, ProcIo* io) {
+    char name[24];
+    char buf[PROC_IO_BUF_SIZE];
+    int  len = proc_format_pid(pid, name);
+    memcpy(name + len, "/io", sizeof("/io"));
+    ssize_t n = proc_read_file(root_fd, name, buf, sizeof(buf));
+    if (n <= 0) return -1;
+    return proc_parse_io(buf, (size_t)n, io);
+}
+
+int proc_parse_diskstats(const char* buf, size_t len, DiskCounters* disks, int max) {
+    const char* p     = buf;
+    const char* end   = buf + len;
+    int         count = 0;
+    while (p < end && count < max) {
+        const char* eol = memchr(p, '\n', (size_t)(end - p));
+        if (!eol) eol = end;
+
+        // major minor name reads merged sectors ms writes merged sectors ms in_flight io_ticks
+        const char* cursor = p;
+        scan_skip(&cursor, eol, 2);
+        scan_blanks(&cursor, eol);
+        const char* name = cursor;
+        while (cursor < eol && *cursor != ' ') cursor++;
+        size_t             name_len = (size_t)(cursor - name);
+        DiskCounters*      disk     = &disks[count];
+        unsigned long long fields[10];
+        int                parsed = 0;
+        while (parsed < 10 && scan_ull(&cursor, eol, &fields[parsed]) == 0) parsed++;
+        if (name_len > 0 && name_len < sizeof(disk->name) && parsed == 10) {
+            memcpy(disk->name, name, name_len);
+            disk->name[name_len]  = '\0';
+            disk->sectors_read    = fields[2];
+            disk->sectors_written = fields[6];
+            disk->io_ticks        = fields[9];
+            count++;
+        }
+        p = eol + 1;
+    }
+    return count;
+}
+
+int proc_parse_uptime(const char* buf, size_t len, long* seconds) {
+    const char*        p = buf;
+    unsigned long long whole;
+    if (scan_ull(&p, buf + len, &whole) != 0) return -1;
+    *seconds = (long)whole;
+    return 0;
+}
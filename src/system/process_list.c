@@ -1,189 +1,749 @@
 /**
  * @file process_list.c
- * @brief Implementation of process list building, sorting, and CPU calculation.
+ * @brief Implementation of the persistent process table and CPU calculation.
  * @version 2.0.1
  */
 
 #include "../../include/system/process_list.h"
 #include "../../include/system/sys_info.h"
+#include "../../include/system/pid_table.h"
+#include "../../include/system/proc_parser.h"
+#include "../../include/system/profile.h"
+#include "../../include/system/scan_pool.h"
+#include "../../include/system/user_cache.h"
 #include <stdio.h>
 #include <dirent.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <fcntl.h>
 #include <string.h>
 #include <unistd.h>
 
 /**
- * @struct PrevTicks
- * @brief Stores previous tick counts for a process to calculate CPU usage.
+ * @brief Upper bound on recycled nodes kept for reuse, relative to the live count.
  */
-typedef struct PrevTicks {
-    pid_t         pid;
-    unsigned long utime;
-    unsigned long stime;
-} PrevTicks;
+#define PROCESS_TABLE_FREE_SLACK(count) (256 + (count) / 8)
 
-static PrevTicks* prev_ticks_list  = NULL;
-static int        prev_ticks_count = 0;
+/**
+ * @brief Smallest batch for which the scan is split across worker threads.
+ */
+#define PROCESS_SCAN_PARALLEL_MIN 512
 
 /**
- * @brief Updates or adds a process's ticks to the global tracking list.
+ * @brief Takes a node from the table's free list, allocating only when it is empty.
  */
-static void update_prev_ticks(pid_t pid, unsigned long utime, unsigned long stime) {
-    for (int i = 0; i < prev_ticks_count; i++) {
-        if (prev_ticks_list[i].pid == pid) {
-            prev_ticks_list[i].utime = utime;
-            prev_ticks_list[i].stime = stime;
-            return;
-        }
+static ProcessNode* process_table_alloc_node(ProcessTable* table) {
+    ProcessNode* node = table->free_nodes;
+    if (node) {
+        table->free_nodes = node->next;
+        table->free_count--;
+        return node;
     }
-    prev_ticks_list = realloc(prev_ticks_list, sizeof(PrevTicks) * (prev_ticks_count + 1));
-    prev_ticks_list[prev_ticks_count].pid   = pid;
-    prev_ticks_list[prev_ticks_count].utime = utime;
-    prev_ticks_list[prev_ticks_count].stime = stime;
-    prev_ticks_count++;
+    PROFILE_COUNT(PROFILE_ALLOCS, 1);
+    return (ProcessNode*)malloc(sizeof(ProcessNode));
 }
 
 /**
- * @brief Retrieves previous ticks for a process.
+ * @brief Returns a node to the free list, or releases it once the list is large enough.
  */
-static int get_prev_ticks(pid_t pid, unsigned long* utime, unsigned long* stime) {
-    for (int i = 0; i < prev_ticks_count; i++) {
-        if (prev_ticks_list[i].pid == pid) {
-            *utime = prev_ticks_list[i].utime;
-            *stime = prev_ticks_list[i].stime;
-            return 0;
+static void process_table_release_node(ProcessTable* table, ProcessNode* node) {
+    if (table->free_count >= PROCESS_TABLE_FREE_SLACK(table->count)) {
+        free(node);
+        return;
+    }
+    node->next        = table->free_nodes;
+    table->free_nodes = node;
+    table->free_count++;
+}
+
+/**
+ * @brief Returns every thread row of a process to the free list.
+ */
+static void process_table_release_threads(ProcessTable* table, ProcessNode* owner) {
+    ProcessNode* thread = owner->threads;
+    while (thread) {
+        ProcessNode* next = thread->next;
+        process_table_release_node(table, thread);
+        thread = next;
+    }
+    owner->threads = NULL;
+}
+
+/**
+ * @brief Records the PID of an exited process in the change set.
+ */
+static void process_table_push_exited(ProcessTable* table, pid_t pid) {
+    if (table->exited_count == table->exited_capacity) {
+        int    capacity = table->exited_capacity ? table->exited_capacity * 2 : 64;
+        pid_t* exited   = realloc(table->exited, sizeof(pid_t) * capacity);
+        PROFILE_COUNT(PROFILE_ALLOCS, 1);
+        if (!exited) return;
+        table->exited          = exited;
+        table->exited_capacity = capacity;
+    }
+    table->exited[table->exited_count++] = pid;
+}
+
+/**
+ * @brief Checks whether any value shown for a process differs between two samples.
+ */
+static int process_node_differs(const ProcessNode* a, const ProcessNode* b) {
+    return a->state != b->state || a->ppid != b->ppid || a->uid != b->uid ||
+           a->num_threads != b->num_threads || a->memory_kb != b->memory_kb ||
+           a->vsz_kb != b->vsz_kb || a->anon_kb != b->anon_kb || a->file_kb != b->file_kb ||
+           a->shmem_kb != b->shmem_kb || a->swap_kb != b->swap_kb || a->pss_kb != b->pss_kb ||
+           a->uss_kb != b->uss_kb ||
+           a->utime != b->utime || a->stime != b->stime || a->priority != b->priority ||
+           a->nice_value != b->nice_value || strcmp(a->name, b->name) != 0 ||
+           a->cgroup_id != b->cgroup_id || a->io_read != b->io_read ||
+           a->io_write != b->io_write || a->io_syscalls != b->io_syscalls ||
+           strcmp(a->username, b->username) != 0;
+}
+
+/**
+ * @brief Returns the growth of a counter, 0 if it went backwards.
+ */
+static float process_io_delta(unsigned long long now, unsigned long long before) {
+    return now > before ? (float)(now - before) : 0.0f;
+}
+
+/**
+ * @brief Reads the I/O counters of a process and sets its rates from the
+ *        counters kept in its PID table entry.
+ * @param now_ms Monotonic time of this update.
+ */
+static void process_table_read_io(int root_fd, ProcessNode* parsed, PidTableEntry* entry,
+                                  long long now_ms) {
+    ProcIo io;
+    parsed->io_read = parsed->io_write = parsed->io_syscalls = -1.0f;
+    if (root_fd < 0 || proc_read_io(root_fd, parsed->pid, &io) != 0) {
+        entry->io_time_ms = 0;
+        return;
+    }
+
+    unsigned long long calls   = io.syscr + io.syscw;
+    long long          elapsed = now_ms - entry->io_time_ms;
+    if (entry->io_time_ms > 0 && elapsed > 0) {
+        parsed->io_read     = process_io_delta(io.read_bytes, entry->io_read) * 1000.0f / elapsed;
+        parsed->io_write    = process_io_delta(io.write_bytes, entry->io_write) * 1000.0f / elapsed;
+        parsed->io_syscalls = process_io_delta(calls, entry->io_calls) * 1000.0f / elapsed;
+    } else {
+        parsed->io_read = parsed->io_write = parsed->io_syscalls = 0.0f;
+    }
+    entry->io_read    = io.read_bytes;
+    entry->io_write   = io.write_bytes;
+    entry->io_calls   = calls;
+    entry->io_time_ms = now_ms;
+}
+
+/**
+ * @brief Measures PSS and USS if the view asks for a process and its last
+ *        measurement is due, then copies the last measurement to the node.
+ * @param now_ms Monotonic time of this update.
+ */
+static void process_table_read_rollup(const MemoryView* view, int root_fd, ProcessNode* parsed,
+                                      PidTableEntry* entry, long long now_ms) {
+    int due = entry->pss_ms == 0 || now_ms - entry->pss_ms >= view->max_age_ms;
+    if (due && root_fd >= 0 && memory_view_wants(view, parsed->pid)) {
+        ProcRollup rollup;
+        if (proc_read_smaps_rollup(root_fd, parsed->pid, &rollup) == 0) {
+            entry->pss_kb = rollup.pss_kb;
+            entry->uss_kb = rollup.uss_kb;
+        } else {
+            // Kernel threads and other users' processes: do not retry until due again.
+            entry->pss_kb = entry->uss_kb = -1;
         }
+        entry->pss_ms = now_ms;
     }
-    return -1;
+    parsed->pss_kb = entry->pss_ms ? entry->pss_kb : -1;
+    parsed->uss_kb = entry->pss_ms ? entry->uss_kb : -1;
+}
+
+void process_table_init(ProcessTable* table) {
+    memset(table, 0, sizeof(*table));
+    pid_table_init(&table->index);
+    pid_table_init(&table->thread_ticks);
+    thread_view_init(&table->thread_view);
+    memory_view_init(&table->memory_view, MEMORY_VIEW_DEFAULT_AGE_MS);
+    proc_events_init(&table->events);
+    system_sampler_init(&table->system);
+    cgroup_sampler_init(&table->cgroups, NULL);
+    table->workers = 1;
+    table->files   = PROC_FILES_SCAN;
+}
+
+/**
+ * @brief Ensures the PID and parse buffers can hold @p count processes.
+ * @return 0 on success, -1 on allocation failure.
+ */
+static int process_table_reserve(ProcessTable* table, int count) {
+    if (count <= table->scan_capacity) return 0;
+
+    int capacity = table->scan_capacity ? table->scan_capacity : 1024;
+    while (capacity < count) capacity *= 2;
+    PROFILE_COUNT(PROFILE_ALLOCS, 2);
+
+    pid_t* pids = realloc(table->pids, sizeof(pid_t) * capacity);
+    if (!pids) return -1;
+    table->pids = pids;
+
+    ProcessNode* scratch = realloc(table->scratch, sizeof(ProcessNode) * capacity);
+    if (!scratch) return -1;
+    table->scratch       = scratch;
+    table->scan_capacity = capacity;
+    return 0;
 }
 
-ProcessNode* build_process_list() {
-    DIR* dir = opendir("/proc");
-    if (!dir) return NULL;
+/**
+ * @brief Collects the numeric entries of /proc into the table's PID buffer.
+ * @return Number of PIDs collected, or -1 if /proc cannot be read.
+ */
+static int process_table_collect_pids(ProcessTable* table) {
+    if (!table->proc_dir) {
+        // A descriptor of its own, so that readdir() has an offset of its own.
+        int root_fd = proc_root_fd();
+        int dir_fd  = root_fd < 0 ? -1 : openat(root_fd, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dir_fd >= 0) table->proc_dir = fdopendir(dir_fd);
+        if (!table->proc_dir) {
+            if (dir_fd >= 0) close(dir_fd);
+            return -1;
+        }
+    } else {
+        rewinddir(table->proc_dir);
+    }
 
+    int            count = 0;
     struct dirent* entry;
-    ProcessNode*   head = NULL;
-    ProcessNode*   tail = NULL;
+    while ((entry = readdir(table->proc_dir)) != NULL) {
+        if (!isdigit(entry->d_name[0])) continue;
+        if (count == table->scan_capacity && process_table_reserve(table, count + 1) != 0) break;
+        table->pids[count++] = (pid_t)atoi(entry->d_name);
+    }
+    return count;
+}
 
-    static unsigned long long last_total_time = 0;
-    unsigned long long        total_time      = 0;
-    FILE*                     stat_file       = fopen("/proc/stat", "r");
-    if (stat_file) {
-        unsigned long long user, nice, system, idle, iowait, irq, softirq, steal;
-        if (fscanf(stat_file, "cpu %llu %llu %llu %llu %llu %llu %llu %llu", &user, &nice, &system,
-                   &idle, &iowait, &irq, &softirq, &steal) == 8) {
-            total_time = user + nice + system + idle + iowait + irq + softirq + steal;
+/**
+ * @brief Builds the PID buffer from event tracking instead of readdir(): every
+ *        process in the table plus those forked since the previous update.
+ *
+ * Processes that exited since then are still listed; their directory no longer
+ * opens, so the merge drops them like any other vanished PID.
+ *
+ * @return Number of PIDs collected, or -1 on allocation failure.
+ */
+static int process_table_collect_tracked(ProcessTable* table) {
+    PidTable* born = &table->events.born;
+    if (process_table_reserve(table, table->count + (int)born->count) != 0) return -1;
+
+    int count = 0;
+    for (ProcessNode* node = table->head; node; node = node->next) table->pids[count++] = node->pid;
+    for (size_t i = 0; i < born->capacity; i++) {
+        pid_t pid = born->slots[i].pid;
+        // A PID may already be listed if the last readdir() raced with its fork.
+        if (pid > 0 && !pid_table_get(&table->index, pid)) table->pids[count++] = pid;
+    }
+    pid_table_clear(born);
+    return count;
+}
+
+/**
+ * @brief Collects the PIDs to sample, from proc events when they are enabled and
+ *        trustworthy, otherwise (and periodically, to reconcile) with readdir().
+ * @return Number of PIDs collected, or -1 if /proc cannot be read.
+ */
+static int process_table_collect(ProcessTable* table) {
+    ProcEvents* events = &table->events;
+    if (events->sock < 0) return process_table_collect_pids(table);
+
+    proc_events_drain(events, &table->index);
+    if (events->sock >= 0 && !events->overrun && table->rescan_countdown > 0) {
+        table->rescan_countdown--;
+        int count = process_table_collect_tracked(table);
+        if (count >= 0) return count;
+    }
+
+    // Everything forked so far is about to be seen by readdir().
+    events->overrun         = 0;
+    table->rescan_countdown = PROCESS_EVENTS_RESCAN_INTERVAL;
+    pid_table_clear(&events->born);
+    return process_table_collect_pids(table);
+}
+
+/**
+ * @brief Parses all collected PIDs into the scratch buffer, in parallel when
+ *        the table is configured with several workers and the batch is large enough.
+ */
+static void process_table_parse(ProcessTable* table, int count) {
+    int root_fd = proc_root_fd();
+    int files   = table->files;
+    if (root_fd < 0) {
+        for (int i = 0; i < count; i++) table->scratch[i].pid = 0;
+        return;
+    }
+
+    if (table->backend == SCAN_BACKEND_URING) {
+        if (!table->uring) table->uring = uring_scan_create();
+        if (table->uring && uring_scan_parse(table->uring, root_fd, files, table->pids,
+                                             table->scratch, count) == 0) {
+            return;
+        }
+        // io_uring is unavailable or failed mid-scan: fall back for good.
+        uring_scan_destroy(table->uring);
+        table->uring   = NULL;
+        table->backend = SCAN_BACKEND_SYNC;
+    }
+
+    int workers = table->workers;
+    if (workers > 1 && count >= PROCESS_SCAN_PARALLEL_MIN) {
+        if (table->pool && scan_pool_workers(table->pool) != workers) {
+            scan_pool_destroy(table->pool);
+            table->pool = NULL;
+        }
+        if (!table->pool) table->pool = scan_pool_create(workers);
+        if (table->pool) {
+            scan_pool_parse(table->pool, root_fd, files, table->pids, table->scratch, count);
+            return;
         }
-        fclose(stat_file);
     }
+    scan_parse_range(root_fd, files, table->pids, table->scratch, count);
+}
+
+void process_table_set_workers(ProcessTable* table, int workers) {
+    if (workers < 1) workers = 1;
+    if (workers > SCAN_POOL_MAX_WORKERS) workers = SCAN_POOL_MAX_WORKERS;
+    table->workers = workers;
+}
 
-    unsigned long long total_time_diff = total_time - last_total_time;
+void process_table_set_backend(ProcessTable* table, ScanBackend backend) {
+    table->backend = backend;
+}
 
-    while ((entry = readdir(dir)) != NULL) {
-        if (isdigit(entry->d_name[0])) {
-            pid_t        pid      = (pid_t)atoi(entry->d_name);
-            ProcessNode* new_node = (ProcessNode*)malloc(sizeof(ProcessNode));
-            if (!new_node) continue;
-
-            if (get_process_info(pid, new_node) == 0) {
-                unsigned long prev_utime, prev_stime;
-                if (get_prev_ticks(pid, &prev_utime, &prev_stime) == 0 && total_time_diff > 0) {
-                    unsigned long process_diff =
-                        (new_node->utime + new_node->stime) - (prev_utime + prev_stime);
-                    new_node->cpu_usage = (float)(process_diff * 100.0) / total_time_diff;
-                } else {
-                    new_node->cpu_usage = 0.0f;
-                }
-                update_prev_ticks(pid, new_node->utime, new_node->stime);
-
-                new_node->next = NULL;
-                if (!head) {
-                    head = new_node;
-                    tail = new_node;
-                } else {
-                    tail->next = new_node;
-                    tail       = new_node;
-                }
-            } else {
-                free(new_node);
-            }
+int process_table_enable_events(ProcessTable* table, FILE* exit_log) {
+    if (table->events.sock < 0 && proc_events_open(&table->events) != 0) return -1;
+    table->events.exit_log  = exit_log;
+    table->rescan_countdown = 0;
+    return 0;
+}
+
+void process_table_set_threads(ProcessTable* table, const ThreadView* view) {
+    table->thread_view = *view;
+}
+
+void process_table_set_cgroups(ProcessTable* table, int enabled) {
+    table->cgroups.enabled = enabled;
+}
+
+void process_table_set_files(ProcessTable* table, int files) {
+    table->files = files | PROC_FILE_STAT;
+}
+
+void process_table_set_memory(ProcessTable* table, const MemoryView* view) {
+    table->memory_view = *view;
+}
+
+void thread_view_init(ThreadView* view) { memset(view, 0, sizeof(*view)); }
+
+int thread_view_expanded(const ThreadView* view, pid_t pid) {
+    if (view->all) return 1;
+    for (int i = 0; i < view->count; i++) {
+        if (view->pids[i] == pid) return 1;
+    }
+    return 0;
+}
+
+int thread_view_toggle(ThreadView* view, pid_t pid) {
+    for (int i = 0; i < view->count; i++) {
+        if (view->pids[i] == pid) {
+            view->pids[i] = view->pids[--view->count];
+            return 0;
         }
     }
-    closedir(dir);
-    last_total_time = total_time;
-    return head;
+    if (view->count == THREAD_VIEW_MAX_PIDS) return -1;
+    view->pids[view->count++] = pid;
+    return 1;
 }
 
-void free_process_list(ProcessNode* head) {
-    ProcessNode* current = head;
-    while (current != NULL) {
-        ProcessNode* next = current->next;
-        free(current);
-        current = next;
+void memory_view_init(MemoryView* view, int max_age_ms) {
+    memset(view, 0, sizeof(*view));
+    view->max_age_ms = max_age_ms;
+}
+
+/**
+ * @brief Returns the position of @p pid in the view, or where it would be inserted.
+ */
+static int memory_view_search(const MemoryView* view, pid_t pid) {
+    int low = 0, high = view->count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (view->pids[mid] < pid) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
     }
+    return low;
+}
+
+int memory_view_add(MemoryView* view, pid_t pid) {
+    int at = memory_view_search(view, pid);
+    if (at < view->count && view->pids[at] == pid) return 0;
+    if (view->count == MEMORY_VIEW_MAX_PIDS) return -1;
+    memmove(&view->pids[at + 1], &view->pids[at], sizeof(pid_t) * (view->count - at));
+    view->pids[at] = pid;
+    view->count++;
+    return 0;
+}
+
+int memory_view_wants(const MemoryView* view, pid_t pid) {
+    if (view->all) return 1;
+    int at = memory_view_search(view, pid);
+    return at < view->count && view->pids[at] == pid;
 }
 
 /**
- * @brief Merges two sorted linked lists.
+ * @brief Ensures the thread parse buffer can hold @p count threads.
+ * @return 0 on success, -1 on allocation failure.
  */
-static ProcessNode* merge(ProcessNode* a, ProcessNode* b, int (*cmp)(ProcessNode*, ProcessNode*)) {
-    if (!a) return b;
-    if (!b) return a;
+static int process_table_reserve_threads(ProcessTable* table, int count) {
+    if (count <= table->thread_capacity) return 0;
 
-    ProcessNode* result = NULL;
-    if (cmp(a, b) <= 0) {
-        result       = a;
-        result->next = merge(a->next, b, cmp);
-    } else {
-        result       = b;
-        result->next = merge(a, b->next, cmp);
+    int capacity = table->thread_capacity ? table->thread_capacity : 64;
+    while (capacity < count) capacity *= 2;
+    ProcessNode* scratch = realloc(table->thread_scratch, sizeof(ProcessNode) * capacity);
+    PROFILE_COUNT(PROFILE_ALLOCS, 1);
+    if (!scratch) return -1;
+    table->thread_scratch  = scratch;
+    table->thread_capacity = capacity;
+    return 0;
+}
+
+/**
+ * @brief Parses the stat file of every thread of a process into the thread
+ *        parse buffer, with the same parser as the process scan.
+ * @return Number of threads read, or -1 if the process has vanished.
+ */
+static int process_table_read_threads(ProcessTable* table, int root_fd, pid_t pid) {
+    char path[24];
+    int  len = proc_format_pid(pid, path);
+    memcpy(path + len, "/task", sizeof("/task"));
+    int task_fd = openat(root_fd, path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    PROFILE_COUNT(PROFILE_SYSCALLS, task_fd < 0 ? 1 : 2);
+    if (task_fd < 0) return -1;
+    DIR* dir = fdopendir(task_fd);
+    if (!dir) {
+        close(task_fd);
+        return -1;
+    }
+
+    int            count = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (!isdigit(entry->d_name[0])) continue;
+        if (count == table->thread_capacity &&
+            process_table_reserve_threads(table, count + 1) != 0) {
+            break;
+        }
+
+        // The TID directory holds the same stat file as a PID directory.
+        char   name[32];
+        char   stat[PROC_STAT_BUF_SIZE];
+        size_t tid_len = strlen(entry->d_name);
+        if (tid_len > sizeof(name) - sizeof("/stat")) continue;
+        memcpy(name, entry->d_name, tid_len);
+        memcpy(name + tid_len, "/stat", sizeof("/stat"));
+        ssize_t      stat_len = proc_read_file(task_fd, name, stat, sizeof(stat));
+        ProcessNode* thread   = &table->thread_scratch[count];
+        // A thread that exited meanwhile is skipped.
+        if (stat_len <= 0 || proc_parse_stat(stat, (size_t)stat_len, thread) != 0) continue;
+        thread->pid = (pid_t)atoi(entry->d_name);
+        count++;
     }
-    return result;
+    closedir(dir);
+    return count;
 }
 
 /**
- * @brief Splits a linked list into two halves.
+ * @brief Rereads the threads of one process into its thread list, reusing the
+ *        nodes it already has.
  */
-static void split(ProcessNode* source, ProcessNode** front, ProcessNode** back) {
-    ProcessNode* fast;
-    ProcessNode* slow;
-    slow = source;
-    fast = source->next;
+static void process_table_scan_threads(ProcessTable* table, ProcessNode* owner, int root_fd,
+                                       unsigned long long total_time_diff) {
+    int           count = process_table_read_threads(table, root_fd, owner->pid);
+    ProcessNode** link  = &owner->threads;
+    for (int i = 0; i < count; i++) {
+        ProcessNode*   parsed = &table->thread_scratch[i];
+        int            is_new = 1;
+        PidTableEntry* ticks  = pid_table_touch(&table->thread_ticks, parsed->pid,
+                                                parsed->starttime, &is_new);
+        if (!ticks) break;
 
-    while (fast != NULL) {
-        fast = fast->next;
-        if (fast != NULL) {
-            slow = slow->next;
-            fast = fast->next;
+        // Same delta as for processes: the thread's share of all CPU time.
+        if (!is_new && total_time_diff > 0) {
+            unsigned long thread_diff =
+                (parsed->utime + parsed->stime) - (ticks->utime + ticks->stime);
+            parsed->cpu_usage = (float)(thread_diff * 100.0) / total_time_diff;
+        } else {
+            parsed->cpu_usage = 0.0f;
         }
+        ticks->utime = parsed->utime;
+        ticks->stime = parsed->stime;
+
+        // Owner, memory, and the thread count are properties of the process.
+        parsed->uid         = owner->uid;
+        parsed->memory_kb   = owner->memory_kb;
+        parsed->vsz_kb      = owner->vsz_kb;
+        parsed->anon_kb     = owner->anon_kb;
+        parsed->file_kb     = owner->file_kb;
+        parsed->shmem_kb    = owner->shmem_kb;
+        parsed->swap_kb     = owner->swap_kb;
+        parsed->pss_kb      = -1;
+        parsed->uss_kb      = -1;
+        parsed->num_threads = 1;
+        parsed->thread_of   = owner->pid;
+        parsed->cgroup_id   = owner->cgroup_id;
+        parsed->io_read     = -1.0f;
+        parsed->io_write    = -1.0f;
+        parsed->io_syscalls = -1.0f;
+        parsed->threads     = NULL;
+        parsed->generation  = owner->generation;
+        memcpy(parsed->username, owner->username, sizeof(parsed->username));
+
+        ProcessNode* node = *link;
+        if (node) {
+            parsed->change = node->pid == parsed->pid && !process_node_differs(node, parsed)
+                                 ? PROCESS_UNCHANGED
+                                 : PROCESS_CHANGED;
+            parsed->next = node->next;
+        } else {
+            node = process_table_alloc_node(table);
+            if (!node) break;
+            parsed->change = PROCESS_ADDED;
+            parsed->next   = NULL;
+            *link          = node;
+        }
+        *node = *parsed;
+        link  = &node->next;
+        table->thread_count++;
     }
 
-    *front     = source;
-    *back      = slow->next;
-    slow->next = NULL;
+    // Threads beyond the current count have exited.
+    ProcessNode* rest = *link;
+    *link             = NULL;
+    while (rest) {
+        ProcessNode* next = rest->next;
+        process_table_release_node(table, rest);
+        rest = next;
+    }
 }
 
 /**
- * @brief Sorts a linked list using the Merge Sort algorithm.
+ * @brief Brings the thread lists of all processes in line with the thread view.
  */
-void sort_process_list(ProcessNode** head_ref, int (*cmp)(ProcessNode*, ProcessNode*)) {
-    ProcessNode* head = *head_ref;
-    ProcessNode* a;
-    ProcessNode* b;
+static void process_table_update_threads(ProcessTable* table, unsigned long long total_time_diff) {
+    const ThreadView* view = &table->thread_view;
+    if (!view->all && view->count == 0 && table->thread_count == 0) return;
 
-    if ((head == NULL) || (head->next == NULL)) return;
+    int root_fd         = proc_root_fd();
+    table->thread_count = 0;
+    pid_table_begin(&table->thread_ticks);
+    if (view->all) {
+        for (ProcessNode* node = table->head; node; node = node->next) {
+            if (root_fd >= 0) process_table_scan_threads(table, node, root_fd, total_time_diff);
+        }
+    } else {
+        for (ProcessNode* node = table->head; node; node = node->next) {
+            if (node->threads && !thread_view_expanded(view, node->pid)) {
+                process_table_release_threads(table, node);
+            }
+        }
+        for (int i = 0; i < view->count && root_fd >= 0; i++) {
+            PidTableEntry* entry = pid_table_get(&table->index, view->pids[i]);
+            if (entry && entry->node) {
+                process_table_scan_threads(table, entry->node, root_fd, total_time_diff);
+            }
+        }
+    }
+    // Ticks of threads that exited or were collapsed are dropped.
+    pid_table_sweep(&table->thread_ticks);
+}
+
+int process_table_update(ProcessTable* table) {
+    ProfilePass* profile = &table->profile;
+    profile_pass_begin(profile);
+    PROFILE_BEGIN(collect_start);
+    int count = process_table_collect(table);
+    PROFILE_END(collect_start, profile->ns[PROFILE_READDIR]);
+    if (count < 0) return -1;
+
+    // /proc/stat is read once per update; the system meters use the same pair.
+    PROFILE_BEGIN(cpu_start);
+    unsigned long long total_time_diff = system_sampler_read_cpu(&table->system);
+    PROFILE_END(cpu_start, profile->ns[PROFILE_SYSINFO]);
+
+    // Parse every process first (possibly on several threads), then merge the
+    // results into the table on this thread so CPU deltas and node ownership
+    // stay single-threaded.
+    PROFILE_BEGIN(parse_start);
+    process_table_parse(table, count);
+    PROFILE_END(parse_start, profile->ns[PROFILE_PARSE]);
+    PROFILE_COUNT(PROFILE_PROCESSES, count);
 
-    split(head, &a, &b);
+    PROFILE_BEGIN(merge_start);
+    table->added        = 0;
+    table->changed      = 0;
+    table->exited_count = 0;
+    pid_table_begin(&table->index);
+    unsigned int generation = table->index.generation;
 
-    sort_process_list(&a, cmp);
-    sort_process_list(&b, cmp);
+    // New processes are collected separately and appended after the exit sweep.
+    ProcessNode* added_head = NULL;
+    ProcessNode* added_tail = NULL;
+
+    // I/O rates are measured over the same interval as CPU usage.
+    int       root_fd = proc_root_fd();
+    long long now_ms  = table->system.cpu->time_ms;
+
+    // Owner names only need copying again once the user cache changed one.
+    unsigned int users = user_cache_generation();
+
+    for (int i = 0; i < count; i++) {
+        ProcessNode* parsed = &table->scratch[i];
+        if (parsed->pid == 0) continue;
+
+        int            is_new = 1;
+        PidTableEntry* ticks  = pid_table_touch(&table->index, parsed->pid, parsed->starttime,
+                                                &is_new);
+        if (!ticks) continue;
+
+        if (!is_new && total_time_diff > 0) {
+            unsigned long process_diff =
+                (parsed->utime + parsed->stime) - (ticks->utime + ticks->stime);
+            parsed->cpu_usage = (float)(process_diff * 100.0) / total_time_diff;
+        } else {
+            parsed->cpu_usage = 0.0f;
+        }
+        ticks->utime = parsed->utime;
+        ticks->stime = parsed->stime;
+
+        ProcessNode* node = ticks->node;
+        if (parsed->username[0] == '\0') {
+            // Only look the owner up when it is new to us, and when status was read at all.
+            if (parsed->uid == (uid_t)-1) {
+                strcpy(parsed->username, "-");
+            } else if (node && node->uid == parsed->uid && users == table->user_generation) {
+                memcpy(parsed->username, node->username, sizeof(parsed->username));
+            } else {
+                user_cache_lookup(parsed->uid, parsed->username, sizeof(parsed->username));
+            }
+        }
 
-    *head_ref = merge(a, b, cmp);
+        // The cgroup is looked up once per process lifetime; an exec, which
+        // renames the process, is when a service manager usually moves it.
+        if (node && node->cgroup_id && strcmp(node->name, parsed->name) == 0) {
+            parsed->cgroup_id = node->cgroup_id;
+        } else if (table->cgroups.enabled) {
+            parsed->cgroup_id = cgroup_sampler_resolve(&table->cgroups, parsed->pid);
+        } else {
+            parsed->cgroup_id = 0;
+        }
+
+        // /proc/[pid]/io costs one more open, so it is only read on request.
+        if (table->files & PROC_FILE_IO) {
+            process_table_read_io(root_fd, parsed, ticks, now_ms);
+        } else {
+            parsed->io_read = parsed->io_write = parsed->io_syscalls = -1.0f;
+            ticks->io_time_ms                                         = 0;
+        }
+
+        // smaps_rollup is only read for the processes the memory view lists.
+        process_table_read_rollup(&table->memory_view, root_fd, parsed, ticks, now_ms);
+
+        parsed->thread_of = 0;
+        if (node) {
+            // Known process: update in place, keeping its position in the list.
+            parsed->change =
+                process_node_differs(node, parsed) ? PROCESS_CHANGED : PROCESS_UNCHANGED;
+            if (parsed->change == PROCESS_CHANGED) table->changed++;
+            parsed->threads = node->threads;
+            parsed->next    = node->next;
+        } else {
+            node = process_table_alloc_node(table);
+            if (!node) {
+                ticks->generation = 0;
+                continue;
+            }
+            parsed->change  = PROCESS_ADDED;
+            parsed->threads = NULL;
+            parsed->next    = NULL;
+            table->added++;
+            if (!added_head) {
+                added_head = node;
+            } else {
+                added_tail->next = node;
+            }
+            added_tail  = node;
+            ticks->node = node;
+        }
+        parsed->generation = generation;
+        *node              = *parsed;
+    }
+
+    // Unlink processes that were not seen in this scan (exited or PID recycled).
+    ProcessNode** link = &table->head;
+    ProcessNode*  tail = NULL;
+    while (*link) {
+        ProcessNode* node = *link;
+        if (node->generation != generation) {
+            *link = node->next;
+            process_table_push_exited(table, node->pid);
+            table->count--;
+            process_table_release_threads(table, node);
+            process_table_release_node(table, node);
+        } else {
+            tail = node;
+            link = &node->next;
+        }
+    }
+    if (tail) {
+        tail->next = added_head;
+    } else {
+        table->head = added_head;
+    }
+    table->count += table->added;
+    table->user_generation = users;
+
+    pid_table_sweep(&table->index);
+    process_table_update_threads(table, total_time_diff);
+    PROFILE_END(merge_start, profile->ns[PROFILE_DELTA]);
+    return 0;
 }
 
-// Comparison functions for sorting
-int cmp_pid(ProcessNode* a, ProcessNode* b) { return a->pid - b->pid; }
-int cmp_cpu(ProcessNode* a, ProcessNode* b) { return (b->cpu_usage > a->cpu_usage) ? 1 : -1; }
-int cmp_mem(ProcessNode* a, ProcessNode* b) { return b->memory_kb - a->memory_kb; }
-int cmp_name(ProcessNode* a, ProcessNode* b) { return strcasecmp(a->name, b->name); }
+void process_table_free(ProcessTable* table) {
+    ProcessNode* lists[2] = {table->head, table->free_nodes};
+    for (int i = 0; i < 2; i++) {
+        ProcessNode* current = lists[i];
+        while (current != NULL) {
+            ProcessNode* next = current->next;
+            for (ProcessNode* thread = current->threads; thread;) {
+                ProcessNode* following = thread->next;
+                free(thread);
+                thread = following;
+            }
+            free(current);
+            current = next;
+        }
+    }
+    if (table->proc_dir) closedir(table->proc_dir);
+    scan_pool_destroy(table->pool);
+    uring_scan_destroy(table->uring);
+    proc_events_close(&table->events);
+    system_sampler_free(&table->system);
+    cgroup_sampler_free(&table->cgroups);
+    free(table->pids);
+    free(table->scratch);
+    free(table->exited);
+    free(table->thread_scratch);
+    pid_table_free(&table->index);
+    pid_table_free(&table->thread_ticks);
+    memset(table, 0, sizeof(*table));
+}
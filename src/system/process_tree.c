@@ -0,0 +1,252 @@
+/**
+ * @file process_tree.c
+ * @brief Implementation of the process tree and its collapsed subtrees.
+ * @version 2.0.1
+ */
+
+#include "../../include/system/process_tree.h"
+#include "../../include/system/profile.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Depth below which connector guides are tracked (bits of ProcessTree::guides).
+ */
+#define TREE_GUIDE_DEPTH 64
+
+void process_tree_init(ProcessTree* tree) { memset(tree, 0, sizeof(*tree)); }
+
+/**
+ * @brief Grows a buffer to @p count elements of @p size bytes.
+ * @return 0 on success, -1 on allocation failure (the buffer is unchanged).
+ */
+static int tree_grow(void** buffer, size_t size, int count) {
+    void* grown = realloc(*buffer, size * count);
+    PROFILE_COUNT(PROFILE_ALLOCS, 1);
+    if (!grown) return -1;
+    *buffer = grown;
+    return 0;
+}
+
+/**
+ * @brief Ensures the per-row arrays hold @p rows rows and the PID index
+ *        has at least twice as many slots as @p keys.
+ * @return 0 on success, -1 on allocation failure.
+ */
+static int tree_reserve(ProcessTree* tree, int rows, int keys) {
+    if (rows > tree->capacity) {
+        int capacity = tree->capacity ? tree->capacity : 1024;
+        while (capacity < rows) capacity *= 2;
+        if (tree_grow((void**)&tree->parent, sizeof(int), capacity) != 0 ||
+            tree_grow((void**)&tree->child_start, sizeof(int), capacity + 2) != 0 ||
+            tree_grow((void**)&tree->children, sizeof(int), capacity) != 0 ||
+            tree_grow((void**)&tree->preorder, sizeof(int), capacity) != 0 ||
+            tree_grow((void**)&tree->descendants, sizeof(int), capacity) != 0 ||
+            tree_grow((void**)&tree->depth, sizeof(int), capacity) != 0 ||
+            tree_grow((void**)&tree->guides, sizeof(uint64_t), capacity) != 0 ||
+            tree_grow((void**)&tree->flags, sizeof(unsigned char), capacity) != 0 ||
+            tree_grow((void**)&tree->subtree_cpu, sizeof(float), capacity) != 0 ||
+            tree_grow((void**)&tree->subtree_mem, sizeof(long), capacity) != 0) {
+            return -1;
+        }
+        tree->capacity = capacity;
+    }
+
+    int slots = tree->index ? tree->index_mask + 1 : 1024;
+    while (slots < 2 * keys) slots *= 2;
+    if (!tree->index || slots > tree->index_mask + 1) {
+        if (tree_grow((void**)&tree->index, sizeof(int), slots) != 0) return -1;
+        tree->index_mask = slots - 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Returns the first index slot to probe for a PID.
+ */
+static inline int tree_slot(const ProcessTree* tree, pid_t pid) {
+    return (int)(((uint32_t)pid * 2654435761u) & (uint32_t)tree->index_mask);
+}
+
+/**
+ * @brief Looks up the row of a process in the PID index.
+ * @return The row, or -1 if the process does not match.
+ */
+static int tree_lookup(const ProcessTree* tree, const ProcessSnapshot* snapshot, pid_t pid) {
+    for (int slot = tree_slot(tree, pid);; slot = (slot + 1) & tree->index_mask) {
+        int row = tree->index[slot];
+        if (row < 0 || snapshot->procs[row].pid == pid) return row;
+    }
+}
+
+int process_tree_build(ProcessTree* tree, const ProcessSnapshot* snapshot) {
+    int        n    = snapshot->matched;
+    int        root = snapshot->count;
+    const int* rows = snapshot->order;
+    tree->count     = 0;
+    if (tree_reserve(tree, snapshot->count, n) != 0) return -1;
+
+    // PID index over the processes; thread rows share the PID of their
+    // process's main thread and are attached through thread_of instead.
+    memset(tree->index, -1, sizeof(int) * (tree->index_mask + 1));
+    for (int i = 0; i < n; i++) {
+        int r = rows[i];
+        if (snapshot->groups[r] != r) continue;
+        int slot = tree_slot(tree, snapshot->procs[r].pid);
+        while (tree->index[slot] >= 0) slot = (slot + 1) & tree->index_mask;
+        tree->index[slot] = r;
+    }
+
+    // Parents, and the size of every sibling group
+    memset(tree->child_start, 0, sizeof(int) * (root + 2));
+    for (int i = 0; i < n; i++) {
+        int                r    = rows[i];
+        const ProcessNode* node = &snapshot->procs[r];
+        int                p    = -1;
+        if (node->thread_of) {
+            p = tree_lookup(tree, snapshot, node->thread_of);
+        } else if (node->ppid != node->pid) {
+            p = tree_lookup(tree, snapshot, node->ppid);
+        }
+        tree->parent[r] = p;
+        tree->child_start[(p < 0 ? root : p) + 1]++;
+    }
+
+    // Place the children in display order: after the pass, child_start[k]
+    // holds the end of group k, so shifting by one gives the starts.
+    for (int k = 1; k <= root + 1; k++) tree->child_start[k] += tree->child_start[k - 1];
+    for (int i = 0; i < n; i++) {
+        int r = rows[i];
+        int p = tree->parent[r];
+        tree->children[tree->child_start[p < 0 ? root : p]++] = r;
+    }
+    memmove(tree->child_start + 1, tree->child_start, sizeof(int) * (root + 1));
+    tree->child_start[0] = 0;
+
+    // Depth-first walk with an explicit stack (descendants serves as it until
+    // the sizes are counted). A row is marked when pushed, so a cycle is cut
+    // at the first row seen again; rows only reachable through a cycle are
+    // walked afterwards as roots.
+    for (int i = 0; i < n; i++) tree->depth[rows[i]] = -1;
+    int* stack = tree->descendants;
+    int  seen  = 0;
+    for (int start = -1; start < n; start++) {
+        int top = 0;
+        if (start < 0) {
+            for (int c = tree->child_start[root + 1] - 1; c >= tree->child_start[root]; c--) {
+                int r           = tree->children[c];
+                tree->depth[r]  = 0;
+                tree->guides[r] = 0;
+                tree->flags[r]  = c == tree->child_start[root + 1] - 1 ? TREE_NODE_LAST : 0;
+                stack[top++]    = r;
+            }
+        } else {
+            int r = rows[start];
+            if (tree->depth[r] >= 0) continue;
+            tree->parent[r] = -1;
+            tree->depth[r]  = 0;
+            tree->guides[r] = 0;
+            tree->flags[r]  = TREE_NODE_LAST;
+            stack[top++]    = r;
+        }
+
+        while (top > 0) {
+            int r                  = stack[--top];
+            tree->preorder[seen++] = r;
+            int      d             = tree->depth[r];
+            uint64_t guides        = tree->guides[r];
+            if (d > 0 && d < TREE_GUIDE_DEPTH && !(tree->flags[r] & TREE_NODE_LAST)) {
+                guides |= 1ULL << d;
+            }
+
+            // Push the children in reverse so the first one is popped first;
+            // the last child not seen before closes the group.
+            int last = 1;
+            for (int c = tree->child_start[r + 1] - 1; c >= tree->child_start[r]; c--) {
+                int child = tree->children[c];
+                if (tree->depth[child] >= 0) continue;
+                tree->parent[child] = r;
+                tree->depth[child]  = d + 1;
+                tree->guides[child] = guides;
+                tree->flags[child]  = last ? TREE_NODE_LAST : 0;
+                stack[top++]        = child;
+                last                = 0;
+            }
+            if (!last) tree->flags[r] |= TREE_NODE_PARENT;
+        }
+    }
+    tree->count = seen;
+
+    // Subtree sizes and totals, children before parents. Thread rows are
+    // already included in their process's CPU and memory.
+    for (int i = 0; i < seen; i++) {
+        int r                = tree->preorder[i];
+        tree->descendants[r] = 0;
+        tree->subtree_cpu[r] = snapshot->procs[r].cpu_usage;
+        tree->subtree_mem[r] = snapshot->procs[r].memory_kb;
+    }
+    for (int i = seen - 1; i >= 0; i--) {
+        int r = tree->preorder[i];
+        int p = tree->parent[r];
+        if (p < 0) continue;
+        tree->descendants[p] += tree->descendants[r] + 1;
+        if (snapshot->procs[r].thread_of) continue;
+        tree->subtree_cpu[p] += tree->subtree_cpu[r];
+        tree->subtree_mem[p] += tree->subtree_mem[r];
+    }
+    return 0;
+}
+
+void process_tree_apply(ProcessTree* tree, ProcessSnapshot* snapshot,
+                        const TreeCollapse* collapse) {
+    for (int i = 0; i < tree->count; i++) tree->flags[tree->preorder[i]] &= ~TREE_NODE_COLLAPSED;
+    for (int i = 0; i < collapse->count; i++) {
+        int r = tree_lookup(tree, snapshot, collapse->pids[i]);
+        if (r >= 0 && (tree->flags[r] & TREE_NODE_PARENT)) tree->flags[r] |= TREE_NODE_COLLAPSED;
+    }
+
+    int visible = 0;
+    for (int i = 0; i < tree->count; i++) {
+        int r                      = tree->preorder[i];
+        snapshot->order[visible++] = r;
+        if (tree->flags[r] & TREE_NODE_COLLAPSED) i += tree->descendants[r];
+    }
+    snapshot->matched = visible;
+    snapshot->sorted  = visible;
+}
+
+void process_tree_free(ProcessTree* tree) {
+    free(tree->index);
+    free(tree->parent);
+    free(tree->child_start);
+    free(tree->children);
+    free(tree->preorder);
+    free(tree->descendants);
+    free(tree->depth);
+    free(tree->guides);
+    free(tree->flags);
+    free(tree->subtree_cpu);
+    free(tree->subtree_mem);
+    process_tree_init(tree);
+}
+
+void tree_collapse_init(TreeCollapse* collapse) { memset(collapse, 0, sizeof(*collapse)); }
+
+int tree_collapse_contains(const TreeCollapse* collapse, pid_t pid) {
+    for (int i = 0; i < collapse->count; i++) {
+        if (collapse->pids[i] == pid) return 1;
+    }
+    return 0;
+}
+
+int tree_collapse_toggle(TreeCollapse* collapse, pid_t pid) {
+    for (int i = 0; i < collapse->count; i++) {
+        if (collapse->pids[i] == pid) {
+            collapse->pids[i] = collapse->pids[--collapse->count];
+            return 0;
+        }
+    }
+    if (collapse->count == TREE_MAX_COLLAPSED) return -1;
+    collapse->pids[collapse->count++] = pid;
+    return 1;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file profile.c
+ * @brief Implementation of the self-profiling counters and phase history.
+ * @version 2.0.1
+ */
+
+#include "../../include/system/profile.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+const char* const profile_phase_names[PROFILE_PHASES] = {
+    [PROFILE_READDIR] = "readdir", [PROFILE_PARSE] = "parse",   [PROFILE_DELTA] = "delta",
+    [PROFILE_SYSINFO] = "sysinfo", [PROFILE_FILTER] = "filter", [PROFILE_SORT] = "sort",
+    [PROFILE_RENDER] = "render",
+};
+
+const char* const profile_counter_names[PROFILE_COUNTERS] = {
+    [PROFILE_SYSCALLS] = "syscalls",
+    [PROFILE_ALLOCS] = "allocs",
+    [PROFILE_PROCESSES] = "processes",
+};
+
+int                profile_enabled;
+unsigned long long profile_counters[PROFILE_COUNTERS];
+
+void profile_set_enabled(int enabled) {
+    __atomic_store_n(&profile_enabled, enabled != 0, __ATOMIC_RELAXED);
+}
+
+unsigned long long profile_counter(ProfileCounter counter) {
+    return __atomic_load_n(&profile_counters[counter], __ATOMIC_RELAXED);
+}
+
+void profile_pass_begin(ProfilePass* pass) { memset(pass->ns, 0, sizeof(pass->ns)); }
+
+void profile_pass_end(ProfilePass* pass) {
+    for (int i = 0; i < PROFILE_COUNTERS; i++) pass->counters[i] = profile_counter(i);
+}
+
+void profiler_init(Profiler* profiler) {
+    memset(profiler, 0, sizeof(*profiler));
+    profiler->rss_kb   = -1;
+    profiler->statm_fd = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+}
+
+void profiler_add(Profiler* profiler, ProfilePhase phase, long long ns) {
+    if (ns <= 0) return;
+    long slot                      = profiler->recorded[phase]++ % PROFILE_HISTORY;
+    profiler->history[phase][slot] = ns;
+}
+
+/**
+ * @brief Returns ProcX's CPU time so far, all threads included.
+ */
+static long long profile_cpu_ns() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return ((long long)usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000LL +
+           ((long long)usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000LL;
+}
+
+/**
+ * @brief Reads the resident size from the kept-open /proc/self/statm.
+ * @return long Resident memory in KB, or -1 if it cannot be read.
+ */
+static long profile_rss_kb(int fd) {
+    char    buf[128];
+    ssize_t n = fd >= 0 ? pread(fd, buf, sizeof(buf) - 1, 0) : -1;
+    if (n <= 0) return -1;
+    buf[n]     = '\0';
+    char* next = NULL;
+    strtol(buf, &next, 10);
+    long pages = strtol(next, NULL, 10);
+    return pages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+void profiler_add_pass(Profiler* profiler, const ProfilePass* pass) {
+    for (int phase = 0; phase < PROFILE_PHASES; phase++) {
+        profiler_add(profiler, (ProfilePhase)phase, pass->ns[phase]);
+    }
+
+    // The first pass only sets the baselines.
+    long long now_ns = profile_now_ns();
+    long long cpu_ns = profile_cpu_ns();
+    for (int i = 0; i < PROFILE_COUNTERS; i++) {
+        profiler->per_sample[i] = profiler->time_ns ? pass->counters[i] - profiler->totals[i] : 0;
+        profiler->totals[i]     = pass->counters[i];
+    }
+    if (profiler->time_ns && now_ns > profiler->time_ns) {
+        profiler->cpu_usage =
+            (float)(cpu_ns - profiler->cpu_ns) * 100.0f / (float)(now_ns - profiler->time_ns);
+    }
+    profiler->cpu_ns  = cpu_ns;
+    profiler->time_ns = now_ns;
+    profiler->rss_kb  = profile_rss_kb(profiler->statm_fd);
+}
+
+/**
+ * @brief Orders durations for the percentiles.
+ */
+static int profile_compare(const void* a, const void* b) {
+    long long x = *(const long long*)a, y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+int profiler_stats(const Profiler* profiler, ProfilePhase phase, ProfileStats* stats) {
+    long recorded = profiler->recorded[phase];
+    if (recorded == 0) return -1;
+
+    // The history is small and only summarized for display, so it is sorted on a copy.
+    long long sorted[PROFILE_HISTORY];
+    int       count = recorded < PROFILE_HISTORY ? (int)recorded : PROFILE_HISTORY;
+    memcpy(sorted, profiler->history[phase], sizeof(long long) * count);
+    qsort(sorted, (size_t)count, sizeof(long long), profile_compare);
+
+    // Nearest rank: the smallest duration at or above the given share of them.
+    stats->last_ns = profiler->history[phase][(recorded - 1) % PROFILE_HISTORY];
+    stats->p50_ns  = sorted[(count * 50 + 99) / 100 - 1];
+    stats->p99_ns  = sorted[(count * 99 + 99) / 100 - 1];
+    stats->count   = count;
+    return 0;
+}
+
+void profiler_free(Profiler* profiler) {
+    if (profiler->statm_fd >= 0) close(profiler->statm_fd);
+    profiler->statm_fd = -1;
+}
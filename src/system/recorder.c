@@ -0,0 +1,688 @@
+/**
+ * @file recorder.c
+ * @brief Implementation of the flight recorder ring file and its replay.
+ * @version 2.0.1
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "../../include/system/recorder.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Bits of a process record saying which values follow.
+ *
+ * Numbers are stored as the zigzag varint of their difference to the previous
+ * sample's value, strings as a varint length and the bytes. A record for a
+ * process that exited carries only PROC_REMOVED.
+ */
+enum {
+    PROC_REMOVED = 1 << 0,
+    PROC_PPID    = 1 << 1,
+    PROC_UID     = 1 << 2,
+    PROC_USER    = 1 << 3,
+    PROC_THREADS = 1 << 4,
+    PROC_NAME    = 1 << 5,
+    PROC_STATE   = 1 << 6,
+    PROC_MEM     = 1 << 7,
+    PROC_CPU     = 1 << 8,
+    PROC_UTIME   = 1 << 9,
+    PROC_STIME   = 1 << 10,
+    PROC_PRI     = 1 << 11,
+    PROC_NICE    = 1 << 12,
+    PROC_START   = 1 << 13
+};
+
+/** @brief Upper bound of one encoded process record. */
+#define RECORD_MAX_SIZE (2 * 10 + 11 * 10 + (5 + 32) + (5 + 256))
+
+/** @brief Upper bound of the encoded system statistics. */
+#define INFO_MAX_SIZE (16 * 10)
+
+/**
+ * @brief Bounds-checked read position inside a frame payload.
+ */
+typedef struct Cursor {
+    const unsigned char* p;     /**< Next byte */
+    const unsigned char* end;   /**< End of the payload */
+    int                  error; /**< Set once a read ran past the end */
+} Cursor;
+
+/**
+ * @brief Appends an unsigned LEB128 varint.
+ */
+static unsigned char* put_varint(unsigned char* p, uint64_t v) {
+    while (v >= 0x80) {
+        *p++ = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (unsigned char)v;
+    return p;
+}
+
+/**
+ * @brief Appends a signed value as a zigzag varint, so small magnitudes stay short.
+ */
+static unsigned char* put_signed(unsigned char* p, int64_t v) {
+    return put_varint(p, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
+
+/**
+ * @brief Appends a varint length followed by the bytes of @p s.
+ */
+static unsigned char* put_string(unsigned char* p, const char* s) {
+    size_t len = strlen(s);
+    p          = put_varint(p, len);
+    memcpy(p, s, len);
+    return p + len;
+}
+
+/**
+ * @brief Reads an unsigned varint; sets the cursor error on truncation.
+ */
+static uint64_t get_varint(Cursor* c) {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (c->p >= c->end) break;
+        unsigned char b = *c->p++;
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) return v;
+    }
+    c->error = 1;
+    return 0;
+}
+
+/**
+ * @brief Reads a zigzag varint.
+ */
+static int64_t get_signed(Cursor* c) {
+    uint64_t v = get_varint(c);
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+/**
+ * @brief Reads a string written by put_string() into @p out of @p size bytes.
+ */
+static void get_string(Cursor* c, char* out, size_t size) {
+    uint64_t len = get_varint(c);
+    if (c->error || len >= size || len > (uint64_t)(c->end - c->p)) {
+        c->error = 1;
+        return;
+    }
+    memcpy(out, c->p, len);
+    out[len] = '\0';
+    c->p += len;
+}
+
+/**
+ * @brief CPU usage in hundredths of a percent, the precision that is recorded.
+ */
+static int64_t cpu_centi(float cpu) {
+    return (int64_t)(cpu * 100.0f + (cpu < 0.0f ? -0.5f : 0.5f));
+}
+
+/**
+ * @brief Appends the system statistics and the short-lived exit count.
+ */
+static unsigned char* encode_info(unsigned char* p, const SystemInfo* info, long short_lived) {
+    p = put_signed(p, info->cpu_usage);
+    p = put_signed(p, info->mem_usage);
+    p = put_signed(p, info->swp_usage);
+    p = put_signed(p, info->total_mem_kb);
+    p = put_signed(p, info->free_mem_kb);
+    p = put_signed(p, info->total_swp_kb);
+    p = put_signed(p, info->free_swp_kb);
+    p = put_signed(p, info->running_tasks);
+    p = put_signed(p, info->total_tasks);
+    for (int i = 0; i < 3; i++) p = put_signed(p, (int64_t)(info->load_avg[i] * 100.0 + 0.5));
+    p = put_signed(p, info->uptime_sec);
+    return put_signed(p, short_lived);
+}
+
+/**
+ * @brief Reads what encode_info() wrote.
+ */
+static void decode_info(Cursor* c, SystemInfo* info, long* short_lived) {
+    info->cpu_usage     = (int)get_signed(c);
+    info->mem_usage     = (int)get_signed(c);
+    info->swp_usage     = (int)get_signed(c);
+    info->total_mem_kb  = (long)get_signed(c);
+    info->free_mem_kb   = (long)get_signed(c);
+    info->total_swp_kb  = (long)get_signed(c);
+    info->free_swp_kb   = (long)get_signed(c);
+    info->running_tasks = (int)get_signed(c);
+    info->total_tasks   = (int)get_signed(c);
+    for (int i = 0; i < 3; i++) info->load_avg[i] = get_signed(c) / 100.0;
+    info->uptime_sec = (long)get_signed(c);
+    *short_lived     = (long)get_signed(c);
+}
+
+/**
+ * @brief Appends the record of one process if any recorded value differs from
+ *        @p old, or unconditionally if @p added.
+ * @param last_pid PID of the previous record in this frame, updated.
+ */
+static unsigned char* encode_process(unsigned char* p, pid_t* last_pid, const ProcessNode* old,
+                                     const ProcessNode* cur, int added) {
+    int64_t  cpu  = cpu_centi(cur->cpu_usage) - cpu_centi(old->cpu_usage);
+    unsigned mask = 0;
+    if (cur->ppid != old->ppid) mask |= PROC_PPID;
+    if (cur->uid != old->uid) mask |= PROC_UID;
+    if (strcmp(cur->username, old->username) != 0) mask |= PROC_USER;
+    if (cur->num_threads != old->num_threads) mask |= PROC_THREADS;
+    if (strcmp(cur->name, old->name) != 0) mask |= PROC_NAME;
+    if (cur->state != old->state) mask |= PROC_STATE;
+    if (cur->memory_kb != old->memory_kb) mask |= PROC_MEM;
+    if (cpu != 0) mask |= PROC_CPU;
+    if (cur->utime != old->utime) mask |= PROC_UTIME;
+    if (cur->stime != old->stime) mask |= PROC_STIME;
+    if (cur->priority != old->priority) mask |= PROC_PRI;
+    if (cur->nice_value != old->nice_value) mask |= PROC_NICE;
+    if (cur->starttime != old->starttime) mask |= PROC_START;
+    if (mask == 0 && !added) return p;
+
+    p         = put_varint(p, (uint64_t)(cur->pid - *last_pid));
+    p         = put_varint(p, mask);
+    *last_pid = cur->pid;
+    if (mask & PROC_PPID) p = put_signed(p, (int64_t)cur->ppid - old->ppid);
+    if (mask & PROC_UID) p = put_signed(p, (int64_t)cur->uid - old->uid);
+    if (mask & PROC_USER) p = put_string(p, cur->username);
+    if (mask & PROC_THREADS) p = put_signed(p, (int64_t)cur->num_threads - old->num_threads);
+    if (mask & PROC_NAME) p = put_string(p, cur->name);
+    if (mask & PROC_STATE) p = put_varint(p, (unsigned char)cur->state);
+    if (mask & PROC_MEM) p = put_signed(p, (int64_t)cur->memory_kb - old->memory_kb);
+    if (mask & PROC_CPU) p = put_signed(p, cpu);
+    if (mask & PROC_UTIME) p = put_signed(p, (int64_t)(cur->utime - old->utime));
+    if (mask & PROC_STIME) p = put_signed(p, (int64_t)(cur->stime - old->stime));
+    if (mask & PROC_PRI) p = put_signed(p, (int64_t)cur->priority - old->priority);
+    if (mask & PROC_NICE) p = put_signed(p, (int64_t)cur->nice_value - old->nice_value);
+    if (mask & PROC_START) p = put_signed(p, (int64_t)(cur->starttime - old->starttime));
+    return p;
+}
+
+/**
+ * @brief Applies the values of a record with @p mask to @p proc.
+ */
+static void decode_process(Cursor* c, unsigned mask, ProcessNode* proc) {
+    if (mask & PROC_PPID) proc->ppid += (pid_t)get_signed(c);
+    if (mask & PROC_UID) proc->uid += (uid_t)get_signed(c);
+    if (mask & PROC_USER) get_string(c, proc->username, sizeof(proc->username));
+    if (mask & PROC_THREADS) proc->num_threads += (int)get_signed(c);
+    if (mask & PROC_NAME) get_string(c, proc->name, sizeof(proc->name));
+    if (mask & PROC_STATE) proc->state = (char)get_varint(c);
+    if (mask & PROC_MEM) proc->memory_kb += (long)get_signed(c);
+    if (mask & PROC_CPU) proc->cpu_usage = (cpu_centi(proc->cpu_usage) + get_signed(c)) / 100.0f;
+    if (mask & PROC_UTIME) proc->utime += (unsigned long)get_signed(c);
+    if (mask & PROC_STIME) proc->stime += (unsigned long)get_signed(c);
+    if (mask & PROC_PRI) proc->priority += (long)get_signed(c);
+    if (mask & PROC_NICE) proc->nice_value += (long)get_signed(c);
+    if (mask & PROC_START) proc->starttime += (unsigned long long)get_signed(c);
+}
+
+/**
+ * @brief Orders processes by PID for qsort().
+ */
+static int cmp_pid(const void* a, const void* b) {
+    pid_t x = ((const ProcessNode*)a)->pid, y = ((const ProcessNode*)b)->pid;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Checks that a header describes a usable ring of @p size bytes.
+ */
+static int header_valid(const RecorderHeader* header, uint64_t size) {
+    return header->magic == RECORDER_MAGIC && header->version == RECORDER_VERSION &&
+           header->size == size && header->head >= RECORDER_DATA_OFFSET && header->head <= size &&
+           header->tail >= RECORDER_DATA_OFFSET && header->tail < size && header->last < size;
+}
+
+/**
+ * @brief Offset of the frame that follows the one at @p offset in a ring.
+ */
+static uint64_t ring_next(const unsigned char* map, uint64_t size, uint64_t offset) {
+    uint64_t next = offset + ((const RecorderFrame*)(map + offset))->length;
+    if (next + sizeof(uint32_t) > size || *(const uint32_t*)(map + next) == RECORDER_WRAP_MAGIC) {
+        return RECORDER_DATA_OFFSET;
+    }
+    return next;
+}
+
+int recorder_open(Recorder* recorder, const char* path, size_t size) {
+    memset(recorder, 0, sizeof(*recorder));
+    recorder->fd = -1;
+    size         = (size + 4095) & ~(size_t)4095;
+    if (size < (size_t)RECORDER_MIN_SIZE) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return -1;
+    RecorderHeader existing;
+    struct stat    st;
+    int            resume = fstat(fd, &st) == 0 && (uint64_t)st.st_size == size &&
+                 pread(fd, &existing, sizeof(existing), 0) == (ssize_t)sizeof(existing) &&
+                 header_valid(&existing, size);
+    // Anything else at the path is discarded; the file stays sparse until written.
+    if (!resume && (ftruncate(fd, 0) != 0 || ftruncate(fd, (off_t)size) != 0)) {
+        close(fd);
+        return -1;
+    }
+
+    void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+    recorder->fd     = fd;
+    recorder->map    = map;
+    recorder->header = (RecorderHeader*)map;
+    if (!resume) {
+        RecorderHeader* header = recorder->header;
+        header->magic          = RECORDER_MAGIC;
+        header->version        = RECORDER_VERSION;
+        header->size           = size;
+        header->head = header->tail = RECORDER_DATA_OFFSET;
+        header->last = header->frames = header->sequence = 0;
+    }
+    // The previous sample is not known, so the first frame is always a keyframe.
+    recorder->since_key = RECORDER_KEYFRAME_INTERVAL;
+    return 0;
+}
+
+/**
+ * @brief Drops the oldest frame.
+ */
+static void ring_evict_one(Recorder* recorder) {
+    RecorderHeader* header = recorder->header;
+    if (--header->frames > 0) header->tail = ring_next(recorder->map, header->size, header->tail);
+}
+
+/**
+ * @brief Drops every frame that starts in [@p begin, @p end), then any delta
+ *        frames up to the next keyframe, which could no longer be decoded.
+ */
+static void ring_evict(Recorder* recorder, uint64_t begin, uint64_t end) {
+    RecorderHeader* header = recorder->header;
+    while (header->frames > 0 && header->tail >= begin && header->tail < end) {
+        ring_evict_one(recorder);
+    }
+    while (header->frames > 0 &&
+           !(((const RecorderFrame*)(recorder->map + header->tail))->flags & RECORDER_FRAME_KEY)) {
+        ring_evict_one(recorder);
+    }
+}
+
+/**
+ * @brief Grows the sorting and encoding buffers for @p count processes.
+ */
+static int recorder_reserve(Recorder* recorder, int count) {
+    if (count > recorder->capacity) {
+        int          capacity = count + count / 4 + 64;
+        ProcessNode* prev     = realloc(recorder->prev, sizeof(ProcessNode) * capacity);
+        if (!prev) return -1;
+        recorder->prev = prev;
+        ProcessNode* next = realloc(recorder->next, sizeof(ProcessNode) * capacity);
+        if (!next) return -1;
+        recorder->next     = next;
+        recorder->capacity = capacity;
+    }
+    // Worst case: every process of both samples gets a full record.
+    size_t needed = sizeof(RecorderFrame) + INFO_MAX_SIZE +
+                    (size_t)(count + recorder->prev_count) * RECORD_MAX_SIZE + 8;
+    if (needed > recorder->buffer_size) {
+        unsigned char* buffer = realloc(recorder->buffer, needed);
+        if (!buffer) return -1;
+        recorder->buffer      = buffer;
+        recorder->buffer_size = needed;
+    }
+    return 0;
+}
+
+/**
+ * @brief Encodes @p sample into the recorder's buffer as a frame, against the
+ *        previous sample or, for a keyframe, against an empty one.
+ * @param cur Processes of @p sample, sorted by PID.
+ * @param count Number of entries in @p cur.
+ * @return size_t Frame length; the prev link is filled in by the caller.
+ */
+static size_t recorder_encode(Recorder* recorder, const Sample* sample, const ProcessNode* cur,
+                              int count, int key) {
+    static const ProcessNode empty;
+    const ProcessNode*       old       = recorder->prev;
+    int                      old_count = key ? 0 : recorder->prev_count;
+
+    unsigned char* start = recorder->buffer + sizeof(RecorderFrame);
+    unsigned char* p     = encode_info(start, &sample->info, sample->short_lived);
+    pid_t          last  = 0;
+    int            i = 0, j = 0;
+    while (i < old_count || j < count) {
+        if (j >= count || (i < old_count && old[i].pid < cur[j].pid)) {
+            p    = put_varint(p, (uint64_t)(old[i].pid - last));
+            p    = put_varint(p, PROC_REMOVED);
+            last = old[i++].pid;
+        } else if (i >= old_count || cur[j].pid < old[i].pid) {
+            p = encode_process(p, &last, &empty, &cur[j++], 1);
+        } else {
+            p = encode_process(p, &last, &old[i++], &cur[j++], 0);
+        }
+    }
+
+    size_t         payload = (size_t)(p - start);
+    size_t         length  = (sizeof(RecorderFrame) + payload + 7) & ~(size_t)7;
+    RecorderFrame* frame   = (RecorderFrame*)recorder->buffer;
+    memset(frame, 0, sizeof(*frame));
+    frame->magic    = RECORDER_FRAME_MAGIC;
+    frame->flags    = key ? RECORDER_FRAME_KEY : 0;
+    frame->length   = length;
+    frame->sequence = recorder->header->sequence + 1;
+    frame->time_ms  = sample->time_ms;
+    frame->count    = (uint32_t)count;
+    frame->payload  = (uint32_t)payload;
+    memset(p, 0, length - sizeof(RecorderFrame) - payload);
+    return length;
+}
+
+int recorder_append(Recorder* recorder, const Sample* sample) {
+    const ProcessSnapshot* snapshot = &sample->snapshot;
+    RecorderHeader*        header   = recorder->header;
+    int                    count    = snapshot->count;
+    if (recorder_reserve(recorder, count) != 0) {
+        recorder->error = ENOMEM;
+        return -1;
+    }
+
+    // Records are merged by PID against the previous sample. Thread rows are
+    // a view of the dashboard and are not recorded.
+    ProcessNode*   cur    = recorder->next;
+    RecorderFrame* frame  = NULL;
+    uint64_t       offset = 0;
+    int            sorted = 1;
+    if (snapshot->threads == 0) {
+        memcpy(cur, snapshot->procs, sizeof(ProcessNode) * count);
+    } else {
+        int n = 0;
+        for (int i = 0; i < snapshot->count; i++) {
+            if (!snapshot->procs[i].thread_of) cur[n++] = snapshot->procs[i];
+        }
+        count = n;
+    }
+    for (int i = 1; i < count && sorted; i++) sorted = cur[i - 1].pid < cur[i].pid;
+    if (!sorted) qsort(cur, count, sizeof(ProcessNode), cmp_pid);
+
+    int key = recorder->since_key >= RECORDER_KEYFRAME_INTERVAL;
+    while (1) {
+        size_t length = recorder_encode(recorder, sample, cur, count, key);
+        if (length > (header->size - RECORDER_DATA_OFFSET) / 2) {
+            // Too large for this ring; the next sample starts over with a keyframe.
+            recorder->since_key = RECORDER_KEYFRAME_INTERVAL;
+            recorder->error     = EFBIG;
+            return -1;
+        }
+
+        // Evict first, so that the header never points at a frame being overwritten.
+        offset = header->head;
+        if (offset + length > header->size) {
+            ring_evict(recorder, offset, header->size);
+            if (offset + sizeof(uint32_t) <= header->size) {
+                *(uint32_t*)(recorder->map + offset) = RECORDER_WRAP_MAGIC;
+            }
+            offset = RECORDER_DATA_OFFSET;
+        }
+        ring_evict(recorder, offset, offset + length);
+        // A delta whose keyframe was evicted could not be decoded; store a keyframe instead.
+        if (key || header->frames > 0) {
+            frame = (RecorderFrame*)recorder->buffer;
+            break;
+        }
+        key = 1;
+    }
+    frame->prev = header->frames > 0 ? header->last : 0;
+    memcpy(recorder->map + offset, frame, frame->length);
+
+    if (header->frames == 0) header->tail = offset;
+    header->last     = offset;
+    header->head     = offset + frame->length;
+    header->sequence = frame->sequence;
+    header->frames++;
+
+    recorder->next       = recorder->prev;
+    recorder->prev       = cur;
+    recorder->prev_count = count;
+    recorder->since_key  = (frame->flags & RECORDER_FRAME_KEY) ? 1 : recorder->since_key + 1;
+    recorder->error      = 0;
+    return 0;
+}
+
+void recorder_close(Recorder* recorder) {
+    if (recorder->map) munmap(recorder->map, recorder->header->size);
+    if (recorder->fd >= 0) close(recorder->fd);
+    free(recorder->prev);
+    free(recorder->next);
+    free(recorder->buffer);
+    memset(recorder, 0, sizeof(*recorder));
+    recorder->fd = -1;
+}
+
+/**
+ * @brief Returns the frame at @p offset if its header is intact, else NULL.
+ */
+static const RecorderFrame* replay_frame(const Replay* replay, uint64_t offset) {
+    if (offset < RECORDER_DATA_OFFSET || offset + sizeof(RecorderFrame) > replay->size) return NULL;
+    const RecorderFrame* frame = (const RecorderFrame*)(replay->map + offset);
+    if (frame->magic != RECORDER_FRAME_MAGIC || frame->length < sizeof(RecorderFrame) ||
+        frame->length > replay->size - offset ||
+        sizeof(RecorderFrame) + (uint64_t)frame->payload > frame->length) {
+        return NULL;
+    }
+    return frame;
+}
+
+/**
+ * @brief Grows the decoding buffers for @p count processes.
+ */
+static int replay_reserve(Replay* replay, int count) {
+    if (count <= replay->capacity) return 0;
+    ProcessNode* procs = realloc(replay->procs, sizeof(ProcessNode) * count);
+    if (!procs) return -1;
+    replay->procs       = procs;
+    ProcessNode* scratch = realloc(replay->scratch, sizeof(ProcessNode) * count);
+    if (!scratch) return -1;
+    replay->scratch  = scratch;
+    replay->capacity = count;
+    return 0;
+}
+
+/**
+ * @brief Applies one frame to the decoded processes; a keyframe replaces them.
+ * @return int 0 on success, -1 if the frame is damaged.
+ */
+static int replay_apply(Replay* replay, const RecorderFrame* frame) {
+    int old_count = (frame->flags & RECORDER_FRAME_KEY) ? 0 : replay->count;
+    int capacity  = (int)frame->count;
+    if (replay_reserve(replay, capacity > old_count ? capacity : old_count) != 0) return -1;
+
+    const unsigned char* payload = (const unsigned char*)(frame + 1);
+    Cursor               c       = {payload, payload + frame->payload, 0};
+    const ProcessNode*   old     = replay->procs;
+    ProcessNode*         out     = replay->scratch;
+    int                  n = 0, i = 0;
+    pid_t                pid = 0;
+    decode_info(&c, &replay->sample.info, &replay->sample.short_lived);
+    while (!c.error && c.p < c.end) {
+        pid += (pid_t)get_varint(&c);
+        unsigned mask = (unsigned)get_varint(&c);
+        // Processes without a record are unchanged.
+        while (i < old_count && old[i].pid < pid && n < capacity) out[n++] = old[i++];
+        int known = i < old_count && old[i].pid == pid;
+        if (mask & PROC_REMOVED) {
+            if (!known) return -1;
+            i++;
+            continue;
+        }
+        if (n >= capacity) return -1;
+        if (known) {
+            out[n] = old[i++];
+        } else {
+            memset(&out[n], 0, sizeof(ProcessNode));
+            out[n].pid = pid;
+            // Only the resident size of the memory figures is recorded.
+            out[n].vsz_kb = out[n].anon_kb = out[n].file_kb = out[n].shmem_kb = -1;
+            out[n].swap_kb = out[n].pss_kb = out[n].uss_kb = -1;
+        }
+        decode_process(&c, mask, &out[n++]);
+    }
+    while (i < old_count && n < capacity) out[n++] = old[i++];
+    if (c.error || i < old_count || n != capacity) return -1;
+
+    replay->scratch = replay->procs;
+    replay->procs   = out;
+    replay->count   = n;
+    return 0;
+}
+
+/**
+ * @brief Decodes the frame at @p offset into the current sample.
+ * @param forward Non-zero if the frame directly follows the one decoded last.
+ */
+static int replay_decode(Replay* replay, uint64_t offset, int forward) {
+    const RecorderFrame* frame = replay_frame(replay, offset);
+    if (!frame) return -1;
+
+    if (forward && !(frame->flags & RECORDER_FRAME_KEY) && replay->decoded) {
+        if (replay_apply(replay, frame) != 0) return -1;
+    } else {
+        // Walk back to the nearest keyframe, then apply the frames in order.
+        uint64_t  chain[RECORDER_KEYFRAME_INTERVAL * 4];
+        int       length = 0;
+        uint64_t  at     = offset;
+        const RecorderFrame* f = frame;
+        while (1) {
+            if (length == (int)(sizeof(chain) / sizeof(chain[0]))) return -1;
+            chain[length++] = at;
+            if (f->flags & RECORDER_FRAME_KEY) break;
+            if (at == replay->header.tail) return -1;
+            uint64_t             prev    = f->prev;
+            const RecorderFrame* earlier = replay_frame(replay, prev);
+            if (!earlier || earlier->sequence + 1 != f->sequence) return -1;
+            at = prev;
+            f  = earlier;
+        }
+        replay->decoded = 0;
+        while (length > 0) {
+            if (replay_apply(replay, replay_frame(replay, chain[--length])) != 0) return -1;
+        }
+    }
+
+    for (int i = 0; i < replay->count; i++) {
+        replay->procs[i].next = (i + 1 < replay->count) ? &replay->procs[i + 1] : NULL;
+    }
+    if (snapshot_build(&replay->sample.snapshot, replay->procs, replay->count) != 0) return -1;
+    replay->sample.time_ms  = frame->time_ms;
+    replay->sample.sequence = frame->sequence;
+    replay->decoded         = offset;
+    return 0;
+}
+
+int replay_open(Replay* replay, const char* path, char* error, size_t error_size) {
+    memset(replay, 0, sizeof(*replay));
+    snapshot_init(&replay->sample.snapshot);
+    cgroup_list_init(&replay->sample.cgroups);
+    replay->fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (replay->fd < 0 || fstat(replay->fd, &st) != 0) {
+        snprintf(error, error_size, "cannot open %s: %s", path, strerror(errno));
+        replay_close(replay);
+        return -1;
+    }
+    if ((uint64_t)st.st_size < RECORDER_DATA_OFFSET) {
+        snprintf(error, error_size, "%s is not a ProcX recording", path);
+        replay_close(replay);
+        return -1;
+    }
+    replay->size = (size_t)st.st_size;
+    void* map    = mmap(NULL, replay->size, PROT_READ, MAP_SHARED, replay->fd, 0);
+    if (map == MAP_FAILED) {
+        snprintf(error, error_size, "cannot map %s: %s", path, strerror(errno));
+        replay->size = 0;
+        replay_close(replay);
+        return -1;
+    }
+    replay->map = map;
+
+    // A recorder may still be appending; replay shows the frames that existed now.
+    memcpy(&replay->header, map, sizeof(RecorderHeader));
+    if (!header_valid(&replay->header, replay->size)) {
+        snprintf(error, error_size, "%s is not a ProcX recording", path);
+        replay_close(replay);
+        return -1;
+    }
+    if (replay->header.frames == 0) {
+        snprintf(error, error_size, "%s contains no samples yet", path);
+        replay_close(replay);
+        return -1;
+    }
+    replay->offset = replay->header.last;
+    replay->index  = (long)replay->header.frames - 1;
+    if (replay_decode(replay, replay->offset, 0) != 0) {
+        snprintf(error, error_size, "%s: newest sample is damaged", path);
+        replay_close(replay);
+        return -1;
+    }
+    return 0;
+}
+
+int replay_step(Replay* replay, long delta) {
+    uint64_t offset = replay->offset;
+    long     index  = replay->index;
+    while (delta > 0 && index < replay_frames(replay) - 1) {
+        const RecorderFrame* frame = replay_frame(replay, offset);
+        if (!frame) return -1;
+        uint64_t             next  = ring_next(replay->map, replay->size, offset);
+        const RecorderFrame* later = replay_frame(replay, next);
+        if (!later || later->sequence != frame->sequence + 1) return -1;
+        offset = next;
+        index++;
+        delta--;
+    }
+    while (delta < 0 && index > 0) {
+        const RecorderFrame* frame   = replay_frame(replay, offset);
+        const RecorderFrame* earlier = frame ? replay_frame(replay, frame->prev) : NULL;
+        if (!earlier || earlier->sequence + 1 != frame->sequence) return -1;
+        offset = frame->prev;
+        index--;
+        delta++;
+    }
+    if (offset == replay->offset) return 0;
+
+    int forward = index == replay->index + 1 && replay->decoded == replay->offset;
+    if (replay_decode(replay, offset, forward) != 0) {
+        // The buffers may hold a partial decode; the next move starts from a keyframe.
+        replay->decoded = 0;
+        replay_decode(replay, replay->offset, 0);
+        return -1;
+    }
+    replay->offset = offset;
+    replay->index  = index;
+    return 0;
+}
+
+void replay_close(Replay* replay) {
+    if (replay->map) munmap(replay->map, replay->size);
+    if (replay->fd >= 0) close(replay->fd);
+    free(replay->procs);
+    free(replay->scratch);
+    snapshot_free(&replay->sample.snapshot);
+    cgroup_list_free(&replay->sample.cgroups);
+    memset(replay, 0, sizeof(*replay));
+    replay->fd = -1;
+}
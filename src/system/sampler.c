@@ -0,0 +1,326 @@
+/**
+ * @file sampler.c
+ * @brief Implementation of the background sampling thread.
+ * @version 2.0.1
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "../../include/system/sampler.h"
+#include "../../include/system/recorder.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Fills @p sample from a fresh update of the table.
+ */
+static void sampler_collect(Sampler* sampler, Sample* sample) {
+    ProcessTable*   table = sampler->table;
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    sample->time_ms = (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+    process_table_update(table);
+    int rows = table->count + table->thread_count;
+    if (snapshot_build(&sample->snapshot, table->head, rows) != 0) {
+        sample->snapshot.count = sample->snapshot.matched = 0;
+    }
+    PROFILE_BEGIN(system_start);
+    system_sampler_collect(&table->system, &sample->info,
+                           sample->snapshot.count - sample->snapshot.threads,
+                           sample->snapshot.running);
+    PROFILE_END(system_start, table->profile.ns[PROFILE_SYSINFO]);
+    if (cgroup_sampler_collect(&table->cgroups, &sample->cgroups) != 0) {
+        sample->cgroups.count = 0;
+    }
+    cgroup_list_count(&sample->cgroups, &sample->snapshot);
+    sample->short_lived = table->events.sock >= 0 ? (long)table->events.short_lived : -1;
+    if (sampler->recorder) recorder_append(sampler->recorder, sample);
+    profile_pass_end(&table->profile);
+    sample->profile = table->profile;
+}
+
+/**
+ * @brief Adds @p ms milliseconds to an absolute time.
+ */
+static void sampler_advance(struct timespec* ts, int ms) {
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+/**
+ * @brief Returns non-zero if @p a is later than @p b.
+ */
+static int sampler_after(const struct timespec* a, const struct timespec* b) {
+    return a->tv_sec > b->tv_sec || (a->tv_sec == b->tv_sec && a->tv_nsec > b->tv_nsec);
+}
+
+/**
+ * @brief Interval until the next sample, shortened while a burst is active.
+ */
+static int sampler_interval(Sampler* sampler, const Sample* sample, const struct timespec* now) {
+    const SamplerTrigger* trigger = &sampler->trigger;
+    if (trigger->cpu_percent <= 0) return sampler->interval_ms;
+    if (sample->info.cpu_usage >= trigger->cpu_percent) {
+        sampler->burst_until = *now;
+        sampler_advance(&sampler->burst_until, trigger->window_ms);
+    }
+    return sampler_after(&sampler->burst_until, now) ? trigger->interval_ms : sampler->interval_ms;
+}
+
+/**
+ * @brief PSI watcher body: waits for a trigger and cuts the sampler's wait short.
+ *
+ * Runs only when triggers were added. A trigger whose descriptor reports an
+ * error (the kernel tore it down) is dropped; the stop pipe ends the thread.
+ */
+static void* sampler_psi_thread(void* arg) {
+    Sampler*      sampler = (Sampler*)arg;
+    struct pollfd fds[SAMPLER_MAX_PSI_TRIGGERS + 1];
+    int           count = sampler->psi_count;
+    for (int i = 0; i < count; i++) fds[i] = (struct pollfd){sampler->psi_fds[i], POLLPRI, 0};
+    fds[count] = (struct pollfd){sampler->psi_stop_fds[0], POLLIN, 0};
+
+    for (;;) {
+        if (poll(fds, (nfds_t)count + 1, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[count].revents) break;
+        int fired = 0;
+        for (int i = 0; i < count; i++) {
+            if (fds[i].revents & (POLLERR | POLLNVAL)) {
+                fds[i].fd = -1;
+            } else if (fds[i].revents & POLLPRI) {
+                fired = 1;
+            }
+        }
+        if (fired) {
+            pthread_mutex_lock(&sampler->lock);
+            sampler->poked = 1;
+            pthread_cond_signal(&sampler->stop_cond);
+            pthread_mutex_unlock(&sampler->lock);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Thread body: sample, publish, and sleep until the next deadline.
+ */
+static void* sampler_thread(void* arg) {
+    Sampler*        sampler  = (Sampler*)arg;
+    unsigned long   sequence = 0;
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    pthread_mutex_lock(&sampler->lock);
+    while (sampler->running) {
+        // Only this thread ever touches the back buffer, so it is filled unlocked.
+        Sample* sample = sampler->back;
+        process_table_set_threads(sampler->table, &sampler->threads);
+        process_table_set_cgroups(sampler->table, sampler->cgroups);
+        process_table_set_files(sampler->table,
+                                sampler->files | (sampler->recorder ? PROC_FILES_SCAN : 0));
+        process_table_set_memory(sampler->table, &sampler->memory);
+        pthread_mutex_unlock(&sampler->lock);
+        sampler_collect(sampler, sample);
+        sample->sequence = ++sequence;
+        pthread_mutex_lock(&sampler->lock);
+
+        sampler->back  = sampler->ready;
+        sampler->ready = sample;
+        if (!sampler->fresh) {
+            // One pending byte is enough to wake the reader.
+            char byte = 1;
+            if (write(sampler->wake_fds[1], &byte, 1) < 0) {
+                // The pipe is non-blocking and never holds more than one byte.
+            }
+        }
+        sampler->fresh = 1;
+
+        // Keep a fixed schedule; if the pass overran it, start the next one now.
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        sampler_advance(&deadline, sampler_interval(sampler, sample, &now));
+        if (sampler_after(&now, &deadline)) deadline = now;
+        while (sampler->running && !sampler->poked &&
+               pthread_cond_timedwait(&sampler->stop_cond, &sampler->lock, &deadline) !=
+                   ETIMEDOUT) {
+        }
+
+        // A PSI trigger fired: sample now, and keep the schedule from here.
+        if (sampler->poked) {
+            sampler->poked = 0;
+            sampler->wakeups++;
+            clock_gettime(CLOCK_MONOTONIC, &deadline);
+        }
+    }
+    pthread_mutex_unlock(&sampler->lock);
+    return NULL;
+}
+
+void sampler_init(Sampler* sampler, ProcessTable* table, int interval_ms) {
+    memset(sampler, 0, sizeof(*sampler));
+    sampler->table       = table;
+    sampler->interval_ms = interval_ms > 0 ? interval_ms : 1;
+    sampler->files       = PROC_FILES_SCAN;
+    thread_view_init(&sampler->threads);
+    memory_view_init(&sampler->memory, MEMORY_VIEW_DEFAULT_AGE_MS);
+    for (int i = 0; i < 3; i++) {
+        snapshot_init(&sampler->samples[i].snapshot);
+        cgroup_list_init(&sampler->samples[i].cgroups);
+        sampler->samples[i].short_lived = -1;
+    }
+    sampler->back  = &sampler->samples[0];
+    sampler->ready = &sampler->samples[1];
+    sampler->front = &sampler->samples[2];
+
+    // The lock exists from here on, so the setters work before the thread starts.
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&sampler->stop_cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&sampler->lock, NULL);
+}
+
+void sampler_set_recorder(Sampler* sampler, struct Recorder* recorder) {
+    sampler->recorder = recorder;
+}
+
+void sampler_set_trigger(Sampler* sampler, const SamplerTrigger* trigger) {
+    sampler->trigger = *trigger;
+    if (sampler->trigger.interval_ms < 1) sampler->trigger.interval_ms = 1;
+}
+
+int sampler_add_psi_trigger(Sampler* sampler, int fd) {
+    if (fd < 0) return -1;
+    if (sampler->psi_count == SAMPLER_MAX_PSI_TRIGGERS) {
+        close(fd);
+        return -1;
+    }
+    sampler->psi_fds[sampler->psi_count++] = fd;
+    return 0;
+}
+
+/**
+ * @brief Starts the PSI watcher if there are triggers.
+ * @return int 0 on success or without triggers, an errno value on failure.
+ */
+static int sampler_start_psi(Sampler* sampler) {
+    if (sampler->psi_count == 0) return 0;
+    if (pipe2(sampler->psi_stop_fds, O_CLOEXEC) != 0) return errno;
+    int rc = pthread_create(&sampler->psi_thread, NULL, sampler_psi_thread, sampler);
+    if (rc != 0) {
+        close(sampler->psi_stop_fds[0]);
+        close(sampler->psi_stop_fds[1]);
+    }
+    return rc;
+}
+
+/**
+ * @brief Stops the PSI watcher and closes the triggers.
+ */
+static void sampler_stop_psi(Sampler* sampler) {
+    if (sampler->psi_count == 0) return;
+    char byte = 1;
+    if (write(sampler->psi_stop_fds[1], &byte, 1) == 1) pthread_join(sampler->psi_thread, NULL);
+    close(sampler->psi_stop_fds[0]);
+    close(sampler->psi_stop_fds[1]);
+    for (int i = 0; i < sampler->psi_count; i++) close(sampler->psi_fds[i]);
+    sampler->psi_count = 0;
+}
+
+int sampler_start(Sampler* sampler) {
+    if (pipe2(sampler->wake_fds, O_NONBLOCK | O_CLOEXEC) != 0) return -1;
+
+    sampler->running = 1;
+    int rc           = pthread_create(&sampler->thread, NULL, sampler_thread, sampler);
+    if (rc == 0 && (rc = sampler_start_psi(sampler)) != 0) {
+        pthread_mutex_lock(&sampler->lock);
+        sampler->running = 0;
+        pthread_cond_signal(&sampler->stop_cond);
+        pthread_mutex_unlock(&sampler->lock);
+        pthread_join(sampler->thread, NULL);
+    }
+    if (rc != 0) {
+        pthread_cond_destroy(&sampler->stop_cond);
+        pthread_mutex_destroy(&sampler->lock);
+        close(sampler->wake_fds[0]);
+        close(sampler->wake_fds[1]);
+        for (int i = 0; i < sampler->psi_count; i++) close(sampler->psi_fds[i]);
+        sampler->psi_count = 0;
+        errno              = rc;
+        return -1;
+    }
+    return 0;
+}
+
+void sampler_set_threads(Sampler* sampler, const ThreadView* view) {
+    pthread_mutex_lock(&sampler->lock);
+    sampler->threads = *view;
+    pthread_mutex_unlock(&sampler->lock);
+}
+
+void sampler_set_cgroups(Sampler* sampler, int enabled) {
+    pthread_mutex_lock(&sampler->lock);
+    sampler->cgroups = enabled;
+    pthread_mutex_unlock(&sampler->lock);
+}
+
+void sampler_set_files(Sampler* sampler, int files) {
+    pthread_mutex_lock(&sampler->lock);
+    sampler->files = files;
+    pthread_mutex_unlock(&sampler->lock);
+}
+
+void sampler_set_memory(Sampler* sampler, const MemoryView* view) {
+    pthread_mutex_lock(&sampler->lock);
+    sampler->memory = *view;
+    pthread_mutex_unlock(&sampler->lock);
+}
+
+int sampler_take(Sampler* sampler) {
+    char drain[16];
+    while (read(sampler->wake_fds[0], drain, sizeof(drain)) > 0) {
+    }
+
+    pthread_mutex_lock(&sampler->lock);
+    int fresh = sampler->fresh;
+    if (fresh) {
+        Sample* sample = sampler->front;
+        sampler->front = sampler->ready;
+        sampler->ready = sample;
+        sampler->fresh = 0;
+    }
+    pthread_mutex_unlock(&sampler->lock);
+    return fresh;
+}
+
+void sampler_stop(Sampler* sampler) {
+    sampler_stop_psi(sampler);
+    pthread_mutex_lock(&sampler->lock);
+    sampler->running = 0;
+    pthread_cond_signal(&sampler->stop_cond);
+    pthread_mutex_unlock(&sampler->lock);
+    pthread_join(sampler->thread, NULL);
+
+    pthread_cond_destroy(&sampler->stop_cond);
+    pthread_mutex_destroy(&sampler->lock);
+    close(sampler->wake_fds[0]);
+    close(sampler->wake_fds[1]);
+    for (int i = 0; i < 3; i++) {
+        snapshot_free(&sampler->samples[i].snapshot);
+        cgroup_list_free(&sampler->samples[i].cgroups);
+    }
+}
@@ -0,0 +1,161 @@
+/**
+ * @file scan_pool.c
+ * @brief Implementation of the parallel /proc scan worker pool.
+ * @version 2.0.1
+ */
+
+#include "../../include/system/scan_pool.h"
+#include "../../include/system/proc_parser.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @struct ScanWorker
+ * @brief Per-thread state: the worker's index within the pool.
+ */
+typedef struct ScanWorker {
+    struct ScanPool* pool;
+    int              index;
+    pthread_t        thread;
+} ScanWorker;
+
+struct ScanPool {
+    pthread_mutex_t    lock;
+    pthread_cond_t     start;    /**< Signalled when a new batch is posted */
+    pthread_cond_t     done;     /**< Signalled when the last slice finishes */
+    unsigned long      batch;    /**< Incremented for every posted batch */
+    int                pending;  /**< Slices of the current batch still running */
+    int                shutdown; /**< Set to stop the worker threads */
+    int                workers;  /**< Total workers including the caller */
+    int                root_fd;
+    int                files;
+    const pid_t*       pids;
+    ProcessNode*       out;
+    int                count;
+    ScanWorker         threads[SCAN_POOL_MAX_WORKERS];
+};
+
+void scan_finish_entry(ProcessNode* out, int result) {
+    if (result < 0) {
+        out->pid = 0;
+    } else if (result == 0) {
+        out->username[0] = '\0';
+    } else {
+        strcpy(out->username, "unknown");
+    }
+}
+
+void scan_parse_range(int root_fd, int files, const pid_t* pids, ProcessNode* out, int count) {
+    for (int i = 0; i < count; i++) {
+        scan_finish_entry(&out[i], proc_read_process(root_fd, pids[i], files, &out[i]));
+    }
+}
+
+/**
+ * @brief Parses the slice of the current batch that belongs to worker @p index.
+ */
+static void scan_pool_run_slice(ScanPool* pool, int index) {
+    int begin = (int)((long)pool->count * index / pool->workers);
+    int end   = (int)((long)pool->count * (index + 1) / pool->workers);
+    scan_parse_range(pool->root_fd, pool->files, pool->pids + begin, pool->out + begin,
+                     end - begin);
+}
+
+/**
+ * @brief Worker thread body: waits for a batch, parses its slice, reports back.
+ */
+static void* scan_pool_thread(void* arg) {
+    ScanWorker*   worker = (ScanWorker*)arg;
+    ScanPool*     pool   = worker->pool;
+    unsigned long seen   = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        while (!pool->shutdown && pool->batch == seen) pthread_cond_wait(&pool->start, &pool->lock);
+        if (pool->shutdown) break;
+        seen = pool->batch;
+        pthread_mutex_unlock(&pool->lock);
+
+        scan_pool_run_slice(pool, worker->index);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+int scan_pool_default_workers() {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) cpus = 1;
+    if (cpus > 16) cpus = 16;
+    return (int)cpus;
+}
+
+ScanPool* scan_pool_create(int workers) {
+    if (workers < 1) workers = 1;
+    if (workers > SCAN_POOL_MAX_WORKERS) workers = SCAN_POOL_MAX_WORKERS;
+
+    ScanPool* pool = calloc(1, sizeof(ScanPool));
+    if (!pool) return NULL;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    pool->workers = 1;
+
+    // Worker 0 is the calling thread; start the others.
+    for (int i = 1; i < workers; i++) {
+        pool->threads[i].pool  = pool;
+        pool->threads[i].index = i;
+        if (pthread_create(&pool->threads[i].thread, NULL, scan_pool_thread, &pool->threads[i]) !=
+            0) {
+            break;
+        }
+        pool->workers++;
+    }
+    return pool;
+}
+
+int scan_pool_workers(const ScanPool* pool) { return pool->workers; }
+
+void scan_pool_parse(ScanPool* pool, int root_fd, int files, const pid_t* pids, ProcessNode* out,
+                     int count) {
+    if (pool->workers == 1) {
+        scan_parse_range(root_fd, files, pids, out, count);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->root_fd = root_fd;
+    pool->files   = files;
+    pool->pids    = pids;
+    pool->out     = out;
+    pool->count   = count;
+    pool->pending = pool->workers - 1;
+    pool->batch++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    scan_pool_run_slice(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0) pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void scan_pool_destroy(ScanPool* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 1; i < pool->workers; i++) pthread_join(pool->threads[i].thread, NULL);
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
@@ -0,0 +1,409 @@
+/**
+ * @file snapshot.c
+ * @brief Implementation of process snapshots and the stable multi-key sort.
+ * @version 2.0.1
+ */
+
+#include "../../include/system/snapshot.h"
+#include "../../include/system/proc_parser.h"
+#include "../../include/system/profile.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+/**
+ * @brief Runs shorter than this are sorted by insertion before merging.
+ */
+#define SORT_RUN_LENGTH 32
+
+void snapshot_init(ProcessSnapshot* snapshot) { memset(snapshot, 0, sizeof(*snapshot)); }
+
+/**
+ * @brief Ensures every buffer can hold @p count processes.
+ * @return 0 on success, -1 on allocation failure.
+ */
+static int snapshot_reserve(ProcessSnapshot* snapshot, int count) {
+    if (count <= snapshot->capacity) return 0;
+
+    int capacity = snapshot->capacity ? snapshot->capacity : 1024;
+    while (capacity < count) capacity *= 2;
+    PROFILE_COUNT(PROFILE_ALLOCS, 6);  // One per buffer
+
+    ProcessNode* procs = realloc(snapshot->procs, sizeof(ProcessNode) * capacity);
+    if (!procs) return -1;
+    snapshot->procs = procs;
+    int* matches    = realloc(snapshot->matches, sizeof(int) * capacity);
+    if (!matches) return -1;
+    snapshot->matches = matches;
+    int* order        = realloc(snapshot->order, sizeof(int) * capacity);
+    if (!order) return -1;
+    snapshot->order = order;
+    int* groups     = realloc(snapshot->groups, sizeof(int) * capacity);
+    if (!groups) return -1;
+    snapshot->groups = groups;
+    SortItem* items = realloc(snapshot->items, sizeof(SortItem) * capacity);
+    if (!items) return -1;
+    snapshot->items   = items;
+    SortItem* scratch = realloc(snapshot->scratch, sizeof(SortItem) * capacity);
+    if (!scratch) return -1;
+    snapshot->scratch  = scratch;
+    snapshot->capacity = capacity;
+    return 0;
+}
+
+int snapshot_build(ProcessSnapshot* snapshot, const ProcessNode* head, int count) {
+    snapshot->count   = 0;
+    snapshot->threads = 0;
+    snapshot->running = 0;
+    snapshot->matched = 0;
+    snapshot->sorted  = 0;
+    if (snapshot_reserve(snapshot, count) != 0) return -1;
+
+    int n = 0;
+    for (const ProcessNode* node = head; node && n < count; node = node->next) {
+        // Thread rows directly follow their process.
+        const ProcessNode* row   = node;
+        int                group = n;
+        do {
+            snapshot->groups[n]        = group;
+            snapshot->procs[n]         = *row;
+            snapshot->procs[n].next    = NULL;
+            snapshot->procs[n].threads = NULL;
+            snapshot->matches[n]       = n;
+            snapshot->order[n]         = n;
+            // The task counts of the header are taken here, not in another pass.
+            if (row->thread_of) {
+                snapshot->threads++;
+            } else if (row->state == 'R') {
+                snapshot->running++;
+            }
+            n++;
+            row = row == node ? node->threads : row->next;
+        } while (row && n < count);
+    }
+    snapshot->count   = n;
+    snapshot->matched = n;
+    snapshot->sorted  = 0;
+    return 0;
+}
+
+void snapshot_filter(ProcessSnapshot* snapshot, const Filter* filter) {
+    int m    = 0;
+    int keep = 0;
+    for (int i = 0; i < snapshot->count; i++) {
+        // Thread rows go wherever their process went.
+        const ProcessNode* proc = &snapshot->procs[i];
+        if (!proc->thread_of) keep = !filter || filter_match(filter, proc);
+        if (!keep) continue;
+        snapshot->matches[m] = i;
+        snapshot->order[m]   = i;
+        m++;
+    }
+    snapshot->matched = m;
+    snapshot->sorted  = 0;
+}
+
+/**
+ * @brief Encodes one attribute as an unsigned integer that sorts ascending.
+ *
+ * Names are reduced to their first eight case-folded bytes, big-endian, which
+ * orders like strcasecmp(); equal prefixes are resolved by sort_item_compare().
+ */
+static uint64_t sort_encode(const ProcessNode* proc, SortField field) {
+    switch (field) {
+        case SORT_FIELD_CPU: {
+            // Non-negative IEEE floats order like their bit patterns.
+            float    cpu = proc->cpu_usage > 0.0f ? proc->cpu_usage : 0.0f;
+            uint32_t bits;
+            memcpy(&bits, &cpu, sizeof(bits));
+            return bits;
+        }
+        case SORT_FIELD_MEM:
+            return proc->memory_kb > 0 ? (uint64_t)proc->memory_kb : 0;
+        case SORT_FIELD_PSS:
+            return proc->pss_kb > 0 ? (uint64_t)proc->pss_kb : 0;
+        case SORT_FIELD_NAME: {
+            uint64_t key = 0;
+            int      i   = 0;
+            for (; i < 8 && proc->name[i]; i++) {
+                key = (key << 8) | (unsigned char)tolower((unsigned char)proc->name[i]);
+            }
+            return key << (8 * (8 - i));
+        }
+        case SORT_FIELD_IO: {
+            // Both rates are -1 when the counters were not read.
+            float    io = proc->io_read + proc->io_write;
+            uint32_t bits;
+            if (io < 0.0f) io = 0.0f;
+            memcpy(&bits, &io, sizeof(bits));
+            return bits;
+        }
+        case SORT_FIELD_PID:
+        default:
+            return proc->pid > 0 ? (uint64_t)proc->pid : 0;
+    }
+}
+
+/**
+ * @brief Compares two threads of the same process by their own values.
+ * @return Negative, zero, or positive like strcmp().
+ */
+static int sort_thread_compare(const SortSpec* spec, const ProcessNode* a, const ProcessNode* b) {
+    for (int k = 0; k < spec->count; k++) {
+        int c = 0;
+        if (spec->keys[k].field == SORT_FIELD_NAME) {
+            c = strcasecmp(a->name, b->name);
+        } else {
+            uint64_t ka = sort_encode(a, spec->keys[k].field);
+            uint64_t kb = sort_encode(b, spec->keys[k].field);
+            if (ka != kb) c = ka < kb ? -1 : 1;
+        }
+        if (c != 0) return spec->keys[k].descending ? -c : c;
+    }
+    return 0;
+}
+
+/**
+ * @brief Orders two records whose keys are equal when thread rows are present.
+ *
+ * Thread rows carry the keys of their process, so a process ties with its
+ * threads. Different processes then keep table order, as in a stable sort,
+ * which keeps every group together; within a group the process comes first
+ * and its threads follow in the order of their own values.
+ */
+static int sort_group_compare(const ProcessSnapshot* snapshot, const SortSpec* spec,
+                              const SortItem* a, const SortItem* b) {
+    if (snapshot->groups[a->index] != snapshot->groups[b->index]) {
+        return a->position < b->position ? -1 : 1;
+    }
+    const ProcessNode* pa = &snapshot->procs[a->index];
+    const ProcessNode* pb = &snapshot->procs[b->index];
+    if (!pa->thread_of || !pb->thread_of) return pa->thread_of ? 1 : -1;
+    return sort_thread_compare(spec, pa, pb);
+}
+
+/**
+ * @brief Compares two sort records key by key.
+ * @return Negative, zero, or positive like strcmp().
+ */
+static int sort_item_compare(const ProcessSnapshot* snapshot, const SortSpec* spec,
+                             const SortItem* a, const SortItem* b) {
+    for (int k = 0; k < spec->count; k++) {
+        if (a->key[k] != b->key[k]) return a->key[k] < b->key[k] ? -1 : 1;
+        if (spec->keys[k].field == SORT_FIELD_NAME) {
+            // Equal prefixes only need the full comparison if both names are
+            // longer than the prefix, i.e. its last byte is not padding.
+            uint64_t prefix = spec->keys[k].descending ? ~a->key[k] : a->key[k];
+            if ((prefix & 0xff) != 0) {
+                // A thread row was keyed by its process's name.
+                int c = strcasecmp(snapshot->procs[snapshot->groups[a->index]].name + 8,
+                                   snapshot->procs[snapshot->groups[b->index]].name + 8);
+                if (c != 0) return spec->keys[k].descending ? -c : c;
+            }
+        }
+    }
+    return snapshot->threads ? sort_group_compare(snapshot, spec, a, b) : 0;
+}
+
+/**
+ * @brief Sorts items[begin, end) in place by insertion; stable.
+ */
+static void sort_insertion(const ProcessSnapshot* snapshot, const SortSpec* spec, SortItem* items,
+                           int begin, int end) {
+    for (int i = begin + 1; i < end; i++) {
+        SortItem item = items[i];
+        int      j    = i;
+        while (j > begin && sort_item_compare(snapshot, spec, &items[j - 1], &item) > 0) {
+            items[j] = items[j - 1];
+            j--;
+        }
+        items[j] = item;
+    }
+}
+
+/**
+ * @brief Merges the sorted runs src[begin, mid) and src[mid, end) into dst; stable.
+ */
+static void sort_merge(const ProcessSnapshot* snapshot, const SortSpec* spec, const SortItem* src,
+                       SortItem* dst, int begin, int mid, int end) {
+    int i = begin, j = mid, k = begin;
+    // Runs that are already in order are copied through.
+    if (mid < end && sort_item_compare(snapshot, spec, &src[mid - 1], &src[mid]) <= 0) {
+        memcpy(&dst[begin], &src[begin], sizeof(SortItem) * (end - begin));
+        return;
+    }
+    while (i < mid && j < end) {
+        if (sort_item_compare(snapshot, spec, &src[j], &src[i]) < 0) {
+            dst[k++] = src[j++];
+        } else {
+            dst[k++] = src[i++];
+        }
+    }
+    while (i < mid) dst[k++] = src[i++];
+    while (j < end) dst[k++] = src[j++];
+}
+
+/**
+ * @brief Fills snapshot->items with the encoded keys of every matching process,
+ *        in table order.
+ *
+ * Descending keys are inverted so that all comparisons are plain ascending
+ * integer comparisons. A thread row gets the keys of its process, which
+ * precedes it in @c matches.
+ */
+static void sort_prepare(ProcessSnapshot* snapshot, const SortSpec* spec) {
+    SortItem* items = snapshot->items;
+    for (int j = 0; j < snapshot->matched; j++) {
+        const ProcessNode* proc = &snapshot->procs[snapshot->matches[j]];
+        if (proc->thread_of && j > 0) {
+            memcpy(items[j].key, items[j - 1].key, sizeof(items[j].key));
+        } else {
+            for (int k = 0; k < spec->count; k++) {
+                uint64_t key    = sort_encode(proc, spec->keys[k].field);
+                items[j].key[k] = spec->keys[k].descending ? ~key : key;
+            }
+        }
+        items[j].index    = snapshot->matches[j];
+        items[j].position = j;
+    }
+}
+
+/**
+ * @brief Total order used by the partial sort: the spec, then table order.
+ * @return Non-zero if @p a comes before @p b.
+ */
+static int sort_item_before(const ProcessSnapshot* snapshot, const SortSpec* spec,
+                            const SortItem* a, const SortItem* b) {
+    int c = sort_item_compare(snapshot, spec, a, b);
+    return c < 0 || (c == 0 && a->position < b->position);
+}
+
+/**
+ * @brief Restores the max-heap property below @p root; the item that comes
+ *        last in sort order is at the top.
+ */
+static void sort_heap_down(const ProcessSnapshot* snapshot, const SortSpec* spec, SortItem* heap,
+                           int size, int root) {
+    SortItem item = heap[root];
+    while (1) {
+        int child = 2 * root + 1;
+        if (child >= size) break;
+        if (child + 1 < size && sort_item_before(snapshot, spec, &heap[child], &heap[child + 1])) {
+            child++;
+        }
+        if (!sort_item_before(snapshot, spec, &item, &heap[child])) break;
+        heap[root] = heap[child];
+        root       = child;
+    }
+    heap[root] = item;
+}
+
+void snapshot_sort(ProcessSnapshot* snapshot, const SortSpec* spec) {
+    int n = snapshot->matched;
+    if (n < 2 || !snapshot->items) {
+        snapshot->sorted = n;
+        return;
+    }
+
+    SortSpec local = *spec;
+    if (local.count > SORT_MAX_KEYS) local.count = SORT_MAX_KEYS;
+    sort_prepare(snapshot, &local);
+
+    SortItem* src = snapshot->items;
+
+    for (int begin = 0; begin < n; begin += SORT_RUN_LENGTH) {
+        int end = begin + SORT_RUN_LENGTH < n ? begin + SORT_RUN_LENGTH : n;
+        sort_insertion(snapshot, &local, src, begin, end);
+    }
+
+    // Bottom-up merge passes, alternating between the two buffers.
+    SortItem* dst = snapshot->scratch;
+    for (int width = SORT_RUN_LENGTH; width < n; width *= 2) {
+        for (int begin = 0; begin < n; begin += 2 * width) {
+            int mid = begin + width < n ? begin + width : n;
+            int end = begin + 2 * width < n ? begin + 2 * width : n;
+            sort_merge(snapshot, &local, src, dst, begin, mid, end);
+        }
+        SortItem* swap = src;
+        src            = dst;
+        dst            = swap;
+    }
+
+    for (int i = 0; i < n; i++) snapshot->order[i] = src[i].index;
+    snapshot->sorted = n;
+}
+
+void snapshot_sort_top(ProcessSnapshot* snapshot, const SortSpec* spec, int limit) {
+    int n = snapshot->matched;
+    if (limit <= 0 || !snapshot->items) return;
+    if (limit > n / SORT_TOP_FULL_RATIO) {
+        snapshot_sort(snapshot, spec);
+        return;
+    }
+
+    SortSpec local = *spec;
+    if (local.count > SORT_MAX_KEYS) local.count = SORT_MAX_KEYS;
+    sort_prepare(snapshot, &local);
+
+    // Keep the best `limit` items in a max-heap whose top is the worst of them.
+    SortItem* items = snapshot->items;
+    SortItem* heap  = snapshot->scratch;
+    for (int i = 0; i < limit; i++) heap[i] = items[i];
+    for (int i = limit / 2 - 1; i >= 0; i--) sort_heap_down(snapshot, &local, heap, limit, i);
+    for (int i = limit; i < n; i++) {
+        if (sort_item_before(snapshot, &local, &items[i], &heap[0])) {
+            heap[0] = items[i];
+            sort_heap_down(snapshot, &local, heap, limit, 0);
+        }
+    }
+
+    // Pop the worst item to the back until the heap is in ascending order.
+    for (int size = limit - 1; size > 0; size--) {
+        SortItem top = heap[0];
+        heap[0]      = heap[size];
+        heap[size]   = top;
+        sort_heap_down(snapshot, &local, heap, size, 0);
+    }
+
+    // The selected processes lead, everything else follows in table order.
+    for (int i = 0; i < limit; i++) {
+        snapshot->order[i]               = heap[i].index;
+        items[heap[i].position].position = -1;
+    }
+    int pos = limit;
+    for (int j = 0; j < n; j++) {
+        if (items[j].position >= 0) snapshot->order[pos++] = items[j].index;
+    }
+    snapshot->sorted = limit;
+}
+
+int snapshot_sort_files(const SortSpec* spec) {
+    int files = PROC_FILE_STAT;
+    for (int i = 0; spec && i < spec->count; i++) {
+        switch (spec->keys[i].field) {
+            case SORT_FIELD_MEM:
+                files |= PROC_FILE_STATM;
+                break;
+            case SORT_FIELD_IO:
+                files |= PROC_FILE_IO;
+                break;
+            case SORT_FIELD_PSS:
+                files |= PROC_FILE_ROLLUP;
+                break;
+            default:
+                break;
+        }
+    }
+    return files;
+}
+
+void snapshot_free(ProcessSnapshot* snapshot) {
+    free(snapshot->procs);
+    free(snapshot->matches);
+    free(snapshot->order);
+    free(snapshot->groups);
+    free(snapshot->items);
+    free(snapshot->scratch);
+    snapshot_init(snapshot);
+}
@@ -5,198 +5,269 @@
  */
 
 #include "../../include/system/sys_info.h"
+#include "../../include/system/proc_parser.h"
+#include "../../include/system/user_cache.h"
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
-#include <pwd.h>
+#include <time.h>
 
 int get_process_info(pid_t pid, ProcessNode* info) {
-    char  path[256];
-    FILE* file;
-
-    // Get basic process information (name, state, ppid, utime, stime)
-    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
-    file = fopen(path, "r");
-    if (!file) return -1;
-
-    info->pid = pid;
-    // Format: pid (comm) state ppid pgrp session tty_nr tpgid flags minflt cminflt majflt cmajflt
-    // utime stime cutime cstime priority nice
-    if (fscanf(file,
-               "%*d (%255[^)]) %c %d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu %*d %*d %ld %ld",
-               info->name, &info->state, &info->ppid, &info->utime, &info->stime, &info->priority,
-               &info->nice_value) < 7) {
-        fclose(file);
-        return -1;
-    }
-    fclose(file);
-
-    // Get memory information (Resident Set Size)
-    snprintf(path, sizeof(path), "/proc/%d/statm", pid);
-    file = fopen(path, "r");
-    if (file) {
-        long dummy, rss;
-        if (fscanf(file, "%ld %ld", &dummy, &rss) == 2) {
-            long page_size  = sysconf(_SC_PAGESIZE) / 1024;
-            info->memory_kb = rss * page_size;
-        } else {
-            info->memory_kb = 0;
-        }
-        fclose(file);
-    } else {
-        info->memory_kb = 0;
-    }
+    int root_fd = proc_root_fd();
+    if (root_fd < 0) return -1;
 
-    // Get UID and Threads from status file
-    snprintf(path, sizeof(path), "/proc/%d/status", pid);
-    file = fopen(path, "r");
-    if (file) {
-        char line[256];
-        info->uid         = 0;
-        info->num_threads = 1;
-        while (fgets(line, sizeof(line), file)) {
-            if (strncmp(line, "Uid:", 4) == 0) {
-                sscanf(line, "Uid:\t%u", &info->uid);
-            } else if (strncmp(line, "Threads:", 8) == 0) {
-                sscanf(line, "Threads:\t%d", &info->num_threads);
-            }
-        }
-        fclose(file);
-
-        struct passwd* pw = getpwuid(info->uid);
-        if (pw) {
-            strncpy(info->username, pw->pw_name, sizeof(info->username) - 1);
-            info->username[sizeof(info->username) - 1] = '\0';
-        } else {
-            snprintf(info->username, sizeof(info->username), "%u", info->uid);
-        }
+    int result = proc_read_process(root_fd, pid, PROC_FILES_SCAN, info);
+    if (result < 0) return -1;
+
+    if (result == 0) {
+        user_cache_lookup(info->uid, info->username, sizeof(info->username));
     } else {
-        info->uid         = 0;
-        info->num_threads = 1;
         strcpy(info->username, "unknown");
     }
 
     return 0;
 }
 
-void get_system_info(SystemInfo* sys_info, ProcessNode* head) {
-    FILE* file;
-    char  line[256];
-
-    // Initialize defaults
-    sys_info->cpu_usage     = 0;
-    sys_info->mem_usage     = 0;
-    sys_info->swp_usage     = 0;
-    sys_info->total_mem_kb  = 0;
-    sys_info->free_mem_kb   = 0;
-    sys_info->total_swp_kb  = 0;
-    sys_info->free_swp_kb   = 0;
-    sys_info->running_tasks = 0;
-    sys_info->total_tasks   = 0;
-    sys_info->uptime_sec    = 0;
-    for (int i = 0; i < 3; i++) sys_info->load_avg[i] = 0.0;
-
-    // Parse Load Average
-    if (getloadavg(sys_info->load_avg, 3) == -1) {
-        // Fallback to /proc/loadavg if getloadavg fails
-        file = fopen("/proc/loadavg", "r");
-        if (file) {
-            fscanf(file, "%lf %lf %lf", &sys_info->load_avg[0], &sys_info->load_avg[1],
-                   &sys_info->load_avg[2]);
-            fclose(file);
+/**
+ * @brief Subtracts two CPU lines field by field.
+ *
+ * A field that went backwards (iowait can, on some kernels) counts as zero.
+ *
+ * @return Sum of the differences.
+ */
+static unsigned long long cpu_times_delta(const CpuTimes* now, const CpuTimes* prev,
+                                          CpuTimes* delta) {
+#define CPU_TICK_DELTA(field) \
+    delta->field = now->field > prev->field ? now->field - prev->field : 0
+    CPU_TICK_DELTA(user);
+    CPU_TICK_DELTA(nice);
+    CPU_TICK_DELTA(system);
+    CPU_TICK_DELTA(idle);
+    CPU_TICK_DELTA(iowait);
+    CPU_TICK_DELTA(irq);
+    CPU_TICK_DELTA(softirq);
+    CPU_TICK_DELTA(steal);
+#undef CPU_TICK_DELTA
+    return proc_cpu_total(delta);
+}
+
+/**
+ * @brief Returns @p part as a whole percentage of @p total, 0 if total is 0.
+ */
+static int cpu_percent(unsigned long long part, unsigned long long total) {
+    return total > 0 ? (int)(100.0 * (double)part / (double)total) : 0;
+}
+
+void system_sampler_init(SystemSampler* sampler) {
+    memset(sampler, 0, sizeof(*sampler));
+    int root_fd         = proc_root_fd();
+    sampler->stat_fd    = root_fd < 0 ? -1 : openat(root_fd, "stat", O_RDONLY | O_CLOEXEC);
+    sampler->meminfo_fd = root_fd < 0 ? -1 : openat(root_fd, "meminfo", O_RDONLY | O_CLOEXEC);
+    sampler->loadavg_fd = root_fd < 0 ? -1 : openat(root_fd, "loadavg", O_RDONLY | O_CLOEXEC);
+    sampler->uptime_fd  = root_fd < 0 ? -1 : openat(root_fd, "uptime", O_RDONLY | O_CLOEXEC);
+    for (int i = 0; i < PRESSURE_RESOURCES; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "pressure/%s", proc_pressure_names[i]);
+        sampler->pressure_fds[i] = root_fd < 0 ? -1 : openat(root_fd, name, O_RDONLY | O_CLOEXEC);
+    }
+    sampler->diskstats_fd = root_fd < 0 ? -1 : openat(root_fd, "diskstats", O_RDONLY | O_CLOEXEC);
+    sampler->cpu          = &sampler->cpu_stats[0];
+    sampler->cpu_prev     = &sampler->cpu_stats[1];
+}
+
+/**
+ * @brief Returns non-zero if a device is a whole disk worth showing.
+ *
+ * Partitions are left out because their disk already counts their I/O, and
+ * loop, RAM, and zram devices because their I/O is memory traffic.
+ */
+static int disk_is_whole(const char* name) {
+    if (strncmp(name, "loop", 4) == 0 || strncmp(name, "ram", 3) == 0 ||
+        strncmp(name, "zram", 4) == 0) {
+        return 0;
+    }
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/block/%.31s", name);
+    return access(path, F_OK) == 0;
+}
+
+/**
+ * @brief Returns the growth of a disk counter, 0 if it went backwards.
+ */
+static unsigned long long disk_delta(unsigned long long now, unsigned long long prev) {
+    return now > prev ? now - prev : 0;
+}
+
+/**
+ * @brief Reads /proc/diskstats and fills the throughput of the whole disks.
+ *
+ * Each device is matched to the previous read by name, trying the same
+ * position first since the kernel keeps the order; only a device seen for
+ * the first time is looked up in /sys/block.
+ */
+static void disk_collect(SystemSampler* sampler, SystemInfo* sys_info) {
+    char         buf[PROC_DISKSTATS_BUF_SIZE];
+    DiskCounters now[PROC_MAX_DISKS];
+    ssize_t      len = proc_reread(sampler->diskstats_fd, buf, sizeof(buf));
+    if (len <= 0) return;
+    int count = proc_parse_diskstats(buf, (size_t)len, now, PROC_MAX_DISKS);
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    long long     time_ms = (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+    long long     elapsed = time_ms - sampler->disk_time_ms;
+    unsigned char whole[PROC_MAX_DISKS];
+    for (int i = 0; i < count; i++) {
+        int prev = -1;
+        if (i < sampler->disk_count && strcmp(sampler->disks[i].name, now[i].name) == 0) {
+            prev = i;
+        }
+        for (int j = 0; prev < 0 && j < sampler->disk_count; j++) {
+            if (strcmp(sampler->disks[j].name, now[i].name) == 0) prev = j;
         }
+        whole[i] = prev >= 0 ? sampler->disk_whole[prev] : disk_is_whole(now[i].name);
+        if (!whole[i] || prev < 0 || sampler->disk_time_ms == 0 || elapsed <= 0 ||
+            sys_info->disk_count == SYSTEM_MAX_DISKS) {
+            continue;
+        }
+
+        const DiskCounters* old  = &sampler->disks[prev];
+        DiskInfo*           disk = &sys_info->disks[sys_info->disk_count++];
+        memcpy(disk->name, now[i].name, sizeof(disk->name));
+        // Sectors are 512 bytes whatever the device's block size; io_ticks are ms.
+        disk->read_bps  = disk_delta(now[i].sectors_read, old->sectors_read) * 512000.0f / elapsed;
+        disk->write_bps = disk_delta(now[i].sectors_written, old->sectors_written) * 512000.0f /
+                          elapsed;
+        disk->util = (int)(disk_delta(now[i].io_ticks, old->io_ticks) * 100 / elapsed);
+        if (disk->util > 100) disk->util = 100;
     }
 
-    // Parse Uptime
-    file = fopen("/proc/uptime", "r");
-    if (file) {
-        double uptime;
-        if (fscanf(file, "%lf", &uptime) == 1) {
-            sys_info->uptime_sec = (long)uptime;
+    memcpy(sampler->disks, now, sizeof(DiskCounters) * count);
+    memcpy(sampler->disk_whole, whole, (size_t)count);
+    sampler->disk_count   = count;
+    sampler->disk_time_ms = time_ms;
+}
+
+unsigned long long system_sampler_read_cpu(SystemSampler* sampler) {
+    CpuStat* prev     = sampler->cpu;
+    sampler->cpu      = sampler->cpu_prev;
+    sampler->cpu_prev = prev;
+    if (proc_read_cpu_stat(sampler->stat_fd, sampler->cpu) != 0) return 0;
+
+    unsigned long long total      = proc_cpu_total(&sampler->cpu->total);
+    unsigned long long prev_total = proc_cpu_total(&prev->total);
+    return total > prev_total ? total - prev_total : 0;
+}
+
+void system_sampler_collect(SystemSampler* sampler, SystemInfo* sys_info, int total_tasks,
+                            int running_tasks) {
+    char     buf[PROC_MEMINFO_BUF_SIZE];
+    ssize_t  len;
+    CpuStat* cpu  = sampler->cpu;
+    CpuStat* prev = sampler->cpu_prev;
+
+    memset(sys_info, 0, sizeof(*sys_info));
+    sys_info->total_tasks   = total_tasks;
+    sys_info->running_tasks = running_tasks;
+
+    len = proc_reread(sampler->loadavg_fd, buf, PROC_SMALL_BUF_SIZE);
+    if (len > 0) proc_parse_loadavg(buf, (size_t)len, sys_info->load_avg);
+
+    len = proc_reread(sampler->uptime_fd, buf, PROC_SMALL_BUF_SIZE);
+    if (len > 0) proc_parse_uptime(buf, (size_t)len, &sys_info->uptime_sec);
+
+    // Without CONFIG_PSI, or with psi=0 on the kernel command line, the files
+    // are missing or fail to read, and the header leaves pressure out.
+    for (int i = 0; i < PRESSURE_RESOURCES; i++) {
+        len = proc_reread(sampler->pressure_fds[i], buf, sizeof(buf));
+        if (len > 0 && proc_parse_pressure(buf, (size_t)len, &sys_info->pressure[i]) == 0) {
+            sys_info->psi = 1;
         }
-        fclose(file);
     }
 
-    // Parse MemInfo
-    file = fopen("/proc/meminfo", "r");
-    if (file) {
-        long buffers = 0, cached = 0, mem_available = 0;
-        while (fgets(line, sizeof(line), file)) {
-            if (strncmp(line, "MemTotal:", 9) == 0) {
-                sscanf(line, "MemTotal: %ld kB", &sys_info->total_mem_kb);
-            } else if (strncmp(line, "MemFree:", 8) == 0) {
-                sscanf(line, "MemFree: %ld kB", &sys_info->free_mem_kb);
-            } else if (strncmp(line, "MemAvailable:", 13) == 0) {
-                sscanf(line, "MemAvailable: %ld kB", &mem_available);
-            } else if (strncmp(line, "Buffers:", 8) == 0) {
-                sscanf(line, "Buffers: %ld kB", &buffers);
-            } else if (strncmp(line, "Cached:", 7) == 0) {
-                sscanf(line, "Cached: %ld kB", &cached);
-            } else if (strncmp(line, "SwapTotal:", 10) == 0) {
-                sscanf(line, "SwapTotal: %ld kB", &sys_info->total_swp_kb);
-            } else if (strncmp(line, "SwapFree:", 9) == 0) {
-                sscanf(line, "SwapFree: %ld kB", &sys_info->free_swp_kb);
-            }
+    disk_collect(sampler, sys_info);
+
+    MemInfo mem;
+    len = proc_reread(sampler->meminfo_fd, buf, sizeof(buf));
+    if (len > 0 && proc_parse_meminfo(buf, (size_t)len, &mem) == 0) {
+        sys_info->total_mem_kb = mem.total_kb;
+        sys_info->free_mem_kb  = mem.free_kb;
+        sys_info->total_swp_kb = mem.swap_total_kb;
+        sys_info->free_swp_kb  = mem.swap_free_kb;
+
+        long used_mem = mem.total_kb - mem.available_kb;
+        if (mem.available_kb == 0) {
+            used_mem = mem.total_kb - mem.free_kb - mem.buffers_kb - mem.cached_kb;
+        }
+        if (mem.total_kb > 0) {
+            sys_info->mem_usage = (int)((used_mem * 100) / mem.total_kb);
         }
-        fclose(file);
 
-        long used_mem = sys_info->total_mem_kb - mem_available;
-        if (mem_available == 0) {
-            used_mem = sys_info->total_mem_kb - sys_info->free_mem_kb - buffers - cached;
+        long used_swp = mem.swap_total_kb - mem.swap_free_kb;
+        if (mem.swap_total_kb > 0) {
+            sys_info->swp_usage = (int)((used_swp * 100) / mem.swap_total_kb);
         }
+    }
+
+    // CPU usage, from the same pair of /proc/stat reads as per-process CPU%
+    if (cpu->time_ms > 0) {
+        CpuTimes           delta;
+        unsigned long long total = cpu_times_delta(&cpu->total, &prev->total, &delta);
+        sys_info->cpu_usage      = cpu_percent(total - delta.idle - delta.iowait, total);
+        sys_info->cpu_user       = cpu_percent(delta.user + delta.nice, total);
+        sys_info->cpu_system     = cpu_percent(delta.system + delta.irq + delta.softirq, total);
+        sys_info->cpu_iowait     = cpu_percent(delta.iowait, total);
+        sys_info->cpu_steal      = cpu_percent(delta.steal, total);
 
-        if (sys_info->total_mem_kb > 0) {
-            sys_info->mem_usage = (int)((used_mem * 100) / sys_info->total_mem_kb);
+        sys_info->core_count = cpu->core_count;
+        for (int i = 0; i < cpu->core_count; i++) {
+            total = cpu_times_delta(&cpu->cores[i], &prev->cores[i], &delta);
+            sys_info->core_usage[i] =
+                (unsigned char)cpu_percent(total - delta.idle - delta.iowait, total);
         }
 
-        long used_swp = sys_info->total_swp_kb - sys_info->free_swp_kb;
-        if (sys_info->total_swp_kb > 0) {
-            sys_info->swp_usage = (int)((used_swp * 100) / sys_info->total_swp_kb);
+        long long elapsed_ms = cpu->time_ms - prev->time_ms;
+        if (prev->time_ms > 0 && elapsed_ms > 0 && cpu->ctxt >= prev->ctxt) {
+            sys_info->ctxt_rate = (long)((cpu->ctxt - prev->ctxt) * 1000 / elapsed_ms);
         }
+        sys_info->procs_running = cpu->procs_running;
+        sys_info->procs_blocked = cpu->procs_blocked;
     }
+}
 
-    // Global CPU usage
-    static unsigned long long prev_user = 0, prev_nice = 0, prev_system = 0, prev_idle = 0;
-    static unsigned long long prev_iowait = 0, prev_irq = 0, prev_softirq = 0, prev_steal = 0;
-    file = fopen("/proc/stat", "r");
-    if (file) {
-        if (fgets(line, sizeof(line), file)) {
-            unsigned long long user, nice, system, idle, iowait, irq, softirq, steal;
-            if (sscanf(line, "cpu  %llu %llu %llu %llu %llu %llu %llu %llu", &user, &nice, &system,
-                       &idle, &iowait, &irq, &softirq, &steal) == 8) {
-                unsigned long long prev_idle_sum = prev_idle + prev_iowait;
-                unsigned long long idle_sum      = idle + iowait;
-                unsigned long long prev_non_idle =
-                    prev_user + prev_nice + prev_system + prev_irq + prev_softirq + prev_steal;
-                unsigned long long non_idle   = user + nice + system + irq + softirq + steal;
-                unsigned long long prev_total = prev_idle_sum + prev_non_idle;
-                unsigned long long total      = idle_sum + non_idle;
-                unsigned long long totald     = total - prev_total;
-                unsigned long long idled      = idle_sum - prev_idle_sum;
-
-                if (totald > 0) {
-                    sys_info->cpu_usage = (int)(100.0 * (double)(totald - idled) / (double)totald);
-                }
-
-                prev_user    = user;
-                prev_nice    = nice;
-                prev_system  = system;
-                prev_idle    = idle;
-                prev_iowait  = iowait;
-                prev_irq     = irq;
-                prev_softirq = softirq;
-                prev_steal   = steal;
-            }
-        }
-        fclose(file);
+void system_sampler_free(SystemSampler* sampler) {
+    int* fds[] = {&sampler->stat_fd, &sampler->meminfo_fd, &sampler->loadavg_fd,
+                  &sampler->uptime_fd, &sampler->diskstats_fd};
+    for (int i = 0; i < 5; i++) {
+        if (*fds[i] >= 0) close(*fds[i]);
+        *fds[i] = -1;
+    }
+    for (int i = 0; i < PRESSURE_RESOURCES; i++) {
+        if (sampler->pressure_fds[i] >= 0) close(sampler->pressure_fds[i]);
+        sampler->pressure_fds[i] = -1;
     }
+}
 
-    // Count tasks
-    ProcessNode* curr = head;
-    while (curr) {
-        sys_info->total_tasks++;
-        if (curr->state == 'R') sys_info->running_tasks++;
-        curr = curr->next;
+int psi_trigger_open(PressureResource resource, int full, long stall_us, long window_us) {
+    int root_fd = proc_root_fd();
+    if (root_fd < 0 || resource < 0 || resource >= PRESSURE_RESOURCES) return -1;
+
+    char name[32];
+    snprintf(name, sizeof(name), "pressure/%s", proc_pressure_names[resource]);
+    int fd = openat(root_fd, name, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    // The trigger lives as long as the descriptor; the kernel rejects the
+    // write if the window is out of range or the stall exceeds it.
+    char    spec[64];
+    int     len     = snprintf(spec, sizeof(spec), "%s %ld %ld", full ? "full" : "some", stall_us,
+                               window_us);
+    ssize_t written = write(fd, spec, (size_t)len + 1);
+    if (written < 0) {
+        close(fd);
+        return -1;
     }
+    return fd;
 }
@@ -0,0 +1,330 @@
+/**
+ * @file uring_scan.c
+ * @brief Implementation of the io_uring /proc collection backend.
+ * @version 2.0.1
+ *
+ * The ring is driven with raw system calls against <linux/io_uring.h>, so no
+ * extra library is needed. Only IORING_OP_OPENAT, IORING_OP_READ, and
+ * IORING_OP_CLOSE are used (Linux 5.6+).
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "../../include/system/uring_scan.h"
+#include "../../include/system/proc_parser.h"
+#include "../../include/system/profile.h"
+#include "../../include/system/scan_pool.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/** @brief Files read per process, in the order proc_parse_files() expects them. */
+#define URING_FILES 3
+/** @brief Tag slot used for the per-PID directory descriptor. */
+#define URING_DIR URING_FILES
+/** @brief Ring size: a batch submits at most reads + directory closes, plus deferred closes. */
+#define URING_ENTRIES (URING_SCAN_BATCH * (URING_FILES + 1) * 2)
+/** @brief Bytes of read buffer needed per process. */
+#define URING_BUF_STRIDE (PROC_STAT_BUF_SIZE + PROC_STATM_BUF_SIZE + PROC_STATUS_BUF_SIZE)
+
+static const char* const uring_file_names[URING_FILES] = {"stat", "statm", "status"};
+static const size_t      uring_file_sizes[URING_FILES] = {PROC_STAT_BUF_SIZE, PROC_STATM_BUF_SIZE,
+                                                          PROC_STATUS_BUF_SIZE};
+static const size_t      uring_file_offsets[URING_FILES] = {
+    0, PROC_STAT_BUF_SIZE, PROC_STAT_BUF_SIZE + PROC_STATM_BUF_SIZE};
+static const int         uring_file_bits[URING_FILES] = {PROC_FILE_STAT, PROC_FILE_STATM,
+                                                         PROC_FILE_STATUS};
+
+/**
+ * @brief Returns non-zero if file @p f is read: stat always, the others if in @p files.
+ */
+static int uring_file_wanted(int files, int f) { return f == 0 || (files & uring_file_bits[f]); }
+
+struct UringScanner {
+    int ring_fd;
+
+    unsigned*            sq_head;
+    unsigned*            sq_tail;
+    unsigned*            sq_mask;
+    unsigned*            sq_array;
+    struct io_uring_sqe* sqes;
+    unsigned*            cq_head;
+    unsigned*            cq_tail;
+    unsigned*            cq_mask;
+    struct io_uring_cqe* cqes;
+
+    void*  sq_ring;
+    size_t sq_ring_len;
+    void*  cq_ring;
+    size_t cq_ring_len;
+    size_t sqes_len;
+
+    unsigned pending;                   /**< SQEs queued but not yet submitted */
+    int      closes[URING_ENTRIES / 2]; /**< Descriptors to close with the next submission */
+    int      close_count;
+
+    char    names[URING_SCAN_BATCH][16];
+    int     fds[URING_SCAN_BATCH][URING_FILES + 1];
+    ssize_t lens[URING_SCAN_BATCH][URING_FILES];
+    char*   buffers;
+};
+
+static int uring_setup(unsigned entries, struct io_uring_params* params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    PROFILE_COUNT(PROFILE_SYSCALLS, 1);
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+/**
+ * @brief Queues a zeroed SQE tagged with a process slot and file index.
+ */
+static struct io_uring_sqe* uring_queue(UringScanner* u, int opcode, int slot, int file) {
+    unsigned             tail  = *u->sq_tail + u->pending;
+    unsigned             index = tail & *u->sq_mask;
+    struct io_uring_sqe* sqe   = &u->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode       = (unsigned char)opcode;
+    sqe->user_data    = ((unsigned long long)slot << 8) | (unsigned long long)file;
+    u->sq_array[index] = index;
+    u->pending++;
+    return sqe;
+}
+
+/**
+ * @brief Queues the deferred closes collected from the previous stage.
+ */
+static void uring_queue_closes(UringScanner* u) {
+    for (int i = 0; i < u->close_count; i++) {
+        struct io_uring_sqe* sqe = uring_queue(u, IORING_OP_CLOSE, 0, 0xff);
+        sqe->fd                  = u->closes[i];
+    }
+    u->close_count = 0;
+}
+
+/**
+ * @brief Submits all queued SQEs with one io_uring_enter() and stores each
+ *        completion result in the descriptor or length slot it was tagged with.
+ * @param reads Non-zero if file-tagged completions are read lengths rather than descriptors.
+ * @return 0 on success, -1 if the ring failed.
+ */
+static int uring_submit(UringScanner* u, int reads) {
+    unsigned to_submit = u->pending;
+    if (to_submit == 0) return 0;
+
+    __atomic_store_n(u->sq_tail, *u->sq_tail + to_submit, __ATOMIC_RELEASE);
+    u->pending = 0;
+
+    unsigned submitted = 0, completed = 0;
+    while (completed < to_submit) {
+        int ret = uring_enter(u->ring_fd, to_submit - submitted, to_submit - completed,
+                              IORING_ENTER_GETEVENTS);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        submitted += (unsigned)ret;
+
+        unsigned head = *u->cq_head;
+        unsigned tail = __atomic_load_n(u->cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            struct io_uring_cqe* cqe  = &u->cqes[head & *u->cq_mask];
+            int                  slot = (int)(cqe->user_data >> 8);
+            int                  file = (int)(cqe->user_data & 0xff);
+            completed++;
+            if (file == 0xff) continue;  // Deferred close
+            if (file == URING_DIR) {
+                if (!reads) u->fds[slot][URING_DIR] = cqe->res;
+            } else if (reads) {
+                u->lens[slot][file] = cqe->res;
+            } else {
+                u->fds[slot][file] = cqe->res;
+            }
+        }
+        __atomic_store_n(u->cq_head, head, __ATOMIC_RELEASE);
+    }
+    return 0;
+}
+
+/**
+ * @brief Closes every descriptor still held by a batch after a ring failure.
+ */
+static void uring_abandon_batch(UringScanner* u, int count) {
+    for (int i = 0; i < count; i++) {
+        for (int f = 0; f <= URING_FILES; f++) {
+            if (u->fds[i][f] >= 0) close(u->fds[i][f]);
+            u->fds[i][f] = -1;
+        }
+    }
+    for (int i = 0; i < u->close_count; i++) close(u->closes[i]);
+    u->close_count = 0;
+}
+
+UringScanner* uring_scan_create() {
+    UringScanner* u = calloc(1, sizeof(UringScanner));
+    if (!u) return NULL;
+    u->buffers = malloc((size_t)URING_SCAN_BATCH * URING_BUF_STRIDE);
+    if (!u->buffers) {
+        free(u);
+        return NULL;
+    }
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    u->ring_fd = uring_setup(URING_ENTRIES, &params);
+    if (u->ring_fd < 0) {
+        free(u->buffers);
+        free(u);
+        return NULL;
+    }
+
+    u->sq_ring_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    u->cq_ring_len = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (u->cq_ring_len > u->sq_ring_len) u->sq_ring_len = u->cq_ring_len;
+        u->cq_ring_len = 0;
+    }
+    u->sq_ring = mmap(NULL, u->sq_ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      u->ring_fd, IORING_OFF_SQ_RING);
+    u->cq_ring = u->sq_ring;
+    if (u->sq_ring != MAP_FAILED && u->cq_ring_len) {
+        u->cq_ring = mmap(NULL, u->cq_ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          u->ring_fd, IORING_OFF_CQ_RING);
+    }
+    u->sqes_len = params.sq_entries * sizeof(struct io_uring_sqe);
+    u->sqes     = mmap(NULL, u->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       u->ring_fd, IORING_OFF_SQES);
+    if (u->sq_ring == MAP_FAILED || u->cq_ring == MAP_FAILED || u->sqes == MAP_FAILED) {
+        if (u->sq_ring == MAP_FAILED) u->sq_ring = NULL;
+        if (u->cq_ring == MAP_FAILED) u->cq_ring = NULL;
+        if (u->sqes == MAP_FAILED) u->sqes = NULL;
+        uring_scan_destroy(u);
+        return NULL;
+    }
+
+    char* sq       = u->sq_ring;
+    char* cq       = u->cq_ring;
+    u->sq_head     = (unsigned*)(sq + params.sq_off.head);
+    u->sq_tail     = (unsigned*)(sq + params.sq_off.tail);
+    u->sq_mask     = (unsigned*)(sq + params.sq_off.ring_mask);
+    u->sq_array    = (unsigned*)(sq + params.sq_off.array);
+    u->cq_head     = (unsigned*)(cq + params.cq_off.head);
+    u->cq_tail     = (unsigned*)(cq + params.cq_off.tail);
+    u->cq_mask     = (unsigned*)(cq + params.cq_off.ring_mask);
+    u->cqes        = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    u->close_count = 0;
+
+    // The ring may exist while the opcodes we need do not (pre-5.6 kernels).
+    struct io_uring_sqe* sqe = uring_queue(u, IORING_OP_OPENAT, 0, URING_DIR);
+    sqe->fd                  = AT_FDCWD;
+    sqe->addr                = (unsigned long long)(uintptr_t) "/proc/self";
+    sqe->open_flags          = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+    u->fds[0][URING_DIR]     = -1;
+    if (uring_submit(u, 0) != 0 || u->fds[0][URING_DIR] < 0) {
+        uring_scan_destroy(u);
+        return NULL;
+    }
+    close(u->fds[0][URING_DIR]);
+    return u;
+}
+
+int uring_scan_parse(UringScanner* u, int root_fd, int files, const pid_t* pids,
+                     ProcessNode* out, int count) {
+    for (int base = 0; base < count; base += URING_SCAN_BATCH) {
+        int n = count - base;
+        if (n > URING_SCAN_BATCH) n = URING_SCAN_BATCH;
+
+        // Stage 1: open every /proc/[pid] directory (and close the previous batch's files).
+        uring_queue_closes(u);
+        for (int i = 0; i < n; i++) {
+            for (int f = 0; f <= URING_FILES; f++) u->fds[i][f] = -1;
+            proc_format_pid(pids[base + i], u->names[i]);
+            struct io_uring_sqe* sqe = uring_queue(u, IORING_OP_OPENAT, i, URING_DIR);
+            sqe->fd                  = root_fd;
+            sqe->addr                = (unsigned long long)(uintptr_t)u->names[i];
+            sqe->open_flags          = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+        }
+        if (uring_submit(u, 0) != 0) {
+            uring_abandon_batch(u, n);
+            return -1;
+        }
+
+        // Stage 2: open stat, and statm and status if wanted, relative to each directory.
+        for (int i = 0; i < n; i++) {
+            if (u->fds[i][URING_DIR] < 0) continue;
+            for (int f = 0; f < URING_FILES; f++) {
+                if (!uring_file_wanted(files, f)) continue;
+                struct io_uring_sqe* sqe = uring_queue(u, IORING_OP_OPENAT, i, f);
+                sqe->fd                  = u->fds[i][URING_DIR];
+                sqe->addr                = (unsigned long long)(uintptr_t)uring_file_names[f];
+                sqe->open_flags          = O_RDONLY | O_CLOEXEC;
+            }
+        }
+        if (uring_submit(u, 0) != 0) {
+            uring_abandon_batch(u, n);
+            return -1;
+        }
+
+        // Stage 3: read every opened file from offset 0 and close the directories.
+        for (int i = 0; i < n; i++) {
+            char* buf = u->buffers + (size_t)i * URING_BUF_STRIDE;
+            for (int f = 0; f < URING_FILES; f++) {
+                u->lens[i][f] = -1;
+                if (u->fds[i][f] < 0) continue;
+                struct io_uring_sqe* sqe = uring_queue(u, IORING_OP_READ, i, f);
+                char*                dest = buf + uring_file_offsets[f];
+                sqe->fd                   = u->fds[i][f];
+                sqe->addr                 = (unsigned long long)(uintptr_t)dest;
+                sqe->len                  = (unsigned)(uring_file_sizes[f] - 1);
+                sqe->off                  = 0;
+            }
+            if (u->fds[i][URING_DIR] >= 0) u->closes[u->close_count++] = u->fds[i][URING_DIR];
+            u->fds[i][URING_DIR] = -1;
+        }
+        uring_queue_closes(u);
+        if (uring_submit(u, 1) != 0) {
+            uring_abandon_batch(u, n);
+            return -1;
+        }
+
+        // Parse, and defer closing the files to the next submission.
+        for (int i = 0; i < n; i++) {
+            char*   buf = u->buffers + (size_t)i * URING_BUF_STRIDE;
+            char*   contents[URING_FILES];
+            ssize_t lens[URING_FILES];
+            for (int f = 0; f < URING_FILES; f++) {
+                contents[f] = uring_file_wanted(files, f) ? buf + uring_file_offsets[f] : NULL;
+                lens[f]     = u->lens[i][f] < 0 ? -1 : u->lens[i][f];
+                if (contents[f] && lens[f] >= 0) contents[f][lens[f]] = '\0';
+                if (u->fds[i][f] >= 0) u->closes[u->close_count++] = u->fds[i][f];
+                u->fds[i][f] = -1;
+            }
+            int result = proc_parse_files(pids[base + i], contents[0], lens[0], contents[1],
+                                          lens[1], contents[2], lens[2], &out[base + i]);
+            scan_finish_entry(&out[base + i], result);
+        }
+    }
+
+    uring_queue_closes(u);
+    return uring_submit(u, 0);
+}
+
+void uring_scan_destroy(UringScanner* u) {
+    if (!u) return;
+    if (u->sqes) munmap(u->sqes, u->sqes_len);
+    if (u->cq_ring && u->cq_ring != u->sq_ring) munmap(u->cq_ring, u->cq_ring_len);
+    if (u->sq_ring) munmap(u->sq_ring, u->sq_ring_len);
+    if (u->ring_fd >= 0) close(u->ring_fd);
+    free(u->buffers);
+    free(u);
+}
@@ -0,0 +1,411 @@
+/**
+ * @file user_cache.c
+ * @brief Implementation of the UID to username cache and its resolver thread.
+ * @version 2.0.1
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "../../include/system/user_cache.h"
+#include <errno.h>
+#include <pthread.h>
+#include <pwd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/** @brief Largest getpwuid_r() buffer tried before giving up on an entry. */
+#define USER_CACHE_MAX_BUFFER (1 << 20)
+
+/**
+ * @enum UserState
+ * @brief Progress of one cached UID.
+ */
+typedef enum UserState {
+    USER_EMPTY = 0, /**< Free slot */
+    USER_PENDING,   /**< Waiting for the resolver */
+    USER_RESOLVING, /**< Being resolved, with the lock released */
+    USER_RESOLVED   /**< Name is current */
+} UserState;
+
+/**
+ * @struct UserEntry
+ * @brief Slot of the open-addressing table, keyed by UID.
+ */
+typedef struct UserEntry {
+    uid_t     uid;
+    UserState state;
+    int       named;                     /**< Non-zero once resolved at least once */
+    char      name[USER_CACHE_NAME_LEN]; /**< Username, or the UID until resolved */
+} UserEntry;
+
+/**
+ * @brief The cache. Slots move when a lookup grows the table, so the resolver
+ *        finds its UID again after calling NSS with the lock released.
+ */
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;       /**< Signalled for new work and for shutdown */
+    pthread_cond_t  idle;       /**< Broadcast when nothing is pending any more */
+    UserEntry*      slots;      /**< Power-of-two table */
+    int             capacity;   /**< Allocated slots */
+    int             count;      /**< UIDs in the table */
+    int             pending;    /**< Entries USER_PENDING or USER_RESOLVING */
+    int             cursor;     /**< Where the resolver looks for work next */
+    unsigned int    generation; /**< Incremented when a name changes */
+    int             thread;     /**< 1 while the resolver runs, -1 if it cannot */
+    int             stopping;   /**< Set by user_cache_shutdown() */
+    pthread_t       resolver;
+    char            passwd[256]; /**< Watched file, empty for /etc/passwd */
+    int             check_ms;    /**< 0 for USER_CACHE_CHECK_MS */
+    int             refresh_ms;  /**< 0 for USER_CACHE_REFRESH_MS */
+    unsigned long   lookups;     /**< getpwuid_r() calls */
+    unsigned long   refreshes;   /**< Calls of user_cache_queue_all() */
+} cache = {.lock = PTHREAD_MUTEX_INITIALIZER,
+           .wake = PTHREAD_COND_INITIALIZER,
+           .idle = PTHREAD_COND_INITIALIZER};
+
+/**
+ * @brief Returns a monotonic timestamp in milliseconds.
+ */
+static long long user_cache_now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Returns the CLOCK_REALTIME deadline @p ms from now, for
+ *        pthread_cond_timedwait().
+ */
+static struct timespec user_cache_deadline(long long ms) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += ms / 1000;
+    ts.tv_nsec += (ms % 1000) * 1000000;
+    if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+    return ts;
+}
+
+/**
+ * @brief Returns the slot of @p uid, or the empty slot where it belongs.
+ *        The table must have at least one empty slot.
+ */
+static UserEntry* user_cache_slot(UserEntry* slots, int capacity, uid_t uid) {
+    unsigned int mask = (unsigned int)capacity - 1;
+    unsigned int i    = ((unsigned int)uid * 2654435761u) & mask;
+    while (slots[i].state != USER_EMPTY && slots[i].uid != uid) i = (i + 1) & mask;
+    return &slots[i];
+}
+
+/**
+ * @brief Returns the entry of @p uid, or NULL if it is not cached.
+ */
+static UserEntry* user_cache_find(uid_t uid) {
+    if (cache.capacity == 0) return NULL;
+    UserEntry* entry = user_cache_slot(cache.slots, cache.capacity, uid);
+    return entry->state == USER_EMPTY ? NULL : entry;
+}
+
+/**
+ * @brief Doubles the table, keeping it at most half full.
+ * @return int 0 on success, -1 if out of memory.
+ */
+static int user_cache_grow() {
+    int        capacity = cache.capacity ? cache.capacity * 2 : 64;
+    UserEntry* slots    = calloc((size_t)capacity, sizeof(UserEntry));
+    if (!slots) return -1;
+    for (int i = 0; i < cache.capacity; i++) {
+        if (cache.slots[i].state != USER_EMPTY) {
+            *user_cache_slot(slots, capacity, cache.slots[i].uid) = cache.slots[i];
+        }
+    }
+    free(cache.slots);
+    cache.slots    = slots;
+    cache.capacity = capacity;
+    cache.cursor   = 0;
+    return 0;
+}
+
+/**
+ * @brief Resolves @p uid through NSS into @p name, or writes the number if the
+ *        UID has no entry. May block for as long as the directory server takes.
+ */
+static void user_cache_resolve(uid_t uid, char* name) {
+    struct passwd  pw;
+    struct passwd* result = NULL;
+    long           hint   = sysconf(_SC_GETPW_R_SIZE_MAX);
+    size_t         size   = hint > 0 ? (size_t)hint : 1024;
+    char*          buffer = malloc(size);
+
+    while (buffer && getpwuid_r(uid, &pw, buffer, size, &result) == ERANGE &&
+           size < USER_CACHE_MAX_BUFFER) {
+        size *= 2;
+        char* larger = realloc(buffer, size);
+        if (!larger) break;
+        buffer = larger;
+    }
+    if (buffer && result) {
+        strncpy(name, pw.pw_name, USER_CACHE_NAME_LEN - 1);
+        name[USER_CACHE_NAME_LEN - 1] = '\0';
+    } else {
+        snprintf(name, USER_CACHE_NAME_LEN, "%u", uid);
+    }
+    free(buffer);
+}
+
+/**
+ * @brief Stores a resolved name in the entry of @p uid, if it is still cached.
+ *        Called with the lock held.
+ */
+static void user_cache_store(uid_t uid, const char* name) {
+    UserEntry* entry = user_cache_find(uid);
+    cache.lookups++;
+    if (!entry) return;
+    if (strcmp(entry->name, name) != 0) {
+        memcpy(entry->name, name, USER_CACHE_NAME_LEN);
+        __atomic_add_fetch(&cache.generation, 1, __ATOMIC_RELEASE);
+    }
+    entry->named = 1;
+    // An entry queued again while it was resolved stays pending for another round.
+    if (entry->state == USER_RESOLVING) {
+        entry->state = USER_RESOLVED;
+        if (--cache.pending == 0) pthread_cond_broadcast(&cache.idle);
+    }
+}
+
+/**
+ * @brief Marks every resolved entry as pending. Called with the lock held.
+ */
+static void user_cache_queue_all() {
+    for (int i = 0; i < cache.capacity; i++) {
+        UserEntry* entry = &cache.slots[i];
+        if (entry->state == USER_RESOLVED) {
+            cache.pending++;
+            entry->state = USER_PENDING;
+        } else if (entry->state == USER_RESOLVING) {
+            entry->state = USER_PENDING;  // Already counted
+        }
+    }
+    cache.refreshes++;
+    cache.cursor = 0;
+}
+
+/**
+ * @brief Returns the next pending entry after the cursor, or NULL.
+ *        Called with the lock held.
+ */
+static UserEntry* user_cache_next_pending() {
+    if (cache.pending == 0) return NULL;
+    for (int n = 0; n < cache.capacity; n++) {
+        int i = (cache.cursor + n) & (cache.capacity - 1);
+        if (cache.slots[i].state == USER_PENDING) {
+            cache.cursor = i + 1;
+            return &cache.slots[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Identity of the passwd file, compared at every check.
+ */
+typedef struct PasswdStamp {
+    int             exists;
+    dev_t           dev;
+    ino_t           ino;
+    off_t           size;
+    struct timespec mtime;
+} PasswdStamp;
+
+/**
+ * @brief Takes the stamp of the watched file. Called with the lock held.
+ */
+static PasswdStamp user_cache_stamp() {
+    PasswdStamp stamp;
+    struct stat st;
+    memset(&stamp, 0, sizeof(stamp));
+    if (stat(cache.passwd[0] ? cache.passwd : "/etc/passwd", &st) == 0) {
+        stamp.exists = 1;
+        stamp.dev    = st.st_dev;
+        stamp.ino    = st.st_ino;
+        stamp.size   = st.st_size;
+        stamp.mtime  = st.st_mtim;
+    }
+    return stamp;
+}
+
+/**
+ * @brief Returns non-zero if two stamps describe different files or contents.
+ */
+static int user_cache_stamp_differs(const PasswdStamp* a, const PasswdStamp* b) {
+    return a->exists != b->exists || a->dev != b->dev || a->ino != b->ino ||
+           a->size != b->size || a->mtime.tv_sec != b->mtime.tv_sec ||
+           a->mtime.tv_nsec != b->mtime.tv_nsec;
+}
+
+/**
+ * @brief Resolver thread: resolves pending UIDs one at a time with the lock
+ *        released, and otherwise sleeps until the next check of the passwd file.
+ *
+ * A replaced passwd file (useradd and vipw write a new one and rename it) or
+ * an edited one queues every UID again, as does the slow refresh timer, which
+ * catches changes NSS makes without touching the file, such as in a directory.
+ */
+static void* user_cache_thread(void* arg) {
+    (void)arg;
+    pthread_setname_np(pthread_self(), "procx-users");
+    pthread_mutex_lock(&cache.lock);
+    PasswdStamp stamp        = user_cache_stamp();
+    long long   refreshed_ms = user_cache_now_ms();
+    long long   next_check   = refreshed_ms;
+
+    while (!cache.stopping) {
+        int       check_ms   = cache.check_ms > 0 ? cache.check_ms : USER_CACHE_CHECK_MS;
+        int       refresh_ms = cache.refresh_ms > 0 ? cache.refresh_ms : USER_CACHE_REFRESH_MS;
+        long long now        = user_cache_now_ms();
+        if (now >= next_check) {
+            PasswdStamp current = user_cache_stamp();
+            if (user_cache_stamp_differs(&current, &stamp) || now - refreshed_ms >= refresh_ms) {
+                user_cache_queue_all();
+                refreshed_ms = now;
+            }
+            stamp      = current;
+            next_check = now + check_ms;
+        }
+
+        UserEntry* entry = user_cache_next_pending();
+        if (!entry) {
+            struct timespec deadline = user_cache_deadline(next_check - now);
+            pthread_cond_timedwait(&cache.wake, &cache.lock, &deadline);
+            continue;
+        }
+
+        uid_t uid    = entry->uid;
+        entry->state = USER_RESOLVING;
+        pthread_mutex_unlock(&cache.lock);
+        char name[USER_CACHE_NAME_LEN];
+        user_cache_resolve(uid, name);
+        pthread_mutex_lock(&cache.lock);
+        user_cache_store(uid, name);
+    }
+    pthread_mutex_unlock(&cache.lock);
+    return NULL;
+}
+
+int user_cache_lookup(uid_t uid, char* out, size_t size) {
+    pthread_mutex_lock(&cache.lock);
+    UserEntry* entry = user_cache_find(uid);
+    if (!entry && (cache.count + 1) * 2 > cache.capacity && user_cache_grow() != 0) {
+        pthread_mutex_unlock(&cache.lock);
+        snprintf(out, size, "%u", uid);
+        return 0;
+    }
+    if (!entry) entry = user_cache_slot(cache.slots, cache.capacity, uid);
+
+    if (entry->state == USER_EMPTY) {
+        // First sight: hand out the number now and let the resolver find the name.
+        entry->uid   = uid;
+        entry->state = USER_PENDING;
+        entry->named = 0;
+        snprintf(entry->name, sizeof(entry->name), "%u", uid);
+        cache.count++;
+        cache.pending++;
+        if (cache.thread == 0) {
+            cache.stopping = 0;
+            cache.thread = pthread_create(&cache.resolver, NULL, user_cache_thread, NULL) == 0
+                               ? 1
+                               : -1;
+        }
+        if (cache.thread > 0) {
+            pthread_cond_signal(&cache.wake);
+        } else {
+            // Without a thread the lookup is made here, as it was before the cache.
+            entry->state = USER_RESOLVING;
+            char name[USER_CACHE_NAME_LEN];
+            pthread_mutex_unlock(&cache.lock);
+            user_cache_resolve(uid, name);
+            pthread_mutex_lock(&cache.lock);
+            user_cache_store(uid, name);
+            entry = user_cache_find(uid);
+        }
+    }
+
+    snprintf(out, size, "%s", entry->name);
+    int named = entry->named;
+    pthread_mutex_unlock(&cache.lock);
+    return named;
+}
+
+unsigned int user_cache_generation() {
+    return __atomic_load_n(&cache.generation, __ATOMIC_ACQUIRE);
+}
+
+void user_cache_invalidate() {
+    pthread_mutex_lock(&cache.lock);
+    user_cache_queue_all();
+    if (cache.thread > 0) pthread_cond_signal(&cache.wake);
+    pthread_mutex_unlock(&cache.lock);
+}
+
+int user_cache_wait(int timeout_ms) {
+    struct timespec deadline = user_cache_deadline(timeout_ms);
+    int             result   = 0;
+    pthread_mutex_lock(&cache.lock);
+    while (cache.pending > 0 && result == 0) {
+        if (cache.thread <= 0) break;  // Nothing would ever resolve them
+        result = pthread_cond_timedwait(&cache.idle, &cache.lock, &deadline);
+    }
+    int pending = cache.pending;
+    pthread_mutex_unlock(&cache.lock);
+    return pending == 0 ? 0 : -1;
+}
+
+void user_cache_configure(const char* passwd_path, int check_ms, int refresh_ms) {
+    pthread_mutex_lock(&cache.lock);
+    snprintf(cache.passwd, sizeof(cache.passwd), "%s", passwd_path ? passwd_path : "");
+    cache.check_ms   = check_ms;
+    cache.refresh_ms = refresh_ms;
+    if (cache.thread > 0) pthread_cond_signal(&cache.wake);
+    pthread_mutex_unlock(&cache.lock);
+}
+
+void user_cache_stats(UserCacheStats* stats) {
+    pthread_mutex_lock(&cache.lock);
+    stats->users     = cache.count;
+    stats->pending   = cache.pending;
+    stats->lookups   = cache.lookups;
+    stats->refreshes = cache.refreshes;
+    pthread_mutex_unlock(&cache.lock);
+}
+
+void user_cache_shutdown() {
+    pthread_mutex_lock(&cache.lock);
+    int running    = cache.thread > 0;
+    cache.stopping = 1;
+    pthread_cond_signal(&cache.wake);
+    pthread_mutex_unlock(&cache.lock);
+    if (running) pthread_join(cache.resolver, NULL);
+
+    pthread_mutex_lock(&cache.lock);
+    free(cache.slots);
+    cache.slots     = NULL;
+    cache.capacity  = 0;
+    cache.count     = 0;
+    cache.pending   = 0;
+    cache.cursor    = 0;
+    cache.thread    = 0;
+    cache.passwd[0] = '\0';
+    cache.check_ms = cache.refresh_ms = 0;
+    cache.lookups = cache.refreshes = 0;
+    pthread_cond_broadcast(&cache.idle);
+    pthread_mutex_unlock(&cache.lock);
+}
@@ -0,0 +1,469 @@
+/**
+ * @file batch.c
+ * @brief Implementation of the headless JSON Lines / CSV output.
+ * @version 2.0.1
+ */
+
+#include "../../include/ui/batch.h"
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @brief Room reserved before appending a numeric value or a separator.
+ */
+#define BATCH_NUMBER_SIZE 32
+
+/** @brief Field names, indexed by BatchField; used for parsing, JSON keys, and the CSV header. */
+static const char* const batch_field_names[BATCH_FIELD_COUNT] = {
+    "time", "pid",  "ppid", "uid",  "user",  "state",    "pri", "nice", "threads",
+    "cpu",  "mem",  "name", "read", "write", "syscalls", "vsz", "anon", "file",
+    "shmem", "swap", "pss", "uss",
+};
+
+/** @brief Per-process files each field is read from, indexed by BatchField; see batch_files(). */
+static const int batch_field_files[BATCH_FIELD_COUNT] = {
+    [BATCH_FIELD_TIME]     = 0,
+    [BATCH_FIELD_PID]      = PROC_FILE_STAT,
+    [BATCH_FIELD_PPID]     = PROC_FILE_STAT,
+    [BATCH_FIELD_UID]      = PROC_FILE_STATUS,
+    [BATCH_FIELD_USER]     = PROC_FILE_STATUS,
+    [BATCH_FIELD_STATE]    = PROC_FILE_STAT,
+    [BATCH_FIELD_PRI]      = PROC_FILE_STAT,
+    [BATCH_FIELD_NICE]     = PROC_FILE_STAT,
+    [BATCH_FIELD_THREADS]  = PROC_FILE_STATUS,
+    [BATCH_FIELD_CPU]      = PROC_FILE_STAT,
+    [BATCH_FIELD_MEM]      = PROC_FILE_STATM,
+    [BATCH_FIELD_NAME]     = PROC_FILE_STAT,
+    [BATCH_FIELD_READ]     = PROC_FILE_IO,
+    [BATCH_FIELD_WRITE]    = PROC_FILE_IO,
+    [BATCH_FIELD_SYSCALLS] = PROC_FILE_IO,
+    [BATCH_FIELD_VSZ]      = PROC_FILE_STATM,
+    [BATCH_FIELD_ANON]     = PROC_FILE_STATUS,
+    [BATCH_FIELD_FILE]     = PROC_FILE_STATUS,
+    [BATCH_FIELD_SHMEM]    = PROC_FILE_STATUS,
+    [BATCH_FIELD_SWAP]     = PROC_FILE_STATUS,
+    [BATCH_FIELD_PSS]      = PROC_FILE_ROLLUP,
+    [BATCH_FIELD_USS]      = PROC_FILE_ROLLUP,
+};
+
+void batch_options_init(BatchOptions* options) {
+    static const BatchField defaults[] = {BATCH_FIELD_TIME, BATCH_FIELD_PID,     BATCH_FIELD_USER,
+                                          BATCH_FIELD_STATE, BATCH_FIELD_CPU,   BATCH_FIELD_MEM,
+                                          BATCH_FIELD_THREADS, BATCH_FIELD_NAME};
+    memset(options, 0, sizeof(*options));
+    options->format      = BATCH_FORMAT_JSON;
+    options->profile_fd  = -1;
+    options->field_count = sizeof(defaults) / sizeof(defaults[0]);
+    memcpy(options->fields, defaults, sizeof(defaults));
+}
+
+int batch_parse_fields(BatchOptions* options, const char* list, char* error, size_t error_size) {
+    BatchField  fields[BATCH_MAX_FIELDS];
+    int         count = 0;
+    const char* p     = list;
+    while (*p) {
+        const char* end   = strchr(p, ',');
+        size_t      len   = end ? (size_t)(end - p) : strlen(p);
+        int         found = -1;
+        for (int f = 0; f < BATCH_FIELD_COUNT; f++) {
+            if (strlen(batch_field_names[f]) == len && strncmp(p, batch_field_names[f], len) == 0) {
+                found = f;
+                break;
+            }
+        }
+        if (found < 0) {
+            snprintf(error, error_size, "unknown field '%.*s'", (int)len, p);
+            return -1;
+        }
+        if (count == BATCH_MAX_FIELDS) {
+            snprintf(error, error_size, "more than %d fields", BATCH_MAX_FIELDS);
+            return -1;
+        }
+        fields[count++] = (BatchField)found;
+        p += len;
+        if (*p == ',') p++;
+    }
+    if (count == 0) {
+        snprintf(error, error_size, "empty field list");
+        return -1;
+    }
+    memcpy(options->fields, fields, sizeof(BatchField) * count);
+    options->field_count = count;
+    return 0;
+}
+
+int batch_files(const BatchOptions* options) {
+    int files = snapshot_sort_files(options->sort);
+    for (int i = 0; i < options->field_count; i++) files |= batch_field_files[options->fields[i]];
+    return files;
+}
+
+int batch_writer_init(BatchWriter* writer, int fd) {
+    writer->fd     = fd;
+    writer->length = 0;
+    writer->error  = 0;
+    writer->buffer = malloc(BATCH_BUFFER_SIZE);
+    return writer->buffer ? 0 : -1;
+}
+
+int batch_writer_flush(BatchWriter* writer) {
+    size_t done = 0;
+    while (done < writer->length && !writer->error) {
+        ssize_t n = write(writer->fd, writer->buffer + done, writer->length - done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            writer->error = errno;
+            break;
+        }
+        done += (size_t)n;
+    }
+    writer->length = 0;
+    return writer->error ? -1 : 0;
+}
+
+void batch_writer_free(BatchWriter* writer) {
+    free(writer->buffer);
+    writer->buffer = NULL;
+}
+
+/**
+ * @brief Makes room for @p size more bytes, flushing if the buffer is full.
+ */
+static inline void out_reserve(BatchWriter* writer, size_t size) {
+    if (writer->length + size > BATCH_BUFFER_SIZE) batch_writer_flush(writer);
+}
+
+/**
+ * @brief Appends one byte; the caller has reserved room for it.
+ */
+static inline void out_char(BatchWriter* writer, char c) { writer->buffer[writer->length++] = c; }
+
+/**
+ * @brief Appends a literal; the caller has reserved room for it.
+ */
+static inline void out_literal(BatchWriter* writer, const char* text) {
+    size_t len = strlen(text);
+    memcpy(writer->buffer + writer->length, text, len);
+    writer->length += len;
+}
+
+/**
+ * @brief Appends a signed decimal; the caller has reserved BATCH_NUMBER_SIZE bytes.
+ */
+static void out_long(BatchWriter* writer, long long value) {
+    char               digits[24];
+    int                n = 0;
+    unsigned long long v = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    if (value < 0) out_char(writer, '-');
+    while (n) out_char(writer, digits[--n]);
+}
+
+/**
+ * @brief Appends a non-negative value scaled by 10^decimals as a fixed-point
+ *        decimal, e.g. 1234 with 2 decimals as "12.34".
+ */
+static void out_fixed(BatchWriter* writer, long long scaled, int decimals) {
+    long long unit = 1;
+    for (int i = 0; i < decimals; i++) unit *= 10;
+    out_long(writer, scaled / unit);
+    out_char(writer, '.');
+    long long frac = scaled % unit;
+    for (long long d = unit / 10; d > 0; d /= 10) {
+        out_char(writer, (char)('0' + frac / d));
+        frac %= d;
+    }
+}
+
+/**
+ * @brief Appends a JSON string literal with the required escapes.
+ */
+static void out_json_string(BatchWriter* writer, const char* text) {
+    static const char hex[] = "0123456789abcdef";
+    // Worst case: every byte becomes a six-byte \u00XX escape.
+    out_reserve(writer, strlen(text) * 6 + 2);
+    out_char(writer, '"');
+    for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            out_char(writer, '\\');
+            out_char(writer, (char)*p);
+        } else if (*p < 0x20) {
+            out_literal(writer, "\\u00");
+            out_char(writer, hex[*p >> 4]);
+            out_char(writer, hex[*p & 0xf]);
+        } else {
+            out_char(writer, (char)*p);
+        }
+    }
+    out_char(writer, '"');
+}
+
+/**
+ * @brief Appends a CSV value, quoted only if it contains a separator, quote,
+ *        or line break.
+ */
+static void out_csv_string(BatchWriter* writer, const char* text) {
+    size_t len = strlen(text);
+    out_reserve(writer, len * 2 + 2);
+    if (strpbrk(text, ",\"\r\n") == NULL) {
+        memcpy(writer->buffer + writer->length, text, len);
+        writer->length += len;
+        return;
+    }
+    out_char(writer, '"');
+    for (const char* p = text; *p; p++) {
+        if (*p == '"') out_char(writer, '"');
+        out_char(writer, *p);
+    }
+    out_char(writer, '"');
+}
+
+void batch_emit_header(BatchWriter* writer, const BatchOptions* options) {
+    if (options->format != BATCH_FORMAT_CSV) return;
+    for (int i = 0; i < options->field_count; i++) {
+        out_reserve(writer, BATCH_NUMBER_SIZE);
+        if (i > 0) out_char(writer, ',');
+        out_literal(writer, batch_field_names[options->fields[i]]);
+    }
+    out_reserve(writer, 1);
+    out_char(writer, '\n');
+}
+
+/**
+ * @brief Appends the value of one field.
+ */
+static void out_field(BatchWriter* writer, const BatchOptions* options, BatchField field,
+                      const ProcessNode* proc, long long time_ms) {
+    int json = options->format == BATCH_FORMAT_JSON;
+    switch (field) {
+        case BATCH_FIELD_USER:
+            if (json) {
+                out_json_string(writer, proc->username);
+            } else {
+                out_csv_string(writer, proc->username);
+            }
+            return;
+        case BATCH_FIELD_NAME:
+            if (json) {
+                out_json_string(writer, proc->name);
+            } else {
+                out_csv_string(writer, proc->name);
+            }
+            return;
+        default:
+            break;
+    }
+
+    out_reserve(writer, BATCH_NUMBER_SIZE);
+    switch (field) {
+        case BATCH_FIELD_TIME:
+            out_fixed(writer, time_ms, 3);
+            break;
+        case BATCH_FIELD_PID:
+            out_long(writer, proc->pid);
+            break;
+        case BATCH_FIELD_PPID:
+            out_long(writer, proc->ppid);
+            break;
+        case BATCH_FIELD_UID:
+            out_long(writer, proc->uid);
+            break;
+        case BATCH_FIELD_STATE:
+            if (json) out_char(writer, '"');
+            out_char(writer, proc->state ? proc->state : '?');
+            if (json) out_char(writer, '"');
+            break;
+        case BATCH_FIELD_PRI:
+            out_long(writer, proc->priority);
+            break;
+        case BATCH_FIELD_NICE:
+            out_long(writer, proc->nice_value);
+            break;
+        case BATCH_FIELD_THREADS:
+            out_long(writer, proc->num_threads);
+            break;
+        case BATCH_FIELD_CPU: {
+            float cpu = proc->cpu_usage > 0.0f ? proc->cpu_usage : 0.0f;
+            out_fixed(writer, (long long)(cpu * 100.0f + 0.5f), 2);
+            break;
+        }
+        case BATCH_FIELD_MEM:
+            out_long(writer, proc->memory_kb);
+            break;
+        case BATCH_FIELD_READ:
+            out_long(writer, proc->io_read < 0.0f ? -1 : (long long)(proc->io_read + 0.5f));
+            break;
+        case BATCH_FIELD_WRITE:
+            out_long(writer, proc->io_write < 0.0f ? -1 : (long long)(proc->io_write + 0.5f));
+            break;
+        case BATCH_FIELD_SYSCALLS:
+            out_long(writer, proc->io_syscalls < 0.0f ? -1 : (long long)(proc->io_syscalls + 0.5f));
+            break;
+        case BATCH_FIELD_VSZ:
+            out_long(writer, proc->vsz_kb);
+            break;
+        case BATCH_FIELD_ANON:
+            out_long(writer, proc->anon_kb);
+            break;
+        case BATCH_FIELD_FILE:
+            out_long(writer, proc->file_kb);
+            break;
+        case BATCH_FIELD_SHMEM:
+            out_long(writer, proc->shmem_kb);
+            break;
+        case BATCH_FIELD_SWAP:
+            out_long(writer, proc->swap_kb);
+            break;
+        case BATCH_FIELD_PSS:
+            out_long(writer, proc->pss_kb);
+            break;
+        case BATCH_FIELD_USS:
+            out_long(writer, proc->uss_kb);
+            break;
+        default:
+            break;
+    }
+}
+
+void batch_emit_sample(BatchWriter* writer, const BatchOptions* options,
+                       const ProcessSnapshot* snapshot, int limit, long long time_ms) {
+    int json = options->format == BATCH_FORMAT_JSON;
+    for (int pos = 0; pos < limit; pos++) {
+        const ProcessNode* proc = snapshot_at(snapshot, pos);
+        if (json) {
+            out_reserve(writer, 1);
+            out_char(writer, '{');
+        }
+        for (int i = 0; i < options->field_count; i++) {
+            BatchField field = options->fields[i];
+            out_reserve(writer, BATCH_NUMBER_SIZE);
+            if (i > 0) out_char(writer, ',');
+            if (json) {
+                out_char(writer, '"');
+                out_literal(writer, batch_field_names[field]);
+                out_literal(writer, "\":");
+            }
+            out_field(writer, options, field, proc, time_ms);
+        }
+        out_reserve(writer, 2);
+        if (json) out_char(writer, '}');
+        out_char(writer, '\n');
+    }
+}
+
+/**
+ * @brief Appends a literal key and a signed value; the caller has reserved room.
+ */
+static void out_profile_value(BatchWriter* writer, const char* key, long long value) {
+    out_literal(writer, key);
+    out_long(writer, value);
+}
+
+void batch_emit_profile(BatchWriter* writer, const Profiler* profiler, long long time_ms) {
+    out_reserve(writer, BATCH_NUMBER_SIZE);
+    out_literal(writer, "{\"time\":");
+    out_fixed(writer, time_ms, 3);
+    for (int phase = 0; phase < PROFILE_PHASES; phase++) {
+        ProfileStats stats = {-1, -1, -1, 0};
+        profiler_stats(profiler, (ProfilePhase)phase, &stats);
+        out_reserve(writer, 4 * BATCH_NUMBER_SIZE);
+        out_literal(writer, ",\"");
+        out_literal(writer, profile_phase_names[phase]);
+        out_profile_value(writer, "\":{\"last_ns\":", stats.last_ns);
+        out_profile_value(writer, ",\"p50_ns\":", stats.p50_ns);
+        out_profile_value(writer, ",\"p99_ns\":", stats.p99_ns);
+        out_char(writer, '}');
+    }
+    for (int i = 0; i < PROFILE_COUNTERS; i++) {
+        out_reserve(writer, 2 * BATCH_NUMBER_SIZE);
+        out_literal(writer, ",\"");
+        out_literal(writer, profile_counter_names[i]);
+        out_literal(writer, "\":");
+        out_long(writer, (long long)profiler->per_sample[i]);
+    }
+    out_reserve(writer, 3 * BATCH_NUMBER_SIZE);
+    out_literal(writer, ",\"cpu\":");
+    out_fixed(writer, (long long)(profiler->cpu_usage * 100.0f + 0.5f), 2);
+    out_profile_value(writer, ",\"rss\":", profiler->rss_kb);
+    out_literal(writer, "}\n");
+}
+
+int batch_run(Sampler* sampler, const BatchOptions* options) {
+    BatchWriter writer;
+    if (batch_writer_init(&writer, STDOUT_FILENO) != 0) return 1;
+    batch_emit_header(&writer, options);
+
+    // Profile records go to their own descriptor, one per emitted sample.
+    BatchWriter profile;
+    Profiler    profiler;
+    int         profiling = options->profile_fd >= 0;
+    if (profiling && batch_writer_init(&profile, options->profile_fd) != 0) {
+        batch_writer_free(&writer);
+        return 1;
+    }
+    if (profiling) {
+        profiler_init(&profiler);
+        profile_set_enabled(1);
+    }
+
+    struct pollfd wait_fd = {sampler_fd(sampler), POLLIN, 0};
+    long          emitted = 0;
+    while (options->count == 0 || emitted < options->count) {
+        if (!sampler_take(sampler)) {
+            poll(&wait_fd, 1, -1);
+            continue;
+        }
+        Sample* sample = sampler->front;
+        if (profiling) profiler_add_pass(&profiler, &sample->profile);
+        // CPU usage needs two samples; the first one only sets the baseline.
+        if (sample->sequence == 1) continue;
+
+        if (options->format != BATCH_FORMAT_NONE) {
+            ProcessSnapshot* snapshot = &sample->snapshot;
+            PROFILE_BEGIN(filter_start);
+            snapshot_filter(snapshot, NULL);
+            PROFILE_ADD(&profiler, PROFILE_FILTER, filter_start);
+            int limit = snapshot->matched;
+            if (options->top > 0 && options->top < limit) limit = options->top;
+            PROFILE_BEGIN(sort_start);
+            if (options->sort && limit == snapshot->matched) {
+                snapshot_sort(snapshot, options->sort);
+            } else if (options->sort) {
+                snapshot_sort_top(snapshot, options->sort, limit);
+            }
+            PROFILE_ADD(&profiler, PROFILE_SORT, sort_start);
+
+            PROFILE_BEGIN(emit_start);
+            batch_emit_sample(&writer, options, snapshot, limit, sample->time_ms);
+            if (batch_writer_flush(&writer) != 0) break;
+            PROFILE_ADD(&profiler, PROFILE_RENDER, emit_start);
+        }
+        if (profiling) {
+            batch_emit_profile(&profile, &profiler, sample->time_ms);
+            if (batch_writer_flush(&profile) != 0) break;
+        }
+        emitted++;
+    }
+
+    int failed = writer.error != 0 || (profiling && profile.error != 0);
+    if (writer.error && writer.error != EPIPE) {
+        fprintf(stderr, "procx: write error: %s\n", strerror(writer.error));
+    }
+    if (profiling) {
+        if (profile.error) {
+            fprintf(stderr, "procx: profile write error: %s\n", strerror(profile.error));
+        }
+        profile_set_enabled(0);
+        profiler_free(&profiler);
+        batch_writer_free(&profile);
+    }
+    batch_writer_free(&writer);
+    return failed;
+}
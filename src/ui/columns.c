@@ -0,0 +1,299 @@
+/**
+ * @file columns.c
+ * @brief Implements the column registry of the process list.
+ * @version 2.0.1
+ */
+
+#include "../../include/ui/columns.h"
+#include "../../include/system/proc_parser.h"
+#include <stdio.h>
+#include <string.h>
+
+/** @brief F3: highest CPU first, then largest resident set, then PID. */
+static const SortSpec sort_by_cpu = {
+    {{SORT_FIELD_CPU, 1}, {SORT_FIELD_MEM, 1}, {SORT_FIELD_PID, 0}}, 3};
+/** @brief F4: largest resident set first, then highest CPU, then PID. */
+static const SortSpec sort_by_mem = {
+    {{SORT_FIELD_MEM, 1}, {SORT_FIELD_CPU, 1}, {SORT_FIELD_PID, 0}}, 3};
+/** @brief F5: command name, then PID. */
+static const SortSpec sort_by_name = {{{SORT_FIELD_NAME, 0}, {SORT_FIELD_PID, 0}}, 2};
+/** @brief F6: PID. */
+static const SortSpec sort_by_pid = {{{SORT_FIELD_PID, 0}}, 1};
+/** @brief F11: most bytes read and written first, then highest CPU, then PID. */
+static const SortSpec sort_by_io = {
+    {{SORT_FIELD_IO, 1}, {SORT_FIELD_CPU, 1}, {SORT_FIELD_PID, 0}}, 3};
+/** @brief F12: largest proportional set first, then largest resident set, then PID. */
+static const SortSpec sort_by_pss = {
+    {{SORT_FIELD_PSS, 1}, {SORT_FIELD_MEM, 1}, {SORT_FIELD_PID, 0}}, 3};
+
+void column_format_rate(char* out, size_t size, float per_second, int bytes) {
+    static const char* units[] = {"B", "K", "M", "G", "T"};
+    int                unit    = 0;
+    if (per_second < 0.0f) {
+        snprintf(out, size, "-");
+        return;
+    }
+    if (!bytes) {
+        snprintf(out, size, "%.0f", per_second);
+        return;
+    }
+    while (per_second >= 1024.0f && unit < 4) {
+        per_second /= 1024.0f;
+        unit++;
+    }
+    snprintf(out, size, unit ? "%.1f%s" : "%.0f%s", per_second, units[unit]);
+}
+
+void column_format_size(char* out, size_t size, long kb) {
+    if (kb < 0) {
+        snprintf(out, size, "-");
+    } else {
+        snprintf(out, size, "%.1f", (float)kb / 1024.0f);
+    }
+}
+
+static int format_pid(char* out, size_t size, const ProcessNode* proc) {
+    snprintf(out, size, "%d", proc->pid);
+    return COLUMN_COLOR_CYAN;
+}
+
+static int format_user(char* out, size_t size, const ProcessNode* proc) {
+    snprintf(out, size, "%s", proc->username);
+    return COLUMN_COLOR_DEFAULT;
+}
+
+static int format_pri(char* out, size_t size, const ProcessNode* proc) {
+    snprintf(out, size, "%ld", proc->priority);
+    return COLUMN_COLOR_DEFAULT;
+}
+
+static int format_nice(char* out, size_t size, const ProcessNode* proc) {
+    snprintf(out, size, "%ld", proc->nice_value);
+    return COLUMN_COLOR_DEFAULT;
+}
+
+/** @brief VIRT is in whole MB. */
+static int format_vsz(char* out, size_t size, const ProcessNode* proc) {
+    if (proc->vsz_kb < 0) {
+        snprintf(out, size, "-");
+    } else {
+        snprintf(out, size, "%ld", proc->vsz_kb / 1024);
+    }
+    return COLUMN_COLOR_DEFAULT;
+}
+
+static int format_mem(char* out, size_t size, const ProcessNode* proc) {
+    snprintf(out, size, "%.1f", (float)proc->memory_kb / 1024.0f);
+    return COLUMN_COLOR_DEFAULT;
+}
+
+/** @brief The count is 0 when /proc/[pid]/status was not read. */
+static int format_threads(char* out, size_t size, const ProcessNode* proc) {
+    if (proc->num_threads > 0) {
+        snprintf(out, size, "%d", proc->num_threads);
+    } else {
+        snprintf(out, size, "-");
+    }
+    return COLUMN_COLOR_DEFAULT;
+}
+
+static int format_read(char* out, size_t size, const ProcessNode* proc) {
+    column_format_rate(out, size, proc->io_read, 1);
+    return COLUMN_COLOR_DEFAULT;
+}
+
+static int format_write(char* out, size_t size, const ProcessNode* proc) {
+    column_format_rate(out, size, proc->io_write, 1);
+    return COLUMN_COLOR_DEFAULT;
+}
+
+static int format_syscalls(char* out, size_t size, const ProcessNode* proc) {
+    column_format_rate(out, size, proc->io_syscalls, 0);
+    return COLUMN_COLOR_DEFAULT;
+}
+
+static int format_pss(char* out, size_t size, const ProcessNode* proc) {
+    column_format_size(out, size, proc->pss_kb);
+    return COLUMN_COLOR_DEFAULT;
+}
+
+static int format_uss(char* out, size_t size, const ProcessNode* proc) {
+    column_format_size(out, size, proc->uss_kb);
+    return COLUMN_COLOR_DEFAULT;
+}
+
+static int format_swap(char* out, size_t size, const ProcessNode* proc) {
+    column_format_size(out, size, proc->swap_kb);
+    return COLUMN_COLOR_DEFAULT;
+}
+
+static int format_state(char* out, size_t size, const ProcessNode* proc) {
+    const char* text  = "UNKNOWN";
+    int         color = COLUMN_COLOR_DEFAULT;
+    switch (proc->state) {
+        case 'R':
+            text  = "RUNNING";
+            color = COLUMN_COLOR_GREEN;
+            break;
+        case 'S':
+            text  = "SLEEPING";
+            color = COLUMN_COLOR_CYAN;
+            break;
+        case 'D':
+            text  = "WAITING";
+            color = COLUMN_COLOR_YELLOW;
+            break;
+        case 'Z':
+            text  = "ZOMBIE";
+            color = COLUMN_COLOR_RED;
+            break;
+        case 'T':
+            text  = "STOPPED";
+            color = COLUMN_COLOR_MAGENTA;
+            break;
+        case 'I':
+            text  = "IDLE";
+            color = COLUMN_COLOR_DIM;
+            break;
+    }
+    snprintf(out, size, "%s", text);
+    return color;
+}
+
+static int format_cpu(char* out, size_t size, const ProcessNode* proc) {
+    snprintf(out, size, "%.1f%%", proc->cpu_usage);
+    return COLUMN_COLOR_YELLOW;
+}
+
+static int format_name(char* out, size_t size, const ProcessNode* proc) {
+    snprintf(out, size, "%s", proc->name);
+    return COLUMN_COLOR_DEFAULT;
+}
+
+const Column columns[COLUMN_COUNT] = {
+    [COLUMN_PID]      = {"pid", "ID", 7, 0, 0, PROC_FILE_STAT, &sort_by_pid, "pid", 6, format_pid},
+    [COLUMN_USER]     = {"user", "OWNER", 12, 0, 0, PROC_FILE_STATUS, NULL, NULL, 0, format_user},
+    [COLUMN_PRI]      = {"pri", "PRI", 4, 0, 1, PROC_FILE_STAT, NULL, NULL, 0, format_pri},
+    [COLUMN_NICE]     = {"nice", "NI", 4, 0, 1, PROC_FILE_STAT, NULL, NULL, 0, format_nice},
+    [COLUMN_VSZ]      = {"vsz", "VIRT", 8, 0, 1, PROC_FILE_STATM, NULL, NULL, 0, format_vsz},
+    [COLUMN_MEM]      = {"mem", "RES", 8, 0, 1, PROC_FILE_STATM, &sort_by_mem, "mem", 4,
+                         format_mem},
+    [COLUMN_THREADS]  = {"threads", "THR", 4, 1, 0, PROC_FILE_STATUS, NULL, NULL, 0,
+                         format_threads},
+    [COLUMN_READ]     = {"read", "READ/s", 8, 1, 1, PROC_FILE_IO, &sort_by_io, "io", 11,
+                         format_read},
+    [COLUMN_WRITE]    = {"write", "WRITE/s", 8, 1, 1, PROC_FILE_IO, &sort_by_io, NULL, 0,
+                         format_write},
+    [COLUMN_SYSCALLS] = {"syscalls", "SYSC/s", 8, 1, 1, PROC_FILE_IO, NULL, NULL, 0,
+                         format_syscalls},
+    [COLUMN_PSS]      = {"pss", "PSS", 8, 1, 1, PROC_FILE_ROLLUP, &sort_by_pss, "pss", 12,
+                         format_pss},
+    [COLUMN_USS]      = {"uss", "USS", 8, 1, 1, PROC_FILE_ROLLUP, NULL, NULL, 0, format_uss},
+    [COLUMN_SWAP]     = {"swap", "SWAP", 8, 1, 1, PROC_FILE_STATUS, NULL, NULL, 0, format_swap},
+    [COLUMN_STATE]    = {"state", "STATUS", 8, 0, 0, PROC_FILE_STAT, NULL, NULL, 0, format_state},
+    [COLUMN_CPU]      = {"cpu", "CPU%", 7, 0, 0, PROC_FILE_STAT, &sort_by_cpu, "cpu", 3,
+                         format_cpu},
+    [COLUMN_NAME]     = {"name", "COMMAND", 0, 0, 0, PROC_FILE_STAT, &sort_by_name, "name", 5,
+                         format_name},
+};
+
+void column_set_default(ColumnSet* set) {
+    static const ColumnId defaults[] = {COLUMN_PID, COLUMN_USER,  COLUMN_PRI, COLUMN_NICE,
+                                        COLUMN_VSZ, COLUMN_MEM,   COLUMN_STATE, COLUMN_CPU,
+                                        COLUMN_NAME};
+    set->count = sizeof(defaults) / sizeof(defaults[0]);
+    memcpy(set->ids, defaults, sizeof(defaults));
+}
+
+int column_set_parse(ColumnSet* set, const char* list, char* error, size_t error_size) {
+    ColumnSet   parsed = {0, {0}};
+    const char* p      = list;
+    while (*p) {
+        const char* end   = strchr(p, ',');
+        size_t      len   = end ? (size_t)(end - p) : strlen(p);
+        int         found = -1;
+        for (int c = 0; c < COLUMN_COUNT; c++) {
+            if (strlen(columns[c].name) == len && strncmp(p, columns[c].name, len) == 0) {
+                found = c;
+                break;
+            }
+        }
+        if (found < 0) {
+            snprintf(error, error_size, "unknown column '%.*s'", (int)len, p);
+            return -1;
+        }
+        for (int i = 0; i < parsed.count; i++) {
+            if (parsed.ids[i] == (ColumnId)found) {
+                snprintf(error, error_size, "column '%s' given twice", columns[found].name);
+                return -1;
+            }
+        }
+        if (parsed.count > 0 && parsed.ids[parsed.count - 1] == COLUMN_NAME) {
+            snprintf(error, error_size, "column 'name' must be last");
+            return -1;
+        }
+        parsed.ids[parsed.count++] = (ColumnId)found;
+        p += len;
+        if (*p == ',') p++;
+    }
+    if (parsed.count == 0) {
+        snprintf(error, error_size, "empty column list");
+        return -1;
+    }
+    *set = parsed;
+    return 0;
+}
+
+int column_set_files(const ColumnSet* set) {
+    int files = PROC_FILE_STAT;
+    for (int i = 0; i < set->count; i++) files |= columns[set->ids[i]].files;
+    return files;
+}
+
+void column_set_mode(const ColumnSet* base, ColumnMode mode, ColumnSet* out) {
+    static const ColumnId io[]     = {COLUMN_READ, COLUMN_WRITE, COLUMN_SYSCALLS};
+    static const ColumnId memory[] = {COLUMN_PSS, COLUMN_USS, COLUMN_SWAP};
+    if (mode == COLUMN_MODE_DEFAULT) {
+        *out = *base;
+        return;
+    }
+    const ColumnId* group = mode == COLUMN_MODE_IO ? io : memory;
+
+    // The group replaces the detail columns, or goes before the columns
+    // that usually end a row.
+    int at = -1;
+    for (int i = 0; i < base->count && at < 0; i++) {
+        if (columns[base->ids[i]].detail) at = i;
+    }
+    for (int i = 0; i < base->count && at < 0; i++) {
+        ColumnId id = base->ids[i];
+        if (id == COLUMN_STATE || id == COLUMN_CPU || id == COLUMN_NAME) at = i;
+    }
+    if (at < 0) at = base->count;
+
+    out->count = 0;
+    for (int i = 0; i <= base->count; i++) {
+        if (i == at) {
+            for (int g = 0; g < 3; g++) out->ids[out->count++] = group[g];
+        }
+        if (i < base->count && !columns[base->ids[i]].detail) {
+            out->ids[out->count++] = base->ids[i];
+        }
+    }
+}
+
+const Column* column_by_key(int function_key) {
+    for (int c = 0; c < COLUMN_COUNT; c++) {
+        if (function_key > 0 && columns[c].function_key == function_key) return &columns[c];
+    }
+    return NULL;
+}
+
+const SortSpec* column_sort_named(const char* name) {
+    for (int c = 0; c < COLUMN_COUNT; c++) {
+        if (columns[c].sort_name && strcmp(columns[c].sort_name, name) == 0) {
+            return columns[c].sort;
+        }
+    }
+    return NULL;
+}
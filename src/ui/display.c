@@ -11,7 +11,10 @@
 #define _XOPEN_SOURCE_EXTENDED 1
 #include "../../include/ui/display.h"
 #include "../../include/system/sys_info.h"
+#include "../../include/ui/columns.h"
 #include <ncurses.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <locale.h>
@@ -30,6 +33,9 @@
 #define CP_DIM 11
 #define CP_ACCENT 12
 
+/** @brief Columns of the process list, set by dashboard_set_columns(). */
+static ColumnSet dashboard_columns;
+
 void init_ui() {
     setlocale(LC_ALL, "");
     initscr();
@@ -52,6 +58,8 @@ void init_ui() {
     init_pair(CP_FOOTER_DESC, COLOR_BLACK, COLOR_CYAN);
     init_pair(CP_DIM, COLOR_WHITE, -1);
     init_pair(CP_ACCENT, COLOR_MAGENTA, -1);
+
+    column_set_default(&dashboard_columns);
 }
 
 /**
@@ -124,183 +132,805 @@ void draw_pill_footer(int* x, int max_y, const char* key, const char* desc) {
     attroff(A_DIM);
 }
 
-void render_dashboard(ProcessNode* head, int scroll_offset, int selection_idx,
-                      const char* search_query, const char* sort_col) {
-    erase();
+/** @brief Most lines the per-core meters may take; more CPUs share a cell. */
+#define DASHBOARD_CORE_LINES 4
+/** @brief Width of a per-core meter with its number and percentage. */
+#define DASHBOARD_CORE_CELL 21
+/** @brief Most single-character core cells on one line. */
+#define DASHBOARD_CORE_PER_LINE 480
+
+/**
+ * @struct CoreLayout
+ * @brief How the per-core meters are arranged for a CPU count and terminal width.
+ *
+ * Few CPUs get a small bar each. Otherwise each CPU is one block character whose
+ * height shows its load, and if even that needs more than DASHBOARD_CORE_LINES
+ * lines, each character stands for @c group adjacent CPUs and shows the busiest.
+ */
+typedef struct CoreLayout {
+    int lines;    /**< Lines taken, 0 when no per-core values are known */
+    int wide;     /**< Non-zero for bars, zero for block characters */
+    int per_line; /**< Cells on a full line */
+    int group;    /**< CPUs per cell */
+} CoreLayout;
+
+/** @brief CPU count of the last drawn sample, which decides the core lines. */
+static int dashboard_cores;
+
+/** @brief Non-zero if the last drawn sample had disk throughput, which takes a line. */
+static int dashboard_disks;
+
+/**
+ * @brief Arranges @p cores per-core meters on a terminal @p max_x columns wide.
+ */
+static CoreLayout dashboard_core_layout(int cores, int max_x) {
+    CoreLayout layout = {0, 0, 0, 1};
+    if (cores <= 0) return layout;
+
+    layout.per_line = (max_x - 2) / DASHBOARD_CORE_CELL;
+    if (layout.per_line > 0 && cores <= layout.per_line * 2) {
+        layout.wide  = 1;
+        layout.lines = (cores + layout.per_line - 1) / layout.per_line;
+        return layout;
+    }
+
+    // Block characters follow a "NNNN ▕" label and end with "▏".
+    layout.per_line = max_x - 9;
+    if (layout.per_line > DASHBOARD_CORE_PER_LINE) layout.per_line = DASHBOARD_CORE_PER_LINE;
+    if (layout.per_line < 1) return layout;
+    int capacity = layout.per_line * DASHBOARD_CORE_LINES;
+    layout.group = (cores + capacity - 1) / capacity;
+    int cells    = (cores + layout.group - 1) / layout.group;
+    layout.lines = (cells + layout.per_line - 1) / layout.per_line;
+    return layout;
+}
+
+int dashboard_rows() {
+    // Rows run from below the table header (line 7 plus the core and disk
+    // lines) to above the footer.
     int max_x, max_y;
     getmaxyx(stdscr, max_y, max_x);
+    int rows = max_y - 8 - dashboard_core_layout(dashboard_cores, max_x).lines - dashboard_disks;
+    return rows > 0 ? rows : 0;
+}
 
-    SystemInfo sys_info;
-    get_system_info(&sys_info, head);
+int dashboard_filter_line() {
+    return 5 + dashboard_core_layout(dashboard_cores, getmaxx(stdscr)).lines + dashboard_disks;
+}
 
-    // Resources
-    int stats_x = 42;
-    draw_futuristic_meter(1, 2, "CPU", sys_info.cpu_usage, CP_CYAN);
-    attron(COLOR_PAIR(CP_CYAN) | A_BOLD);
-    mvprintw(1, stats_x, "◸ TASKS ");
-    attroff(COLOR_PAIR(CP_CYAN) | A_BOLD);
-    printw(": %d ", sys_info.total_tasks);
-    attron(A_DIM);
-    printw("(%dR)", sys_info.running_tasks);
-    attroff(A_DIM);
+/** @brief Size of the text that identifies what a dashboard region shows. */
+#define DASHBOARD_KEY_SIZE 512
 
-    draw_futuristic_meter(2, 2, "MEM", sys_info.mem_usage, CP_MAGENTA);
-    attron(COLOR_PAIR(CP_MAGENTA) | A_BOLD);
-    mvprintw(2, stats_x, "◸ LOAD  ");
-    attroff(COLOR_PAIR(CP_MAGENTA) | A_BOLD);
-    printw(": %.2f %.2f %.2f", sys_info.load_avg[0], sys_info.load_avg[1], sys_info.load_avg[2]);
+/** @brief Deepest level of the tree view that is indented further. */
+#define DASHBOARD_TREE_DEPTH 16
 
-    draw_futuristic_meter(3, 2, "SWP", sys_info.swp_usage, CP_YELLOW);
-    attron(COLOR_PAIR(CP_YELLOW) | A_BOLD);
-    mvprintw(3, stats_x, "◸ UPTIME");
-    attroff(COLOR_PAIR(CP_YELLOW) | A_BOLD);
-    int hh = sys_info.uptime_sec / 3600;
-    int mm = (sys_info.uptime_sec % 3600) / 60;
-    int ss = sys_info.uptime_sec % 60;
-    printw(": %02d:%02d:%02d", hh, mm, ss);
+/** @brief Width of the name column of the cgroup view, including the indentation. */
+#define DASHBOARD_CGROUP_NAME 32
 
-    // Filter Info
-    if (search_query[0] != '\0') {
-        attron(A_BOLD | COLOR_PAIR(CP_MAGENTA));
-        mvprintw(5, 2, " ❯ FILTER: ");
-        attroff(A_BOLD | COLOR_PAIR(CP_MAGENTA));
-        printw("%s", search_query);
+/**
+ * @struct DashboardCache
+ * @brief What each region of the dashboard showed when it was last drawn.
+ *
+ * Every region is identified by a key string formatted from exactly the values
+ * it displays; an empty key is a blank region. A region is only redrawn when
+ * its key changes, and the frame is not refreshed at all when none did.
+ */
+typedef struct DashboardCache {
+    int  valid;                                           /**< Zero forces a full redraw */
+    int  touched;                                         /**< Non-zero after an overlay */
+    int  max_x, max_y;                                    /**< Size at the last full redraw */
+    char stats[3][DASHBOARD_KEY_SIZE];                    /**< Meter and statistics lines */
+    char cores[DASHBOARD_CORE_LINES][DASHBOARD_KEY_SIZE]; /**< Per-core meter lines */
+    int  core_lines;                                      /**< Core lines of the last full redraw */
+    char disks[DASHBOARD_KEY_SIZE];                       /**< Disk throughput line */
+    int  disk_line;                                       /**< Disk line of the last full redraw */
+    char status[DASHBOARD_KEY_SIZE];                      /**< Status line */
+    char filter[DASHBOARD_KEY_SIZE];                      /**< Filter line */
+    char header[DASHBOARD_KEY_SIZE];                      /**< Table header */
+    char (*rows)[DASHBOARD_KEY_SIZE];                     /**< Process rows */
+    int  row_count;                                       /**< Number of entries in rows */
+} DashboardCache;
+
+static DashboardCache dashboard_cache;
+
+/** @brief Text of the status line, set by dashboard_set_status(). */
+static char dashboard_status[DASHBOARD_KEY_SIZE];
+
+void dashboard_invalidate() { dashboard_cache.valid = 0; }
+
+void dashboard_set_status(const char* status) {
+    snprintf(dashboard_status, sizeof(dashboard_status), "%s", status);
+}
+
+void dashboard_set_columns(const ColumnSet* set) { dashboard_columns = *set; }
+
+/**
+ * @brief Marks the dashboard for repainting after an overlay window is closed.
+ *
+ * The contents of stdscr are still current, so the next frame only needs
+ * refresh() to restore the covered cells.
+ */
+static void dashboard_touch() {
+    touchwin(stdscr);
+    dashboard_cache.touched = 1;
+}
+
+/**
+ * @brief Records a region's new key.
+ * @return 1 if it differs from the cached key, i.e. the region must be redrawn.
+ */
+static int dashboard_damaged(char* cached, const char* key) {
+    if (strcmp(cached, key) == 0) return 0;
+    snprintf(cached, DASHBOARD_KEY_SIZE, "%s", key);
+    return 1;
+}
+
+/**
+ * @brief Clears the cache and the screen for a full redraw.
+ * @return 0 on success, -1 if the row cache cannot be allocated.
+ */
+static int dashboard_reset(int max_x, int max_y) {
+    int rows = dashboard_rows();
+    if (rows > dashboard_cache.row_count) {
+        char(*cached)[DASHBOARD_KEY_SIZE] = realloc(dashboard_cache.rows, sizeof(*cached) * rows);
+        if (!cached) return -1;
+        dashboard_cache.rows      = cached;
+        dashboard_cache.row_count = rows;
     }
+    for (int i = 0; i < dashboard_cache.row_count; i++) dashboard_cache.rows[i][0] = '\0';
+    for (int i = 0; i < 3; i++) dashboard_cache.stats[i][0] = '\0';
+    for (int i = 0; i < DASHBOARD_CORE_LINES; i++) dashboard_cache.cores[i][0] = '\0';
+    dashboard_cache.status[0]  = '\0';
+    dashboard_cache.filter[0]  = '\0';
+    dashboard_cache.header[0]  = '\0';
+    dashboard_cache.disks[0]   = '\0';
+    dashboard_cache.max_x      = max_x;
+    dashboard_cache.max_y      = max_y;
+    dashboard_cache.core_lines = dashboard_core_layout(dashboard_cores, max_x).lines;
+    dashboard_cache.disk_line  = dashboard_disks;
+    dashboard_cache.valid      = 1;
+    erase();
+    return 0;
+}
 
-    // Precise Table Header
-    int header_y = 6;
-    attron(COLOR_PAIR(CP_HEADER) | A_BOLD);
-    mvhline(header_y, 0, ' ', max_x);
-    mvprintw(header_y, 1, "  %-7s  %-12s  %-4s  %-4s  %-8s  %-8s  %-10s  %-7s  %-s", "ID", "OWNER",
-             "PRI", "NI", "VIRT", "RES", "STATUS", "CPU%", "COMMAND");
-
-    // Exact Sort Highlighting
-    if (strcmp(sort_col, "PID") == 0)
-        mvprintw(header_y, 3, "ID");
-    else if (strcmp(sort_col, "CPU%") == 0)
-        mvprintw(header_y, 66, "CPU%%");
-    else if (strcmp(sort_col, "MEM") == 0)
-        mvprintw(header_y, 44, "RES");
-    else if (strcmp(sort_col, "NAME") == 0)
-        mvprintw(header_y, 76, "COMMAND");
-    attroff(COLOR_PAIR(CP_HEADER) | A_BOLD);
-
-    // Process Datastream
-    ProcessNode* curr = head;
-    int          row  = header_y + 1;
-    int          idx  = 0;
-
-    while (curr && row < max_y - 1) {
-        if (search_query[0] != '\0' && strcasestr(curr->name, search_query) == NULL) {
-            curr = curr->next;
-            continue;
-        }
+/**
+ * @brief Color of a per-core meter at @p percentage.
+ */
+static int core_color(int percentage) {
+    if (percentage >= 80) return CP_RED;
+    if (percentage >= 50) return CP_YELLOW;
+    return CP_GREEN;
+}
 
-        if (idx >= scroll_offset) {
-            bool is_sel = (idx == selection_idx);
-            if (is_sel) {
-                attron(COLOR_PAIR(CP_SELECT) | A_BOLD);
-                mvhline(row, 0, ' ', max_x);
-            }
+/**
+ * @brief Busy percentage shown by core cell @p cell: the busiest CPU of its group.
+ */
+static int core_cell_value(const SystemInfo* sys_info, const CoreLayout* layout, int cell) {
+    int value = 0;
+    for (int i = cell * layout->group; i < (cell + 1) * layout->group && i < sys_info->core_count;
+         i++) {
+        if (sys_info->core_usage[i] > value) value = sys_info->core_usage[i];
+    }
+    return value;
+}
 
-            // Column: ID
-            if (!is_sel) attron(COLOR_PAIR(CP_CYAN) | A_BOLD);
-            mvprintw(row, 1, "› %-6d", curr->pid);
-            if (!is_sel) attroff(COLOR_PAIR(CP_CYAN) | A_BOLD);
+/**
+ * @brief Formats the key of core line @p line: the values it shows, at the
+ *        precision it shows them.
+ */
+static void core_line_key(char* key, const SystemInfo* sys_info, const CoreLayout* layout,
+                          int line) {
+    int cells = (sys_info->core_count + layout->group - 1) / layout->group;
+    int first = line * layout->per_line;
+    int len   = snprintf(key, DASHBOARD_KEY_SIZE, "%d %d:", layout->wide, layout->group);
+    for (int c = first; c < first + layout->per_line && c < cells; c++) {
+        if (len >= DASHBOARD_KEY_SIZE - 1) break;  // Only on terminals thousands of columns wide
+        int value = core_cell_value(sys_info, layout, c);
+        if (layout->wide) {
+            len += snprintf(key + len, DASHBOARD_KEY_SIZE - len, " %d", value);
+        } else {
+            key[len++] = (char)('0' + (value * 8 + 50) / 100);
+            key[len]   = '\0';
+        }
+    }
+}
 
+/**
+ * @brief Draws core line @p line at screen line @p y, replacing whatever it held.
+ */
+static void draw_core_line(int y, const SystemInfo* sys_info, const CoreLayout* layout, int line) {
+    static const char* blocks[] = {"·", "▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+    int                cells    = (sys_info->core_count + layout->group - 1) / layout->group;
+    int                first    = line * layout->per_line;
+    move(y, 0);
+    clrtoeol();
+    if (layout->wide) {
+        for (int c = first; c < first + layout->per_line && c < cells; c++) {
+            int value  = core_cell_value(sys_info, layout, c);
+            int color  = core_color(value);
+            int filled = value / 10;
             attron(A_DIM);
-            mvaddstr(row, 9, "┆");
+            mvprintw(y, 2 + (c - first) * DASHBOARD_CORE_CELL, "%3d▕", c);
             attroff(A_DIM);
-
-            // Column: Owner
-            mvprintw(row, 11, "%-12.12s", curr->username);
+            attron(COLOR_PAIR(color) | A_BOLD);
+            for (int i = 0; i < filled; i++) addstr("━");
+            attroff(COLOR_PAIR(color) | A_BOLD);
             attron(A_DIM);
-            mvaddstr(row, 24, "┆");
+            for (int i = filled; i < 10; i++) addstr("─");
+            addstr("▏");
             attroff(A_DIM);
+            attron(COLOR_PAIR(color));
+            printw("%3d%%", value);
+            attroff(COLOR_PAIR(color));
+        }
+        return;
+    }
 
-            // Column: PRI/NI/VIRT/RES
-            mvprintw(row, 26, "%-4ld %-4ld %-8d %-8.1f", curr->priority, curr->nice_value,
-                     (int)(curr->memory_kb * 1.1), (float)curr->memory_kb / 1024.0);
-            attron(A_DIM);
-            mvaddstr(row, 53, "┆");
-            attroff(A_DIM);
+    attron(A_DIM);
+    mvprintw(y, 2, "%4d ▕", first * layout->group);
+    attroff(A_DIM);
+    for (int c = first; c < first + layout->per_line && c < cells; c++) {
+        int value = core_cell_value(sys_info, layout, c);
+        int level = (value * 8 + 50) / 100;
+        int attrs = level == 0 ? A_DIM : COLOR_PAIR(core_color(value)) | A_BOLD;
+        attron(attrs);
+        addstr(blocks[level]);
+        attroff(attrs);
+    }
+    attron(A_DIM);
+    addstr("▏");
+    attroff(A_DIM);
+}
 
-            // Column: Status (Full Text)
-            const char* status_text = "UNKNOWN";
-            int         s_color     = CP_DEFAULT;
-            switch (curr->state) {
-                case 'R':
-                    status_text = "RUNNING";
-                    s_color     = CP_GREEN;
-                    break;
-                case 'S':
-                    status_text = "SLEEPING";
-                    s_color     = CP_CYAN;
-                    break;
-                case 'D':
-                    status_text = "WAITING";
-                    s_color     = CP_YELLOW;
-                    break;
-                case 'Z':
-                    status_text = "ZOMBIE";
-                    s_color     = CP_RED;
-                    break;
-                case 'T':
-                    status_text = "STOPPED";
-                    s_color     = CP_MAGENTA;
-                    break;
-                case 'I':
-                    status_text = "IDLE";
-                    s_color     = CP_DIM;
-                    break;
-            }
+/**
+ * @brief Writes the connector lines drawn in front of a row of the tree view.
+ * @return int Width of the connectors in columns.
+ */
+static int tree_branch(char* out, size_t size, const ProcessTree* tree, int r) {
+    int    depth = tree->depth[r] < DASHBOARD_TREE_DEPTH ? tree->depth[r] : DASHBOARD_TREE_DEPTH;
+    int    width = 0;
+    size_t len   = 0;
+    out[0]       = '\0';
+    for (int level = 1; level < depth; level++) {
+        const char* guide = (tree->guides[r] >> level) & 1 ? "│ " : "  ";
+        len += snprintf(out + len, size - len, "%s", guide);
+        width += 2;
+    }
+    if (depth > 0) {
+        const char* branch = tree->flags[r] & TREE_NODE_LAST ? "└─" : "├─";
+        len += snprintf(out + len, size - len, "%s", branch);
+        width += 2;
+    }
+    if (tree->flags[r] & TREE_NODE_PARENT) {
+        const char* fold = tree->flags[r] & TREE_NODE_COLLAPSED ? "▸ " : "▾ ";
+        snprintf(out + len, size - len, "%s", fold);
+        width += 2;
+    } else if (depth > 0) {
+        snprintf(out + len, size - len, " ");
+        width += 1;
+    }
+    return width;
+}
+
+/**
+ * @struct DashboardRow
+ * @brief The cells of one process row, formatted by the column registry.
+ */
+typedef struct DashboardRow {
+    char text[COLUMN_COUNT][COLUMN_CELL_SIZE]; /**< Text of each shown column, in order */
+    int  color[COLUMN_COUNT];                  /**< ColumnColor of each cell */
+} DashboardRow;
 
-            if (!is_sel) attron(COLOR_PAIR(s_color) | A_BOLD);
-            mvprintw(row, 55, "%-10s", status_text);
-            if (!is_sel) attroff(COLOR_PAIR(s_color) | A_BOLD);
+/**
+ * @brief Computes the screen column at which each shown column starts.
+ *
+ * Rows begin with "› " at column 1. Neighbouring detail columns are joined by
+ * a space, all others by a dim rule.
+ */
+static void dashboard_layout(int* x) {
+    x[0] = 3;
+    for (int i = 1; i < dashboard_columns.count; i++) {
+        const Column* prev = &columns[dashboard_columns.ids[i - 1]];
+        const Column* curr = &columns[dashboard_columns.ids[i]];
+        x[i]               = x[i - 1] + prev->width + (prev->detail && curr->detail ? 1 : 3);
+    }
+}
+
+/**
+ * @brief Returns the attributes that draw a ColumnColor.
+ */
+static int column_attrs(int color) {
+    static const int pairs[] = {
+        [COLUMN_COLOR_CYAN]    = CP_CYAN,    [COLUMN_COLOR_YELLOW] = CP_YELLOW,
+        [COLUMN_COLOR_GREEN]   = CP_GREEN,   [COLUMN_COLOR_RED]    = CP_RED,
+        [COLUMN_COLOR_MAGENTA] = CP_MAGENTA, [COLUMN_COLOR_DIM]    = CP_DIM,
+    };
+    return color == COLUMN_COLOR_DEFAULT ? 0 : COLOR_PAIR(pairs[color]) | A_BOLD;
+}
 
+/**
+ * @brief Draws @p text at @p x, padded to the width of @p column and clipped
+ *        at the right edge. A column without a width is not padded.
+ */
+static void draw_cell(int row, int x, const Column* column, const char* text, int max_x) {
+    int room  = max_x - x - 1;
+    int width = column->width && column->width < room ? column->width : room;
+    if (width <= 0) return;
+    if (!column->width) {
+        mvprintw(row, x, "%.*s", width, text);
+    } else if (column->right) {
+        mvprintw(row, x, "%*.*s", width, width, text);
+    } else {
+        mvprintw(row, x, "%-*.*s", width, width, text);
+    }
+}
+
+/**
+ * @brief Draws the command of a process row at @p x.
+ *
+ * In the tree view (@p tree not NULL) the command is indented below its
+ * parent, and a collapsed process shows the number of hidden rows. Threads
+ * are indented below their process.
+ */
+static void draw_command(int row, int x, const char* name, const ProcessNode* curr, int max_x,
+                         const ProcessTree* tree, int r) {
+    if (tree) {
+        char branch[128];
+        int  width = tree_branch(branch, sizeof(branch), tree, r);
+        int  room  = max_x - x - 1 - width;
+        attron(A_DIM);
+        mvaddstr(row, x, branch);
+        attroff(A_DIM);
+        printw("%.*s", room > 0 ? room : 0, name);
+        if ((tree->flags[r] & TREE_NODE_COLLAPSED) && getcurx(stdscr) + 12 < max_x) {
             attron(A_DIM);
-            mvaddstr(row, 65, "┆");
+            printw(" +%d", tree->descendants[r]);
             attroff(A_DIM);
+        }
+    } else if (curr->thread_of) {
+        int room = max_x - x - 4;
+        attron(A_DIM);
+        mvaddstr(row, x, " ↳ ");
+        attroff(A_DIM);
+        printw("%.*s", room > 0 ? room : 0, name);
+    } else {
+        mvprintw(row, x, "%.*s", max_x - x - 1, name);
+    }
+}
+
+/**
+ * @brief Draws one process row from its formatted cells.
+ */
+static void draw_process_row(int row, const DashboardRow* cells, const ProcessNode* curr,
+                             bool is_sel, int max_x, const ProcessTree* tree, int r) {
+    if (is_sel) {
+        attron(COLOR_PAIR(CP_SELECT) | A_BOLD);
+        mvhline(row, 0, ' ', max_x);
+    } else {
+        move(row, 0);
+        clrtoeol();
+    }
 
-            // Column: CPU%
-            if (!is_sel) attron(COLOR_PAIR(CP_YELLOW) | A_BOLD);
-            mvprintw(row, 67, "%-6.1f%%", curr->cpu_usage);
-            if (!is_sel) attroff(COLOR_PAIR(CP_YELLOW) | A_BOLD);
+    if (!is_sel) attron(COLOR_PAIR(CP_CYAN) | A_BOLD);
+    mvaddstr(row, 1, "›");
+    if (!is_sel) attroff(COLOR_PAIR(CP_CYAN) | A_BOLD);
 
+    int x[COLUMN_COUNT];
+    dashboard_layout(x);
+    for (int i = 0; i < dashboard_columns.count && x[i] < max_x - 1; i++) {
+        ColumnId      id     = dashboard_columns.ids[i];
+        const Column* column = &columns[id];
+        if (i > 0 && !(columns[dashboard_columns.ids[i - 1]].detail && column->detail)) {
             attron(A_DIM);
-            mvaddstr(row, 74, "┆");
+            mvaddstr(row, x[i] - 2, "┆");
             attroff(A_DIM);
+        }
+        if (id == COLUMN_NAME) {
+            draw_command(row, x[i], cells->text[i], curr, max_x, tree, r);
+            continue;
+        }
+        int attrs = is_sel ? 0 : column_attrs(cells->color[i]);
+        attron(attrs);
+        draw_cell(row, x[i], column, cells->text[i], max_x);
+        attroff(attrs);
+    }
+
+    if (is_sel) attroff(COLOR_PAIR(CP_SELECT) | A_BOLD);
+}
+
+/**
+ * @brief Draws one row of the cgroup view.
+ *
+ * The name is indented below its parent. Memory columns are in MB, pressure
+ * columns are "some" avg10 in percent; a value the cgroup does not expose (no
+ * controller, no PSI, or the root) is shown as "-".
+ */
+static void draw_cgroup_row(int row, const CgroupInfo* cgroup, bool is_sel, int max_x) {
+    if (is_sel) {
+        attron(COLOR_PAIR(CP_SELECT) | A_BOLD);
+        mvhline(row, 0, ' ', max_x);
+    } else {
+        move(row, 0);
+        clrtoeol();
+    }
+
+    // Column: Name, two columns per level up to half the column
+    int indent = 2 * (cgroup->depth < DASHBOARD_CGROUP_NAME / 4 ? cgroup->depth
+                                                                 : DASHBOARD_CGROUP_NAME / 4);
+    if (!is_sel) attron(COLOR_PAIR(CP_CYAN) | A_BOLD);
+    mvprintw(row, 1, "› %*s%-*.*s", indent, "", DASHBOARD_CGROUP_NAME - indent,
+             DASHBOARD_CGROUP_NAME - indent, cgroup->name);
+    if (!is_sel) attroff(COLOR_PAIR(CP_CYAN) | A_BOLD);
+
+    // Column: CPU%
+    if (!is_sel) attron(COLOR_PAIR(CP_YELLOW) | A_BOLD);
+    mvprintw(row, 37, "%5.1f%%", cgroup->cpu_usage);
+    if (!is_sel) attroff(COLOR_PAIR(CP_YELLOW) | A_BOLD);
+
+    // Columns: MEMORY/ANON/FILE/KERNEL
+    const long sizes[] = {cgroup->memory_kb, cgroup->anon_kb, cgroup->file_kb, cgroup->kernel_kb};
+    for (int i = 0; i < 4; i++) {
+        char cell[16];
+        column_format_size(cell, sizeof(cell), sizes[i]);
+        mvprintw(row, 45 + i * 10, "%8s", cell);
+    }
+
+    // Columns: TASKS/PROCS
+    if (cgroup->tasks < 0) {
+        mvprintw(row, 85, "%6s", "-");
+    } else {
+        mvprintw(row, 85, "%6ld", cgroup->tasks);
+    }
+    mvprintw(row, 93, "%6d", cgroup->processes);
+
+    // Columns: CPU.P/MEM.P/IO.P, the share of the last 10 s some task was stalled
+    for (int i = 0; i < PRESSURE_RESOURCES; i++) {
+        if (cgroup->pressure[i].some_avg10 < 0) {
+            mvprintw(row, 101 + i * 8, "%6s", "-");
+        } else {
+            mvprintw(row, 101 + i * 8, "%6.2f", cgroup->pressure[i].some_avg10);
+        }
+    }
+
+    if (is_sel) attroff(COLOR_PAIR(CP_SELECT) | A_BOLD);
+}
+
+/**
+ * @brief Draws the pressure of one resource in the fourth header column.
+ * @param row Header line.
+ * @param x Column of the label.
+ * @param label Label, padded to the width of the others.
+ * @param stat Stall averages.
+ * @param color Color pair of the label.
+ */
+static void draw_pressure(int row, int x, const char* label, const PressureStat* stat,
+                          int color) {
+    attron(COLOR_PAIR(color) | A_BOLD);
+    mvprintw(row, x, "◸ %s", label);
+    attroff(COLOR_PAIR(color) | A_BOLD);
+    printw(": some %5.2f %5.2f full %5.2f %5.2f", stat->some_avg10, stat->some_avg60,
+           stat->full_avg10, stat->full_avg60);
+}
+
+/**
+ * @brief Appends the pressure of one resource to a damage key.
+ */
+static void pressure_key(char* key, size_t size, int shown, const PressureStat* stat) {
+    size_t len = strlen(key);
+    snprintf(key + len, size - len, " %d %.2f %.2f %.2f %.2f", shown, stat->some_avg10,
+             stat->some_avg60, stat->full_avg10, stat->full_avg60);
+}
+
+void render_dashboard(const ProcessSnapshot* snapshot, const ProcessTree* tree,
+                      const CgroupList* cgroups, const SystemInfo* sys_info, int scroll_offset,
+                      int selection_idx, const char* search_query, const SortSpec* sort,
+                      long short_lived) {
+    int max_x, max_y;
+    getmaxyx(stdscr, max_y, max_x);
+
+    // A resize, a different number of core lines, or an explicit
+    // invalidation starts from a blank screen.
+    dashboard_cores   = sys_info->core_count;
+    dashboard_disks   = sys_info->disk_count > 0;
+    CoreLayout layout = dashboard_core_layout(dashboard_cores, max_x);
+    int full = !dashboard_cache.valid || max_x != dashboard_cache.max_x ||
+               max_y != dashboard_cache.max_y || layout.lines != dashboard_cache.core_lines ||
+               dashboard_disks != dashboard_cache.disk_line;
+    if (full && dashboard_reset(max_x, max_y) != 0) return;
+    int  changed = full || dashboard_cache.touched;
+    char key[DASHBOARD_KEY_SIZE];
+
+    // Resources; the CPU breakdown needs a second column and /proc/stat values,
+    // which recordings do not hold. Pressure needs a third and a kernel with PSI.
+    int                 stats_x  = 42;
+    int                 detail_x = 84;
+    int                 psi_x    = detail_x + 38;
+    int                 detail   = sys_info->core_count > 0 && max_x >= detail_x + 37;
+    int                 psi      = detail && sys_info->psi && max_x >= psi_x + 44;
+    const PressureStat* pressure = sys_info->pressure;
+    snprintf(key, sizeof(key), "%d %d %d %ld %d %d %d %d %d", sys_info->cpu_usage,
+             sys_info->total_tasks, sys_info->running_tasks, short_lived, detail,
+             sys_info->cpu_user, sys_info->cpu_system, sys_info->cpu_iowait, sys_info->cpu_steal);
+    pressure_key(key, sizeof(key), psi, &pressure[PRESSURE_CPU]);
+    if (dashboard_damaged(dashboard_cache.stats[0], key)) {
+        move(1, 0);
+        clrtoeol();
+        draw_futuristic_meter(1, 2, "CPU", sys_info->cpu_usage, CP_CYAN);
+        attron(COLOR_PAIR(CP_CYAN) | A_BOLD);
+        mvprintw(1, stats_x, "◸ TASKS ");
+        attroff(COLOR_PAIR(CP_CYAN) | A_BOLD);
+        printw(": %d ", sys_info->total_tasks);
+        attron(A_DIM);
+        printw("(%dR)", sys_info->running_tasks);
+        if (short_lived >= 0) printw(" +%ld short-lived", short_lived);
+        attroff(A_DIM);
+        if (detail) {
+            attron(COLOR_PAIR(CP_CYAN) | A_BOLD);
+            mvprintw(1, detail_x, "◸ CPU   ");
+            attroff(COLOR_PAIR(CP_CYAN) | A_BOLD);
+            printw(": usr %d%% sys %d%% io %d%% st %d%%", sys_info->cpu_user, sys_info->cpu_system,
+                   sys_info->cpu_iowait, sys_info->cpu_steal);
+        }
+        if (psi) draw_pressure(1, psi_x, "PSI CPU", &pressure[PRESSURE_CPU], CP_CYAN);
+        changed = 1;
+    }
+
+    snprintf(key, sizeof(key), "%d %.2f %.2f %.2f %d %ld", sys_info->mem_usage,
+             sys_info->load_avg[0], sys_info->load_avg[1], sys_info->load_avg[2], detail,
+             sys_info->ctxt_rate);
+    pressure_key(key, sizeof(key), psi, &pressure[PRESSURE_MEMORY]);
+    if (dashboard_damaged(dashboard_cache.stats[1], key)) {
+        move(2, 0);
+        clrtoeol();
+        draw_futuristic_meter(2, 2, "MEM", sys_info->mem_usage, CP_MAGENTA);
+        attron(COLOR_PAIR(CP_MAGENTA) | A_BOLD);
+        mvprintw(2, stats_x, "◸ LOAD  ");
+        attroff(COLOR_PAIR(CP_MAGENTA) | A_BOLD);
+        printw(": %.2f %.2f %.2f", sys_info->load_avg[0], sys_info->load_avg[1],
+               sys_info->load_avg[2]);
+        if (detail) {
+            attron(COLOR_PAIR(CP_MAGENTA) | A_BOLD);
+            mvprintw(2, detail_x, "◸ CTXT  ");
+            attroff(COLOR_PAIR(CP_MAGENTA) | A_BOLD);
+            printw(": %ld/s", sys_info->ctxt_rate);
+        }
+        if (psi) draw_pressure(2, psi_x, "PSI MEM", &pressure[PRESSURE_MEMORY], CP_MAGENTA);
+        changed = 1;
+    }
+
+    int hh = sys_info->uptime_sec / 3600;
+    int mm = (sys_info->uptime_sec % 3600) / 60;
+    int ss = sys_info->uptime_sec % 60;
+    snprintf(key, sizeof(key), "%d %02d:%02d:%02d %d %d %d", sys_info->swp_usage, hh, mm, ss,
+             detail, sys_info->procs_running, sys_info->procs_blocked);
+    pressure_key(key, sizeof(key), psi, &pressure[PRESSURE_IO]);
+    if (dashboard_damaged(dashboard_cache.stats[2], key)) {
+        move(3, 0);
+        clrtoeol();
+        draw_futuristic_meter(3, 2, "SWP", sys_info->swp_usage, CP_YELLOW);
+        attron(COLOR_PAIR(CP_YELLOW) | A_BOLD);
+        mvprintw(3, stats_x, "◸ UPTIME");
+        attroff(COLOR_PAIR(CP_YELLOW) | A_BOLD);
+        printw(": %02d:%02d:%02d", hh, mm, ss);
+        if (detail) {
+            attron(COLOR_PAIR(CP_YELLOW) | A_BOLD);
+            mvprintw(3, detail_x, "◸ PROCS ");
+            attroff(COLOR_PAIR(CP_YELLOW) | A_BOLD);
+            printw(": %d runnable, %d blocked", sys_info->procs_running, sys_info->procs_blocked);
+        }
+        if (psi) draw_pressure(3, psi_x, "PSI IO ", &pressure[PRESSURE_IO], CP_YELLOW);
+        changed = 1;
+    }
+
+    // Per-core meters, between the meters and the status line
+    for (int line = 0; line < layout.lines; line++) {
+        core_line_key(key, sys_info, &layout, line);
+        if (!dashboard_damaged(dashboard_cache.cores[line], key)) continue;
+        draw_core_line(4 + line, sys_info, &layout, line);
+        changed = 1;
+    }
+    int top = 4 + layout.lines;
+
+    // Disk throughput, below the core lines; recordings do not hold it.
+    if (dashboard_disks) {
+        int len = 0;
+        key[0]  = '\0';
+        for (int i = 0; i < sys_info->disk_count; i++) {
+            const DiskInfo* disk = &sys_info->disks[i];
+            char            read[16], write[16], entry[96];
+            column_format_rate(read, sizeof(read), disk->read_bps, 1);
+            column_format_rate(write, sizeof(write), disk->write_bps, 1);
+            int width = snprintf(entry, sizeof(entry), "%s%s r %s/s w %s/s %3d%%", i ? "   " : "",
+                                 disk->name, read, write, disk->util);
+            if (12 + len + width > max_x) break;
+            len += snprintf(key + len, sizeof(key) - len, "%s", entry);
+        }
+        if (dashboard_damaged(dashboard_cache.disks, key)) {
+            move(top, 0);
+            clrtoeol();
+            attron(COLOR_PAIR(CP_GREEN) | A_BOLD);
+            mvprintw(top, 2, "◸ DISK  ");
+            attroff(COLOR_PAIR(CP_GREEN) | A_BOLD);
+            printw(": %s", key);
+            changed = 1;
+        }
+        top++;
+    }
+
+    // Status Line
+    if (dashboard_damaged(dashboard_cache.status, dashboard_status)) {
+        move(top, 0);
+        clrtoeol();
+        if (dashboard_status[0] != '\0') {
+            attron(A_BOLD | COLOR_PAIR(CP_YELLOW));
+            mvprintw(top, 2, " ◷ %s", dashboard_status);
+            attroff(A_BOLD | COLOR_PAIR(CP_YELLOW));
+        }
+        changed = 1;
+    }
+
+    // Filter Info
+    if (dashboard_damaged(dashboard_cache.filter, search_query)) {
+        move(top + 1, 0);
+        clrtoeol();
+        if (search_query[0] != '\0') {
+            attron(A_BOLD | COLOR_PAIR(CP_MAGENTA));
+            mvprintw(top + 1, 2, " ❯ FILTER: ");
+            attroff(A_BOLD | COLOR_PAIR(CP_MAGENTA));
+            printw("%s", search_query);
+        }
+        changed = 1;
+    }
+
+    // Precise Table Header
+    int header_y = top + 2;
+    int header_len = snprintf(key, sizeof(key), "%d %d", tree != NULL, cgroups != NULL);
+    for (int c = 0; c < dashboard_columns.count && header_len < (int)sizeof(key); c++) {
+        const Column* column = &columns[dashboard_columns.ids[c]];
+        header_len += snprintf(key + header_len, sizeof(key) - header_len, " %d%s",
+                               dashboard_columns.ids[c], sort && column->sort == sort ? "*" : "");
+    }
+    if (dashboard_damaged(dashboard_cache.header, key)) {
+        attron(COLOR_PAIR(CP_HEADER) | A_BOLD);
+        mvhline(header_y, 0, ' ', max_x);
+        if (cgroups) {
+            // The cgroup view keeps the hierarchy's own order.
+            mvprintw(header_y, 1, "  %-*s  %6s  %8s  %8s  %8s  %8s  %6s  %6s  %6s  %6s  %6s",
+                     DASHBOARD_CGROUP_NAME, "CGROUP", "CPU%", "MEMORY", "ANON", "FILE", "KERNEL",
+                     "TASKS", "PROCS", "CPU.P", "MEM.P", "IO.P");
+        } else {
+            // Labels line up with the cells; the columns the order comes from
+            // are shown in reverse.
+            int x[COLUMN_COUNT];
+            dashboard_layout(x);
+            for (int c = 0; c < dashboard_columns.count; c++) {
+                const Column* column = &columns[dashboard_columns.ids[c]];
+                const char*   label  = column->header;
+                int           attrs  = sort && column->sort == sort ? A_REVERSE : 0;
+                if (dashboard_columns.ids[c] == COLUMN_NAME && tree) label = "COMMAND ▾ TREE";
+                attron(attrs);
+                draw_cell(header_y, x[c], column, label, max_x);
+                attroff(attrs);
+            }
+        }
+        attroff(COLOR_PAIR(CP_HEADER) | A_BOLD);
+        changed = 1;
+    }
+
+    // Cgroup Datastream: one row per cgroup, in hierarchy order.
+    int rows = dashboard_rows();
+    for (int i = 0; i < rows && i < dashboard_cache.row_count && cgroups; i++) {
+        int               pos    = scroll_offset + i;
+        const CgroupInfo* cgroup = pos < cgroups->count ? &cgroups->items[pos] : NULL;
+        bool              is_sel = (pos == selection_idx);
+        key[0]                   = '\0';
+        if (cgroup) {
+            snprintf(key, sizeof(key), "C %d %llu %d %s %.1f %ld %ld %ld %ld %ld %d %.2f %.2f %.2f",
+                     is_sel, cgroup->id, cgroup->depth, cgroup->name, cgroup->cpu_usage,
+                     cgroup->memory_kb, cgroup->anon_kb, cgroup->file_kb, cgroup->kernel_kb,
+                     cgroup->tasks, cgroup->processes, cgroup->pressure[PRESSURE_CPU].some_avg10,
+                     cgroup->pressure[PRESSURE_MEMORY].some_avg10,
+                     cgroup->pressure[PRESSURE_IO].some_avg10);
+        }
+        if (!dashboard_damaged(dashboard_cache.rows[i], key)) continue;
 
-            // Column: Command
-            mvprintw(row, 76, "%.*s", max_x - 77, curr->name);
+        int row = header_y + 1 + i;
+        if (cgroup) {
+            draw_cgroup_row(row, cgroup, is_sel, max_x);
+        } else {
+            move(row, 0);
+            clrtoeol();
+        }
+        changed = 1;
+    }
+
+    // Process Datastream: the snapshot already holds only the matching
+    // processes, so the visible rows are read directly from the scroll offset.
+    // A row is redrawn only if its process or any value it shows changed.
+    for (int i = 0; i < rows && i < dashboard_cache.row_count && !cgroups; i++) {
+        int                pos    = scroll_offset + i;
+        int                r      = pos < snapshot->matched ? snapshot->order[pos] : -1;
+        const ProcessNode* curr   = r >= 0 ? &snapshot->procs[r] : NULL;
+        bool               is_sel = (pos == selection_idx);
+        DashboardRow       cells;
+        key[0]                    = '\0';
+        if (curr) {
+            // A collapsed process shows the CPU and memory of its whole
+            // subtree; address spaces do not add up, so VIRT is unknown.
+            ProcessNode        subtree;
+            const ProcessNode* values = curr;
+            if (tree && (tree->flags[r] & TREE_NODE_COLLAPSED)) {
+                subtree           = *curr;
+                subtree.cpu_usage = tree->subtree_cpu[r];
+                subtree.memory_kb = tree->subtree_mem[r];
+                subtree.vsz_kb    = -1;
+                values            = &subtree;
+            }
 
-            if (is_sel) attroff(COLOR_PAIR(CP_SELECT) | A_BOLD);
-            row++;
+            // The key is the formatted cells, so a row is redrawn only when
+            // its text does change.
+            int len = snprintf(key, sizeof(key), "%d %d", is_sel, curr->thread_of != 0);
+            for (int c = 0; c < dashboard_columns.count; c++) {
+                const Column* column = &columns[dashboard_columns.ids[c]];
+                cells.color[c] = column->format(cells.text[c], sizeof(cells.text[c]), values);
+                if (len < (int)sizeof(key)) {
+                    len += snprintf(key + len, sizeof(key) - len, "\x1f%s", cells.text[c]);
+                }
+            }
+            if (tree && len < (int)sizeof(key)) {
+                snprintf(key + len, sizeof(key) - len, " %d %llx %d %d", tree->depth[r],
+                         (unsigned long long)tree->guides[r], tree->flags[r],
+                         tree->descendants[r]);
+            }
         }
-        curr = curr->next;
-        idx++;
+        if (!dashboard_damaged(dashboard_cache.rows[i], key)) continue;
+
+        int row = header_y + 1 + i;
+        if (curr) {
+            draw_process_row(row, &cells, curr, is_sel, max_x, tree, r);
+        } else {
+            move(row, 0);
+            clrtoeol();
+        }
+        changed = 1;
     }
 
-    // Command Footer
-    int fx = 1;
-    mvhline(max_y - 1, 0, ' ', max_x);
-    draw_pill_footer(&fx, max_y, "F1", "HELP");
-    draw_pill_footer(&fx, max_y, "F3", "CPU%");
-    draw_pill_footer(&fx, max_y, "F4", "MEM");
-    draw_pill_footer(&fx, max_y, "F6", "PID");
-    draw_pill_footer(&fx, max_y, "F9", "KILL");
-    draw_pill_footer(&fx, max_y, "ENT", "INFO");
-    draw_pill_footer(&fx, max_y, "ESC", "QUIT");
+    if (full) {
+        // Command Footer
+        int fx = 1;
+        mvhline(max_y - 1, 0, ' ', max_x);
+        draw_pill_footer(&fx, max_y, "F1", "HELP");
+        draw_pill_footer(&fx, max_y, "F2", "THREADS");
+        draw_pill_footer(&fx, max_y, "F3", "CPU%");
+        draw_pill_footer(&fx, max_y, "F4", "MEM");
+        draw_pill_footer(&fx, max_y, "F6", "PID");
+        draw_pill_footer(&fx, max_y, "F9", "KILL");
+        draw_pill_footer(&fx, max_y, "ENT", "INFO");
+        draw_pill_footer(&fx, max_y, "ESC", "QUIT");
+    }
 
+    // Nothing visible changed: leave the terminal alone.
+    if (!changed) return;
+    dashboard_cache.touched = 0;
     refresh();
 }
 
+/**
+ * @brief Prints one line of two sizes in the inspector's memory box.
+ */
+static void inspector_sizes(WINDOW* win, int y, const char* left, long left_kb,
+                            const char* right, long right_kb) {
+    char a[16] = "-", b[16] = "-";
+    if (left_kb >= 0) snprintf(a, sizeof(a), "%.1f MB", (float)left_kb / 1024.0f);
+    if (right_kb >= 0) snprintf(b, sizeof(b), "%.1f MB", (float)right_kb / 1024.0f);
+    mvwprintw(win, y, 4, "│ %-5s: %-15s%-5s: %-15s │", left, a, right, b);
+}
+
 void render_process_details(ProcessNode* proc) {
     if (!proc) return;
     int max_x, max_y;
     getmaxyx(stdscr, max_y, max_x);
-    int w = 66, h = 18;
+    int w = 66, h = 21;
     int x = (max_x - w) / 2, y = (max_y - h) / 2;
 
     WINDOW* win = newwin(h, w, y, x);
@@ -316,7 +946,11 @@ void render_process_details(ProcessNode* proc) {
 
     mvwprintw(win, 2, 4, "┌─ IDENTIFICATION ─────────────────────────────┐");
     mvwprintw(win, 3, 4, "│ NAME : %-37s │", proc->name);
-    mvwprintw(win, 4, 4, "│ PID  : %-10d  PPID : %-10d      │", proc->pid, proc->ppid);
+    if (proc->thread_of) {
+        mvwprintw(win, 4, 4, "│ TID  : %-10d  PID  : %-10d      │", proc->pid, proc->thread_of);
+    } else {
+        mvwprintw(win, 4, 4, "│ PID  : %-10d  PPID : %-10d      │", proc->pid, proc->ppid);
+    }
     mvwprintw(win, 5, 4, "│ USER : %-10s  UID  : %-10d      │", proc->username, proc->uid);
     mvwprintw(win, 6, 4, "└──────────────────────────────────────────────┘");
 
@@ -327,6 +961,14 @@ void render_process_details(ProcessNode* proc) {
               (float)proc->memory_kb / 1024.0, proc->state);
     mvwprintw(win, 11, 4, "└──────────────────────────────────────────────┘");
 
+    // PSS and USS are only known once the sampler has measured the process.
+    mvwprintw(win, 13, 4, "┌─ MEMORY ─────────────────────────────────────┐");
+    inspector_sizes(win, 14, "RES", proc->memory_kb, "VIRT", proc->vsz_kb);
+    inspector_sizes(win, 15, "ANON", proc->anon_kb, "FILE", proc->file_kb);
+    inspector_sizes(win, 16, "SHMEM", proc->shmem_kb, "SWAP", proc->swap_kb);
+    inspector_sizes(win, 17, "PSS", proc->pss_kb, "USS", proc->uss_kb);
+    mvwprintw(win, 18, 4, "└──────────────────────────────────────────────┘");
+
     wattron(win, A_DIM | COLOR_PAIR(CP_CYAN));
     mvwprintw(win, h - 2, (w - 28) / 2, "PRESS ANY KEY TO DISMISS");
     wattroff(win, A_DIM | COLOR_PAIR(CP_CYAN));
@@ -334,12 +976,78 @@ void render_process_details(ProcessNode* proc) {
     wrefresh(win);
     wgetch(win);
     delwin(win);
+    dashboard_touch();
+}
+
+/**
+ * @brief Formats a duration with a unit that keeps three significant digits.
+ */
+static void profile_duration(char* out, size_t size, long long ns) {
+    if (ns < 0) {
+        snprintf(out, size, "-");
+    } else if (ns < 1000000) {
+        snprintf(out, size, "%.1f us", ns / 1e3);
+    } else if (ns < 1000000000) {
+        snprintf(out, size, "%.2f ms", ns / 1e6);
+    } else {
+        snprintf(out, size, "%.2f s", ns / 1e9);
+    }
+}
+
+void render_profile(const Profiler* profiler) {
+    int max_x, max_y;
+    getmaxyx(stdscr, max_y, max_x);
+    int w = 48, h = PROFILE_PHASES + 6;
+    int x = max_x - w - 1, y = max_y - h - 1;
+    if (x < 0 || y < dashboard_filter_line()) return;
+
+    WINDOW* win = newwin(h, w, y, x);
+    if (!win) return;
+    wbkgd(win, COLOR_PAIR(CP_DEFAULT));
+    wattron(win, COLOR_PAIR(CP_YELLOW));
+    box(win, 0, 0);
+    wattroff(win, COLOR_PAIR(CP_YELLOW));
+
+    wattron(win, COLOR_PAIR(CP_YELLOW) | A_BOLD);
+    mvwprintw(win, 0, (w - 16) / 2, " SELF_PROFILE ");
+    wattroff(win, COLOR_PAIR(CP_YELLOW) | A_BOLD);
+
+    wattron(win, A_DIM);
+    mvwprintw(win, 1, 2, "%-9s %10s %10s %10s", "PHASE", "LAST", "P50", "P99");
+    wattroff(win, A_DIM);
+    for (int phase = 0; phase < PROFILE_PHASES; phase++) {
+        ProfileStats stats = {-1, -1, -1, 0};
+        char         last[16], p50[16], p99[16];
+        profiler_stats(profiler, (ProfilePhase)phase, &stats);
+        profile_duration(last, sizeof(last), stats.last_ns);
+        profile_duration(p50, sizeof(p50), stats.p50_ns);
+        profile_duration(p99, sizeof(p99), stats.p99_ns);
+        mvwprintw(win, 2 + phase, 2, "%-9s %10s %10s %10s", profile_phase_names[phase], last, p50,
+                  p99);
+    }
+
+    // Counters are per sample: everything ProcX did between the last two.
+    int row = 3 + PROFILE_PHASES;
+    mvwprintw(win, row, 2, "%llu syscalls  %llu allocs  %llu procs /sample",
+              profiler->per_sample[PROFILE_SYSCALLS], profiler->per_sample[PROFILE_ALLOCS],
+              profiler->per_sample[PROFILE_PROCESSES]);
+    wattron(win, COLOR_PAIR(CP_CYAN));
+    mvwprintw(win, row + 1, 2, "PROCX CPU %.1f%%  RSS ", profiler->cpu_usage);
+    if (profiler->rss_kb >= 0) {
+        wprintw(win, "%.1f MB", (float)profiler->rss_kb / 1024.0f);
+    } else {
+        wprintw(win, "-");
+    }
+    wattroff(win, COLOR_PAIR(CP_CYAN));
+
+    wrefresh(win);
+    delwin(win);
 }
 
 void render_help() {
     int max_x, max_y;
     getmaxyx(stdscr, max_y, max_x);
-    int w = 54, h = 14;
+    int w = 54, h = 18;
     int x = (max_x - w) / 2, y = (max_y - h) / 2;
 
     WINDOW* win = newwin(h, w, y, x);
@@ -358,7 +1066,13 @@ void render_help() {
     mvwprintw(win, 6, 4, "F9 / K   : Terminate Task");
     mvwprintw(win, 7, 4, "/        : Dynamic Filter");
     mvwprintw(win, 8, 4, "ENTER    : Inspect Process");
-    mvwprintw(win, 9, 4, "ESC / Q  : Shutdown ProcX");
+    mvwprintw(win, 9, 4, "T / F2   : Threads of Selected / All");
+    mvwprintw(win, 10, 4, "V / SPC  : Tree View / Fold Subtree");
+    mvwprintw(win, 11, 4, "C / ENTER: Cgroups / Drill Down");
+    mvwprintw(win, 12, 4, "I / F11  : I/O Columns / Sort by I/O");
+    mvwprintw(win, 13, 4, "M / F12  : Memory Columns / Sort by PSS");
+    mvwprintw(win, 14, 4, "P        : ProcX's Own Cost (Profile)");
+    mvwprintw(win, 15, 4, "ESC / Q  : Shutdown ProcX");
 
     wattron(win, A_BOLD | COLOR_PAIR(CP_CYAN));
     mvwprintw(win, h - 2, (w - 22) / 2, "READY TO CONTINUE");
@@ -367,6 +1081,7 @@ void render_help() {
     wrefresh(win);
     wgetch(win);
     delwin(win);
+    dashboard_touch();
 }
 
 int render_confirmation(int pid) {
@@ -389,7 +1104,32 @@ int render_confirmation(int pid) {
     wrefresh(win);
     int ch = wgetch(win);
     delwin(win);
+    dashboard_touch();
     return (ch == 'y' || ch == 'Y');
 }
 
+void render_filter_error(const char* error) {
+    int max_x, max_y;
+    getmaxyx(stdscr, max_y, max_x);
+    int w = 60, h = 7;
+    int x = (max_x - w) / 2, y = (max_y - h) / 2;
+
+    WINDOW* win = newwin(h, w, y, x);
+    wbkgd(win, COLOR_PAIR(CP_DEFAULT));
+    wattron(win, COLOR_PAIR(CP_RED));
+    box(win, 0, 0);
+    wattroff(win, COLOR_PAIR(CP_RED));
+
+    wattron(win, A_BOLD | COLOR_PAIR(CP_RED));
+    mvwprintw(win, 2, (w - 20) / 2, "!! INVALID FILTER !!");
+    wattroff(win, A_BOLD | COLOR_PAIR(CP_RED));
+    mvwprintw(win, 3, 2, "%.*s", w - 4, error);
+    mvwprintw(win, 5, (w - 26) / 2, "PRESS ANY KEY TO DISMISS");
+
+    wrefresh(win);
+    wgetch(win);
+    delwin(win);
+    dashboard_touch();
+}
+
 void close_ui() { endwin(); }
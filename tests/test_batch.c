@@ -0,0 +1,192 @@
+/**
+ * @file test_batch.c
+ * @brief Unit tests for the batch-mode field parser and record writer.
+ * @version 2.0.1
+ */
+
+#include "../include/ui/batch.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @brief Emits the first @p limit positions of @p snapshot through a pipe and
+ * returns the text in @p out.
+ */
+static void emit(const BatchOptions* options, const ProcessSnapshot* snapshot, int limit,
+                 char* out, size_t size) {
+    int fds[2];
+    assert(pipe(fds) == 0);
+    BatchWriter writer;
+    assert(batch_writer_init(&writer, fds[1]) == 0);
+    batch_emit_header(&writer, options);
+    batch_emit_sample(&writer, options, snapshot, limit, 1729212345007LL);
+    assert(batch_writer_flush(&writer) == 0);
+    batch_writer_free(&writer);
+    close(fds[1]);
+
+    ssize_t n = read(fds[0], out, size - 1);
+    assert(n >= 0);
+    out[n] = '\0';
+    close(fds[0]);
+}
+
+/**
+ * @brief Tests field list parsing and its error messages.
+ */
+void test_parse_fields() {
+    BatchOptions options;
+    char         error[128];
+    batch_options_init(&options);
+    assert(options.field_count == 8);
+
+    assert(batch_parse_fields(&options, "pid,cpu,name", error, sizeof(error)) == 0);
+    assert(options.field_count == 3);
+    assert(options.fields[0] == BATCH_FIELD_PID && options.fields[2] == BATCH_FIELD_NAME);
+
+    assert(batch_parse_fields(&options, "pid,bogus", error, sizeof(error)) == -1);
+    assert(strstr(error, "bogus") != NULL);
+    assert(options.field_count == 3);
+    assert(batch_parse_fields(&options, "", error, sizeof(error)) == -1);
+
+    // The sampler reads only the files the fields and the sort need.
+    SortSpec by_io = {{{SORT_FIELD_IO, 1}}, 1};
+    assert(batch_parse_fields(&options, "pid,cpu,name", error, sizeof(error)) == 0);
+    assert(batch_files(&options) == PROC_FILE_STAT);
+    options.sort = &by_io;
+    assert(batch_files(&options) == (PROC_FILE_STAT | PROC_FILE_IO));
+    options.sort = NULL;
+    assert(batch_parse_fields(&options, "pid,syscalls", error, sizeof(error)) == 0);
+    assert(batch_files(&options) == (PROC_FILE_STAT | PROC_FILE_IO));
+    assert(batch_parse_fields(&options, "pid,vsz,anon,file,shmem,swap", error, sizeof(error)) == 0);
+    assert(batch_files(&options) == (PROC_FILE_STAT | PROC_FILE_STATM | PROC_FILE_STATUS));
+    assert(options.fields[1] == BATCH_FIELD_VSZ);
+    assert(batch_parse_fields(&options, "pid,uss", error, sizeof(error)) == 0);
+    assert(batch_files(&options) & PROC_FILE_ROLLUP);
+    batch_options_init(&options);
+    assert(batch_files(&options) == PROC_FILES_SCAN);
+    printf("OK: field lists are parsed and validated\n");
+}
+
+/**
+ * @brief Tests JSON Lines records, including string escaping and number formatting.
+ */
+void test_json() {
+    ProcessNode procs[2] = {
+        {.pid        = 7,
+         .ppid       = 1,
+         .state      = 'R',
+         .cpu_usage  = 12.345f,
+         .memory_kb  = 2048,
+         .nice_value = -5},
+        {.pid = 8, .state = 'S'},
+    };
+    strcpy(procs[0].name, "a\"b\\c\td");
+    strcpy(procs[0].username, "root");
+    strcpy(procs[1].name, "idle");
+    strcpy(procs[1].username, "nobody");
+    procs[0].next = &procs[1];
+
+    ProcessSnapshot snapshot;
+    snapshot_init(&snapshot);
+    assert(snapshot_build(&snapshot, procs, 2) == 0);
+    snapshot_filter(&snapshot, NULL);
+
+    BatchOptions options;
+    char         error[128], out[1024];
+    batch_options_init(&options);
+    assert(batch_parse_fields(&options, "time,pid,nice,state,cpu,mem,name", error,
+                              sizeof(error)) == 0);
+    emit(&options, &snapshot, 2, out, sizeof(out));
+    assert(strcmp(out,
+                  "{\"time\":1729212345.007,\"pid\":7,\"nice\":-5,\"state\":\"R\",\"cpu\":12.35,"
+                  "\"mem\":2048,\"name\":\"a\\\"b\\\\c\\u0009d\"}\n"
+                  "{\"time\":1729212345.007,\"pid\":8,\"nice\":0,\"state\":\"S\",\"cpu\":0.00,"
+                  "\"mem\":0,\"name\":\"idle\"}\n") == 0);
+
+    emit(&options, &snapshot, 1, out, sizeof(out));
+    assert(strchr(out, '\n') == out + strlen(out) - 1);
+    snapshot_free(&snapshot);
+    printf("OK: JSON records are escaped and formatted\n");
+}
+
+/**
+ * @brief Tests the CSV header and RFC 4180 quoting.
+ */
+void test_csv() {
+    ProcessNode proc = {.pid = 42, .uid = 1000, .num_threads = 3};
+    strcpy(proc.name, "say \"hi\", bye");
+    strcpy(proc.username, "alice");
+
+    ProcessSnapshot snapshot;
+    snapshot_init(&snapshot);
+    assert(snapshot_build(&snapshot, &proc, 1) == 0);
+    snapshot_filter(&snapshot, NULL);
+
+    BatchOptions options;
+    char         error[128], out[512];
+    batch_options_init(&options);
+    options.format = BATCH_FORMAT_CSV;
+    assert(batch_parse_fields(&options, "pid,uid,user,threads,name", error, sizeof(error)) == 0);
+    emit(&options, &snapshot, 1, out, sizeof(out));
+    assert(strcmp(out,
+                  "pid,uid,user,threads,name\n42,1000,alice,3,\"say \"\"hi\"\", bye\"\n") == 0);
+
+    // Rates are rounded to whole units; unread counters are -1.
+    snapshot.procs[0].io_read     = 1536.4f;
+    snapshot.procs[0].io_write    = 0.0f;
+    snapshot.procs[0].io_syscalls = -1.0f;
+    assert(batch_parse_fields(&options, "pid,read,write,syscalls", error, sizeof(error)) == 0);
+    emit(&options, &snapshot, 1, out, sizeof(out));
+    assert(strcmp(out, "pid,read,write,syscalls\n42,1536,0,-1\n") == 0);
+    snapshot_free(&snapshot);
+    printf("OK: CSV records are quoted\n");
+}
+
+/**
+ * @brief Tests the profile record, with -1 for phases that never ran.
+ */
+void test_profile() {
+    Profiler profiler;
+    profiler_init(&profiler);
+    profiler_add(&profiler, PROFILE_SORT, 1500);
+    profiler.per_sample[PROFILE_SYSCALLS] = 12;
+    profiler.cpu_usage                    = 0.5f;
+    profiler.rss_kb                       = 2048;
+
+    int  fds[2];
+    char out[1024];
+    assert(pipe(fds) == 0);
+    BatchWriter writer;
+    assert(batch_writer_init(&writer, fds[1]) == 0);
+    batch_emit_profile(&writer, &profiler, 1729212345007LL);
+    assert(batch_writer_flush(&writer) == 0);
+    batch_writer_free(&writer);
+    close(fds[1]);
+    ssize_t n = read(fds[0], out, sizeof(out) - 1);
+    assert(n > 0);
+    out[n] = '\0';
+    close(fds[0]);
+
+    assert(strncmp(out, "{\"time\":1729212345.007,\"readdir\":{\"last_ns\":-1,", 44) == 0);
+    assert(strstr(out, "\"sort\":{\"last_ns\":1500,\"p50_ns\":1500,\"p99_ns\":1500}"));
+    assert(strstr(out, "\"syscalls\":12,\"allocs\":0,\"processes\":0,"
+                       "\"cpu\":0.50,\"rss\":2048}\n"));
+    profiler_free(&profiler);
+    printf("OK: profile records are formatted\n");
+}
+
+/**
+ * @brief Main entry point for the batch output test suite.
+ * @return int Returns 0 if all tests pass, non-zero otherwise.
+ */
+int main() {
+    printf("Running ProcX Batch Output Tests...\n");
+    test_parse_fields();
+    test_json();
+    test_csv();
+    test_profile();
+    printf("All tests passed!\n");
+    return 0;
+}
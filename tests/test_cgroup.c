@@ -0,0 +1,224 @@
+/**
+ * @file test_cgroup.c
+ * @brief Unit tests for the cgroup v2 parsers, walk, and drill-down.
+ * @version 2.0.1
+ */
+
+#include "../include/system/cgroup.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Writes @p text to @p root/@p name.
+ */
+static void write_file(const char* root, const char* name, const char* text) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", root, name);
+    FILE* file = fopen(path, "w");
+    assert(file);
+    fputs(text, file);
+    fclose(file);
+}
+
+/**
+ * @brief Creates the cgroup @p name below @p root with the usual interface files.
+ */
+static void make_cgroup(const char* root, const char* name, unsigned long long usage_usec,
+                        long memory_kb, long tasks) {
+    char dir[512];
+    char text[256];
+    snprintf(dir, sizeof(dir), "%s/%s", root, name);
+    assert(mkdir(dir, 0755) == 0);
+    snprintf(text, sizeof(text), "usage_usec %llu\nuser_usec 0\nsystem_usec 0\n", usage_usec);
+    write_file(dir, "cpu.stat", text);
+    snprintf(text, sizeof(text), "%ld\n", memory_kb * 1024);
+    write_file(dir, "memory.current", text);
+    snprintf(text, sizeof(text), "anon %ld\nfile %ld\nkernel 8192\nshmem 0\n",
+             memory_kb * 512, memory_kb * 256);
+    write_file(dir, "memory.stat", text);
+    snprintf(text, sizeof(text), "%ld\n", tasks);
+    write_file(dir, "pids.current", text);
+}
+
+/**
+ * @brief Returns the inode of @p root/@p name, which is its cgroup ID.
+ */
+static unsigned long long inode_of(const char* root, const char* name) {
+    char        path[512];
+    struct stat st;
+    snprintf(path, sizeof(path), "%s/%s", root, name);
+    assert(stat(path, &st) == 0);
+    return st.st_ino;
+}
+
+/**
+ * @brief Tests the cpu.stat, memory.stat, and /proc/<pid>/cgroup parsers.
+ */
+void test_cgroup_parsers() {
+    const char*        cpu = "usage_usec 123456\nuser_usec 100000\nsystem_usec 23456\n";
+    unsigned long long usage;
+    assert(cgroup_parse_cpu_stat(cpu, strlen(cpu), &usage) == 0 && usage == 123456);
+    assert(cgroup_parse_cpu_stat("user_usec 5\n", 12, &usage) == -1);
+
+    // A key must match in full: "file_mapped" is not "file".
+    const char* stat = "anon 1048576\nfile_mapped 4096\nfile 2097152\nkernel 409600\nslab 8192\n";
+    CgroupInfo  info;
+    assert(cgroup_parse_memory_stat(stat, strlen(stat), &info) == 0);
+    assert(info.anon_kb == 1024 && info.file_kb == 2048 && info.kernel_kb == 400);
+
+    // Without "kernel", its parts are added up.
+    const char* old = "anon 0\nfile 0\nkernel_stack 16384\npagetables 8192\nslab 8192\n";
+    assert(cgroup_parse_memory_stat(old, strlen(old), &info) == 0);
+    assert(info.kernel_kb == 32);
+
+    char        path[64];
+    const char* hybrid = "12:memory:/user.slice\n1:name=systemd:/user.slice\n0::/user.slice/a\n";
+    assert(cgroup_parse_proc(hybrid, strlen(hybrid), path, sizeof(path)) == 0);
+    assert(strcmp(path, "/user.slice/a") == 0);
+    assert(cgroup_parse_proc("0::/\n", 5, path, sizeof(path)) == 0 && strcmp(path, "/") == 0);
+    assert(cgroup_parse_proc("3:cpu:/x\n", 9, path, sizeof(path)) == -1);
+    assert(cgroup_parse_proc(hybrid, strlen(hybrid), path, 8) == -1);
+    printf("OK: cpu.stat, memory.stat, and /proc/<pid>/cgroup parse\n");
+}
+
+/**
+ * @brief Tests the walk of a fixture hierarchy: order, depths, subtree
+ * ranges, missing files, pressure, CPU deltas, paths, and the drill-down restriction.
+ */
+void test_cgroup_walk() {
+    char root[] = "/tmp/procx_cgroup_XXXXXX";
+    assert(mkdtemp(root));
+    write_file(root, "cpu.stat", "usage_usec 0\n");
+    make_cgroup(root, "user.slice", 1000, 4096, 3);
+    make_cgroup(root, "system.slice", 2000, 1024, 5);
+    make_cgroup(root, "system.slice/ssh.service", 500, 256, 1);
+    make_cgroup(root, "system.slice/cron.service", 700, 512, 2);
+    make_cgroup(root, "init.scope", 10, 128, 1);
+    write_file(root, "system.slice/io.pressure",
+               "some avg10=4.50 avg60=1.00 avg300=0.20 total=100\n"
+               "full avg10=2.00 avg60=0.50 avg300=0.10 total=50\n");
+
+    CgroupSampler sampler;
+    CgroupList    list;
+    assert(cgroup_sampler_init(&sampler, root) == 0);
+    cgroup_list_init(&list);
+
+    // Disabled samplers walk nothing.
+    assert(cgroup_sampler_collect(&sampler, &list) == 0 && list.count == 0);
+    sampler.enabled = 1;
+    assert(cgroup_sampler_collect(&sampler, &list) == 0);
+
+    // Depth first, siblings by name.
+    const char* names[]  = {"/", "init.scope", "system.slice", "cron.service", "ssh.service",
+                            "user.slice"};
+    const int   depths[] = {0, 1, 1, 2, 2, 1};
+    assert(list.count == 6);
+    for (int i = 0; i < 6; i++) {
+        assert(strcmp(list.items[i].name, names[i]) == 0);
+        assert(list.items[i].depth == depths[i]);
+        assert(list.items[i].cpu_usage == 0.0f);
+    }
+    assert(list.items[0].descendants == 5 && list.items[2].descendants == 2);
+    assert(list.items[3].parent == 2 && list.items[5].parent == 0);
+    assert(list.items[0].memory_kb == -1 && list.items[0].tasks == -1);
+    assert(list.items[2].memory_kb == 1024 && list.items[2].anon_kb == 512);
+    assert(list.items[2].file_kb == 256 && list.items[2].kernel_kb == 8);
+    assert(list.items[4].tasks == 1);
+    assert(list.items[2].pressure[PRESSURE_IO].some_avg10 == 4.5f);
+    assert(list.items[2].pressure[PRESSURE_IO].full_avg60 == 0.5f);
+    assert(list.items[2].pressure[PRESSURE_CPU].some_avg10 == -1.0f);
+    assert(list.items[0].pressure[PRESSURE_MEMORY].some_avg10 == -1.0f);
+
+    unsigned long long slice = inode_of(root, "system.slice");
+    unsigned long long ssh   = inode_of(root, "system.slice/ssh.service");
+    assert(cgroup_list_find(&list, slice) == 2 && cgroup_list_find(&list, 12345678) == -1);
+
+    char path[64];
+    cgroup_list_path(&list, 4, path, sizeof(path));
+    assert(strcmp(path, "/system.slice/ssh.service") == 0);
+    cgroup_list_path(&list, 0, path, sizeof(path));
+    assert(strcmp(path, "/") == 0);
+    cgroup_list_path(&list, 4, path, 10);
+    assert(strlen(path) == 9);
+
+    // A second walk, one second later: 500 ms of CPU is 50%.
+    write_file(root, "system.slice/cpu.stat", "usage_usec 502000\n");
+    sampler.time_ms -= 1000;
+    assert(cgroup_sampler_collect(&sampler, &list) == 0);
+    assert(list.items[2].cpu_usage > 45.0f && list.items[2].cpu_usage <= 50.0f);
+    assert(list.items[3].cpu_usage == 0.0f);
+
+    // Process counts add up through the subtree; drilling into system.slice
+    // keeps its processes and their threads.
+    ProcessNode nodes[4], thread;
+    memset(nodes, 0, sizeof(nodes));
+    memset(&thread, 0, sizeof(thread));
+    nodes[0] = (ProcessNode){.pid = 1, .cgroup_id = inode_of(root, "init.scope")};
+    nodes[1] = (ProcessNode){.pid = 10, .cgroup_id = ssh};
+    nodes[2] = (ProcessNode){.pid = 11, .cgroup_id = slice};
+    nodes[3] = (ProcessNode){.pid = 20, .cgroup_id = inode_of(root, "user.slice")};
+    thread   = (ProcessNode){.pid = 12, .thread_of = 10, .cgroup_id = ssh};
+    for (int i = 0; i < 3; i++) nodes[i].next = &nodes[i + 1];
+    nodes[1].threads = &thread;
+
+    ProcessSnapshot snapshot;
+    Filter          filter;
+    snapshot_init(&snapshot);
+    filter_init(&filter);
+    assert(snapshot_build(&snapshot, nodes, 5) == 0);
+    cgroup_list_count(&list, &snapshot);
+    assert(list.items[0].processes == 4 && list.items[2].processes == 2);
+    assert(list.items[4].processes == 1 && list.items[3].processes == 0);
+
+    snapshot_filter(&snapshot, &filter);
+    cgroup_list_restrict(&list, slice, &snapshot);
+    assert(snapshot.matched == 3);
+    for (int i = 0; i < snapshot.matched; i++) {
+        pid_t pid = snapshot.procs[snapshot.matches[i]].pid;
+        assert(pid == 10 || pid == 11 || pid == 12);
+    }
+    snapshot_filter(&snapshot, &filter);
+    cgroup_list_restrict(&list, 12345678, &snapshot);
+    assert(snapshot.matched == 0);
+
+    snapshot_free(&snapshot);
+    cgroup_list_free(&list);
+    cgroup_sampler_free(&sampler);
+    char command[64];
+    snprintf(command, sizeof(command), "rm -rf %s", root);
+    assert(system(command) == 0);
+    printf("OK: cgroup_sampler_collect() walks the hierarchy depth-first\n");
+}
+
+/**
+ * @brief Tests that the cgroup of this process is found in the host hierarchy,
+ * when the host has one.
+ */
+void test_cgroup_resolve() {
+    CgroupSampler sampler;
+    if (cgroup_sampler_init(&sampler, NULL) != 0) {
+        printf("SKIP: no cgroup v2 hierarchy on this host\n");
+        return;
+    }
+    assert(cgroup_sampler_resolve(&sampler, getpid()) != 0);
+    assert(cgroup_sampler_resolve(&sampler, 0) == 0);
+    cgroup_sampler_free(&sampler);
+    printf("OK: cgroup_sampler_resolve() maps this process to its cgroup\n");
+}
+
+/**
+ * @brief Main entry point for the cgroup test suite.
+ * @return int Returns 0 if all tests pass, non-zero otherwise.
+ */
+int main() {
+    printf("Running ProcX Cgroup Tests...\n");
+    test_cgroup_parsers();
+    test_cgroup_walk();
+    test_cgroup_resolve();
+    printf("All tests passed!\n");
+    return 0;
+}
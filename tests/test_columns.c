@@ -0,0 +1,163 @@
+/**
+ * @file test_columns.c
+ * @brief Unit tests for the column registry: parsing, detail modes, formatting,
+ *        and the /proc files each set of columns needs.
+ * @version 2.0.1
+ */
+
+#include "../include/ui/columns.h"
+#include "../include/system/proc_parser.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Returns non-zero if @p set holds exactly the @p count columns of @p ids.
+ */
+static int set_is(const ColumnSet* set, const ColumnId* ids, int count) {
+    return set->count == count && memcmp(set->ids, ids, sizeof(ColumnId) * count) == 0;
+}
+
+/**
+ * @brief Tests that every column is declared, and the sort keys are bound once.
+ */
+void test_registry() {
+    int keys = 0;
+    for (int c = 0; c < COLUMN_COUNT; c++) {
+        assert(columns[c].name && columns[c].header && columns[c].format);
+        assert(columns[c].files != 0);
+        assert(columns[c].width > 0 || c == COLUMN_NAME);
+        if (columns[c].function_key) {
+            assert(column_by_key(columns[c].function_key) == &columns[c]);
+            keys++;
+        }
+    }
+    assert(keys == 6);
+    assert(column_by_key(3) == &columns[COLUMN_CPU] && column_by_key(7) == NULL);
+    assert(column_by_key(0) == NULL);
+    assert(column_sort_named("io") == columns[COLUMN_WRITE].sort);
+    assert(column_sort_named("pss") == columns[COLUMN_PSS].sort);
+    assert(column_sort_named("mem") == columns[COLUMN_MEM].sort);
+    assert(column_sort_named("vsz") == NULL);
+    printf("OK: the registry declares every column\n");
+}
+
+/**
+ * @brief Tests column lists and the files they need.
+ */
+void test_parse() {
+    ColumnSet set;
+    char      error[128];
+    column_set_default(&set);
+    assert(set.count == 9 && set.ids[8] == COLUMN_NAME);
+    assert(column_set_files(&set) == PROC_FILES_SCAN);
+
+    // Without the owner and thread columns, status is not read at all.
+    assert(column_set_parse(&set, "pid,cpu,mem,name", error, sizeof(error)) == 0);
+    const ColumnId parsed[] = {COLUMN_PID, COLUMN_CPU, COLUMN_MEM, COLUMN_NAME};
+    assert(set_is(&set, parsed, 4));
+    assert(column_set_files(&set) == (PROC_FILE_STAT | PROC_FILE_STATM));
+    assert(column_set_parse(&set, "pid,state,name", error, sizeof(error)) == 0);
+    assert(column_set_files(&set) == PROC_FILE_STAT);
+    assert(column_set_parse(&set, "pid,threads", error, sizeof(error)) == 0);
+    assert(column_set_files(&set) == (PROC_FILE_STAT | PROC_FILE_STATUS));
+    assert(column_set_parse(&set, "read,uss", error, sizeof(error)) == 0);
+    assert(column_set_files(&set) == (PROC_FILE_STAT | PROC_FILE_IO | PROC_FILE_ROLLUP));
+
+    // A failed parse leaves the set alone.
+    assert(column_set_parse(&set, "pid,owner", error, sizeof(error)) == -1);
+    assert(strstr(error, "owner") && set.count == 2);
+    assert(column_set_parse(&set, "pid,cpu,pid", error, sizeof(error)) == -1);
+    assert(column_set_parse(&set, "pid,name,cpu", error, sizeof(error)) == -1);
+    assert(column_set_parse(&set, "", error, sizeof(error)) == -1);
+    assert(set.count == 2);
+    printf("OK: column lists are parsed and give their files\n");
+}
+
+/**
+ * @brief Tests that the I/O and memory modes swap the detail columns.
+ */
+void test_modes() {
+    ColumnSet base, out;
+    char      error[128];
+    column_set_default(&base);
+    column_set_mode(&base, COLUMN_MODE_DEFAULT, &out);
+    assert(set_is(&out, base.ids, base.count));
+
+    const ColumnId io[] = {COLUMN_PID,  COLUMN_USER,  COLUMN_READ, COLUMN_WRITE,
+                           COLUMN_SYSCALLS, COLUMN_STATE, COLUMN_CPU,  COLUMN_NAME};
+    column_set_mode(&base, COLUMN_MODE_IO, &out);
+    assert(set_is(&out, io, 8));
+    assert(column_set_files(&out) == (PROC_FILE_STAT | PROC_FILE_STATUS | PROC_FILE_IO));
+
+    // Without detail columns the group goes before state, cpu, or name.
+    assert(column_set_parse(&base, "pid,threads,cpu,name", error, sizeof(error)) == 0);
+    const ColumnId memory[] = {COLUMN_PID, COLUMN_THREADS, COLUMN_PSS, COLUMN_USS,
+                               COLUMN_SWAP, COLUMN_CPU,    COLUMN_NAME};
+    column_set_mode(&base, COLUMN_MODE_MEMORY, &out);
+    assert(set_is(&out, memory, 7));
+
+    // Or at the end.
+    assert(column_set_parse(&base, "pid", error, sizeof(error)) == 0);
+    const ColumnId end[] = {COLUMN_PID, COLUMN_READ, COLUMN_WRITE, COLUMN_SYSCALLS};
+    column_set_mode(&base, COLUMN_MODE_IO, &out);
+    assert(set_is(&out, end, 4));
+    printf("OK: the detail modes swap the detail columns\n");
+}
+
+/**
+ * @brief Tests the cell formatters, including unknown values.
+ */
+void test_format() {
+    ProcessNode proc;
+    char        cell[COLUMN_CELL_SIZE];
+    memset(&proc, 0, sizeof(proc));
+    proc.pid         = 4242;
+    proc.state       = 'R';
+    proc.cpu_usage   = 12.34f;
+    proc.memory_kb   = 2048;
+    proc.vsz_kb      = -1;
+    proc.io_read     = 3 * 1024 * 1024;
+    proc.io_write    = -1.0f;
+    proc.io_syscalls = 17.0f;
+    proc.pss_kb      = 512;
+    strcpy(proc.name, "worker");
+
+    assert(columns[COLUMN_PID].format(cell, sizeof(cell), &proc) == COLUMN_COLOR_CYAN);
+    assert(strcmp(cell, "4242") == 0);
+    assert(columns[COLUMN_STATE].format(cell, sizeof(cell), &proc) == COLUMN_COLOR_GREEN);
+    assert(strcmp(cell, "RUNNING") == 0);
+    columns[COLUMN_CPU].format(cell, sizeof(cell), &proc);
+    assert(strcmp(cell, "12.3%") == 0);
+    columns[COLUMN_MEM].format(cell, sizeof(cell), &proc);
+    assert(strcmp(cell, "2.0") == 0);
+    columns[COLUMN_VSZ].format(cell, sizeof(cell), &proc);
+    assert(strcmp(cell, "-") == 0);
+    columns[COLUMN_THREADS].format(cell, sizeof(cell), &proc);
+    assert(strcmp(cell, "-") == 0);
+    columns[COLUMN_READ].format(cell, sizeof(cell), &proc);
+    assert(strcmp(cell, "3.0M") == 0);
+    columns[COLUMN_WRITE].format(cell, sizeof(cell), &proc);
+    assert(strcmp(cell, "-") == 0);
+    columns[COLUMN_SYSCALLS].format(cell, sizeof(cell), &proc);
+    assert(strcmp(cell, "17") == 0);
+    columns[COLUMN_PSS].format(cell, sizeof(cell), &proc);
+    assert(strcmp(cell, "0.5") == 0);
+    columns[COLUMN_NAME].format(cell, sizeof(cell), &proc);
+    assert(strcmp(cell, "worker") == 0);
+    printf("OK: cells are formatted\n");
+}
+
+/**
+ * @brief Main entry point for the column registry test suite.
+ * @return int Returns 0 if all tests pass, non-zero otherwise.
+ */
+int main() {
+    printf("Running ProcX Column Tests...\n");
+    test_registry();
+    test_parse();
+    test_modes();
+    test_format();
+    printf("All tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file test_filter.c
+ * @brief Unit tests for the filter expression compiler and matcher.
+ * @version 2.0.1
+ */
+
+#include "../include/system/filter.h"
+#include "../include/system/proc_parser.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Compiles @p query, asserting success, and tests it against @p proc.
+ */
+static int matches(const char* query, const ProcessNode* proc) {
+    Filter filter;
+    char   error[128];
+    assert(filter_compile(&filter, query, error, sizeof(error)) == 0);
+    int result = filter_match(&filter, proc);
+    filter_free(&filter);
+    return result;
+}
+
+/**
+ * @brief Tests that bare words keep the old case-insensitive name substring
+ * behaviour, including words that contain a colon.
+ */
+void test_bare_words() {
+    ProcessNode proc = {.pid = 42, .state = 'S'};
+    strcpy(proc.name, "kworker/0:1-events");
+    strcpy(proc.username, "root");
+
+    assert(matches("", &proc));
+    assert(matches("KWORK", &proc));
+    assert(matches("kworker/0:1", &proc));
+    assert(!matches("bash", &proc));
+    assert(matches("!bash", &proc));
+    assert(!matches("kworker bash", &proc));
+    printf("OK: bare words match name substrings\n");
+}
+
+/**
+ * @brief Tests text, state, regex, and numeric terms combined in one expression.
+ */
+void test_fields() {
+    ProcessNode proc = {.pid         = 1234,
+                        .ppid        = 1,
+                        .uid         = 26,
+                        .state       = 'R',
+                        .cpu_usage   = 7.5f,
+                        .memory_kb   = 3 * 1024 * 1024,
+                        .num_threads = 12,
+                        .nice_value  = -5,
+                        .priority    = 15};
+    strcpy(proc.name, "java");
+    strcpy(proc.username, "postgres");
+
+    assert(matches("user:postgres cpu>5 state:R name~^java", &proc));
+    assert(matches("user:POSTGRES", &proc));
+    assert(!matches("user:post", &proc));
+    assert(matches("user~^post", &proc));
+    assert(matches("state:DR", &proc));
+    assert(!matches("state:S", &proc));
+    assert(matches("!state:S", &proc));
+    assert(!matches("cpu>=7.6", &proc));
+    assert(matches("cpu<=7.5 pid=1234 ppid:1 uid<100 threads>10 nice<0 pri=15", &proc));
+    assert(matches("mem>2G mem<4g mem>=3072M mem=3145728", &proc));
+    assert(!matches("name~^ava", &proc));
+    printf("OK: field terms match their attributes\n");
+}
+
+/**
+ * @brief Tests that malformed expressions are rejected with a message and leave
+ * an empty filter behind.
+ */
+void test_errors() {
+    const char* bad[] = {"cpu>", "cpu>abc", "mem>5X", "name>5", "state~R", "name~(", "pid~1"};
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        Filter filter;
+        char   error[128] = "";
+        assert(filter_compile(&filter, bad[i], error, sizeof(error)) == -1);
+        assert(error[0] != '\0');
+        assert(filter.count == 0);
+    }
+    printf("OK: malformed expressions are rejected\n");
+}
+
+/**
+ * @brief Tests that a filter reports the files its fields are read from.
+ */
+void test_files() {
+    Filter filter;
+    char   error[128];
+    assert(filter_compile(&filter, "", error, sizeof(error)) == 0);
+    assert(filter_files(&filter) == PROC_FILE_STAT);
+    assert(filter_compile(&filter, "ssh cpu>1 state:R pid<100 nice<0", error, sizeof(error)) == 0);
+    assert(filter_files(&filter) == PROC_FILE_STAT);
+    assert(filter_compile(&filter, "mem>1G", error, sizeof(error)) == 0);
+    assert(filter_files(&filter) == (PROC_FILE_STAT | PROC_FILE_STATM));
+    assert(filter_compile(&filter, "!user:root threads>4", error, sizeof(error)) == 0);
+    assert(filter_files(&filter) == (PROC_FILE_STAT | PROC_FILE_STATUS));
+    printf("OK: filters report the files they need\n");
+}
+
+/**
+ * @brief Main entry point for the filter test suite.
+ * @return int Returns 0 if all tests pass, non-zero otherwise.
+ */
+int main() {
+    printf("Running ProcX Filter Tests...\n");
+    test_bare_words();
+    test_fields();
+    test_errors();
+    test_files();
+    printf("All tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file test_pid_table.c
+ * @brief Unit tests for the PID hash table used for CPU tick tracking.
+ * @version 2.0.1
+ */
+
+#include "../include/system/pid_table.h"
+#include <assert.h>
+#include <stdio.h>
+
+/**
+ * @brief Tests that entries survive a generation in which they are touched and
+ * that recycled PIDs (same PID, new start time) are reported as new.
+ */
+void test_touch_and_pid_reuse() {
+    PidTable table;
+    int      is_new;
+    pid_table_init(&table);
+
+    pid_table_begin(&table);
+    PidTableEntry* e = pid_table_touch(&table, 42, 1000, &is_new);
+    assert(e != NULL && is_new == 1);
+    e->utime = 7;
+    e->stime = 3;
+    pid_table_sweep(&table);
+
+    pid_table_begin(&table);
+    e = pid_table_touch(&table, 42, 1000, &is_new);
+    assert(e != NULL && is_new == 0);
+    assert(e->utime == 7 && e->stime == 3);
+
+    e = pid_table_touch(&table, 42, 2000, &is_new);
+    assert(e != NULL && is_new == 1);
+    assert(e->utime == 0 && e->stime == 0);
+    assert(pid_table_find(&table, 42, 1000) == NULL);
+    assert(pid_table_find(&table, 42, 2000) == e);
+    pid_table_sweep(&table);
+
+    pid_table_free(&table);
+    printf("OK: pid_table_touch() keeps ticks and resets recycled PIDs\n");
+}
+
+/**
+ * @brief Tests that processes missing from a generation are evicted and that the
+ * table shrinks back once the process churn is over.
+ */
+void test_sweep_evicts_dead_pids() {
+    PidTable table;
+    int      is_new;
+    pid_table_init(&table);
+
+    // Simulate many generations of short-lived processes next to one long-lived one.
+    for (int gen = 0; gen < 200; gen++) {
+        pid_table_begin(&table);
+        assert(pid_table_touch(&table, 1, 1, &is_new) != NULL);
+        for (int i = 0; i < 500; i++) {
+            pid_t pid = 1000 + gen * 500 + i;
+            assert(pid_table_touch(&table, pid, (unsigned long long)pid, &is_new) != NULL);
+            assert(is_new == 1);
+        }
+        pid_table_sweep(&table);
+        assert(table.count == 501);
+    }
+    assert(table.capacity <= 4096);
+
+    pid_table_begin(&table);
+    assert(pid_table_touch(&table, 1, 1, &is_new) != NULL && is_new == 0);
+    pid_table_sweep(&table);
+    assert(table.count == 1);
+    assert(table.capacity <= 256);
+    assert(pid_table_find(&table, 1, 1) != NULL);
+    assert(pid_table_find(&table, 1000, 1000) == NULL);
+
+    pid_table_free(&table);
+    printf("OK: pid_table_sweep() evicts dead PIDs and shrinks the table\n");
+}
+
+/**
+ * @brief Tests lookups by PID alone, single removals that keep probe chains
+ * intact, and clearing the table for reuse.
+ */
+void test_get_remove_clear() {
+    PidTable table;
+    int      is_new;
+    pid_table_init(&table);
+    assert(pid_table_get(&table, 7) == NULL);
+
+    for (pid_t pid = 1; pid <= 100; pid++) {
+        assert(pid_table_touch(&table, pid, 5000 + pid, &is_new) != NULL);
+    }
+    PidTableEntry* e = pid_table_get(&table, 42);
+    assert(e != NULL && e->starttime == 5042);
+
+    assert(pid_table_remove(&table, 42) == 1);
+    assert(pid_table_remove(&table, 42) == 0);
+    assert(pid_table_get(&table, 42) == NULL);
+    assert(table.count == 99);
+    for (pid_t pid = 1; pid <= 100; pid++) {
+        if (pid != 42) assert(pid_table_get(&table, pid) != NULL);
+    }
+
+    size_t capacity = table.capacity;
+    pid_table_clear(&table);
+    assert(table.count == 0 && table.used == 0 && table.capacity == capacity);
+    assert(pid_table_get(&table, 1) == NULL);
+    assert(pid_table_touch(&table, 1, 1, &is_new) != NULL && is_new == 1);
+
+    pid_table_free(&table);
+    printf("OK: pid_table_get(), pid_table_remove(), and pid_table_clear()\n");
+}
+
+/**
+ * @brief Main entry point for the PID table test suite.
+ * @return int Returns 0 if all tests pass, non-zero otherwise.
+ */
+int main() {
+    printf("Running ProcX PID Table Tests...\n");
+    test_touch_and_pid_reuse();
+    test_sweep_evicts_dead_pids();
+    test_get_remove_clear();
+    printf("All tests passed!\n");
+    return 0;
+}
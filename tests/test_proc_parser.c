@@ -0,0 +1,302 @@
+/**
+ * @file test_proc_parser.c
+ * @brief Unit tests for the /proc/[pid] field scanners.
+ * @version 2.0.1
+ */
+
+#include "../include/system/proc_parser.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Tests that a command name containing spaces and ')' is kept intact and
+ * that the numeric fields after it are still found.
+ */
+void test_stat_with_tricky_comm() {
+    const char* stat =
+        "4242 (my (weird) app) S 1 4242 4242 0 -1 4194560 1234 0 5 0 "
+        "150 25 0 0 20 -5 3 0 987654 12345678 910 18446744073709551615\n";
+    ProcessNode info;
+    memset(&info, 0, sizeof(info));
+
+    assert(proc_parse_stat(stat, strlen(stat), &info) == 0);
+    assert(strcmp(info.name, "my (weird) app") == 0);
+    assert(info.state == 'S');
+    assert(info.ppid == 1);
+    assert(info.utime == 150 && info.stime == 25);
+    assert(info.priority == 20 && info.nice_value == -5);
+    assert(info.starttime == 987654ULL);
+
+    assert(proc_parse_stat("4242 (broken", 12, &info) == -1);
+    printf("OK: proc_parse_stat() handles comm with spaces and parentheses\n");
+}
+
+/**
+ * @brief Tests statm and status parsing on fixed inputs.
+ */
+void test_statm_and_status() {
+    ProcessNode info;
+    const char* statm = "2000 300 100 10 0 150 0\n";
+    assert(proc_parse_statm(statm, strlen(statm), &info) == 0);
+    assert(info.memory_kb == 300 * (sysconf(_SC_PAGESIZE) / 1024));
+    assert(info.vsz_kb == 2000 * (sysconf(_SC_PAGESIZE) / 1024));
+
+    const char* status =
+        "Name:\tbash\nUmask:\t0022\nState:\tS (sleeping)\nUid:\t1000\t1000\t1000\t1000\n"
+        "Gid:\t1000\t1000\t1000\t1000\nGroups:\t4 24 27\nVmSize:\t8000 kB\nVmRSS:\t1200 kB\n"
+        "RssAnon:\t700 kB\nRssFile:\t480 kB\nRssShmem:\t20 kB\nVmSwap:\t64 kB\nThreads:\t7\n";
+    proc_parse_status(status, strlen(status), &info);
+    assert(info.uid == 1000);
+    assert(info.num_threads == 7);
+    assert(info.anon_kb == 700 && info.file_kb == 480 && info.shmem_kb == 20);
+    assert(info.swap_kb == 64);
+
+    // Kernel threads have no memory lines.
+    const char* kthread = "Name:\tkworker/0:1\nUid:\t0\t0\t0\t0\nThreads:\t1\n";
+    proc_parse_status(kthread, strlen(kthread), &info);
+    assert(info.anon_kb == -1 && info.file_kb == -1 && info.swap_kb == -1);
+    printf("OK: proc_parse_statm() and proc_parse_status() read memory, UID, and threads\n");
+}
+
+/**
+ * @brief Tests reading the running test process through the cached /proc descriptor.
+ */
+void test_read_self() {
+    ProcessNode info;
+    assert(proc_read_process(proc_root_fd(), getpid(), PROC_FILES_SCAN, &info) == 0);
+    assert(info.pid == getpid());
+    assert(info.ppid == getppid());
+    assert(info.starttime > 0);
+    assert(proc_read_process(proc_root_fd(), 0, PROC_FILES_SCAN, &info) == -1);
+
+    // Files that are not wanted are not read, and their values are unknown.
+    assert(proc_read_process(proc_root_fd(), getpid(), PROC_FILE_STAT, &info) == 0);
+    assert(info.ppid == getppid());
+    assert(info.memory_kb == 0 && info.vsz_kb == -1);
+    assert(info.uid == (uid_t)-1 && info.num_threads == 0 && info.anon_kb == -1);
+    assert(proc_read_process(proc_root_fd(), getpid(), PROC_FILE_STAT | PROC_FILE_STATM, &info) ==
+           0);
+    assert(info.memory_kb > 0 && info.uid == (uid_t)-1);
+    printf("OK: proc_read_process() reads PID %d (%s)\n", info.pid, info.name);
+}
+
+/**
+ * @brief Tests /proc/stat parsing on a fixed input with an offline CPU, and on
+ *        the live file.
+ */
+void test_cpu_stat() {
+    static char text[8192];
+    int         len = snprintf(text, sizeof(text),
+                               "cpu  100 5 50 1000 20 3 2 1 0 0\n"
+                               "cpu0 60 5 30 500 10 2 1 1 0 0\n"
+                               "cpu2 40 0 20 500 10 1 1 0 0 0\n"
+                               "intr 123456");
+    // A long interrupt line must not disturb the lines after it.
+    for (int i = 0; i < 1000; i++) len += snprintf(text + len, sizeof(text) - len, " %d", i);
+    len += snprintf(text + len, sizeof(text) - len,
+                    "\nctxt 987654321\nbtime 1700000000\nprocesses 4242\n"
+                    "procs_running 3\nprocs_blocked 1\nsoftirq 1 2 3\n");
+
+    CpuStat stat;
+    memset(&stat, 0, sizeof(stat));
+    assert(proc_parse_cpu_stat(text, (size_t)len, &stat) == 0);
+    assert(stat.total.user == 100 && stat.total.nice == 5 && stat.total.system == 50);
+    assert(stat.total.idle == 1000 && stat.total.steal == 1);
+    assert(proc_cpu_total(&stat.total) == 1181);
+    assert(stat.core_count == 3);
+    assert(stat.cores[0].user == 60 && stat.cores[2].system == 20);
+    assert(proc_cpu_total(&stat.cores[1]) == 0);
+    assert(stat.ctxt == 987654321ULL);
+    assert(stat.procs_running == 3 && stat.procs_blocked == 1);
+
+    const char* broken = "intr 1 2 3\nctxt 5\n";
+    assert(proc_parse_cpu_stat(broken, strlen(broken), &stat) == -1);
+
+    // The same descriptor is re-read from the start for every sample.
+    int fd = openat(proc_root_fd(), "stat", O_RDONLY);
+    assert(fd >= 0);
+    assert(proc_read_cpu_stat(fd, &stat) == 0);
+    assert(stat.core_count >= 1 && stat.time_ms > 0 && stat.ctxt > 0);
+    assert(proc_cpu_total(&stat.total) >= proc_cpu_total(&stat.cores[0]));
+    unsigned long long ctxt  = stat.ctxt;
+    int                cores = stat.core_count;
+    assert(proc_read_cpu_stat(fd, &stat) == 0 && stat.ctxt >= ctxt);
+    close(fd);
+    assert(proc_read_cpu_stat(-1, &stat) == -1 && stat.time_ms == 0);
+    printf("OK: proc_parse_cpu_stat() reads %d CPU(s), ctxt, and procs_running\n", cores);
+}
+
+/**
+ * @brief Tests the meminfo, loadavg, and uptime parsers on fixed inputs.
+ */
+void test_system_files() {
+    const char* meminfo =
+        "MemTotal:       16000000 kB\nMemFree:         2000000 kB\n"
+        "MemAvailable:    9000000 kB\nBuffers:          300000 kB\n"
+        "Cached:          5000000 kB\nSwapCached:            0 kB\n"
+        "Active:          6000000 kB\nSwapTotal:       4000000 kB\n"
+        "SwapFree:        3000000 kB\nDirty:               100 kB\n";
+    MemInfo mem;
+    assert(proc_parse_meminfo(meminfo, strlen(meminfo), &mem) == 0);
+    assert(mem.total_kb == 16000000 && mem.free_kb == 2000000 && mem.available_kb == 9000000);
+    assert(mem.buffers_kb == 300000 && mem.cached_kb == 5000000);
+    assert(mem.swap_total_kb == 4000000 && mem.swap_free_kb == 3000000);
+
+    // SwapCached must not be taken for Cached, nor a missing key for another.
+    const char* old = "MemTotal: 1000 kB\nSwapCached: 7 kB\nCached: 300 kB\n";
+    assert(proc_parse_meminfo(old, strlen(old), &mem) == 0);
+    assert(mem.cached_kb == 300 && mem.available_kb == 0 && mem.swap_total_kb == 0);
+    assert(proc_parse_meminfo("Cached: 1 kB\n", 13, &mem) == -1);
+
+    double      load[3];
+    const char* loadavg = "0.25 1.50 12.05 2/345 6789\n";
+    assert(proc_parse_loadavg(loadavg, strlen(loadavg), load) == 0);
+    assert(load[0] > 0.2499 && load[0] < 0.2501 && load[1] == 1.5);
+    assert(load[2] > 12.0499 && load[2] < 12.0501);
+    assert(proc_parse_loadavg("0.1 x", 5, load) == -1);
+
+    long        uptime;
+    const char* text = "123456.78 98765.43\n";
+    assert(proc_parse_uptime(text, strlen(text), &uptime) == 0 && uptime == 123456);
+    printf("OK: proc_parse_meminfo(), proc_parse_loadavg(), and proc_parse_uptime()\n");
+}
+
+/**
+ * @brief Tests the pressure parser on both line layouts and on a file without PSI data.
+ */
+void test_pressure() {
+    PressureStat stat;
+    const char*  memory = "some avg10=1.25 avg60=0.50 avg300=0.10 total=123456789\n"
+                          "full avg10=0.75 avg60=0.25 avg300=0.05 total=98765\n";
+    assert(proc_parse_pressure(memory, strlen(memory), &stat) == 0);
+    assert(stat.some_avg10 > 1.249f && stat.some_avg10 < 1.251f && stat.some_avg60 == 0.5f);
+    assert(stat.full_avg10 == 0.75f && stat.full_avg60 == 0.25f);
+
+    // CPU pressure before Linux 5.13 has no "full" line.
+    const char* cpu = "some avg10=12.00 avg60=3.40 avg300=1.00 total=5000\n";
+    assert(proc_parse_pressure(cpu, strlen(cpu), &stat) == 0);
+    assert(stat.some_avg10 == 12.0f && stat.full_avg10 == 0.0f && stat.full_avg60 == 0.0f);
+
+    const char* broken = "full avg10=1.00 avg60=1.00 avg300=1.00 total=1\nsome avg10=x\n";
+    assert(proc_parse_pressure(broken, strlen(broken), &stat) == -1);
+    assert(proc_parse_pressure("", 0, &stat) == -1);
+    printf("OK: proc_parse_pressure()\n");
+}
+
+/**
+ * @brief Tests the /proc/[pid]/io and /proc/diskstats parsers, and reads the
+ * counters of this process.
+ */
+void test_io() {
+    ProcIo      io;
+    const char* text = "rchar: 4096\nwchar: 100\nsyscr: 12\nsyscw: 3\nread_bytes: 8192\n"
+                       "write_bytes: 512\ncancelled_write_bytes: 0\n";
+    assert(proc_parse_io(text, strlen(text), &io) == 0);
+    assert(io.read_bytes == 8192 && io.write_bytes == 512 && io.syscr == 12 && io.syscw == 3);
+    assert(proc_parse_io("rchar: 1\nsyscr: 2\n", 18, &io) == -1);
+
+    // Reading our own counters is always allowed.
+    assert(proc_read_io(proc_root_fd(), getpid(), &io) == 0 && io.syscr > 0);
+
+    // Older kernels end after io_ticks; partitions and discard fields follow on newer ones.
+    DiskCounters disks[2];
+    const char*  stats = "   8       0 sda 100 5 2000 40 50 6 3000 70 1 900 110 0 0 0 0\n"
+                         "   8       1 sda1 90 5 1800 30 40 6 2800 60 0 800 90\n"
+                         " 259       0 nvme0n1 1 2 3\n"
+                         "   8      16 sdb 1 0 8 0 2 0 16 0 0 4 0\n";
+    assert(proc_parse_diskstats(stats, strlen(stats), disks, 2) == 2);
+    assert(strcmp(disks[0].name, "sda") == 0 && strcmp(disks[1].name, "sda1") == 0);
+    assert(disks[0].sectors_read == 2000 && disks[0].sectors_written == 3000);
+    assert(disks[0].io_ticks == 900 && disks[1].io_ticks == 800);
+    assert(proc_parse_diskstats(stats, strlen(stats), disks, 1) == 1);
+    printf("OK: proc_parse_io() and proc_parse_diskstats()\n");
+}
+
+/**
+ * @brief Tests the smaps_rollup parser, and reads the rollup of this process.
+ */
+void test_smaps_rollup() {
+    ProcRollup  rollup;
+    const char* text = "55d0c0000000-7ffd00000000 ---p 00000000 00:00 0    [rollup]\n"
+                       "Rss:                1244 kB\nPss:                 438 kB\n"
+                       "Pss_Anon:            100 kB\nShared_Clean:       1080 kB\n"
+                       "Private_Clean:        64 kB\nPrivate_Dirty:       100 kB\n"
+                       "Private_Hugetlb:       0 kB\nSwap:                  0 kB\n";
+    assert(proc_parse_smaps_rollup(text, strlen(text), &rollup) == 0);
+    assert(rollup.pss_kb == 438 && rollup.uss_kb == 164);
+    assert(proc_parse_smaps_rollup("Rss: 4 kB\n", 10, &rollup) == -1);
+
+    assert(proc_read_smaps_rollup(proc_root_fd(), getpid(), &rollup) == 0);
+    assert(rollup.pss_kb > 0 && rollup.uss_kb > 0 && rollup.uss_kb <= rollup.pss_kb);
+    printf("OK: proc_parse_smaps_rollup() reads PSS %ld kB and USS %ld kB\n", rollup.pss_kb,
+           rollup.uss_kb);
+}
+
+/**
+ * @brief Writes @p text to @p name below @p dir_fd.
+ */
+static void write_text(int dir_fd, const char* name, const char* text) {
+    int fd = openat(dir_fd, name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    assert(fd >= 0);
+    assert(write(fd, text, strlen(text)) == (ssize_t)strlen(text));
+    close(fd);
+}
+
+/**
+ * @brief Tests that a different root is read instead of /proc. Runs last,
+ *        since the root stays changed.
+ */
+void test_set_root() {
+    char root[] = "/tmp/procx_test_root_XXXXXX";
+    assert(mkdtemp(root) != NULL);
+    assert(proc_set_root("/nonexistent/procx") == -1);
+    assert(proc_read_process(proc_root_fd(), getpid(), PROC_FILE_STAT, &(ProcessNode){0}) == 0);
+
+    int root_fd = open(root, O_RDONLY | O_DIRECTORY);
+    assert(root_fd >= 0 && mkdirat(root_fd, "77", 0755) == 0);
+    int pid_fd = openat(root_fd, "77", O_RDONLY | O_DIRECTORY);
+    write_text(pid_fd, "stat",
+               "77 (fixture) S 1 77 77 0 -1 4194560 0 0 0 0 12 3 0 0 20 0 1 0 500 0 0\n");
+    write_text(pid_fd, "statm", "100 25 5 1 0 20 0\n");
+    write_text(pid_fd, "status", "Name:\tfixture\nUid:\t1000\t1000\t1000\t1000\nThreads:\t4\n");
+
+    ProcessNode info;
+    assert(proc_set_root(root) == 0);
+    assert(proc_read_process(proc_root_fd(), 77, PROC_FILES_SCAN, &info) == 0);
+    assert(strcmp(info.name, "fixture") == 0 && info.utime == 12 && info.starttime == 500);
+    assert(info.uid == 1000 && info.num_threads == 4 && info.memory_kb > 0);
+    assert(proc_read_process(proc_root_fd(), getpid(), PROC_FILE_STAT, &info) == -1);
+
+    unlinkat(pid_fd, "stat", 0);
+    unlinkat(pid_fd, "statm", 0);
+    unlinkat(pid_fd, "status", 0);
+    close(pid_fd);
+    unlinkat(root_fd, "77", AT_REMOVEDIR);
+    close(root_fd);
+    rmdir(root);
+    printf("OK: proc_set_root() reads another tree\n");
+}
+
+/**
+ * @brief Main entry point for the /proc parser test suite.
+ * @return int Returns 0 if all tests pass, non-zero otherwise.
+ */
+int main() {
+    printf("Running ProcX Parser Tests...\n");
+    test_stat_with_tricky_comm();
+    test_statm_and_status();
+    test_read_self();
+    test_cpu_stat();
+    test_system_files();
+    test_pressure();
+    test_io();
+    test_smaps_rollup();
+    test_set_root();
+    printf("All tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,254 @@
+/**
+ * @file test_process_tree.c
+ * @brief Unit tests for the process tree view.
+ * @version 2.0.1
+ */
+
+#include "../include/system/process_tree.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief CPU descending, then PID, like the dashboard's F3 order. */
+static const SortSpec by_cpu = {{{SORT_FIELD_CPU, 1}, {SORT_FIELD_PID, 0}}, 2};
+
+/**
+ * @brief Builds a linked list of @p count processes in a caller-provided array.
+ */
+static ProcessNode* make_list(ProcessNode* nodes, int count) {
+    for (int i = 0; i < count; i++) {
+        nodes[i].next = (i + 1 < count) ? &nodes[i + 1] : NULL;
+    }
+    return count ? &nodes[0] : NULL;
+}
+
+/**
+ * @brief Returns the row of a PID in the snapshot.
+ */
+static int row_of(const ProcessSnapshot* snapshot, pid_t pid) {
+    for (int r = 0; r < snapshot->count; r++) {
+        if (snapshot->procs[r].pid == pid) return r;
+    }
+    return -1;
+}
+
+/**
+ * @brief Checks the display order against a list of PIDs.
+ */
+static void assert_order(const ProcessSnapshot* snapshot, const pid_t* pids, int count) {
+    assert(snapshot->matched == count);
+    for (int pos = 0; pos < count; pos++) assert(snapshot_at(snapshot, pos)->pid == pids[pos]);
+}
+
+/**
+ * @brief Tests the depth-first layout, sibling order, connector flags, and
+ * subtree totals of a small hierarchy with an orphan.
+ */
+void test_tree_layout() {
+    ProcessNode nodes[9];
+    memset(nodes, 0, sizeof(nodes));
+    const pid_t pids[]  = {1, 2, 10, 11, 12, 13, 14, 20, 99};
+    const pid_t ppids[] = {0, 0, 1, 10, 10, 1, 13, 2, 555};
+    const float cpus[]  = {0, 0, 1, 5, 2, 3, 0, 0.5f, 4};
+    for (int i = 0; i < 9; i++) {
+        nodes[i] = (ProcessNode){
+            .pid = pids[i], .ppid = ppids[i], .cpu_usage = cpus[i], .memory_kb = pids[i] * 10};
+    }
+
+    ProcessSnapshot snapshot;
+    ProcessTree     tree;
+    snapshot_init(&snapshot);
+    process_tree_init(&tree);
+    assert(snapshot_build(&snapshot, make_list(nodes, 9), 9) == 0);
+    snapshot_sort(&snapshot, &by_cpu);
+    assert(process_tree_build(&tree, &snapshot) == 0);
+    assert(tree.count == 9);
+
+    // Roots and every sibling group are in CPU order.
+    const pid_t preorder[] = {99, 1, 13, 14, 10, 11, 12, 2, 20};
+    const int   depth[]    = {0, 0, 1, 2, 1, 2, 2, 0, 1};
+    const int   last[]     = {0, 0, 0, 1, 1, 0, 1, 1, 1};
+    for (int i = 0; i < 9; i++) {
+        int r = tree.preorder[i];
+        assert(snapshot.procs[r].pid == preorder[i]);
+        assert(tree.depth[r] == depth[i]);
+        assert(!!(tree.flags[r] & TREE_NODE_LAST) == last[i]);
+    }
+
+    // 14 sits below 13, which has a later sibling, so depth 1 keeps a guide.
+    assert(tree.guides[row_of(&snapshot, 14)] == (1ULL << 1));
+    assert(tree.guides[row_of(&snapshot, 11)] == 0);
+
+    int init = row_of(&snapshot, 1);
+    int pool = row_of(&snapshot, 10);
+    assert(tree.flags[init] & TREE_NODE_PARENT);
+    assert(!(tree.flags[row_of(&snapshot, 12)] & TREE_NODE_PARENT));
+    assert(tree.descendants[init] == 5 && tree.descendants[pool] == 2);
+    assert(tree.subtree_cpu[init] == 11.0f && tree.subtree_cpu[pool] == 8.0f);
+    assert(tree.subtree_mem[pool] == 330);
+
+    process_tree_free(&tree);
+    snapshot_free(&snapshot);
+    printf("OK: process_tree_build() lays out sorted sibling groups depth-first\n");
+}
+
+/**
+ * @brief Tests that collapsing hides exactly the subtree and that expanding
+ * restores it, without rebuilding the tree.
+ */
+void test_tree_collapse() {
+    ProcessNode nodes[6];
+    memset(nodes, 0, sizeof(nodes));
+    const pid_t pids[]  = {1, 2, 3, 4, 5, 6};
+    const pid_t ppids[] = {0, 1, 2, 2, 1, 0};
+    for (int i = 0; i < 6; i++) nodes[i] = (ProcessNode){.pid = pids[i], .ppid = ppids[i]};
+
+    ProcessSnapshot snapshot;
+    ProcessTree     tree;
+    TreeCollapse    collapse;
+    snapshot_init(&snapshot);
+    process_tree_init(&tree);
+    tree_collapse_init(&collapse);
+    assert(snapshot_build(&snapshot, make_list(nodes, 6), 6) == 0);
+    snapshot_sort(&snapshot, &by_cpu);
+    assert(process_tree_build(&tree, &snapshot) == 0);
+
+    process_tree_apply(&tree, &snapshot, &collapse);
+    const pid_t all[] = {1, 2, 3, 4, 5, 6};
+    assert_order(&snapshot, all, 6);
+
+    assert(tree_collapse_toggle(&collapse, 2) == 1);
+    process_tree_apply(&tree, &snapshot, &collapse);
+    const pid_t without_2[] = {1, 2, 5, 6};
+    assert_order(&snapshot, without_2, 4);
+    assert(snapshot.sorted == 4);
+    assert(tree.flags[row_of(&snapshot, 2)] & TREE_NODE_COLLAPSED);
+
+    // Collapsing a leaf has no effect; collapsing the root hides the rest.
+    assert(tree_collapse_toggle(&collapse, 6) == 1);
+    assert(tree_collapse_toggle(&collapse, 1) == 1);
+    process_tree_apply(&tree, &snapshot, &collapse);
+    const pid_t roots[] = {1, 6};
+    assert_order(&snapshot, roots, 2);
+
+    assert(tree_collapse_toggle(&collapse, 1) == 0);
+    assert(tree_collapse_toggle(&collapse, 2) == 0);
+    assert(tree_collapse_contains(&collapse, 6));
+    process_tree_apply(&tree, &snapshot, &collapse);
+    assert_order(&snapshot, all, 6);
+
+    tree_collapse_init(&collapse);
+    for (int i = 0; i < TREE_MAX_COLLAPSED; i++) assert(tree_collapse_toggle(&collapse, i) == 1);
+    assert(tree_collapse_toggle(&collapse, TREE_MAX_COLLAPSED) == -1);
+
+    process_tree_free(&tree);
+    snapshot_free(&snapshot);
+    printf("OK: process_tree_apply() skips collapsed subtrees\n");
+}
+
+/**
+ * @brief Tests that thread rows hang below their process without being
+ * counted twice, and that a parent cycle still shows every row once.
+ */
+void test_tree_threads_and_cycles() {
+    ProcessNode procs[4], threads[2];
+    memset(procs, 0, sizeof(procs));
+    memset(threads, 0, sizeof(threads));
+    procs[0] = (ProcessNode){.pid = 10, .ppid = 0, .cpu_usage = 1.0f, .memory_kb = 100};
+    procs[1] = (ProcessNode){.pid = 20, .ppid = 10, .cpu_usage = 4.0f, .memory_kb = 200};
+    procs[2] = (ProcessNode){.pid = 30, .ppid = 40, .cpu_usage = 0.0f};
+    procs[3] = (ProcessNode){.pid = 40, .ppid = 30, .cpu_usage = 0.0f};
+    make_list(procs, 4);
+    threads[0]       = (ProcessNode){.pid = 20, .thread_of = 20, .cpu_usage = 3.0f};
+    threads[1]       = (ProcessNode){.pid = 21, .thread_of = 20, .cpu_usage = 1.0f};
+    threads[0].next  = &threads[1];
+    procs[1].threads = &threads[0];
+
+    ProcessSnapshot snapshot;
+    ProcessTree     tree;
+    snapshot_init(&snapshot);
+    process_tree_init(&tree);
+    assert(snapshot_build(&snapshot, procs, 6) == 0);
+    snapshot_sort(&snapshot, &by_cpu);
+    assert(process_tree_build(&tree, &snapshot) == 0);
+    assert(tree.count == 6);
+
+    // The main thread's row shares PID 20 with its process but is its child.
+    int process = row_of(&snapshot, 20);
+    assert(snapshot.procs[process].pid == 20 && !snapshot.procs[process].thread_of);
+    assert(tree.descendants[process] == 2);
+    assert(tree.subtree_cpu[process] == 4.0f);
+    assert(tree.subtree_cpu[row_of(&snapshot, 10)] == 5.0f);
+    assert(tree.subtree_mem[row_of(&snapshot, 10)] == 300);
+
+    // 30 and 40 are each other's parent: the cycle is cut at one of them.
+    int rows[2] = {row_of(&snapshot, 30), row_of(&snapshot, 40)};
+    assert(tree.depth[rows[0]] + tree.depth[rows[1]] == 1);
+
+    TreeCollapse collapse;
+    tree_collapse_init(&collapse);
+    process_tree_apply(&tree, &snapshot, &collapse);
+    int seen[6] = {0};
+    for (int pos = 0; pos < snapshot.matched; pos++) seen[snapshot.order[pos]]++;
+    for (int r = 0; r < 6; r++) assert(seen[r] == 1);
+
+    process_tree_free(&tree);
+    snapshot_free(&snapshot);
+    printf("OK: thread rows and parent cycles are laid out once\n");
+}
+
+/**
+ * @brief Tests the invariants of a large random forest: every row appears
+ * once, parents come before their children, and subtree sizes add up.
+ */
+void test_tree_random() {
+    enum { COUNT = 20000 };
+    ProcessNode* nodes = calloc(COUNT, sizeof(ProcessNode));
+    srand(7);
+    for (int i = 0; i < COUNT; i++) {
+        nodes[i].pid       = 1 + i * 3;
+        nodes[i].ppid      = i == 0 ? 0 : 1 + (rand() % (i + 100)) * 3;
+        nodes[i].cpu_usage = (float)(rand() % 100);
+    }
+
+    ProcessSnapshot snapshot;
+    ProcessTree     tree;
+    snapshot_init(&snapshot);
+    process_tree_init(&tree);
+    assert(snapshot_build(&snapshot, make_list(nodes, COUNT), COUNT) == 0);
+    snapshot_sort(&snapshot, &by_cpu);
+    assert(process_tree_build(&tree, &snapshot) == 0);
+    assert(tree.count == COUNT);
+
+    int* position = calloc(COUNT, sizeof(int));
+    for (int i = 0; i < COUNT; i++) position[tree.preorder[i]] = i + 1;
+    for (int r = 0; r < COUNT; r++) {
+        assert(position[r] > 0);
+        int p = tree.parent[r];
+        if (p < 0) continue;
+        assert(position[p] < position[r]);
+        assert(position[r] <= position[p] + tree.descendants[p]);
+        assert(tree.depth[r] == tree.depth[p] + 1);
+    }
+
+    free(position);
+    process_tree_free(&tree);
+    snapshot_free(&snapshot);
+    free(nodes);
+    printf("OK: a random forest of %d processes keeps the preorder invariants\n", COUNT);
+}
+
+/**
+ * @brief Main entry point for the process tree test suite.
+ * @return int Returns 0 if all tests pass, non-zero otherwise.
+ */
+int main() {
+    printf("Running ProcX Process Tree Tests...\n");
+    test_tree_layout();
+    test_tree_collapse();
+    test_tree_threads_and_cycles();
+    test_tree_random();
+    printf("All tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file test_profile.c
+ * @brief Unit tests for the self-profiling counters, phase history, and percentiles.
+ * @version 2.0.1
+ */
+
+#include "../include/system/profile.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Tests the latest duration and the nearest-rank percentiles.
+ */
+void test_stats() {
+    Profiler     profiler;
+    ProfileStats stats;
+    profiler_init(&profiler);
+    assert(profiler_stats(&profiler, PROFILE_SORT, &stats) == -1);
+
+    // 100 down to 1: the median is 50 and the 99th percentile 99.
+    for (long long ns = 100; ns >= 1; ns--) profiler_add(&profiler, PROFILE_SORT, ns);
+    profiler_add(&profiler, PROFILE_SORT, 0);
+    assert(profiler_stats(&profiler, PROFILE_SORT, &stats) == 0);
+    assert(stats.count == 100 && stats.last_ns == 1);
+    assert(stats.p50_ns == 50 && stats.p99_ns == 99);
+
+    // A single duration is every percentile.
+    profiler_add(&profiler, PROFILE_RENDER, 7);
+    assert(profiler_stats(&profiler, PROFILE_RENDER, &stats) == 0);
+    assert(stats.last_ns == 7 && stats.p50_ns == 7 && stats.p99_ns == 7);
+    profiler_free(&profiler);
+    printf("OK: percentiles are taken over the kept durations\n");
+}
+
+/**
+ * @brief Tests that the history keeps only the latest PROFILE_HISTORY durations.
+ */
+void test_history() {
+    Profiler     profiler;
+    ProfileStats stats;
+    profiler_init(&profiler);
+    for (int i = 0; i < PROFILE_HISTORY; i++) profiler_add(&profiler, PROFILE_PARSE, 1000000);
+    for (int i = 1; i <= PROFILE_HISTORY; i++) profiler_add(&profiler, PROFILE_PARSE, i);
+    assert(profiler_stats(&profiler, PROFILE_PARSE, &stats) == 0);
+    assert(stats.count == PROFILE_HISTORY && stats.last_ns == PROFILE_HISTORY);
+    assert(stats.p99_ns < 1000000);
+    profiler_free(&profiler);
+    printf("OK: old durations leave the history\n");
+}
+
+/**
+ * @brief Tests that counters only run while profiling is enabled.
+ */
+void test_counters() {
+    profile_set_enabled(0);
+    unsigned long long before = profile_counter(PROFILE_SYSCALLS);
+    PROFILE_COUNT(PROFILE_SYSCALLS, 5);
+    assert(profile_counter(PROFILE_SYSCALLS) == before);
+
+    profile_set_enabled(1);
+    PROFILE_COUNT(PROFILE_SYSCALLS, 5);
+    PROFILE_COUNT(PROFILE_ALLOCS, 2);
+    assert(profile_counter(PROFILE_SYSCALLS) == before + 5);
+
+    // Timers too: a disabled one never reads the clock.
+    long long total = 0;
+    PROFILE_BEGIN(start);
+    assert(start > 0);
+    PROFILE_END(start, total);
+    assert(total >= 0);
+    profile_set_enabled(0);
+    PROFILE_BEGIN(stopped);
+    assert(stopped == 0);
+    printf("OK: counters and timers follow the switch\n");
+}
+
+/**
+ * @brief Tests that passes give per-sample counter increases and own usage.
+ */
+void test_passes() {
+    Profiler    profiler;
+    ProfilePass pass;
+    profiler_init(&profiler);
+    profile_set_enabled(1);
+
+    profile_pass_begin(&pass);
+    pass.ns[PROFILE_READDIR] = 10;
+    profile_pass_end(&pass);
+    profiler_add_pass(&profiler, &pass);
+    assert(profiler.per_sample[PROFILE_PROCESSES] == 0);
+    assert(profiler.recorded[PROFILE_READDIR] == 1 && profiler.recorded[PROFILE_PARSE] == 0);
+    assert(profiler.rss_kb > 0);
+
+    profile_pass_begin(&pass);
+    assert(pass.ns[PROFILE_READDIR] == 0);
+    PROFILE_COUNT(PROFILE_PROCESSES, 42);
+    profile_pass_end(&pass);
+    profiler_add_pass(&profiler, &pass);
+    assert(profiler.per_sample[PROFILE_PROCESSES] == 42);
+    assert(profiler.recorded[PROFILE_READDIR] == 1);
+    assert(profiler.cpu_usage >= 0.0f);
+
+    profile_set_enabled(0);
+    profiler_free(&profiler);
+    printf("OK: passes give the counters per sample\n");
+}
+
+/**
+ * @brief Main entry point for the self-profiling test suite.
+ * @return int Returns 0 if all tests pass, non-zero otherwise.
+ */
+int main() {
+    printf("Running ProcX Profile Tests...\n");
+    test_stats();
+    test_history();
+    test_counters();
+    test_passes();
+    printf("All tests passed!\n");
+    return 0;
+}
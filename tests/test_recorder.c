@@ -0,0 +1,292 @@
+/**
+ * @file test_recorder.c
+ * @brief Unit tests for the flight recorder ring file and its replay.
+ * @version 2.0.1
+ */
+
+#include "../include/system/recorder.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** @brief Maximum number of samples a test records. */
+#define MAX_STEPS 600
+
+/**
+ * @struct History
+ * @brief Synthetic process population and every sample taken from it.
+ */
+typedef struct History {
+    ProcessNode  live[512];           /**< Current processes, sorted by PID */
+    int          count;               /**< Number of live processes */
+    pid_t        next_pid;            /**< PID of the next new process */
+    ProcessNode* steps[MAX_STEPS];    /**< Copy of live for each recorded sample */
+    int          counts[MAX_STEPS];   /**< Process count of each sample */
+    SystemInfo   infos[MAX_STEPS];    /**< System statistics of each sample */
+    int          taken;               /**< Number of samples recorded */
+} History;
+
+/**
+ * @brief Fills a process with values derived from its PID.
+ */
+static void make_process(ProcessNode* proc, pid_t pid) {
+    memset(proc, 0, sizeof(*proc));
+    proc->pid         = pid;
+    proc->ppid        = pid > 1 ? 1 : 0;
+    proc->uid         = (uid_t)(pid % 3) * 1000;
+    proc->num_threads = 1 + pid % 5;
+    proc->state       = 'S';
+    proc->memory_kb   = 1000L * pid;
+    proc->priority    = 20;
+    proc->starttime   = 100ULL * pid;
+    snprintf(proc->name, sizeof(proc->name), "proc-%d", pid);
+    snprintf(proc->username, sizeof(proc->username), "user%d", pid % 3);
+}
+
+/**
+ * @brief Starts a population of @p count processes.
+ */
+static void history_init(History* history, int count) {
+    memset(history, 0, sizeof(*history));
+    for (int i = 0; i < count; i++) make_process(&history->live[i], 1 + i * 2);
+    history->count    = count;
+    history->next_pid = 1 + count * 2;
+}
+
+/**
+ * @brief Changes some values, ends two processes, and starts two new ones.
+ */
+static void history_advance(History* history) {
+    for (int i = 0; i < history->count; i++) {
+        ProcessNode* proc = &history->live[i];
+        if (rand() % 10 == 0) {
+            proc->cpu_usage = (float)(rand() % 10000) / 100.0f;
+            proc->utime += rand() % 50;
+            proc->stime += rand() % 5;
+        }
+        if (rand() % 20 == 0) proc->memory_kb += rand() % 2000 - 1000;
+        if (rand() % 50 == 0) proc->state = proc->state == 'S' ? 'R' : 'S';
+        if (rand() % 200 == 0) snprintf(proc->name, sizeof(proc->name), "renamed-%d", rand());
+        if (rand() % 300 == 0) proc->nice_value = rand() % 40 - 20;
+    }
+    for (int k = 0; k < 2 && history->count > 2; k++) {
+        int victim = rand() % history->count;
+        memmove(&history->live[victim], &history->live[victim + 1],
+                sizeof(ProcessNode) * (history->count - victim - 1));
+        history->count--;
+    }
+    for (int k = 0; k < 2; k++) make_process(&history->live[history->count++], history->next_pid++);
+}
+
+/**
+ * @brief Records the current population, in reverse PID order to exercise
+ *        the recorder's sort, and keeps a copy for comparison.
+ */
+static void history_record(History* history, Recorder* recorder) {
+    int   n    = history->count;
+    int   step = history->taken++;
+    assert(step < MAX_STEPS);
+    ProcessNode* reversed = malloc(sizeof(ProcessNode) * n);
+    for (int i = 0; i < n; i++) {
+        reversed[i]      = history->live[n - 1 - i];
+        reversed[i].next = i + 1 < n ? &reversed[i + 1] : NULL;
+    }
+
+    Sample sample;
+    memset(&sample, 0, sizeof(sample));
+    snapshot_init(&sample.snapshot);
+    assert(snapshot_build(&sample.snapshot, reversed, n) == 0);
+    sample.info.cpu_usage   = step % 100;
+    sample.info.total_tasks = n;
+    sample.info.load_avg[0] = step / 100.0;
+    sample.info.uptime_sec  = 1000 + step;
+    sample.short_lived      = step % 7 ? -1 : step;
+    sample.time_ms          = 1729212345000LL + step * 1000LL;
+    assert(recorder_append(recorder, &sample) == 0);
+
+    history->steps[step] = malloc(sizeof(ProcessNode) * n);
+    memcpy(history->steps[step], history->live, sizeof(ProcessNode) * n);
+    history->counts[step] = n;
+    history->infos[step]  = sample.info;
+    snapshot_free(&sample.snapshot);
+    free(reversed);
+}
+
+/**
+ * @brief Asserts that the replay's current sample equals recorded step @p step.
+ */
+static void check_step(const History* history, const Replay* replay, int step) {
+    const Sample* sample = &replay->sample;
+    assert(sample->time_ms == 1729212345000LL + step * 1000LL);
+    assert(sample->info.cpu_usage == history->infos[step].cpu_usage);
+    assert(sample->info.uptime_sec == history->infos[step].uptime_sec);
+    assert(sample->info.load_avg[0] > history->infos[step].load_avg[0] - 0.005);
+    assert(sample->short_lived == (step % 7 ? -1 : step));
+    assert(sample->snapshot.count == history->counts[step]);
+    for (int i = 0; i < sample->snapshot.count; i++) {
+        const ProcessNode* got  = &sample->snapshot.procs[i];
+        const ProcessNode* want = &history->steps[step][i];
+        assert(got->pid == want->pid && got->ppid == want->ppid && got->uid == want->uid);
+        assert(strcmp(got->name, want->name) == 0);
+        assert(strcmp(got->username, want->username) == 0);
+        assert(got->state == want->state && got->memory_kb == want->memory_kb);
+        assert(got->utime == want->utime && got->stime == want->stime);
+        assert(got->nice_value == want->nice_value && got->starttime == want->starttime);
+        assert(got->num_threads == want->num_threads && got->priority == want->priority);
+        assert((long)(got->cpu_usage * 100.0f + 0.5f) == (long)(want->cpu_usage * 100.0f + 0.5f));
+    }
+}
+
+/**
+ * @brief Frees the per-step copies.
+ */
+static void history_free(History* history) {
+    for (int i = 0; i < history->taken; i++) free(history->steps[i]);
+}
+
+/**
+ * @brief Tests that every recorded sample is replayed exactly, stepping both
+ * ways, in pages, and from end to end.
+ */
+void test_roundtrip() {
+    char path[] = "/tmp/procx_recorder_XXXXXX";
+    int  fd     = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    static History history;
+    srand(7);
+    history_init(&history, 200);
+    Recorder recorder;
+    assert(recorder_open(&recorder, path, 4 * 1024 * 1024) == 0);
+    for (int i = 0; i < 75; i++) {
+        history_record(&history, &recorder);
+        history_advance(&history);
+    }
+    recorder_close(&recorder);
+
+    Replay replay;
+    char   error[256];
+    assert(replay_open(&replay, path, error, sizeof(error)) == 0);
+    assert(replay_frames(&replay) == 75);
+    assert(replay.index == 74);
+    check_step(&history, &replay, 74);
+    for (int step = 73; step >= 0; step--) {
+        assert(replay_step(&replay, -1) == 0);
+        check_step(&history, &replay, step);
+    }
+    assert(replay_step(&replay, -1) == 0 && replay.index == 0);
+    for (int step = 1; step < 75; step++) {
+        assert(replay_step(&replay, 1) == 0);
+        check_step(&history, &replay, step);
+    }
+    assert(replay_step(&replay, -33) == 0);
+    check_step(&history, &replay, 41);
+    assert(replay_step(&replay, -1000) == 0);
+    check_step(&history, &replay, 0);
+    assert(replay_step(&replay, 1000) == 0);
+    check_step(&history, &replay, 74);
+    replay_close(&replay);
+
+    history_free(&history);
+    unlink(path);
+    printf("OK: recorded samples replay exactly in both directions\n");
+}
+
+/**
+ * @brief Tests that a small ring keeps its size, evicts the oldest frames,
+ * always starts at a keyframe, and continues a recording when reopened.
+ */
+void test_ring_bounded() {
+    char path[] = "/tmp/procx_recorder_XXXXXX";
+    int  fd     = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    static History history;
+    srand(11);
+    history_init(&history, 300);
+    Recorder recorder;
+    assert(recorder_open(&recorder, path, RECORDER_MIN_SIZE) == 0);
+    for (int i = 0; i < 250; i++) {
+        history_record(&history, &recorder);
+        history_advance(&history);
+    }
+    recorder_close(&recorder);
+
+    // Reopening continues the same ring.
+    assert(recorder_open(&recorder, path, RECORDER_MIN_SIZE) == 0);
+    for (int i = 0; i < 250; i++) {
+        history_record(&history, &recorder);
+        history_advance(&history);
+    }
+    recorder_close(&recorder);
+
+    struct stat st;
+    assert(stat(path, &st) == 0 && st.st_size == RECORDER_MIN_SIZE);
+
+    Replay replay;
+    char   error[256];
+    assert(replay_open(&replay, path, error, sizeof(error)) == 0);
+    long frames = replay_frames(&replay);
+    assert(frames > RECORDER_KEYFRAME_INTERVAL && frames < 500);
+    assert(replay.sample.sequence == 500);
+    check_step(&history, &replay, 499);
+
+    int oldest = 500 - (int)frames;
+    assert(replay_step(&replay, -frames) == 0 && replay.index == 0);
+    check_step(&history, &replay, oldest);
+    for (int step = oldest + 1; step < 500; step += 7) {
+        assert(replay_step(&replay, step - oldest - replay.index) == 0);
+        check_step(&history, &replay, step);
+    }
+    replay_close(&replay);
+
+    history_free(&history);
+    unlink(path);
+    printf("OK: the ring stays bounded and starts at a keyframe\n");
+}
+
+/**
+ * @brief Tests that files which are not recordings are rejected.
+ */
+void test_rejects() {
+    char path[] = "/tmp/procx_recorder_XXXXXX";
+    int  fd     = mkstemp(path);
+    assert(fd >= 0);
+    char junk[8192];
+    memset(junk, 'x', sizeof(junk));
+    assert(write(fd, junk, sizeof(junk)) == (ssize_t)sizeof(junk));
+    close(fd);
+
+    Replay replay;
+    char   error[256] = "";
+    assert(replay_open(&replay, path, error, sizeof(error)) == -1);
+    assert(strstr(error, "not a ProcX recording") != NULL);
+
+    // An empty ring is valid but has nothing to show.
+    Recorder recorder;
+    assert(recorder_open(&recorder, path, RECORDER_MIN_SIZE) == 0);
+    recorder_close(&recorder);
+    assert(replay_open(&replay, path, error, sizeof(error)) == -1);
+    assert(strstr(error, "no samples") != NULL);
+
+    unlink(path);
+    printf("OK: invalid and empty recordings are rejected\n");
+}
+
+/**
+ * @brief Main entry point for the recorder test suite.
+ * @return int Returns 0 if all tests pass, non-zero otherwise.
+ */
+int main() {
+    printf("Running ProcX Recorder Tests...\n");
+    test_roundtrip();
+    test_ring_bounded();
+    test_rejects();
+    printf("All tests passed!\n");
+    return 0;
+}
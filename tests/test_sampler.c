@@ -0,0 +1,350 @@
+/**
+ * @file test_sampler.c
+ * @brief Unit tests for the background sampling thread.
+ * @version 2.0.1
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "../include/system/sampler.h"
+#include "../include/system/user_cache.h"
+#include <assert.h>
+#include <poll.h>
+#include <pwd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Waits until the sampler signals a new sample and takes it.
+ * @return 1 if a sample was taken within @p timeout_ms, 0 otherwise.
+ */
+static int wait_sample(Sampler* sampler, int timeout_ms) {
+    struct pollfd pfd = {sampler_fd(sampler), POLLIN, 0};
+    while (poll(&pfd, 1, timeout_ms) > 0) {
+        if (sampler_take(sampler)) return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Tests that samples are published in order, contain this process, and
+ * are never shared between the reader and the sampling thread.
+ */
+void test_publish() {
+    ProcessTable table;
+    process_table_init(&table);
+    Sampler sampler;
+    sampler_init(&sampler, &table, 20);
+    assert(sampler_start(&sampler) == 0);
+
+    assert(wait_sample(&sampler, 2000));
+    Sample* first = sampler.front;
+    assert(first->sequence >= 1);
+    assert(first->info.total_tasks == first->snapshot.count);
+    int found = 0;
+    for (int i = 0; i < first->snapshot.count; i++) {
+        if (first->snapshot.procs[i].pid == getpid()) found = 1;
+    }
+    assert(found);
+
+    unsigned long last = first->sequence;
+    for (int i = 0; i < 5; i++) {
+        assert(wait_sample(&sampler, 2000));
+        assert(sampler.front->sequence > last);
+        last = sampler.front->sequence;
+        pthread_mutex_lock(&sampler.lock);
+        assert(sampler.front != sampler.back && sampler.front != sampler.ready);
+        pthread_mutex_unlock(&sampler.lock);
+    }
+
+    sampler_stop(&sampler);
+    process_table_free(&table);
+    printf("OK: sampler publishes fresh samples in order\n");
+}
+
+/**
+ * @brief Tests that a reader that stops taking samples does not hold up the
+ * sampling thread, and that it then gets the most recent sample.
+ */
+void test_slow_reader() {
+    ProcessTable table;
+    process_table_init(&table);
+    Sampler sampler;
+    sampler_init(&sampler, &table, 10);
+    assert(sampler_start(&sampler) == 0);
+
+    assert(wait_sample(&sampler, 2000));
+    unsigned long before = sampler.front->sequence;
+    struct timespec pause = {0, 200 * 1000000L};
+    nanosleep(&pause, NULL);
+    assert(sampler_take(&sampler));
+    // At 10 ms per sample, many samples were skipped rather than queued.
+    assert(sampler.front->sequence > before + 2);
+
+    sampler_stop(&sampler);
+    process_table_free(&table);
+    printf("OK: a slow reader skips to the latest sample\n");
+}
+
+/**
+ * @brief Returns this process in the reader's sample, or NULL.
+ */
+static const ProcessNode* find_self(const Sampler* sampler) {
+    const ProcessSnapshot* snapshot = &sampler->front->snapshot;
+    for (int i = 0; i < snapshot->count; i++) {
+        if (snapshot->procs[i].pid == getpid()) return &snapshot->procs[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Tests that I/O rates are only measured while wanted, that the switch
+ * works before the thread starts, and that status and statm are only read
+ * while wanted.
+ */
+void test_files() {
+    ProcessTable table;
+    process_table_init(&table);
+    Sampler sampler;
+    sampler_init(&sampler, &table, 20);
+    sampler_set_files(&sampler, PROC_FILES_SCAN | PROC_FILE_IO);
+    assert(sampler_start(&sampler) == 0);
+
+    // The first sample only records the counters; later ones see the
+    // system calls the sampler itself makes on behalf of this process.
+    const ProcessNode* self = NULL;
+    for (int i = 0; i < 10 && !(self && self->io_syscalls > 0.0f); i++) {
+        assert(wait_sample(&sampler, 2000));
+        self = find_self(&sampler);
+        assert(self && self->io_read >= 0.0f && self->io_write >= 0.0f);
+    }
+    assert(self->io_syscalls > 0.0f);
+
+    assert(self->uid == getuid() && self->num_threads >= 1 && self->memory_kb > 0);
+
+    sampler_set_files(&sampler, PROC_FILE_STAT);
+    for (int i = 0; i < 3; i++) assert(wait_sample(&sampler, 2000));
+    self = find_self(&sampler);
+    assert(self && self->io_read == -1.0f && self->io_syscalls == -1.0f);
+    assert(self->uid == (uid_t)-1 && strcmp(self->username, "-") == 0);
+    assert(self->num_threads == 0 && self->memory_kb == 0 && self->vsz_kb == -1);
+
+    // Back with status, the owner is resolved again, by name once the user cache has it.
+    sampler_set_files(&sampler, PROC_FILES_SCAN);
+    for (int i = 0; i < 3; i++) assert(wait_sample(&sampler, 2000));
+    self = find_self(&sampler);
+    assert(self && self->uid == getuid() && strcmp(self->username, "-") != 0);
+    assert(user_cache_wait(5000) == 0);
+    for (int i = 0; i < 2; i++) assert(wait_sample(&sampler, 2000));
+    self = find_self(&sampler);
+    assert(self && strcmp(self->username, getpwuid(getuid())->pw_name) == 0);
+
+    sampler_stop(&sampler);
+    process_table_free(&table);
+    printf("OK: I/O rates, statm, and status are read while wanted\n");
+}
+
+/**
+ * @brief Tests that PSS and USS are measured only for the processes in the
+ * memory view, and kept once the view moves on.
+ */
+void test_memory() {
+    MemoryView view;
+    memory_view_init(&view, 60 * 1000);
+    assert(memory_view_add(&view, 30) == 0 && memory_view_add(&view, 10) == 0);
+    assert(memory_view_add(&view, 20) == 0 && memory_view_add(&view, 10) == 0);
+    assert(view.count == 3 && view.pids[0] == 10 && view.pids[2] == 30);
+    assert(memory_view_wants(&view, 20) && !memory_view_wants(&view, 15));
+
+    ProcessTable table;
+    process_table_init(&table);
+    Sampler sampler;
+    sampler_init(&sampler, &table, 20);
+    memory_view_init(&view, 60 * 1000);
+    memory_view_add(&view, getpid());
+    sampler_set_memory(&sampler, &view);
+    assert(sampler_start(&sampler) == 0);
+    assert(wait_sample(&sampler, 2000));
+
+    const ProcessNode* self = find_self(&sampler);
+    assert(self && self->pss_kb > 0 && self->uss_kb > 0 && self->vsz_kb >= self->memory_kb);
+    const ProcessSnapshot* snapshot = &sampler.front->snapshot;
+    for (int i = 0; i < snapshot->count; i++) {
+        if (snapshot->procs[i].pid != getpid()) assert(snapshot->procs[i].pss_kb == -1);
+    }
+
+    // Out of the view, the last measurement stays.
+    memory_view_init(&view, 60 * 1000);
+    sampler_set_memory(&sampler, &view);
+    for (int i = 0; i < 3; i++) assert(wait_sample(&sampler, 2000));
+    self = find_self(&sampler);
+    assert(self && self->pss_kb > 0);
+
+    sampler_stop(&sampler);
+    process_table_free(&table);
+    printf("OK: PSS and USS are measured for the processes in the view\n");
+}
+
+/** @brief Cleared to end the threads started by test_threads(). */
+static volatile int threads_running = 1;
+
+/**
+ * @brief Named helper thread; "px-busy" spins, the others sleep.
+ */
+static void* helper_thread(void* arg) {
+    const char* name = (const char*)arg;
+    pthread_setname_np(pthread_self(), name);
+    while (threads_running) {
+        if (strcmp(name, "px-busy") != 0) usleep(1000);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Tests that an expanded process lists its threads with their own names
+ * and CPU usage, below it in the sample, and that collapsing it removes them.
+ */
+void test_threads() {
+    static const char* names[] = {"px-busy", "px-idle-1", "px-idle-2"};
+    pthread_t          helpers[3];
+    for (int i = 0; i < 3; i++) {
+        assert(pthread_create(&helpers[i], NULL, helper_thread, (void*)names[i]) == 0);
+    }
+
+    ProcessTable table;
+    process_table_init(&table);
+    ThreadView view;
+    thread_view_init(&view);
+    assert(thread_view_toggle(&view, getpid()) == 1);
+    process_table_set_threads(&table, &view);
+    assert(process_table_update(&table) == 0);
+    struct timespec pause = {0, 200 * 1000000L};
+    nanosleep(&pause, NULL);
+    assert(process_table_update(&table) == 0);
+
+    PidTableEntry* self = pid_table_get(&table.index, getpid());
+    assert(self && self->node);
+    int   count    = 0;
+    float busy_cpu = -1.0f, idle_cpu = 100.0f;
+    for (ProcessNode* thread = self->node->threads; thread; thread = thread->next) {
+        assert(thread->thread_of == getpid());
+        assert(strcmp(thread->username, self->node->username) == 0);
+        if (strcmp(thread->name, "px-busy") == 0) busy_cpu = thread->cpu_usage;
+        if (strcmp(thread->name, "px-idle-1") == 0) idle_cpu = thread->cpu_usage;
+        count++;
+    }
+    // The main thread, the three helpers, and the user cache's resolver.
+    assert(count == 5 && table.thread_count == 5);
+    assert(busy_cpu > idle_cpu);
+
+    // The same rows reach a sample, directly below the process.
+    Sampler sampler;
+    sampler_init(&sampler, &table, 20);
+    assert(sampler_start(&sampler) == 0);
+    sampler_set_threads(&sampler, &view);
+    assert(wait_sample(&sampler, 2000) && wait_sample(&sampler, 2000));
+    const ProcessSnapshot* snapshot = &sampler.front->snapshot;
+    // The sampling thread is now a thread of this process as well.
+    assert(snapshot->threads == 6);
+    assert(sampler.front->info.total_tasks == snapshot->count - 6);
+    int row = 0;
+    while (row < snapshot->count && snapshot->procs[row].pid != getpid()) row++;
+    assert(row + 6 < snapshot->count);
+    for (int i = 1; i <= 6; i++) assert(snapshot->procs[row + i].thread_of == getpid());
+
+    thread_view_toggle(&view, getpid());
+    sampler_set_threads(&sampler, &view);
+    assert(wait_sample(&sampler, 2000) && wait_sample(&sampler, 2000));
+    assert(sampler.front->snapshot.threads == 0);
+    sampler_stop(&sampler);
+    assert(table.thread_count == 0 && pid_table_get(&table.index, getpid())->node->threads == NULL);
+
+    process_table_free(&table);
+    threads_running = 0;
+    for (int i = 0; i < 3; i++) pthread_join(helpers[i], NULL);
+    printf("OK: expanded processes list their threads with per-thread CPU usage\n");
+}
+
+/** @brief Cleared to end the threads started by test_psi_trigger(). */
+static volatile int stall_running = 1;
+
+/**
+ * @brief Spins until stall_running is cleared.
+ */
+static void* stall_thread(void* arg) {
+    (void)arg;
+    while (stall_running) {
+    }
+    return NULL;
+}
+
+/**
+ * @brief Tests that a CPU pressure trigger cuts the wait between samples
+ * short, when the kernel has PSI and lets this process set triggers.
+ */
+void test_psi_trigger() {
+    // Unprivileged triggers need a window that is a multiple of 2 s.
+    int fd = psi_trigger_open(PRESSURE_CPU, 0, 20 * 1000, 2000 * 1000);
+    if (fd < 0) {
+        printf("SKIP: no PSI triggers on this host\n");
+        return;
+    }
+    ProcessTable table;
+    process_table_init(&table);
+    Sampler sampler;
+    sampler_init(&sampler, &table, 60 * 1000);
+    assert(sampler_add_psi_trigger(&sampler, fd) == 0);
+    assert(sampler_add_psi_trigger(&sampler, -1) == -1);
+    assert(sampler_start(&sampler) == 0);
+    assert(wait_sample(&sampler, 2000));
+
+    // One more spinning thread than CPUs stalls some of them on the CPU; the
+    // next sample is then due to the trigger, not to the 60 s interval.
+    long       cpus     = sysconf(_SC_NPROCESSORS_ONLN);
+    int        count    = cpus > 0 ? (int)cpus + 1 : 2;
+    pthread_t* spinners = calloc((size_t)count, sizeof(pthread_t));
+    int        started  = 0;
+    assert(spinners);
+    while (started < count && pthread_create(&spinners[started], NULL, stall_thread, NULL) == 0) {
+        started++;
+    }
+    int woken = started == count && wait_sample(&sampler, 10000);
+    stall_running = 0;
+    for (int i = 0; i < started; i++) pthread_join(spinners[i], NULL);
+    free(spinners);
+    if (started < count) {
+        sampler_stop(&sampler);
+        process_table_free(&table);
+        printf("SKIP: cannot start %d threads to stall the CPUs\n", count);
+        return;
+    }
+    assert(woken);
+    pthread_mutex_lock(&sampler.lock);
+    assert(sampler.wakeups >= 1);
+    pthread_mutex_unlock(&sampler.lock);
+
+    sampler_stop(&sampler);
+    process_table_free(&table);
+    printf("OK: a PSI trigger wakes the sampler early\n");
+}
+
+/**
+ * @brief Main entry point for the sampler test suite.
+ * @return int Returns 0 if all tests pass, non-zero otherwise.
+ */
+int main() {
+    printf("Running ProcX Sampler Tests...\n");
+    test_publish();
+    test_slow_reader();
+    test_files();
+    test_memory();
+    test_threads();
+    test_psi_trigger();
+    printf("All tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,354 @@
+/**
+ * @file test_snapshot.c
+ * @brief Unit tests for process snapshots, their filter, and their multi-key sort.
+ * @version 2.0.1
+ */
+
+#include "../include/system/snapshot.h"
+#include "../include/system/proc_parser.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+/**
+ * @brief Builds a linked list of @p count processes in a caller-provided array.
+ */
+static ProcessNode* make_list(ProcessNode* nodes, int count) {
+    for (int i = 0; i < count; i++) {
+        nodes[i].thread_of = 0;
+        nodes[i].threads   = NULL;
+        nodes[i].next      = (i + 1 < count) ? &nodes[i + 1] : NULL;
+    }
+    return count ? &nodes[0] : NULL;
+}
+
+/**
+ * @brief Tests that processes equal on every key keep the list order, so rows
+ * with the same CPU usage no longer swap places between frames.
+ */
+void test_sort_is_stable() {
+    enum { COUNT = 1000 };
+    ProcessNode* nodes = calloc(COUNT, sizeof(ProcessNode));
+    for (int i = 0; i < COUNT; i++) {
+        nodes[i].pid       = COUNT - i;  // List order differs from PID order.
+        nodes[i].cpu_usage = (float)(i % 3);
+    }
+
+    ProcessSnapshot snapshot;
+    snapshot_init(&snapshot);
+    assert(snapshot_build(&snapshot, make_list(nodes, COUNT), COUNT) == 0);
+    assert(snapshot.count == COUNT);
+
+    SortSpec spec = {{{SORT_FIELD_CPU, 1}}, 1};
+    snapshot_sort(&snapshot, &spec);
+    for (int pos = 1; pos < COUNT; pos++) {
+        ProcessNode* prev = snapshot_at(&snapshot, pos - 1);
+        ProcessNode* curr = snapshot_at(&snapshot, pos);
+        assert(prev->cpu_usage >= curr->cpu_usage);
+        if (prev->cpu_usage == curr->cpu_usage) assert(prev->pid > curr->pid);
+    }
+
+    // Sorting again yields the same order.
+    int* first = malloc(sizeof(int) * COUNT);
+    memcpy(first, snapshot.order, sizeof(int) * COUNT);
+    snapshot_sort(&snapshot, &spec);
+    assert(memcmp(first, snapshot.order, sizeof(int) * COUNT) == 0);
+
+    free(first);
+    snapshot_free(&snapshot);
+    free(nodes);
+    printf("OK: snapshot_sort() is stable for equal keys\n");
+}
+
+/**
+ * @brief Tests CPU desc, RES desc, PID asc ordering, including memory values
+ * whose difference does not fit in an int.
+ */
+void test_sort_multi_key() {
+    ProcessNode nodes[6];
+    memset(nodes, 0, sizeof(nodes));
+    nodes[0] = (ProcessNode){.pid = 50, .cpu_usage = 1.0f, .memory_kb = 10};
+    nodes[1] = (ProcessNode){.pid = 40, .cpu_usage = 2.0f, .memory_kb = 10};
+    nodes[2] = (ProcessNode){.pid = 30, .cpu_usage = 1.0f, .memory_kb = 5000000000L};
+    nodes[3] = (ProcessNode){.pid = 20, .cpu_usage = 1.0f, .memory_kb = 10};
+    nodes[4] = (ProcessNode){.pid = 10, .cpu_usage = 0.0f, .memory_kb = 1};
+    nodes[5] = (ProcessNode){.pid = 60, .cpu_usage = 0.0f, .memory_kb = 3000000000L};
+
+    ProcessSnapshot snapshot;
+    snapshot_init(&snapshot);
+    assert(snapshot_build(&snapshot, make_list(nodes, 6), 6) == 0);
+
+    SortSpec spec = {{{SORT_FIELD_CPU, 1}, {SORT_FIELD_MEM, 1}, {SORT_FIELD_PID, 0}}, 3};
+    snapshot_sort(&snapshot, &spec);
+    const pid_t expected[] = {40, 30, 20, 50, 60, 10};
+    for (int pos = 0; pos < 6; pos++) assert(snapshot_at(&snapshot, pos)->pid == expected[pos]);
+
+    SortSpec by_mem = {{{SORT_FIELD_MEM, 0}, {SORT_FIELD_PID, 1}}, 2};
+    snapshot_sort(&snapshot, &by_mem);
+    const pid_t expected_mem[] = {10, 50, 40, 20, 60, 30};
+    for (int pos = 0; pos < 6; pos++) assert(snapshot_at(&snapshot, pos)->pid == expected_mem[pos]);
+
+    // Unread I/O counters (-1) rank like no I/O at all.
+    nodes[0].io_read = nodes[0].io_write = -1.0f;
+    nodes[1].io_write = 4096.0f;
+    nodes[2].io_read  = 512.0f;
+    nodes[2].io_write = 8192.0f;
+    SortSpec by_io = {{{SORT_FIELD_IO, 1}, {SORT_FIELD_PID, 0}}, 2};
+    snapshot_build(&snapshot, make_list(nodes, 6), 6);
+    snapshot_sort(&snapshot, &by_io);
+    const pid_t expected_io[] = {30, 40, 10, 20, 50, 60};
+    for (int pos = 0; pos < 6; pos++) assert(snapshot_at(&snapshot, pos)->pid == expected_io[pos]);
+
+    // Unmeasured PSS (-1) ranks like none.
+    nodes[0].pss_kb = -1;
+    nodes[3].pss_kb = 900;
+    nodes[5].pss_kb = 100;
+    SortSpec by_pss = {{{SORT_FIELD_PSS, 1}, {SORT_FIELD_PID, 0}}, 2};
+    snapshot_build(&snapshot, make_list(nodes, 6), 6);
+    snapshot_sort(&snapshot, &by_pss);
+    const pid_t expected_pss[] = {20, 60, 10, 30, 40, 50};
+    for (int pos = 0; pos < 6; pos++) assert(snapshot_at(&snapshot, pos)->pid == expected_pss[pos]);
+
+    snapshot_free(&snapshot);
+    printf("OK: snapshot_sort() orders by several keys and wide memory values\n");
+}
+
+/**
+ * @brief Tests that name order matches strcasecmp(), also for names that share
+ * the precomputed eight-byte prefix, and that stale bytes after a short name
+ * are ignored.
+ */
+void test_sort_by_name() {
+    const char* names[] = {"kworker/u8:2", "Bash", "kworker/0:1", "bash", "kworker/u8:10",
+                           "a", "KWORKER", "systemd"};
+    enum { COUNT = sizeof(names) / sizeof(names[0]) };
+    ProcessNode nodes[COUNT];
+    memset(nodes, 'x', sizeof(nodes));
+    for (int i = 0; i < COUNT; i++) {
+        nodes[i].pid = 100 + i;
+        strcpy(nodes[i].name, names[i]);
+    }
+
+    ProcessSnapshot snapshot;
+    snapshot_init(&snapshot);
+    assert(snapshot_build(&snapshot, make_list(nodes, COUNT), COUNT) == 0);
+
+    SortSpec spec = {{{SORT_FIELD_NAME, 0}, {SORT_FIELD_PID, 0}}, 2};
+    snapshot_sort(&snapshot, &spec);
+    for (int pos = 1; pos < COUNT; pos++) {
+        ProcessNode* prev = snapshot_at(&snapshot, pos - 1);
+        ProcessNode* curr = snapshot_at(&snapshot, pos);
+        int          c    = strcasecmp(prev->name, curr->name);
+        assert(c < 0 || (c == 0 && prev->pid < curr->pid));
+    }
+
+    spec.keys[0].descending = 1;
+    snapshot_sort(&snapshot, &spec);
+    for (int pos = 1; pos < COUNT; pos++) {
+        ProcessNode* prev = snapshot_at(&snapshot, pos - 1);
+        ProcessNode* curr = snapshot_at(&snapshot, pos);
+        int          c    = strcasecmp(prev->name, curr->name);
+        assert(c > 0 || (c == 0 && prev->pid < curr->pid));
+    }
+
+    snapshot_free(&snapshot);
+    printf("OK: snapshot_sort() orders names like strcasecmp()\n");
+}
+
+/**
+ * @brief Tests that a partial sort yields exactly the leading rows of a full
+ * sort, for heavily tied keys and limits on both sides of the full-sort cutoff,
+ * and that the remaining positions still hold every other process once.
+ */
+void test_sort_top_matches_full() {
+    enum { COUNT = 5000 };
+    ProcessNode* nodes = calloc(COUNT, sizeof(ProcessNode));
+    srand(7);
+    for (int i = 0; i < COUNT; i++) {
+        nodes[i].pid       = 1 + rand() % 100000;
+        nodes[i].cpu_usage = (rand() % 4 == 0) ? (float)(rand() % 5) : 0.0f;
+        nodes[i].memory_kb = rand() % 50;
+        snprintf(nodes[i].name, sizeof(nodes[i].name), "proc-name-%d", rand() % 30);
+    }
+    const SortSpec specs[] = {
+        {{{SORT_FIELD_CPU, 1}}, 1},
+        {{{SORT_FIELD_MEM, 1}, {SORT_FIELD_CPU, 1}}, 2},
+        {{{SORT_FIELD_NAME, 0}}, 1},
+    };
+    const int limits[] = {1, 37, 60, 500, COUNT / SORT_TOP_FULL_RATIO + 1};
+
+    ProcessSnapshot full, top;
+    snapshot_init(&full);
+    snapshot_init(&top);
+    int* seen = calloc(COUNT, sizeof(int));
+    for (int s = 0; s < 3; s++) {
+        assert(snapshot_build(&full, make_list(nodes, COUNT), COUNT) == 0);
+        snapshot_sort(&full, &specs[s]);
+        assert(full.sorted == COUNT);
+        for (int l = 0; l < 5; l++) {
+            assert(snapshot_build(&top, make_list(nodes, COUNT), COUNT) == 0);
+            snapshot_sort_top(&top, &specs[s], limits[l]);
+            assert(top.sorted >= limits[l]);
+            assert(memcmp(top.order, full.order, sizeof(int) * limits[l]) == 0);
+
+            memset(seen, 0, sizeof(int) * COUNT);
+            for (int pos = 0; pos < COUNT; pos++) seen[top.order[pos]]++;
+            for (int i = 0; i < COUNT; i++) assert(seen[i] == 1);
+        }
+    }
+
+    free(seen);
+    snapshot_free(&top);
+    snapshot_free(&full);
+    free(nodes);
+    printf("OK: snapshot_sort_top() matches the leading rows of a full sort\n");
+}
+
+/**
+ * @brief Tests that a filtered snapshot sorts only the matching processes, in
+ * the same order as sorting them without the others, and that clearing the
+ * filter brings every process back.
+ */
+void test_filter_then_sort() {
+    enum { COUNT = 3000 };
+    ProcessNode* nodes = calloc(COUNT, sizeof(ProcessNode));
+    srand(11);
+    for (int i = 0; i < COUNT; i++) {
+        nodes[i].pid       = i + 1;
+        nodes[i].cpu_usage = (float)(rand() % 6);
+        strcpy(nodes[i].name, (i % 3 == 0) ? "worker" : "idle");
+    }
+
+    Filter filter;
+    char   error[64];
+    assert(filter_compile(&filter, "work cpu>=1", error, sizeof(error)) == 0);
+
+    ProcessSnapshot snapshot;
+    snapshot_init(&snapshot);
+    assert(snapshot_build(&snapshot, make_list(nodes, COUNT), COUNT) == 0);
+    snapshot_filter(&snapshot, &filter);
+
+    int expected = 0;
+    for (int i = 0; i < COUNT; i++) expected += filter_match(&filter, &nodes[i]);
+    assert(snapshot.matched == expected);
+
+    const SortSpec spec = {{{SORT_FIELD_CPU, 1}}, 1};
+    snapshot_sort_top(&snapshot, &spec, 20);
+    assert(snapshot.sorted >= 20);
+    for (int pos = 0; pos < snapshot.matched; pos++) {
+        assert(filter_match(&filter, snapshot_at(&snapshot, pos)));
+    }
+    int* top = malloc(sizeof(int) * 20);
+    memcpy(top, snapshot.order, sizeof(int) * 20);
+
+    snapshot_sort(&snapshot, &spec);
+    assert(memcmp(top, snapshot.order, sizeof(int) * 20) == 0);
+    for (int pos = 1; pos < snapshot.matched; pos++) {
+        ProcessNode* prev = snapshot_at(&snapshot, pos - 1);
+        ProcessNode* curr = snapshot_at(&snapshot, pos);
+        assert(prev->cpu_usage > curr->cpu_usage ||
+               (prev->cpu_usage == curr->cpu_usage && prev->pid < curr->pid));
+    }
+
+    snapshot_filter(&snapshot, NULL);
+    assert(snapshot.matched == COUNT);
+
+    free(top);
+    filter_free(&filter);
+    snapshot_free(&snapshot);
+    free(nodes);
+    printf("OK: snapshot_filter() restricts sorting to the matching processes\n");
+}
+
+/**
+ * @brief Tests that thread rows follow their process, ranked among themselves,
+ * under a full sort, a partial sort, and a filter that only their process passes.
+ */
+void test_threads_stay_grouped() {
+    ProcessNode procs[3], threads[4];
+    memset(procs, 0, sizeof(procs));
+    memset(threads, 0, sizeof(threads));
+    procs[0] = (ProcessNode){.pid = 10, .cpu_usage = 1.0f};
+    procs[1] = (ProcessNode){.pid = 20, .cpu_usage = 5.0f};
+    procs[2] = (ProcessNode){.pid = 30, .cpu_usage = 3.0f};
+    make_list(procs, 3);
+    threads[0]       = (ProcessNode){.pid = 11, .thread_of = 10, .cpu_usage = 0.5f};
+    threads[1]       = (ProcessNode){.pid = 21, .thread_of = 20, .cpu_usage = 1.0f};
+    threads[2]       = (ProcessNode){.pid = 22, .thread_of = 20, .cpu_usage = 3.0f};
+    threads[3]       = (ProcessNode){.pid = 23, .thread_of = 20, .cpu_usage = 1.0f};
+    threads[1].next  = &threads[2];
+    threads[2].next  = &threads[3];
+    procs[0].threads = &threads[0];
+    procs[1].threads = &threads[1];
+
+    ProcessSnapshot snapshot;
+    snapshot_init(&snapshot);
+    assert(snapshot_build(&snapshot, procs, 7) == 0);
+    assert(snapshot.count == 7 && snapshot.threads == 4);
+    const pid_t table_order[] = {10, 11, 20, 21, 22, 23, 30};
+    for (int i = 0; i < 7; i++) assert(snapshot.procs[i].pid == table_order[i]);
+
+    const SortSpec spec       = {{{SORT_FIELD_CPU, 1}, {SORT_FIELD_PID, 0}}, 2};
+    const pid_t    expected[] = {20, 22, 21, 23, 30, 10, 11};
+    snapshot_sort(&snapshot, &spec);
+    for (int pos = 0; pos < 7; pos++) assert(snapshot_at(&snapshot, pos)->pid == expected[pos]);
+    for (int limit = 1; limit <= 7; limit++) {
+        snapshot_filter(&snapshot, NULL);
+        snapshot_sort_top(&snapshot, &spec, limit);
+        for (int pos = 0; pos < limit; pos++) {
+            assert(snapshot_at(&snapshot, pos)->pid == expected[pos]);
+        }
+    }
+
+    Filter filter;
+    char   error[64];
+    assert(filter_compile(&filter, "cpu>=4", error, sizeof(error)) == 0);
+    snapshot_filter(&snapshot, &filter);
+    assert(snapshot.matched == 4);
+    snapshot_sort(&snapshot, &spec);
+    for (int pos = 0; pos < 4; pos++) assert(snapshot_at(&snapshot, pos)->pid == expected[pos]);
+
+    filter_free(&filter);
+    snapshot_free(&snapshot);
+    printf("OK: thread rows stay below their process, ranked by their own values\n");
+}
+
+/**
+ * @brief Tests that a sort order needs the files of all its keys, tie-breaks included.
+ */
+void test_sort_files() {
+    SortSpec by_cpu  = {{{SORT_FIELD_CPU, 1}, {SORT_FIELD_MEM, 1}, {SORT_FIELD_PID, 0}}, 3};
+    SortSpec by_mem  = {{{SORT_FIELD_MEM, 1}, {SORT_FIELD_CPU, 1}}, 2};
+    SortSpec by_io   = {{{SORT_FIELD_IO, 1}}, 1};
+    SortSpec by_pss  = {{{SORT_FIELD_PSS, 1}, {SORT_FIELD_MEM, 1}}, 2};
+    SortSpec by_name = {{{SORT_FIELD_NAME, 0}, {SORT_FIELD_PID, 0}}, 2};
+    SortSpec empty   = {{{SORT_FIELD_MEM, 1}}, 0};
+    assert(snapshot_sort_files(NULL) == PROC_FILE_STAT);
+    assert(snapshot_sort_files(&empty) == PROC_FILE_STAT);
+    assert(snapshot_sort_files(&by_name) == PROC_FILE_STAT);
+    // The RES tie-break of the CPU order needs statm even without a RES column.
+    assert(snapshot_sort_files(&by_cpu) == (PROC_FILE_STAT | PROC_FILE_STATM));
+    assert(snapshot_sort_files(&by_mem) == (PROC_FILE_STAT | PROC_FILE_STATM));
+    assert(snapshot_sort_files(&by_io) == (PROC_FILE_STAT | PROC_FILE_IO));
+    assert(snapshot_sort_files(&by_pss) == (PROC_FILE_STAT | PROC_FILE_STATM | PROC_FILE_ROLLUP));
+    printf("OK: sort orders report the files they need\n");
+}
+
+/**
+ * @brief Main entry point for the snapshot test suite.
+ * @return int Returns 0 if all tests pass, non-zero otherwise.
+ */
+int main() {
+    printf("Running ProcX Snapshot Tests...\n");
+    test_sort_is_stable();
+    test_sort_multi_key();
+    test_sort_by_name();
+    test_sort_top_matches_full();
+    test_filter_then_sort();
+    test_threads_stay_grouped();
+    test_sort_files();
+    printf("All tests passed!\n");
+    return 0;
+}
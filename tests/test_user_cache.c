@@ -0,0 +1,167 @@
+/**
+ * @file test_user_cache.c
+ * @brief Unit tests for the UID to username cache and its resolver thread.
+ * @version 2.0.1
+ */
+
+#include "../include/system/user_cache.h"
+#include <assert.h>
+#include <pwd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/** @brief A UID no passwd database has an entry for. */
+#define UNKNOWN_UID ((uid_t)3999999999u)
+
+/**
+ * @brief Replaces @p path with a file holding @p text, written next to it and
+ *        renamed over it as useradd and vipw do, so no reader sees it half written.
+ */
+static void write_text(const char* path, const char* text) {
+    char temp[64];
+    snprintf(temp, sizeof(temp), "%s.new", path);
+    FILE* file = fopen(temp, "w");
+    assert(file);
+    fputs(text, file);
+    assert(fclose(file) == 0);
+    assert(rename(temp, path) == 0);
+}
+
+/**
+ * @brief Tests that a lookup never waits, and that the resolver replaces the
+ *        placeholder with the passwd name once.
+ */
+void test_lookup() {
+    char           name[USER_CACHE_NAME_LEN], placeholder[16];
+    UserCacheStats stats;
+    unsigned int   generation = user_cache_generation();
+    struct passwd* pw         = getpwuid(getuid());
+
+    int named = user_cache_lookup(getuid(), name, sizeof(name));
+    snprintf(placeholder, sizeof(placeholder), "%u", getuid());
+    assert(named ? strcmp(name, pw->pw_name) == 0 : strcmp(name, placeholder) == 0);
+
+    assert(user_cache_wait(5000) == 0);
+    assert(user_cache_lookup(getuid(), name, sizeof(name)) == 1);
+    assert(strcmp(name, pw->pw_name) == 0);
+    assert(user_cache_generation() != generation);
+
+    // Further lookups are served from the cache.
+    for (int i = 0; i < 1000; i++) user_cache_lookup(getuid(), name, sizeof(name));
+    user_cache_stats(&stats);
+    assert(stats.users == 1 && stats.pending == 0 && stats.lookups == 1);
+
+    // A UID without an entry keeps its number, and is not looked up again.
+    assert(user_cache_lookup(UNKNOWN_UID, name, sizeof(name)) >= 0);
+    assert(user_cache_wait(5000) == 0);
+    assert(user_cache_lookup(UNKNOWN_UID, name, sizeof(name)) == 1);
+    assert(strcmp(name, "3999999999") == 0);
+    user_cache_stats(&stats);
+    assert(stats.users == 2 && stats.lookups == 2);
+
+    // Short buffers get a cut copy.
+    char cut[3];
+    user_cache_lookup(UNKNOWN_UID, cut, sizeof(cut));
+    assert(strcmp(cut, "39") == 0);
+    printf("OK: %u resolves to %s in the background, once\n", getuid(), pw->pw_name);
+}
+
+/**
+ * @brief Tests that the table grows past its initial size and resolves every UID.
+ */
+void test_many_users() {
+    char           name[USER_CACHE_NAME_LEN];
+    UserCacheStats stats;
+    for (uid_t uid = 100000; uid < 101000; uid++) user_cache_lookup(uid, name, sizeof(name));
+    assert(user_cache_wait(30000) == 0);
+    for (uid_t uid = 100000; uid < 101000; uid++) {
+        assert(user_cache_lookup(uid, name, sizeof(name)) == 1);
+    }
+    user_cache_stats(&stats);
+    assert(stats.users == 1002 && stats.pending == 0);
+    printf("OK: %d UIDs cached with %lu lookups\n", stats.users, stats.lookups);
+}
+
+/**
+ * @brief Tests that invalidating keeps every name until it is resolved again,
+ *        and that unchanged names leave the generation alone.
+ */
+void test_invalidate() {
+    char           name[USER_CACHE_NAME_LEN], before[USER_CACHE_NAME_LEN];
+    UserCacheStats stats, after;
+    user_cache_lookup(getuid(), before, sizeof(before));
+    user_cache_stats(&stats);
+    unsigned int generation = user_cache_generation();
+
+    user_cache_invalidate();
+    assert(user_cache_lookup(getuid(), name, sizeof(name)) == 1);
+    assert(strcmp(name, before) == 0);
+    assert(user_cache_wait(30000) == 0);
+    user_cache_stats(&after);
+    assert(after.lookups == stats.lookups + (unsigned long)stats.users);
+    assert(after.refreshes == stats.refreshes + 1);
+    assert(user_cache_generation() == generation);
+    printf("OK: invalidated names stay until they are resolved again\n");
+}
+
+/**
+ * @brief Tests that a changed passwd file and the refresh timer both queue
+ *        every name again.
+ */
+void test_refresh() {
+    char           path[] = "/tmp/procx_passwd_XXXXXX";
+    char           name[USER_CACHE_NAME_LEN];
+    UserCacheStats stats, after;
+    int            fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+    write_text(path, "root:x:0:0:root:/root:/bin/sh\n");
+
+    user_cache_shutdown();
+    user_cache_configure(path, 10, 3600000);
+    user_cache_lookup(0, name, sizeof(name));
+    assert(user_cache_wait(5000) == 0);
+    usleep(50000);  // A few checks of an unchanged file
+    user_cache_stats(&stats);
+    assert(stats.lookups == 1 && stats.refreshes == 0);
+
+    write_text(path, "root:x:0:0:root:/root:/bin/sh\nalice:x:1000:1000::/home/alice:/bin/sh\n");
+    for (int i = 0; i < 200 && stats.refreshes == 0; i++) {
+        usleep(10000);
+        user_cache_stats(&stats);
+    }
+    assert(stats.refreshes == 1);
+    assert(user_cache_wait(5000) == 0);
+    user_cache_stats(&stats);
+    assert(stats.lookups == 2);
+
+    // The timer queues the names again without any change to the file.
+    user_cache_configure(path, 10, 30);
+    for (int i = 0; i < 200 && stats.refreshes < 3; i++) {
+        usleep(10000);
+        user_cache_stats(&stats);
+    }
+    assert(stats.refreshes >= 3);
+
+    user_cache_shutdown();
+    user_cache_stats(&after);
+    assert(after.users == 0 && after.pending == 0 && after.lookups == 0);
+    unlink(path);
+    printf("OK: passwd changes and the refresh timer resolve the names again\n");
+}
+
+/**
+ * @brief Main entry point for the username cache test suite.
+ * @return int Returns 0 if all tests pass, non-zero otherwise.
+ */
+int main() {
+    printf("Running ProcX User Cache Tests...\n");
+    test_lookup();
+    test_many_users();
+    test_invalidate();
+    test_refresh();
+    printf("All tests passed!\n");
+    return 0;
+}